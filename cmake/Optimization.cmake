@@ -0,0 +1,146 @@
+include_guard()
+
+# Release optimizations for agent_lib and the agent:
+#
+#   AGENT_ENABLE_LTO    link time optimization
+#   AGENT_PGO           profile guided optimization, GENERATE builds an instrumented agent that
+#                       the pgo-train target runs, USE rebuilds the same build directory with the
+#                       collected profile
+#   AGENT_TARGET_ARCH   instruction set for the build, for example native or x86-64-v3 (-march)
+#                       or AVX2 (MSVC /arch)
+#
+# The PGO and instruction set flags are public on agent_lib so the header only code in the
+# buffer, the tokenizer and the printers is compiled the same way in every target. The tests and
+# agent_loadgen are instrumented as well, they write their profiles to AGENT_PGO_EXCLUDED_DIR
+# so only the training run of the agent is in the profile.
+
+option(AGENT_ENABLE_LTO "Link time optimization for agent_lib and the agent. Conan options: lto" OFF)
+set(AGENT_PGO "OFF" CACHE STRING "Profile guided optimization phase: OFF, GENERATE or USE. Conan options: pgo")
+set_property(CACHE AGENT_PGO PROPERTY STRINGS OFF GENERATE USE)
+set(AGENT_PGO_PROFILE_DIR "${CMAKE_BINARY_DIR}/pgo" CACHE PATH "Directory for the PGO profile data. Conan options: pgo_profile_dir")
+set(AGENT_TARGET_ARCH "" CACHE STRING "Instruction set to compile for, empty for the compiler default. Conan options: target_arch")
+
+string(TOUPPER "${AGENT_PGO}" AGENT_PGO)
+if(NOT AGENT_PGO MATCHES "^(OFF|GENERATE|USE)$")
+  message(FATAL_ERROR "AGENT_PGO must be OFF, GENERATE or USE: ${AGENT_PGO}")
+endif()
+
+if(AGENT_ENABLE_LTO)
+  include(CheckIPOSupported)
+  check_ipo_supported(RESULT agent_ipo_supported OUTPUT agent_ipo_output LANGUAGES CXX)
+  if(NOT agent_ipo_supported)
+    message(WARNING "Link time optimization is not supported: ${agent_ipo_output}")
+    set(AGENT_ENABLE_LTO OFF)
+  endif()
+endif()
+
+if(NOT AGENT_PGO STREQUAL "OFF")
+  if(MSVC)
+    message(FATAL_ERROR "AGENT_PGO is only supported with GCC and Clang")
+  endif()
+
+  if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    set(AGENT_PGO_PROFILE "${AGENT_PGO_PROFILE_DIR}/agent.profdata")
+    get_filename_component(_compiler_dir "${CMAKE_CXX_COMPILER}" DIRECTORY)
+    find_program(LLVM_PROFDATA_EXECUTABLE NAMES llvm-profdata
+      HINTS "${_compiler_dir}" DOC "Path to llvm-profdata")
+    if(NOT LLVM_PROFDATA_EXECUTABLE AND APPLE)
+      set(LLVM_PROFDATA_EXECUTABLE "xcrun llvm-profdata")
+    endif()
+  endif()
+
+  if(AGENT_PGO STREQUAL "USE")
+    if(CMAKE_CXX_COMPILER_ID MATCHES "Clang" AND NOT EXISTS "${AGENT_PGO_PROFILE}")
+      message(FATAL_ERROR "No PGO profile, build with AGENT_PGO=GENERATE and run the pgo-train target: ${AGENT_PGO_PROFILE}")
+    elseif(NOT EXISTS "${AGENT_PGO_PROFILE_DIR}")
+      message(FATAL_ERROR "No PGO profile, build with AGENT_PGO=GENERATE and run the pgo-train target: ${AGENT_PGO_PROFILE_DIR}")
+    endif()
+  endif()
+  message(INFO " PGO ${AGENT_PGO}: ${AGENT_PGO_PROFILE_DIR}")
+
+  if(AGENT_PGO STREQUAL "GENERATE")
+    # Redirects the profile of an instrumented process that is not the agent at run time
+    set(AGENT_PGO_EXCLUDED_DIR "${CMAKE_BINARY_DIR}/pgo_excluded")
+    if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+      set(AGENT_PGO_EXCLUDED_ENVIRONMENT "LLVM_PROFILE_FILE=${AGENT_PGO_EXCLUDED_DIR}/%p.profraw")
+    else()
+      set(AGENT_PGO_EXCLUDED_ENVIRONMENT "GCOV_PREFIX=${AGENT_PGO_EXCLUDED_DIR}")
+    endif()
+  endif()
+endif()
+
+function(target_optimization_setup _target)
+  if(AGENT_ENABLE_LTO)
+    set_property(TARGET ${_target} PROPERTY INTERPROCEDURAL_OPTIMIZATION TRUE)
+  endif()
+
+  get_target_property(_type ${_target} TYPE)
+  if(_type STREQUAL "EXECUTABLE")
+    return()
+  endif()
+
+  if(AGENT_TARGET_ARCH)
+    if(MSVC)
+      target_compile_options(${_target} PUBLIC "/arch:${AGENT_TARGET_ARCH}")
+    else()
+      target_compile_options(${_target} PUBLIC "-march=${AGENT_TARGET_ARCH}")
+    endif()
+  endif()
+
+  if(AGENT_PGO STREQUAL "GENERATE")
+    # The agent is multithreaded, the counters must be updated atomically
+    set(_flags "-fprofile-generate=${AGENT_PGO_PROFILE_DIR}")
+    if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+      list(APPEND _flags "-fprofile-update=atomic")
+    endif()
+    target_compile_options(${_target} PUBLIC ${_flags})
+    target_link_options(${_target} PUBLIC ${_flags})
+    target_compile_definitions(${_target} PUBLIC AGENT_PGO_GENERATE)
+  elseif(AGENT_PGO STREQUAL "USE")
+    if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+      set(_flags "-fprofile-use=${AGENT_PGO_PROFILE}"
+        -Wno-profile-instr-unprofiled -Wno-profile-instr-out-of-date)
+    else()
+      set(_flags "-fprofile-use=${AGENT_PGO_PROFILE_DIR}" -fprofile-correction -Wno-missing-profile)
+    endif()
+    # LTO compiles again when linking, so the link needs the profile as well
+    target_compile_options(${_target} PUBLIC ${_flags})
+    target_link_options(${_target} PUBLIC ${_flags})
+  endif()
+endfunction()
+
+# Runs the instrumented agent against a replay of a recorded SHDR file with XML and JSON REST
+# and streaming clients. Profiles left by earlier runs are removed first, agent_loadgen writes
+# its profile to AGENT_PGO_EXCLUDED_DIR. Clang profiles are merged into one profile for the USE
+# phase.
+function(create_pgo_train_target)
+  if(NOT AGENT_PGO STREQUAL "GENERATE")
+    return()
+  endif()
+  if(NOT TARGET agent_loadgen)
+    message(WARNING "The pgo-train target requires AGENT_WITH_LOADGEN")
+    return()
+  endif()
+
+  find_program(RUBY_EXECUTABLE NAMES ruby REQUIRED)
+  set(_commands
+    COMMAND ${CMAKE_COMMAND} -E make_directory "${AGENT_PGO_PROFILE_DIR}"
+    COMMAND sh -c "rm -f ${AGENT_PGO_PROFILE_DIR}/*.profraw ${AGENT_PGO_PROFILE_DIR}/*.gcda"
+    COMMAND ${RUBY_EXECUTABLE} "${PROJECT_SOURCE_DIR}/tools/pgo_train.rb"
+            --agent "$<TARGET_FILE:agent>" --loadgen "$<TARGET_FILE:agent_loadgen>"
+            --dir "${CMAKE_BINARY_DIR}/pgo_train" --excluded-dir "${AGENT_PGO_EXCLUDED_DIR}")
+  if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    if(NOT LLVM_PROFDATA_EXECUTABLE)
+      message(FATAL_ERROR "llvm-profdata is required to merge the Clang PGO profiles")
+    endif()
+    list(APPEND _commands
+      COMMAND sh -c "${LLVM_PROFDATA_EXECUTABLE} merge -output=${AGENT_PGO_PROFILE} ${AGENT_PGO_PROFILE_DIR}/*.profraw")
+  endif()
+
+  add_custom_target(pgo-train ${_commands}
+    DEPENDS agent agent_loadgen
+    WORKING_DIRECTORY "${CMAKE_BINARY_DIR}"
+    COMMENT "Training the instrumented agent, profile in ${AGENT_PGO_PROFILE_DIR}"
+    USES_TERMINAL
+    VERBATIM)
+endfunction()
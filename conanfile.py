@@ -15,6 +15,14 @@ class MTConnectAgentConan(ConanFile):
     settings = "os", "compiler", "arch", "build_type"
     options = { "without_ipv6": [True, False],
                 "with_ruby": [True, False], 
+                "with_python": [True, False],
+                "with_io_uring": [True, False],
+                "with_loadgen": [True, False],
+                "with_zstd": [True, False],
+                "lto": [True, False],
+                "pgo": ["off", "generate", "use"],
+                "pgo_profile_dir": [None, "ANY"],
+                "target_arch": [None, "ANY"],
                  "development" : [True, False],
                  "shared": [True, False],
                  "winver": [None, "ANY"],
@@ -33,6 +41,14 @@ class MTConnectAgentConan(ConanFile):
     default_options = {
         "without_ipv6": False,
         "with_ruby": True,
+        "with_python": False,
+        "with_io_uring": False,
+        "with_loadgen": False,
+        "with_zstd": True,
+        "lto": False,
+        "pgo": "off",
+        "pgo_profile_dir": None,
+        "target_arch": None,
         "development": False,
         "shared": False,
         "winver": "0x0A00",
@@ -87,6 +103,10 @@ class MTConnectAgentConan(ConanFile):
     def config_options(self):
         if is_msvc(self):
             self.options.rm_safe("fPIC")
+        if self.settings.os == "Windows":
+            self.options.rm_safe("with_loadgen")
+        if self.settings.os != "Linux":
+            self.options.rm_safe("with_io_uring")
 
     def tool_requires_version(self, package, version):
         self.output.info(f"Checking version of {package} > {version}")
@@ -123,6 +143,12 @@ class MTConnectAgentConan(ConanFile):
         self.requires("mqtt_cpp/13.2.2", headers=True, libs=False, transitive_headers=True, transitive_libs=False)
         self.requires("bzip2/1.0.8", headers=True, libs=True, transitive_headers=True, transitive_libs=True)
         
+        if self.options.with_zstd:
+            self.requires("zstd/1.5.7", headers=True, libs=True, transitive_headers=True, transitive_libs=True)
+
+        if self.options.get_safe("with_io_uring"):
+            self.requires("liburing/2.6", headers=True, libs=True, transitive_headers=True, transitive_libs=True)
+
         if self.options.with_ruby:
             self.requires("mruby/3.4.0", headers=True, libs=True, transitive_headers=True, transitive_libs=True)
 
@@ -136,6 +162,9 @@ class MTConnectAgentConan(ConanFile):
             self.options["boost/*"].shared = True
             self.package_type = "shared-library"
 
+        if self.options.with_python:
+            self.options["boost/*"].without_python = False
+
         if is_msvc(self):
             self.options["boost/*"].extra_b2_flags = ("define=BOOST_USE_WINAPI_VERSION=" + str(self.options.winver))
             
@@ -174,8 +203,18 @@ class MTConnectAgentConan(ConanFile):
         tc = CMakeToolchain(self)
         tc.cache_variables['SHARED_AGENT_LIB'] = self.options.shared.__bool__()
         tc.cache_variables['WITH_RUBY'] = self.options.with_ruby.__bool__()
+        tc.cache_variables['WITH_PYTHON'] = self.options.with_python.__bool__()
         tc.cache_variables['AGENT_WITH_DOCS'] = self.options.with_docs.__bool__()
         tc.cache_variables['AGENT_WITHOUT_IPV6'] = self.options.without_ipv6.__bool__()
+        tc.cache_variables['AGENT_WITH_IO_URING'] = bool(self.options.get_safe("with_io_uring"))
+        tc.cache_variables['AGENT_WITH_LOADGEN'] = bool(self.options.get_safe("with_loadgen"))
+        tc.cache_variables['AGENT_WITH_ZSTD'] = self.options.with_zstd.__bool__()
+        tc.cache_variables['AGENT_ENABLE_LTO'] = self.options.lto.__bool__()
+        tc.cache_variables['AGENT_PGO'] = str(self.options.pgo).upper()
+        if self.options.pgo_profile_dir:
+            tc.cache_variables['AGENT_PGO_PROFILE_DIR'] = str(self.options.pgo_profile_dir)
+        if self.options.target_arch:
+            tc.cache_variables['AGENT_TARGET_ARCH'] = str(self.options.target_arch)
         tc.cache_variables['DEVELOPMENT'] = self.options.development.__bool__()
         if self.options.agent_prefix:
             tc.cache_variables['AGENT_PREFIX'] = self.options.agent_prefix
@@ -217,8 +256,15 @@ class MTConnectAgentConan(ConanFile):
                                  'BOOST_FILESYSTEM_VERSION=3']
         if self.options.with_ruby:
             self.cpp_info.defines.append("WITH_RUBY=1")
+        if self.options.with_python:
+            self.cpp_info.defines.append("WITH_PYTHON=1")
         if self.options.without_ipv6:
             self.cpp_info.defines.append("AGENT_WITHOUT_IPV6=1")
+        if self.options.with_zstd:
+            self.cpp_info.defines.append("AGENT_WITH_ZSTD")
+        if self.options.get_safe("with_io_uring"):
+            self.cpp_info.defines.append("BOOST_ASIO_HAS_IO_URING")
+            self.cpp_info.defines.append("BOOST_ASIO_DISABLE_EPOLL")
         if self.options.shared:
             self.cpp_info.defines.append("SHARED_AGENT_LIB=1")
             self.cpp_info.defines.append("BOOST_ALL_DYN_LINK")
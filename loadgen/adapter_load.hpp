@@ -0,0 +1,352 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <boost/asio.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "timestamp.hpp"
+
+namespace mtconnect::loadgen {
+  /// @brief The kinds of observations an adapter emits
+  enum class Kind
+  {
+    SAMPLE,
+    EVENT,
+    CONDITION,
+    DATA_SET,
+    TIME_SERIES
+  };
+
+  /// @brief The relative weights of the observation kinds
+  struct Mix
+  {
+    int m_samples {60};
+    int m_events {25};
+    int m_conditions {5};
+    int m_dataSets {5};
+    int m_timeSeries {5};
+
+    /// @brief expand the weights into a repeating sequence of kinds
+    /// @return the kinds, interleaved so every kind appears regularly
+    std::vector<Kind> sequence() const
+    {
+      std::vector<std::pair<Kind, int>> weights {{Kind::SAMPLE, m_samples},
+                                                 {Kind::EVENT, m_events},
+                                                 {Kind::CONDITION, m_conditions},
+                                                 {Kind::DATA_SET, m_dataSets},
+                                                 {Kind::TIME_SERIES, m_timeSeries}};
+      int total = 0;
+      for (auto &w : weights)
+        total += std::max(0, w.second);
+
+      // Bresenham style interleaving of the kinds
+      std::vector<Kind> kinds;
+      std::vector<int> error(weights.size(), 0);
+      for (int i = 0; i < total; i++)
+      {
+        size_t best = 0;
+        for (size_t k = 0; k < weights.size(); k++)
+        {
+          error[k] += std::max(0, weights[k].second);
+          if (error[k] > error[best])
+            best = k;
+        }
+        error[best] -= total;
+        kinds.push_back(weights[best].first);
+      }
+      return kinds;
+    }
+  };
+
+  /// @brief Counters shared by all the adapters
+  struct AdapterStats
+  {
+    std::atomic<uint64_t> m_observations {0};
+    std::atomic<uint64_t> m_bytes {0};
+    std::atomic<uint64_t> m_connections {0};
+    std::atomic<uint64_t> m_behind {0};
+  };
+
+  /// @brief A simulated SHDR adapter
+  ///
+  /// Listens on a port for the agent, then emits observations at the target rate. The
+  /// observations are written every tick as one batch of lines timestamped with the time they
+  /// are written, so the clients can measure the latency from ingest to delivery.
+  class AdapterLoad : public std::enable_shared_from_this<AdapterLoad>
+  {
+  public:
+    using Tick = std::chrono::milliseconds;
+    static constexpr Tick TickInterval {10};
+
+    /// @brief Create an adapter
+    /// @param[in] context the io context
+    /// @param[in] port the port to listen on, `0` for any free port
+    /// @param[in] rate the observations per second
+    /// @param[in] kinds the sequence of observation kinds to emit
+    /// @param[in] stats the shared counters
+    AdapterLoad(boost::asio::io_context &context, uint16_t port, double rate,
+                const std::vector<Kind> &kinds, AdapterStats &stats)
+      : m_strand(boost::asio::make_strand(context)),
+        m_acceptor(m_strand),
+        m_socket(m_strand),
+        m_timer(m_strand),
+        m_port(port),
+        m_rate(rate),
+        m_kinds(kinds),
+        m_stats(stats)
+    {}
+
+    /// @brief Replay recorded SHDR lines instead of generating observations
+    /// @param[in] lines the lines without their timestamps, they are timestamped when written
+    void setReplay(const std::vector<std::string> &lines) { m_replay = &lines; }
+
+    /// @brief Listen for the agent
+    void start()
+    {
+      using namespace boost::asio::ip;
+      tcp::endpoint ep(address_v4::loopback(), m_port);
+      m_acceptor.open(ep.protocol());
+      m_acceptor.set_option(tcp::acceptor::reuse_address(true));
+      m_acceptor.bind(ep);
+      m_acceptor.listen();
+      m_port = m_acceptor.local_endpoint().port();
+      accept();
+    }
+
+    /// @brief get the port the adapter listens on
+    /// @return the port, assigned by the system if the adapter was created with port `0`
+    uint16_t port() const { return m_port; }
+
+    /// @brief Stop emitting and close the connections
+    void stop()
+    {
+      boost::asio::dispatch(m_strand, [self = shared_from_this()]() {
+        self->m_running = false;
+        boost::system::error_code ec;
+        self->m_acceptor.close(ec);
+        self->m_socket.close(ec);
+        self->m_timer.cancel();
+      });
+    }
+
+  protected:
+    void accept()
+    {
+      m_acceptor.async_accept(
+          m_socket, [self = shared_from_this()](boost::system::error_code ec) {
+            if (ec || !self->m_running)
+              return;
+
+            self->m_stats.m_connections++;
+            boost::asio::ip::tcp::no_delay option(true);
+            self->m_socket.set_option(option, ec);
+
+            self->m_pending = FormatTimestamp(Clock::now()) + "|avail|AVAILABLE\n";
+            self->m_last = std::chrono::steady_clock::now();
+            self->m_credit = 0.0;
+            self->read();
+            self->write();
+            self->tick();
+          });
+    }
+
+    void read()
+    {
+      boost::asio::async_read_until(
+          m_socket, boost::asio::dynamic_buffer(m_input), '\n',
+          [self = shared_from_this(), gen = m_generation](boost::system::error_code ec,
+                                                          std::size_t len) {
+            if (gen != self->m_generation)
+              return;
+            if (ec)
+            {
+              self->reconnect();
+              return;
+            }
+
+            if (self->m_input.compare(0, 6, "* PING") == 0)
+            {
+              self->m_pending.append("* PONG 10000\n");
+              self->write();
+            }
+            self->m_input.erase(0, len);
+            self->read();
+          });
+    }
+
+    void tick()
+    {
+      m_timer.expires_after(TickInterval);
+      m_timer.async_wait([self = shared_from_this()](boost::system::error_code ec) {
+        if (ec || !self->m_running || !self->m_socket.is_open())
+          return;
+
+        auto now = std::chrono::steady_clock::now();
+        std::chrono::duration<double> delta = now - self->m_last;
+        self->m_last = now;
+        self->m_credit += delta.count() * self->m_rate;
+
+        auto count = int(self->m_credit);
+        self->m_credit -= count;
+        if (count > 0)
+          self->emit(count);
+
+        self->tick();
+      });
+    }
+
+    void emit(int count)
+    {
+      // If the agent is not reading, do not queue more than a megabyte
+      if (m_pending.size() > 1024 * 1024)
+      {
+        m_stats.m_behind += count;
+        return;
+      }
+
+      auto timestamp = FormatTimestamp(Clock::now());
+      if (m_replay)
+      {
+        for (int i = 0; i < count; i++)
+        {
+          auto &line = (*m_replay)[m_sequence++ % m_replay->size()];
+          if (line[0] != '*')
+            m_pending.append(timestamp);
+          m_pending.append(line).push_back('\n');
+        }
+        m_stats.m_observations += count;
+        write();
+        return;
+      }
+
+      for (int i = 0; i < count; i++)
+      {
+        m_pending.append(timestamp);
+        auto n = m_sequence++;
+        switch (m_kinds[n % m_kinds.size()])
+        {
+          case Kind::SAMPLE:
+            m_pending.append(n % 2 ? "|x|" : "|load|")
+                .append(std::to_string(n % 1000))
+                .append(".")
+                .append(std::to_string(n % 10));
+            break;
+
+          case Kind::EVENT:
+            if (n % 2)
+              m_pending.append(n % 4 == 1 ? "|exec|ACTIVE" : "|exec|READY");
+            else
+              m_pending.append("|program|P").append(std::to_string(n % 100));
+            break;
+
+          case Kind::CONDITION:
+            if (n % 2)
+              m_pending.append("|system|FAULT|E42||HIGH|Overtemperature");
+            else
+              m_pending.append("|system|NORMAL||||");
+            break;
+
+          case Kind::DATA_SET:
+            m_pending.append("|vars|a=")
+                .append(std::to_string(n % 1000))
+                .append(" b=")
+                .append(std::to_string(n % 7))
+                .append(" c=text");
+            break;
+
+          case Kind::TIME_SERIES:
+            m_pending.append("|ts|10|1000|");
+            for (int v = 0; v < 10; v++)
+              m_pending.append(v ? " " : "").append(std::to_string((n + v) % 100));
+            break;
+        }
+        m_pending.push_back('\n');
+      }
+      m_stats.m_observations += count;
+      write();
+    }
+
+    void write()
+    {
+      if (m_writing || m_pending.empty())
+        return;
+
+      m_writing = true;
+      m_output.swap(m_pending);
+      m_pending.clear();
+      boost::asio::async_write(
+          m_socket, boost::asio::buffer(m_output),
+          [self = shared_from_this(), gen = m_generation](boost::system::error_code ec,
+                                                          std::size_t len) {
+            if (gen != self->m_generation)
+              return;
+            self->m_writing = false;
+            if (ec)
+            {
+              self->reconnect();
+              return;
+            }
+            self->m_stats.m_bytes += len;
+            self->write();
+          });
+    }
+
+    void reconnect()
+    {
+      // Handlers of the closed connection are ignored
+      m_generation++;
+      m_writing = false;
+
+      boost::system::error_code ec;
+      m_socket.close(ec);
+      m_timer.cancel();
+      m_pending.clear();
+      m_input.clear();
+      if (m_running)
+        accept();
+    }
+
+  protected:
+    boost::asio::strand<boost::asio::io_context::executor_type> m_strand;
+    boost::asio::ip::tcp::acceptor m_acceptor;
+    boost::asio::ip::tcp::socket m_socket;
+    boost::asio::steady_timer m_timer;
+    uint16_t m_port;
+    double m_rate;
+    const std::vector<Kind> &m_kinds;
+    const std::vector<std::string> *m_replay {nullptr};
+    AdapterStats &m_stats;
+
+    bool m_running {true};
+    bool m_writing {false};
+    uint64_t m_generation {0};
+    double m_credit {0.0};
+    uint64_t m_sequence {0};
+    std::chrono::steady_clock::time_point m_last;
+    std::string m_input;
+    std::string m_pending;
+    std::string m_output;
+  };
+}  // namespace mtconnect::loadgen
@@ -0,0 +1,416 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <boost/asio.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/websocket.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "mtconnect/metrics/latency.hpp"
+#include "timestamp.hpp"
+
+namespace mtconnect::loadgen {
+  namespace beast = boost::beast;
+  namespace http = boost::beast::http;
+  namespace websocket = boost::beast::websocket;
+  using tcp = boost::asio::ip::tcp;
+
+  /// @brief Latency and throughput of one kind of client
+  struct ClientStats
+  {
+    ClientStats(const char *name) : m_name(name) {}
+
+    const char *m_name;
+    metrics::Histogram m_latency;  ///< Ingest to delivery latency
+    std::atomic<uint64_t> m_observations {0};
+    std::atomic<uint64_t> m_bytes {0};
+    std::atomic<uint64_t> m_responses {0};
+    std::atomic<uint64_t> m_errors {0};
+  };
+
+  /// @brief The time from which latencies are recorded, observations timestamped before the
+  ///        warmup ends are ignored
+  inline std::atomic<Clock::rep> RecordFrom {std::numeric_limits<Clock::rep>::max()};
+
+  /// @brief Find the observation timestamps in an XML or JSON document
+  /// @param[in] doc the document or a part of it
+  /// @param[in] each called with the time of each observation
+  template <typename F>
+  void ScanTimestamps(std::string_view doc, F each)
+  {
+    constexpr std::string_view attribute {"timestamp"};
+    Clock::time_point time;
+    for (auto pos = doc.find(attribute); pos != std::string_view::npos;
+         pos = doc.find(attribute, pos))
+    {
+      // XML: timestamp="...", JSON: "timestamp":"..."
+      pos += attribute.size();
+      if (doc.substr(pos, 2) == "=\"")
+        pos += 2;
+      else if (doc.substr(pos, 3) == "\":\"")
+        pos += 3;
+      else
+        continue;
+
+      auto end = doc.find('"', pos);
+      if (end == std::string_view::npos)
+        break;
+      if (ParseTimestamp(doc.substr(pos, end - pos), time))
+        each(time);
+      pos = end;
+    }
+  }
+
+  /// @brief Base for the clients, connects to the agent and reconnects after errors
+  class ClientLoad : public std::enable_shared_from_this<ClientLoad>
+  {
+  public:
+    /// @brief Create a client
+    /// @param[in] context the io context
+    /// @param[in] endpoints the resolved agent address
+    /// @param[in] host the host name for the requests
+    /// @param[in] target the request target
+    /// @param[in] accept the mime type of the documents to request
+    /// @param[in] stats the counters of this kind of client
+    ClientLoad(boost::asio::io_context &context, const tcp::resolver::results_type &endpoints,
+               const std::string &host, const std::string &target, const std::string &accept,
+               ClientStats &stats)
+      : m_strand(boost::asio::make_strand(context)),
+        m_timer(m_strand),
+        m_endpoints(endpoints),
+        m_host(host),
+        m_target(target),
+        m_accept(accept),
+        m_stats(stats)
+    {}
+    virtual ~ClientLoad() = default;
+
+    /// @brief Connect and start requesting
+    virtual void start() = 0;
+    /// @brief Stop requesting and close the connection
+    virtual void stop() = 0;
+
+  protected:
+    /// @brief record the latency of every observation timestamped after the warmup
+    void record(std::string_view doc, Clock::time_point now)
+    {
+      auto from = Clock::time_point(Clock::duration(RecordFrom.load()));
+      uint64_t count = 0;
+      ScanTimestamps(doc, [&](Clock::time_point time) {
+        if (time >= from)
+        {
+          recordLatency(now - time);
+          count++;
+        }
+      });
+      m_stats.m_observations += count;
+      m_stats.m_bytes += doc.size();
+    }
+
+    /// @brief record a latency, the clocks of the adapter and client can differ by a little
+    void recordLatency(Clock::duration latency)
+    {
+      auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count();
+      m_stats.m_latency.record(ns > 0 ? uint64_t(ns) : uint64_t(0));
+    }
+
+    /// @brief wait a second and start again
+    void retry(boost::system::error_code ec)
+    {
+      if (!m_running)
+        return;
+      if (ec != boost::asio::error::operation_aborted)
+        m_stats.m_errors++;
+
+      m_timer.expires_after(std::chrono::seconds(1));
+      m_timer.async_wait([self = shared_from_this()](boost::system::error_code ec) {
+        if (!ec && self->m_running)
+          self->start();
+      });
+    }
+
+  protected:
+    boost::asio::strand<boost::asio::io_context::executor_type> m_strand;
+    boost::asio::steady_timer m_timer;
+    tcp::resolver::results_type m_endpoints;
+    std::string m_host;
+    std::string m_target;
+    std::string m_accept;
+    ClientStats &m_stats;
+    bool m_running {true};
+  };
+
+  /// @brief Streams a `sample` request and records the latency of every observation
+  class StreamClient : public ClientLoad
+  {
+  public:
+    /// @brief Create a streaming client
+    template <typename... Args>
+    StreamClient(Args &&...args) : ClientLoad(std::forward<Args>(args)...)
+    {
+      m_onChunk = [this](std::uint64_t, beast::string_view body, boost::system::error_code &) {
+        record(std::string_view(body.data(), body.size()), Clock::now());
+        return body.size();
+      };
+    }
+
+    void start() override
+    {
+      m_stream.emplace(m_strand);
+      m_stream->async_connect(
+          m_endpoints, [self = ptr()](boost::system::error_code ec, const tcp::endpoint &) {
+            if (ec)
+              return self->retry(ec);
+
+            self->m_request = {http::verb::get, self->m_target, 11};
+            self->m_request.set(http::field::host, self->m_host);
+            self->m_request.set(http::field::accept, self->m_accept);
+            http::async_write(*self->m_stream, self->m_request,
+                              [self](boost::system::error_code ec, std::size_t) {
+                                if (ec)
+                                  return self->retry(ec);
+                                self->readHeader();
+                              });
+          });
+    }
+
+    void stop() override
+    {
+      boost::asio::dispatch(m_strand, [self = ptr()]() {
+        self->m_running = false;
+        self->m_timer.cancel();
+        if (self->m_stream)
+          self->m_stream->close();
+      });
+    }
+
+  protected:
+    std::shared_ptr<StreamClient> ptr()
+    {
+      return std::static_pointer_cast<StreamClient>(shared_from_this());
+    }
+
+    void readHeader()
+    {
+      m_buffer.clear();
+      m_parser.emplace();
+      m_parser->body_limit(std::numeric_limits<std::uint64_t>::max());
+      m_parser->on_chunk_body(m_onChunk);
+
+      http::async_read_header(*m_stream, m_buffer, *m_parser,
+                              [self = ptr()](boost::system::error_code ec, std::size_t) {
+                                if (ec)
+                                  return self->retry(ec);
+                                self->m_stats.m_responses++;
+                                self->readBody();
+                              });
+    }
+
+    void readBody()
+    {
+      http::async_read_some(*m_stream, m_buffer, *m_parser,
+                            [self = ptr()](boost::system::error_code ec, std::size_t) {
+                              if (ec)
+                                return self->retry(ec);
+                              // The stream ends when the count is reached, request it again
+                              if (self->m_parser->is_done())
+                                return self->start();
+                              self->readBody();
+                            });
+    }
+
+  protected:
+    std::optional<beast::tcp_stream> m_stream;
+    beast::flat_buffer m_buffer;
+    http::request<http::empty_body> m_request;
+    std::optional<http::response_parser<http::empty_body>> m_parser;
+    std::function<std::size_t(std::uint64_t, beast::string_view, boost::system::error_code &)>
+        m_onChunk;
+  };
+
+  /// @brief Polls `current` and records the age of the newest observation in each response
+  class PollClient : public ClientLoad
+  {
+  public:
+    /// @brief Create a polling client
+    /// @param[in] interval the time between the end of a response and the next request
+    template <typename... Args>
+    PollClient(std::chrono::milliseconds interval, Args &&...args)
+      : ClientLoad(std::forward<Args>(args)...), m_interval(interval)
+    {}
+
+    void start() override
+    {
+      m_stream.emplace(m_strand);
+      m_stream->async_connect(m_endpoints,
+                              [self = ptr()](boost::system::error_code ec, const tcp::endpoint &) {
+                                if (ec)
+                                  return self->retry(ec);
+                                self->poll();
+                              });
+    }
+
+    void stop() override
+    {
+      boost::asio::dispatch(m_strand, [self = ptr()]() {
+        self->m_running = false;
+        self->m_timer.cancel();
+        if (self->m_stream)
+          self->m_stream->close();
+      });
+    }
+
+  protected:
+    std::shared_ptr<PollClient> ptr()
+    {
+      return std::static_pointer_cast<PollClient>(shared_from_this());
+    }
+
+    void poll()
+    {
+      m_request = {http::verb::get, m_target, 11};
+      m_request.set(http::field::host, m_host);
+      m_request.set(http::field::accept, m_accept);
+      http::async_write(*m_stream, m_request, [self = ptr()](boost::system::error_code ec,
+                                                              std::size_t) {
+        if (ec)
+          return self->retry(ec);
+
+        self->m_response = {};
+        http::async_read(*self->m_stream, self->m_buffer, self->m_response,
+                         [self](boost::system::error_code ec, std::size_t) {
+                           if (ec)
+                             return self->retry(ec);
+                           self->received();
+                         });
+      });
+    }
+
+    void received()
+    {
+      auto now = Clock::now();
+      auto from = Clock::time_point(Clock::duration(RecordFrom.load()));
+      std::string_view body = m_response.body();
+
+      Clock::time_point newest;
+      ScanTimestamps(body, [&newest](Clock::time_point time) { newest = std::max(newest, time); });
+      if (newest >= from)
+      {
+        recordLatency(now - newest);
+        m_stats.m_observations++;
+      }
+      m_stats.m_bytes += body.size();
+      m_stats.m_responses++;
+
+      m_timer.expires_after(m_interval);
+      m_timer.async_wait([self = ptr()](boost::system::error_code ec) {
+        if (!ec && self->m_running)
+          self->poll();
+      });
+    }
+
+  protected:
+    std::chrono::milliseconds m_interval;
+    std::optional<beast::tcp_stream> m_stream;
+    beast::flat_buffer m_buffer;
+    http::request<http::empty_body> m_request;
+    http::response<http::string_body> m_response;
+  };
+
+  /// @brief Sends a streaming `sample` request over a WebSocket and records the latency of every
+  ///        observation
+  class WebsocketClient : public ClientLoad
+  {
+  public:
+    /// @brief Create a WebSocket client
+    /// @param[in] request the JSON request sent after the handshake
+    template <typename... Args>
+    WebsocketClient(const std::string &request, Args &&...args)
+      : ClientLoad(std::forward<Args>(args)...), m_command(request)
+    {}
+
+    void start() override
+    {
+      m_stream.emplace(m_strand);
+      beast::get_lowest_layer(*m_stream).async_connect(
+          m_endpoints, [self = ptr()](boost::system::error_code ec, const tcp::endpoint &) {
+            if (ec)
+              return self->retry(ec);
+
+            self->m_stream->async_handshake(
+                self->m_host, self->m_target, [self](boost::system::error_code ec) {
+                  if (ec)
+                    return self->retry(ec);
+                  self->m_stream->async_write(
+                      boost::asio::buffer(self->m_command),
+                      [self](boost::system::error_code ec, std::size_t) {
+                        if (ec)
+                          return self->retry(ec);
+                        self->read();
+                      });
+                });
+          });
+    }
+
+    void stop() override
+    {
+      boost::asio::dispatch(m_strand, [self = ptr()]() {
+        self->m_running = false;
+        self->m_timer.cancel();
+        if (self->m_stream)
+          beast::get_lowest_layer(*self->m_stream).close();
+      });
+    }
+
+  protected:
+    std::shared_ptr<WebsocketClient> ptr()
+    {
+      return std::static_pointer_cast<WebsocketClient>(shared_from_this());
+    }
+
+    void read()
+    {
+      m_stream->async_read(m_buffer, [self = ptr()](boost::system::error_code ec, std::size_t) {
+        if (ec)
+          return self->retry(ec);
+
+        auto data = self->m_buffer.cdata();
+        self->record(std::string_view(static_cast<const char *>(data.data()), data.size()),
+                     Clock::now());
+        self->m_stats.m_responses++;
+        self->m_buffer.consume(self->m_buffer.size());
+        self->read();
+      });
+    }
+
+  protected:
+    std::string m_command;
+    std::optional<websocket::stream<beast::tcp_stream>> m_stream;
+    beast::flat_buffer m_buffer;
+  };
+}  // namespace mtconnect::loadgen
@@ -0,0 +1,437 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+// Synthetic load for sizing an agent. `generate` writes a Devices.xml and agent.cfg for the
+// simulated adapters, `run` serves the adapters and runs the clients against the agent and
+// reports the ingest to delivery latency and the throughput.
+
+#include <boost/algorithm/string.hpp>
+#include <boost/asio.hpp>
+#include <boost/program_options.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <map>
+#include <thread>
+
+#include "adapter_load.hpp"
+#include "client_load.hpp"
+
+using namespace std;
+using namespace mtconnect::loadgen;
+namespace po = boost::program_options;
+namespace asio = boost::asio;
+
+static Mix ParseMix(const string &text)
+{
+  Mix mix {0, 0, 0, 0, 0};
+  vector<string> parts;
+  boost::split(parts, text, boost::is_any_of(","));
+  for (auto &part : parts)
+  {
+    auto eq = part.find('=');
+    if (eq == string::npos)
+      throw po::error("mix must be a list of kind=weight: " + part);
+
+    auto kind = boost::trim_copy(part.substr(0, eq));
+    auto weight = stoi(part.substr(eq + 1));
+    if (kind == "samples")
+      mix.m_samples = weight;
+    else if (kind == "events")
+      mix.m_events = weight;
+    else if (kind == "conditions")
+      mix.m_conditions = weight;
+    else if (kind == "data_sets")
+      mix.m_dataSets = weight;
+    else if (kind == "time_series")
+      mix.m_timeSeries = weight;
+    else
+      throw po::error("unknown observation kind in mix: " + kind);
+  }
+  return mix;
+}
+
+// The data item names are the keys the adapters send
+static const char *DeviceTemplate = R"(    <Device id="{device}" name="{device}" uuid="{uuid}">
+      <DataItems>
+        <DataItem id="{device}_avail" name="avail" type="AVAILABILITY" category="EVENT"/>
+      </DataItems>
+      <Components>
+        <Controller id="{device}_cont">
+          <DataItems>
+            <DataItem id="{device}_exec" name="exec" type="EXECUTION" category="EVENT"/>
+            <DataItem id="{device}_program" name="program" type="PROGRAM" category="EVENT"/>
+            <DataItem id="{device}_vars" name="vars" type="VARIABLE" category="EVENT"
+                      representation="DATA_SET"/>
+            <DataItem id="{device}_system" name="system" type="SYSTEM" category="CONDITION"/>
+          </DataItems>
+        </Controller>
+        <Axes id="{device}_axes">
+          <Components>
+            <Linear id="{device}_x" name="X">
+              <DataItems>
+                <DataItem id="{device}_xpos" name="x" type="POSITION" subType="ACTUAL"
+                          category="SAMPLE" units="MILLIMETER"/>
+                <DataItem id="{device}_load" name="load" type="LOAD" category="SAMPLE"
+                          units="PERCENT"/>
+                <DataItem id="{device}_ts" name="ts" type="POSITION" category="SAMPLE"
+                          units="MILLIMETER" representation="TIME_SERIES" sampleRate="1000"/>
+              </DataItems>
+            </Linear>
+          </Components>
+        </Axes>
+      </Components>
+    </Device>
+)";
+
+static void Generate(const po::variables_map &options)
+{
+  filesystem::path dir = options["dir"].as<string>();
+  auto adapters = options["adapters"].as<int>();
+  auto port = options["port"].as<int>();
+  filesystem::create_directories(dir);
+
+  ofstream devices(dir / "Devices.xml");
+  devices << R"(<?xml version="1.0" encoding="UTF-8"?>
+<MTConnectDevices xmlns="urn:mtconnect.org:MTConnectDevices:2.0">
+  <Header creationTime="2025-01-01T00:00:00Z" sender="loadgen" instanceId="1"
+          bufferSize="131072" version="2.0"/>
+  <Devices>
+)";
+  for (int i = 0; i < adapters; i++)
+  {
+    auto device = boost::replace_all_copy(string(DeviceTemplate), "{device}", "lg" + to_string(i));
+    boost::replace_all(device, "{uuid}", "loadgen-" + to_string(i));
+    devices << device;
+  }
+  devices << "  </Devices>\n</MTConnectDevices>\n";
+
+  ofstream config(dir / "agent.cfg");
+  config << "Devices = Devices.xml\n"
+         << "Port = " << options["agent-port"].as<int>() << "\n"
+         << "BufferSize = 17\n"
+         << "SchemaVersion = 2.0\n"
+         << "\nAdapters {\n";
+  for (int i = 0; i < adapters; i++)
+  {
+    config << "  lg" << i << " {\n"
+           << "    Device = lg" << i << "\n"
+           << "    Host = 127.0.0.1\n"
+           << "    Port = " << port + i << "\n"
+           << "  }\n";
+  }
+  config << "}\n";
+
+  cout << "Wrote " << (dir / "Devices.xml").string() << " and " << (dir / "agent.cfg").string()
+       << " for " << adapters << " adapters on ports " << port << '-' << port + adapters - 1
+       << endl;
+}
+
+static void Report(double elapsed, const AdapterStats &adapters, const list<ClientStats> &clients,
+                   uint64_t &lastSent, map<const ClientStats *, uint64_t> &lastDelivered,
+                   double interval)
+{
+  auto sent = adapters.m_observations.load();
+  printf("%7.1fs  sent %9.0f/s", elapsed, (sent - lastSent) / interval);
+  lastSent = sent;
+  for (auto &stats : clients)
+  {
+    auto delivered = stats.m_observations.load();
+    auto latency = stats.m_latency.snapshot();
+    printf("  %s %9.0f/s p50 %.2fms p99 %.2fms", stats.m_name,
+           (delivered - lastDelivered[&stats]) / interval, latency.quantile(0.5) / 1e6,
+           latency.quantile(0.99) / 1e6);
+    lastDelivered[&stats] = delivered;
+  }
+  printf("\n");
+  fflush(stdout);
+}
+
+static void Summary(double seconds, const AdapterStats &adapters, uint64_t warmupSent,
+                    const list<ClientStats> &clients)
+{
+  auto sent = adapters.m_observations.load() - warmupSent;
+  printf("\nAdapters: %llu connections, %llu observations (%.0f/s), %.1f MB, %llu dropped\n",
+         (unsigned long long)adapters.m_connections.load(), (unsigned long long)sent,
+         sent / seconds, adapters.m_bytes.load() / 1e6,
+         (unsigned long long)adapters.m_behind.load());
+
+  printf("\n%-10s %10s %12s %10s %9s %9s %9s %9s %9s %9s %7s\n", "client", "responses",
+         "observations", "obs/s", "MB/s", "p50 ms", "p90 ms", "p99 ms", "p99.9 ms", "max ms",
+         "errors");
+  for (auto &stats : clients)
+  {
+    auto l = stats.m_latency.snapshot();
+    printf("%-10s %10llu %12llu %10.0f %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f %7llu\n", stats.m_name,
+           (unsigned long long)stats.m_responses.load(),
+           (unsigned long long)stats.m_observations.load(), stats.m_observations.load() / seconds,
+           stats.m_bytes.load() / 1e6 / seconds, l.quantile(0.5) / 1e6, l.quantile(0.9) / 1e6,
+           l.quantile(0.99) / 1e6, l.quantile(0.999) / 1e6, l.m_max / 1e6,
+           (unsigned long long)stats.m_errors.load());
+  }
+}
+
+/// @brief Read a recorded SHDR file to replay
+///
+/// The recorded timestamps are removed, the lines are timestamped when they are written.
+/// Protocol commands starting with `*` are replayed as they are.
+static vector<string> ReadReplay(const string &file)
+{
+  ifstream in(file);
+  if (!in)
+    throw po::error("cannot open replay file: " + file);
+
+  vector<string> lines;
+  string line;
+  while (getline(in, line))
+  {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    if (line.empty())
+      continue;
+    if (line[0] == '*')
+    {
+      lines.push_back(line);
+      continue;
+    }
+
+    auto bar = line.find('|');
+    if (bar != string::npos && bar + 1 < line.size())
+      lines.push_back(line.substr(bar));
+  }
+  if (lines.empty())
+    throw po::error("no SHDR lines in replay file: " + file);
+  return lines;
+}
+
+static int Run(const po::variables_map &options)
+{
+  auto adapterCount = options["adapters"].as<int>();
+  auto port = options["port"].as<int>();
+  auto rate = options["rate"].as<double>();
+  auto kinds = ParseMix(options["mix"].as<string>()).sequence();
+  if (kinds.empty())
+    throw po::error("the mix must have a positive weight");
+  vector<string> replay;
+  if (options.count("replay"))
+    replay = ReadReplay(options["replay"].as<string>());
+
+  auto format = options["format"].as<string>();
+  if (format != "xml" && format != "json")
+    throw po::error("format must be xml or json: " + format);
+  auto accept = format == "json" ? "application/json" : "text/xml";
+
+  auto host = options["host"].as<string>();
+  auto agentPort = options["agent-port"].as<int>();
+  auto interval = options["sample-interval"].as<int>();
+  auto count = options["count"].as<int>();
+  auto perDevice = options.count("per-device") > 0;
+  auto duration = chrono::seconds(options["duration"].as<int>());
+  auto warmup = chrono::seconds(options["warmup"].as<int>());
+  auto report = chrono::seconds(max(1, options["report"].as<int>()));
+  auto threads = options["threads"].as<int>();
+
+  asio::io_context context(threads);
+  auto guard = asio::make_work_guard(context);
+
+  AdapterStats adapterStats;
+  list<ClientStats> clientStats;
+  vector<shared_ptr<AdapterLoad>> adapters;
+  vector<shared_ptr<ClientLoad>> clients;
+
+  for (int i = 0; i < adapterCount; i++)
+  {
+    auto adapter = make_shared<AdapterLoad>(context, uint16_t(port + i), rate, kinds, adapterStats);
+    if (!replay.empty())
+      adapter->setReplay(replay);
+    adapter->start();
+    adapters.push_back(adapter);
+  }
+
+  auto device = [&](int i) -> string {
+    if (perDevice && adapterCount > 0)
+      return "/lg" + to_string(i % adapterCount);
+    else
+      return "";
+  };
+  auto stream = "/sample?interval=" + to_string(interval) + "&count=" + to_string(count) +
+                "&heartbeat=10000";
+
+  tcp::resolver resolver(context);
+  auto endpoints = resolver.resolve(host, to_string(agentPort));
+
+  if (auto n = options["sample-clients"].as<int>(); n > 0)
+  {
+    auto &stats = clientStats.emplace_back("sample");
+    for (int i = 0; i < n; i++)
+      clients.push_back(
+          make_shared<StreamClient>(context, endpoints, host, device(i) + stream, accept, stats));
+  }
+  if (auto n = options["current-clients"].as<int>(); n > 0)
+  {
+    auto &stats = clientStats.emplace_back("current");
+    auto poll = chrono::milliseconds(options["poll-interval"].as<int>());
+    for (int i = 0; i < n; i++)
+      clients.push_back(make_shared<PollClient>(poll, context, endpoints, host,
+                                                device(i) + "/current", accept, stats));
+  }
+  if (auto n = options["websocket-clients"].as<int>(); n > 0)
+  {
+    auto &stats = clientStats.emplace_back("websocket");
+    for (int i = 0; i < n; i++)
+    {
+      auto request = R"({"id": ")" + to_string(i) + R"(", "request": "sample", "interval": )" +
+                     to_string(interval) + R"(, "count": )" + to_string(count);
+      if (perDevice && adapterCount > 0)
+        request += R"(, "device": "lg)" + to_string(i % adapterCount) + "\"";
+      request += R"(, "format": ")" + format + "\"}";
+      clients.push_back(
+          make_shared<WebsocketClient>(request, context, endpoints, host, "/", accept, stats));
+    }
+  }
+
+  RecordFrom = (Clock::now() + warmup).time_since_epoch().count();
+  for (auto &client : clients)
+    client->start();
+
+  atomic_bool done {false};
+  asio::signal_set signals(context, SIGINT, SIGTERM);
+  signals.async_wait([&done](boost::system::error_code ec, int) {
+    if (!ec)
+      done = true;
+  });
+
+  vector<thread> workers;
+  for (int i = 0; i < threads; i++)
+    workers.emplace_back([&context]() { context.run(); });
+
+  cout << adapterCount << " adapters at " << rate << " observations/s, " << clients.size()
+       << " clients, warming up for " << warmup.count() << "s" << endl;
+
+  auto start = chrono::steady_clock::now();
+  auto end = start + warmup + duration;
+  auto measured = start + warmup;
+  uint64_t lastSent = 0;
+  map<const ClientStats *, uint64_t> lastDelivered;
+  auto last = start;
+  optional<uint64_t> warmupSent;
+  while (!done && chrono::steady_clock::now() < end)
+  {
+    this_thread::sleep_for(chrono::milliseconds(100));
+    auto now = chrono::steady_clock::now();
+    if (!warmupSent && now >= measured)
+      warmupSent = adapterStats.m_observations.load();
+    if (now - last >= report)
+    {
+      chrono::duration<double> elapsed = now - start, delta = now - last;
+      Report(elapsed.count(), adapterStats, clientStats, lastSent, lastDelivered, delta.count());
+      last = now;
+    }
+  }
+
+  chrono::duration<double> seconds = chrono::steady_clock::now() - measured;
+  Summary(max(seconds.count(), 0.001), adapterStats, warmupSent.value_or(0), clientStats);
+
+  for (auto &client : clients)
+    client->stop();
+  for (auto &adapter : adapters)
+    adapter->stop();
+  signals.cancel();
+  guard.reset();
+  context.stop();
+  for (auto &worker : workers)
+    worker.join();
+
+  return 0;
+}
+
+int main(int argc, const char *argv[])
+{
+  po::options_description desc("Options");
+  // clang-format off
+  desc.add_options()
+    ("help,h", "Show this help message")
+    ("adapters,a", po::value<int>()->default_value(10), "Number of SHDR adapters")
+    ("port,p", po::value<int>()->default_value(7900), "Port of the first adapter")
+    ("rate,r", po::value<double>()->default_value(100.0), "Observations per second per adapter")
+    ("mix,m",
+     po::value<string>()->default_value(
+       "samples=60,events=25,conditions=5,data_sets=5,time_series=5"),
+     "Relative weights of the observation kinds")
+    ("host", po::value<string>()->default_value("localhost"), "Agent host")
+    ("agent-port", po::value<int>()->default_value(5000), "Agent HTTP port")
+    ("sample-clients,s", po::value<int>()->default_value(0), "Streaming sample clients")
+    ("current-clients,c", po::value<int>()->default_value(0), "Polling current clients")
+    ("websocket-clients,w", po::value<int>()->default_value(0), "WebSocket sample clients")
+    ("sample-interval", po::value<int>()->default_value(0), "Streaming interval in ms")
+    ("count", po::value<int>()->default_value(1000), "Maximum observations per streamed chunk")
+    ("poll-interval", po::value<int>()->default_value(1000), "Time between current polls in ms")
+    ("per-device", "Clients request a single device instead of all devices")
+    ("format", po::value<string>()->default_value("xml"), "Document format requested: xml or json")
+    ("replay", po::value<string>(),
+     "Recorded SHDR file the adapters replay instead of the mix, the timestamps are replaced")
+    ("duration,d", po::value<int>()->default_value(60), "Seconds to measure")
+    ("warmup", po::value<int>()->default_value(5), "Seconds before latencies are recorded")
+    ("report", po::value<int>()->default_value(5), "Seconds between progress reports")
+    ("threads,t", po::value<int>()->default_value(max(1, int(thread::hardware_concurrency()))),
+     "Load generator threads")
+    ("dir", po::value<string>()->default_value("."), "Directory for the generated configuration");
+  // clang-format on
+
+  po::options_description hidden("Hidden");
+  hidden.add_options()("command", po::value<string>(), "The command");
+  po::positional_options_description pos;
+  pos.add("command", 1);
+
+  po::options_description all("All Options");
+  all.add(desc).add(hidden);
+
+  try
+  {
+    po::variables_map options;
+    po::store(po::command_line_parser(argc, argv).options(all).positional(pos).run(), options);
+    po::notify(options);
+
+    auto command = options.count("command") ? options["command"].as<string>() : "help";
+    if (options.count("help") || (command != "generate" && command != "run"))
+    {
+      cout << "Usage: agent_loadgen generate|run [options]\n\n"
+           << "  generate  Write a Devices.xml and agent.cfg for the adapters into --dir\n"
+           << "  run       Serve the adapters and run the clients against the agent\n\n"
+           << desc << endl;
+      return command == "help" ? 0 : 1;
+    }
+
+    if (command == "generate")
+    {
+      Generate(options);
+      return 0;
+    }
+    else
+    {
+      return Run(options);
+    }
+  }
+  catch (std::exception &e)
+  {
+    cerr << "agent_loadgen: " << e.what() << endl;
+    return 1;
+  }
+}
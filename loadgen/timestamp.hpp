@@ -0,0 +1,85 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <string_view>
+
+namespace mtconnect::loadgen {
+  using Clock = std::chrono::system_clock;
+  using Micros = std::chrono::microseconds;
+
+  /// @brief Format a time as an SHDR and MTConnect timestamp with microseconds
+  /// @param[in] time the time
+  /// @return the timestamp text
+  inline std::string FormatTimestamp(Clock::time_point time)
+  {
+    auto micros = std::chrono::duration_cast<Micros>(time.time_since_epoch()).count();
+    std::time_t seconds = micros / 1000000;
+    std::tm tm;
+    gmtime_r(&seconds, &tm);
+
+    char text[64];
+    std::snprintf(text, sizeof(text), "%04d-%02d-%02dT%02d:%02d:%02d.%06dZ", tm.tm_year + 1900,
+                  tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec,
+                  int(micros % 1000000));
+    return text;
+  }
+
+  /// @brief Parse an MTConnect timestamp
+  /// @param[in] text the timestamp text, `YYYY-MM-DDThh:mm:ss[.ffffff]Z`
+  /// @param[out] time the time
+  /// @return `true` if the text is a timestamp
+  inline bool ParseTimestamp(std::string_view text, Clock::time_point &time)
+  {
+    if (text.size() < 20 || text[4] != '-' || text[10] != 'T' || text.back() != 'Z')
+      return false;
+
+    auto number = [&text](size_t pos, size_t len) {
+      int value = 0;
+      for (auto i = pos; i < pos + len; i++)
+        value = value * 10 + (text[i] - '0');
+      return value;
+    };
+
+    std::tm tm {};
+    tm.tm_year = number(0, 4) - 1900;
+    tm.tm_mon = number(5, 2) - 1;
+    tm.tm_mday = number(8, 2);
+    tm.tm_hour = number(11, 2);
+    tm.tm_min = number(14, 2);
+    tm.tm_sec = number(17, 2);
+
+    int64_t micros = 0;
+    if (text[19] == '.')
+    {
+      size_t digits = 0;
+      for (size_t i = 20; i < text.size() - 1 && digits < 6; i++, digits++)
+        micros = micros * 10 + (text[i] - '0');
+      for (; digits < 6; digits++)
+        micros *= 10;
+    }
+
+    time = Clock::from_time_t(timegm(&tm)) + Micros(micros);
+    return true;
+  }
+}  // namespace mtconnect::loadgen
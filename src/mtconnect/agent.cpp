@@ -43,6 +43,7 @@
 #include <libxml/xmlwriter.h>
 
 #include "mtconnect/asset/asset.hpp"
+#include "mtconnect/asset/asset_log_storage.hpp"
 #include "mtconnect/asset/component_configuration_parameters.hpp"
 #include "mtconnect/asset/cutting_tool.hpp"
 #include "mtconnect/asset/file_asset.hpp"
@@ -57,7 +58,9 @@
 #include "mtconnect/device_model/agent_device.hpp"
 #include "mtconnect/entity/xml_parser.hpp"
 #include "mtconnect/logging.hpp"
+#include "mtconnect/metrics/latency.hpp"
 #include "mtconnect/observation/observation.hpp"
+#include "mtconnect/printer/binary_printer.hpp"
 #include "mtconnect/printer/json_printer.hpp"
 #include "mtconnect/printer/xml_printer.hpp"
 #include "mtconnect/sink/rest_sink/file_cache.hpp"
@@ -90,7 +93,8 @@ namespace mtconnect {
       m_schemaVersion(GetOption<string>(options, config::SchemaVersion)),
       m_deviceXmlPath(deviceXmlPath),
       m_circularBuffer(GetOption<int>(options, config::BufferSize).value_or(17),
-                       GetOption<int>(options, config::CheckpointFrequency).value_or(1000)),
+                       GetOption<int>(options, config::CheckpointFrequency).value_or(1000),
+                       IsOptionSet(options, config::CompactBuffer)),
       m_pretty(IsOptionSet(options, mtconnect::configuration::Pretty)),
       m_validation(IsOptionSet(options, mtconnect::configuration::Validation))
   {
@@ -112,10 +116,50 @@ namespace mtconnect {
     Task::registerAsset();
     TaskArchetype::registerAsset();
 
-    m_assetStorage = make_unique<AssetBuffer>(
-        GetOption<int>(options, mtconnect::configuration::MaxAssets).value_or(1024));
+    auto historyPath = GetOption<string>(options, config::HistoryPath);
+    if (historyPath && !historyPath->empty())
+    {
+      try
+      {
+        auto history = make_unique<buffer::HistoryStore>(
+            *historyPath, GetOption<int>(options, config::HistoryBlockSize).value_or(4096),
+            GetOption<int>(options, config::HistoryMaxBlocks).value_or(0));
+        history->setResolver([this](const string &id) { return getDataItemById(id); });
+        m_circularBuffer.setHistoryStore(std::move(history));
+      }
+      catch (std::filesystem::filesystem_error &e)
+      {
+        LOG(error) << "Cannot create history store in " << *historyPath << ": " << e.what();
+      }
+    }
+
+    // Latency histograms are only created when they are enabled
+    auto &registry = metrics::Registry::global();
+    registry.setEnabled(IsOptionSet(options, config::LatencyMetrics));
+    m_circularBuffer.setLockWaitLatency(
+        registry.histogram("mtconnect_buffer_lock_wait_seconds",
+                           "Time adding an observation waits for the buffer lock", {},
+                           "buffer_lock_wait"));
+
+    auto maxAssets = GetOption<int>(options, mtconnect::configuration::MaxAssets).value_or(1024);
+    auto assetPath = GetOption<string>(options, config::AssetStoragePath);
+    if (assetPath && !assetPath->empty())
+    {
+      try
+      {
+        m_assetStorage = make_unique<AssetLogStorage>(
+            *assetPath, maxAssets, GetOption<int>(options, config::AssetCacheSize).value_or(1024));
+      }
+      catch (std::filesystem::filesystem_error &e)
+      {
+        LOG(error) << "Cannot create asset storage in " << *assetPath << ": " << e.what();
+      }
+    }
+    if (!m_assetStorage)
+      m_assetStorage = make_unique<AssetBuffer>(maxAssets);
     m_versionDeviceXml = IsOptionSet(options, mtconnect::configuration::VersionDeviceXml);
     m_createUniqueIds = IsOptionSet(options, config::CreateUniqueIds);
+    m_startupThreads = size_t(max(1, GetOption<int>(options, config::WorkerThreads).value_or(1)));
 
     auto jsonVersion =
         uint32_t(GetOption<int>(options, mtconnect::configuration::JsonVersion).value_or(2));
@@ -123,6 +167,7 @@ namespace mtconnect {
     // Create the Printers
     m_printers["xml"] = make_unique<printer::XmlPrinter>(m_pretty, m_validation);
     m_printers["json"] = make_unique<printer::JsonPrinter>(jsonVersion, m_pretty, m_validation);
+    m_printers["binary"] = make_unique<printer::BinaryPrinter>(m_validation);
 
     if (m_schemaVersion)
     {
@@ -131,6 +176,18 @@ namespace mtconnect {
         pr->setSchemaVersion(*m_schemaVersion);
     }
 
+    if (IsOptionSet(options, config::ObservationRenderCache))
+    {
+      for (auto &[k, pr] : m_printers)
+        pr->setRenderCache(true);
+    }
+
+    if (IsOptionSet(options, config::AssetRenderCache))
+    {
+      for (auto &[k, pr] : m_printers)
+        pr->setAssetRenderCache(true);
+    }
+
     auto sender = GetOption<string>(options, config::Sender);
     if (sender)
     {
@@ -145,11 +202,15 @@ namespace mtconnect {
 
     m_beforeInitializeHooks.exec(*this);
 
+    using namespace std::chrono;
+    auto start = steady_clock::now();
+
     m_pipelineContext = context;
     m_loopback =
         std::make_shared<source::LoopbackSource>("AgentSource", m_strand, context, m_options);
 
     auto devices = loadXMLDeviceFile(m_deviceXmlPath);
+    auto parsed = steady_clock::now();
     if (!m_schemaVersion)
     {
       m_schemaVersion.emplace(StrDefaultSchemaVersion());
@@ -165,15 +226,26 @@ namespace mtconnect {
       createAgentDevice();
     }
 
+    // Verify and hash the devices in parallel, then add them in order
+    prepareDevices(devices);
+    auto prepared = steady_clock::now();
+
     // For the DeviceAdded event for each device
     for (auto device : devices)
-      addDevice(device);
+      registerDevice(device, true);
 
     if (m_versionDeviceXml && m_createUniqueIds)
       versionDeviceXml();
 
     loadCachedProbe();
 
+    auto finished = steady_clock::now();
+    auto ms = [](auto d) { return duration_cast<milliseconds>(d).count(); };
+    LOG(info) << "Initialized " << devices.size() << " devices in " << ms(finished - start)
+              << "ms using " << m_startupThreads << " threads (parse: " << ms(parsed - start)
+              << "ms, verify and hash: " << ms(prepared - parsed)
+              << "ms, path document: " << ms(finished - prepared) << "ms)";
+
     m_initialized = true;
 
     m_afterInitializeHooks.exec(*this);
@@ -256,6 +328,16 @@ namespace mtconnect {
       for (auto source : m_sources)
         source->start();
 
+      if (m_agentDevice && metrics::Registry::global().isEnabled())
+      {
+        m_latencyReporter = make_shared<metrics::LatencyReporter>(
+            m_strand, metrics::Registry::global(), [this](const string &id, double seconds) {
+              if (auto di = m_agentDevice->getDeviceDataItem(id))
+                m_loopback->receive(di, Properties {{"VALUE", seconds}});
+            });
+        m_latencyReporter->start();
+      }
+
       m_afterStartHooks.exec(*this);
     }
     catch (std::runtime_error &e)
@@ -279,6 +361,12 @@ namespace mtconnect {
 
     m_beforeStopHooks.exec(*this);
 
+    if (m_latencyReporter)
+    {
+      m_latencyReporter->stop();
+      m_latencyReporter.reset();
+    }
+
     // Stop all adapter threads...
     LOG(info) << "Shutting down sources";
     for (auto source : m_sources)
@@ -622,12 +710,14 @@ namespace mtconnect {
 
         // Remove the old data items
         set<string> skip;
+        unordered_map<string, DataItemPtr> previous;
         for (auto &di : oldDev->getDeviceDataItems())
         {
-          if (!di.expired())
+          if (auto ldi = di.lock())
           {
-            m_dataItemMap.erase(di.lock()->getId());
-            skip.insert(di.lock()->getId());
+            m_dataItemMap.erase(ldi->getId());
+            skip.insert(ldi->getId());
+            previous.emplace(ldi->getId(), ldi);
           }
         }
 
@@ -641,10 +731,20 @@ namespace mtconnect {
           return false;
         }
 
-        initializeDataItems(device, skip);
+        // Hand the slots of the old data items to their replacements so the buffered
+        // observations refer to the new model without being visited
+        LOG(info) << "Device " << *uuid << " rebinding data items";
+        for (auto &di : device->getDeviceDataItems())
+        {
+          if (auto ldi = di.lock())
+          {
+            auto old = previous.find(ldi->getId());
+            if (old != previous.end())
+              ldi->rebind(*old->second);
+          }
+        }
 
-        LOG(info) << "Device " << *uuid << " updating circular buffer";
-        m_circularBuffer.updateDataItems(m_dataItemMap);
+        initializeDataItems(device, skip);
 
         if (m_intSchemaVersion > SCHEMA_VERSION(2, 2))
           device->addHash();
@@ -846,6 +946,16 @@ namespace mtconnect {
         LOG(fatal) << "Error creating the agent device: " << e->what();
       throw FatalException("Cannot create AgentDevice");
     }
+
+    // Streams are only checked for lag when there is a send budget or a lag limit
+    if (ConvertFileSize(m_options, config::MaxStreamBytesInFlight) > 0 ||
+        GetOption<int>(m_options, config::MaxStreamChunksInFlight).value_or(0) > 0 ||
+        GetOption<int>(m_options, config::MaxStreamLag).value_or(0) > 0)
+      m_agentDevice->addStreamMetrics();
+
+    if (metrics::Registry::global().isEnabled())
+      m_agentDevice->addLatencyMetrics();
+
     addDevice(m_agentDevice);
   }
 
@@ -861,7 +971,8 @@ namespace mtconnect {
     {
       // Load the configuration for the Agent
       auto devices = m_xmlParser->parseFile(
-          configXmlPath, dynamic_cast<printer::XmlPrinter *>(m_printers["xml"].get()));
+          configXmlPath, dynamic_cast<printer::XmlPrinter *>(m_printers["xml"].get()),
+          m_startupThreads);
 
       if (!m_schemaVersion && m_xmlParser->getSchemaVersion() &&
           !m_xmlParser->getSchemaVersion()->empty())
@@ -1012,8 +1123,30 @@ namespace mtconnect {
     }
   }
 
+  void Agent::prepareDevices(const std::list<DevicePtr> &devices)
+  {
+    NAMED_SCOPE("Agent::prepareDevices");
+
+    // Each device is only modified by its own thread. The changed ids are applied to the
+    // data item map after all the threads finish.
+    std::vector<DevicePtr> list(devices.begin(), devices.end());
+    std::vector<std::unordered_map<std::string, std::string>> idMaps(list.size());
+    ParallelFor(list.size(), m_startupThreads, [&](size_t i) {
+      auto &device = list[i];
+      verifyDevice(device);
+      idMaps[i] = makeUniqueIds(device);
+      if (m_intSchemaVersion >= SCHEMA_VERSION(2, 2))
+        device->addHash();
+    });
+
+    for (size_t i = 0; i < list.size(); i++)
+      remapDataItemIds(list[i], idMaps[i]);
+  }
+
   // Add the a device from a configuration file
-  void Agent::addDevice(DevicePtr device)
+  void Agent::addDevice(DevicePtr device) { registerDevice(device, false); }
+
+  void Agent::registerDevice(DevicePtr device, bool prepared)
   {
     NAMED_SCOPE("Agent::addDevice");
 
@@ -1035,8 +1168,11 @@ namespace mtconnect {
 
       // TODO: Redo Resolve Reference  with entity
       // device->resolveReferences();
-      verifyDevice(device);
-      createUniqueIds(device);
+      if (!prepared)
+      {
+        verifyDevice(device);
+        createUniqueIds(device);
+      }
 
       if (m_observationsInitialized)
       {
@@ -1059,7 +1195,7 @@ namespace mtconnect {
       }
     }
 
-    if (m_intSchemaVersion >= SCHEMA_VERSION(2, 2))
+    if (!prepared && m_intSchemaVersion >= SCHEMA_VERSION(2, 2))
       device->addHash();
 
     for (auto &printer : m_printers)
@@ -1097,22 +1233,31 @@ namespace mtconnect {
 
   void Agent::createUniqueIds(DevicePtr device)
   {
+    remapDataItemIds(device, makeUniqueIds(device));
+  }
+
+  std::unordered_map<std::string, std::string> Agent::makeUniqueIds(DevicePtr device)
+  {
+    std::unordered_map<std::string, std::string> idMap;
     if (m_createUniqueIds && !dynamic_pointer_cast<AgentDevice>(device))
     {
-      std::unordered_map<std::string, std::string> idMap;
-
       device->createUniqueIds(idMap);
       device->updateReferences(idMap);
+    }
+    return idMap;
+  }
 
-      // Update the data item map.
-      for (auto &id : idMap)
+  void Agent::remapDataItemIds(DevicePtr device,
+                               const std::unordered_map<std::string, std::string> &idMap)
+  {
+    // Update the data item map.
+    for (auto &id : idMap)
+    {
+      auto di = device->getDeviceDataItem(id.second);
+      if (auto it = m_dataItemMap.find(id.first); it != m_dataItemMap.end())
       {
-        auto di = device->getDeviceDataItem(id.second);
-        if (auto it = m_dataItemMap.find(id.first); it != m_dataItemMap.end())
-        {
-          m_dataItemMap.erase(it);
-          m_dataItemMap.emplace(id.second, di);
-        }
+        m_dataItemMap.erase(it);
+        m_dataItemMap.emplace(id.second, di);
       }
     }
   }
@@ -1209,6 +1354,37 @@ namespace mtconnect {
       sink->start();
   }
 
+  void Agent::removeSource(source::SourcePtr source)
+  {
+    source->stop();
+    m_sources.remove(source);
+
+    auto adapter = dynamic_pointer_cast<source::adapter::Adapter>(source);
+    if (m_agentDevice && adapter)
+    {
+      if (auto comp = m_agentDevice->removeAdapter(adapter))
+      {
+        if (auto items = comp->getDataItems())
+        {
+          for (auto &item : *items)
+            m_dataItemMap.erase(item->get<string>("id"));
+        }
+
+        // Reload the document so probe no longer shows the adapter
+        if (m_initialized)
+        {
+          loadCachedProbe();
+        }
+      }
+    }
+  }
+
+  void Agent::removeSink(sink::SinkPtr sink)
+  {
+    sink->stop();
+    m_sinks.remove(sink);
+  }
+
   void AgentPipelineContract::deliverConnectStatus(entity::EntityPtr entity,
                                                    const StringList &devices, bool autoAvailable)
   {
@@ -45,6 +45,7 @@
 #include "mtconnect/configuration/service.hpp"
 #include "mtconnect/device_model/agent_device.hpp"
 #include "mtconnect/device_model/device.hpp"
+#include "mtconnect/metrics/latency.hpp"
 #include "mtconnect/parser/xml_parser.hpp"
 #include "mtconnect/pipeline/pipeline.hpp"
 #include "mtconnect/pipeline/pipeline_contract.hpp"
@@ -87,7 +88,17 @@ namespace mtconnect {
     /// @param[in] options Configuration Options
     ///     - SchemaVersion
     ///     - CheckpointFrequency
+    ///     - CompactBuffer
+    ///     - HistoryPath
+    ///     - HistoryBlockSize
+    ///     - HistoryMaxBlocks
+    ///     - AssetStoragePath
+    ///     - AssetCacheSize
+    ///     - LatencyMetrics
+    ///     - WorkerThreads
     ///     - Pretty
+    ///     - ObservationRenderCache
+    ///     - AssetRenderCache
     ///     - VersionDeviceXml
     ///     - JsonVersion
     ///     - DisableAgentDevice
@@ -177,6 +188,12 @@ namespace mtconnect {
     /// @param[in] sink shared pointer to the the sink being added
     /// @param[in] start: starts the source if start is true, otherwise delayed start
     void addSink(sink::SinkPtr sink, bool start = false);
+    /// @brief Stops a source and removes it from the agent
+    /// @param[in] source: shared pointer to the source being removed
+    void removeSource(source::SourcePtr source);
+    /// @brief Stops a sink and removes it from the agent
+    /// @param[in] sink shared pointer to the the sink being removed
+    void removeSink(sink::SinkPtr sink);
 
     // Source and Sink
     /// @brief Find a source by name
@@ -458,6 +475,22 @@ namespace mtconnect {
     void createAgentDevice();
     std::list<device_model::DevicePtr> loadXMLDeviceFile(const std::string &config);
     void verifyDevice(DevicePtr device);
+    /// @brief verify, create unique ids and hash the devices on the startup threads
+    /// @param[in] devices the devices loaded from the device file
+    void prepareDevices(const std::list<DevicePtr> &devices);
+    /// @brief add a device to the index and initialize its data items
+    /// @param[in] device the device
+    /// @param[in] prepared `true` if the device was already verified and hashed
+    void registerDevice(DevicePtr device, bool prepared);
+    /// @brief create the unique ids of a device without changing the agent
+    /// @param[in] device the device
+    /// @return map from the original ids to the unique ids
+    std::unordered_map<std::string, std::string> makeUniqueIds(DevicePtr device);
+    /// @brief move data items to their unique ids in the data item map
+    /// @param[in] device the device
+    /// @param[in] idMap map from the original ids to the unique ids
+    void remapDataItemIds(DevicePtr device,
+                          const std::unordered_map<std::string, std::string> &idMap);
     void initializeDataItems(DevicePtr device,
                              std::optional<std::set<std::string>> skip = std::nullopt);
     void loadCachedProbe();
@@ -479,6 +512,7 @@ namespace mtconnect {
     boost::asio::io_context::strand m_strand;
 
     std::shared_ptr<source::LoopbackSource> m_loopback;
+    std::shared_ptr<metrics::LatencyReporter> m_latencyReporter;
 
     bool m_started {false};
 
@@ -543,6 +577,7 @@ namespace mtconnect {
     std::string m_deviceXmlPath;
     bool m_versionDeviceXml {false};
     bool m_createUniqueIds {false};
+    size_t m_startupThreads {1};
     int32_t m_intSchemaVersion = IntDefaultSchemaVersion();
 
     // Circular Buffer
@@ -24,6 +24,7 @@
 #include "mtconnect/config.hpp"
 #include "mtconnect/entity/entity.hpp"
 #include "mtconnect/entity/factory.hpp"
+#include "mtconnect/entity/render_cache.hpp"
 #include "mtconnect/utilities.hpp"
 
 namespace mtconnect {
@@ -66,7 +67,8 @@ namespace mtconnect {
 
       /// @brief Sets a property of the asset
       ///
-      /// Special handling of `removed`. If `true` sets the asset state to removed.
+      /// Special handling of `removed`. If `true` sets the asset state to removed. Any change
+      /// invalidates the serialized forms of the asset.
       /// @param key property `key`
       /// @param v property value
       void setProperty(const std::string &key, const entity::Value &v) override
@@ -81,6 +83,22 @@ namespace mtconnect {
         }
 
         m_properties.insert_or_assign(key, r);
+        m_renderCache.clear();
+      }
+      /// @brief Add an entity to an entity list and invalidate the serialized forms
+      bool addToList(const std::string &name, entity::FactoryPtr factory, entity::EntityPtr entity,
+                     entity::ErrorList &errors) override
+      {
+        auto added = Entity::addToList(name, factory, entity, errors);
+        m_renderCache.clear();
+        return added;
+      }
+      /// @brief Remove an entity from an entity list and invalidate the serialized forms
+      bool removeFromList(const std::string &name, entity::EntityPtr entity) override
+      {
+        auto removed = Entity::removeFromList(name, entity);
+        m_renderCache.clear();
+        return removed;
       }
       /// @brief Set a property
       /// @param property the property
@@ -153,6 +171,12 @@ namespace mtconnect {
       /// @return `true` if they have the same asset id
       bool operator==(const Asset &another) const { return getAssetId() == another.getAssetId(); }
 
+      /// @brief get the cache of the serialized forms of this asset
+      ///
+      /// The cache is cleared after a property of the asset is set or an entity list changes.
+      /// @return the render cache
+      const entity::RenderCache &getRenderCache() const { return m_renderCache; }
+
     protected:
       /// @brief The virtual method that covers `hash(boost::uuids::detail::sha1&,
       /// boost::unordered_set<std::string> skip)`
@@ -169,6 +193,7 @@ namespace mtconnect {
     protected:
       std::string m_assetId;
       bool m_removed;
+      entity::RenderCache m_renderCache;
     };
 
     /// @brief A simple `RAW` asset that just carries the data associated
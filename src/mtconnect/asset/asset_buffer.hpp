@@ -52,25 +52,36 @@ namespace mtconnect::asset {
   {
   public:
     /// @brief Structure to store asset for boost multi index container
+    ///
+    /// The indexed properties of the asset are kept as columns in the node so the indexes do
+    /// not need to walk the asset properties. The columns must be refreshed with `update()`
+    /// inside `modify()` whenever the asset changes.
     struct AssetNode
     {
-      AssetNode(AssetPtr &asset) : m_asset(asset), m_identity(asset->getAssetId()) {}
+      AssetNode(AssetPtr &asset, uint64_t order)
+        : m_asset(asset), m_identity(asset->getAssetId()), m_order(order)
+      {
+        update();
+      }
       ~AssetNode() = default;
 
       using element_type = AssetPtr;
 
-      const std::string &getAssetId() const { return m_identity; }
-      const std::string &getType() const { return m_asset->getType(); }
-      const std::string &getDeviceUuid() const
+      /// @brief copy the indexed properties from the asset
+      void update()
       {
-        static const std::string unknown {"UNKNOWN"};
-        const auto &dev = m_asset->getProperty("deviceUuid");
-        if (std::holds_alternative<std::string>(dev))
-          return std::get<std::string>(dev);
-        else
-          return unknown;
+        m_type = m_asset->getType();
+        m_deviceUuid = stringProperty("deviceUuid", "UNKNOWN");
+        m_serialNumber = stringProperty("serialNumber");
+        m_toolId = stringProperty("toolId");
+        m_timestamp = m_asset->getTimestamp().value_or(Timestamp());
+        m_removed = m_asset->isRemoved();
       }
-      bool isRemoved() const { return m_asset->isRemoved(); }
+
+      const std::string &getAssetId() const { return m_identity; }
+      const std::string &getType() const { return m_type; }
+      const std::string &getDeviceUuid() const { return m_deviceUuid; }
+      bool isRemoved() const { return m_removed; }
 
       bool operator<(const AssetNode &o) const { return m_identity < o.m_identity; }
 
@@ -78,6 +89,24 @@ namespace mtconnect::asset {
 
       AssetPtr m_asset;
       std::string m_identity;
+      uint64_t m_order;  //< Increases every time an asset is added or updated
+
+      std::string m_type;
+      std::string m_deviceUuid;
+      std::string m_serialNumber;
+      std::string m_toolId;
+      Timestamp m_timestamp;
+      bool m_removed {false};
+
+    protected:
+      std::string stringProperty(const std::string &key, const char *missing = "") const
+      {
+        const auto &v = m_asset->getProperty(key);
+        if (std::holds_alternative<std::string>(v))
+          return std::get<std::string>(v);
+        else
+          return missing;
+      }
     };
 
   public:
@@ -93,12 +122,21 @@ namespace mtconnect::asset {
     /// @brief Index by assetId
     struct ByAssetId
     {};
-    /// @brief Index by Device and Type
+    /// @brief Index by Device, Type, and newest timestamp first
     struct ByDeviceAndType
     {};
-    /// @brief Index by type
+    /// @brief Index by type and newest timestamp first
     struct ByType
     {};
+    /// @brief Index by `serialNumber`
+    struct BySerialNumber
+    {};
+    /// @brief Index by `toolId`
+    struct ByToolId
+    {};
+    /// @brief Index by removed state in first in/first out order
+    struct ByRemoved
+    {};
 
     /// @brief The Multi-Index Container type
     using AssetIndex = mic::multi_index_container<
@@ -106,9 +144,23 @@ namespace mtconnect::asset {
         mic::indexed_by<
             mic::sequenced<mic::tag<ByFifo>>,
             mic::hashed_unique<mic::tag<ByAssetId>, mic::key<&AssetNode::m_identity>>,
-            mic::ordered_non_unique<mic::tag<ByDeviceAndType>,
-                                    mic::key<&AssetNode::getDeviceUuid, &AssetNode::getType>>,
-            mic::hashed_non_unique<mic::tag<ByType>, mic::key<&AssetNode::getType>>>>;
+            mic::ordered_non_unique<
+                mic::tag<ByDeviceAndType>,
+                mic::key<&AssetNode::m_deviceUuid, &AssetNode::m_type, &AssetNode::m_timestamp,
+                         &AssetNode::m_order>,
+                mic::composite_key_compare<std::less<std::string>, std::less<std::string>,
+                                           std::greater<Timestamp>, std::greater<uint64_t>>>,
+            mic::ordered_non_unique<
+                mic::tag<ByType>,
+                mic::key<&AssetNode::m_type, &AssetNode::m_timestamp, &AssetNode::m_order>,
+                mic::composite_key_compare<std::less<std::string>, std::greater<Timestamp>,
+                                           std::greater<uint64_t>>>,
+            mic::hashed_non_unique<mic::tag<BySerialNumber>,
+                                   mic::key<&AssetNode::m_serialNumber>>,
+            mic::hashed_non_unique<mic::tag<ByToolId>, mic::key<&AssetNode::m_toolId>>,
+            mic::ordered_non_unique<
+                mic::tag<ByRemoved>, mic::key<&AssetNode::m_removed, &AssetNode::m_order>,
+                mic::composite_key_compare<std::less<bool>, std::greater<uint64_t>>>>>;
 
     /// @brief Create an asset buffer with a maximum size
     /// @param max the maximum size
@@ -138,13 +190,18 @@ namespace mtconnect::asset {
         throw entity::PropertyError("Asset does not have an asset id");
       }
 
-      auto added = m_index.emplace_front(asset);
+      auto order = ++m_order;
+      auto added = m_index.emplace_front(asset, order);
 
       // Is duplicate
       if (!added.second)
       {
         old = added.first->m_asset;
-        m_index.modify(added.first, [&asset](AssetNode &n) { n.m_asset = asset; });
+        m_index.modify(added.first, [&asset, order](AssetNode &n) {
+          n.m_asset = asset;
+          n.m_order = order;
+          n.update();
+        });
         m_index.relocate(m_index.begin(), added.first);
         if (asset->isRemoved() && !old->isRemoved())
           adjustCount(asset, 1);
@@ -178,9 +235,12 @@ namespace mtconnect::asset {
         asset = it->m_asset;
         if (!asset->isRemoved())
         {
-          asset->setProperty("removed", true);
           Timestamp ts = time ? *time : std::chrono::system_clock::now();
-          asset->setProperty("timestamp", ts);
+          idx.modify(it, [&ts](AssetNode &n) {
+            n.m_asset->setProperty("removed", true);
+            n.m_asset->setProperty("timestamp", ts);
+            n.update();
+          });
           adjustCount(asset, 1);
         }
       }
@@ -215,7 +275,12 @@ namespace mtconnect::asset {
       }
       else if (type)
       {
-        range = m_index.get<ByType>().equal_range(*type);
+        range = m_index.get<ByType>().equal_range(std::make_tuple(*type));
+      }
+      else if (active)
+      {
+        // Skip the removed assets without visiting them
+        range = m_index.get<ByRemoved>().equal_range(std::make_tuple(false));
       }
       else
       {
@@ -245,6 +310,50 @@ namespace mtconnect::asset {
       return list.size();
     }
 
+    size_t getAssetsByProperty(AssetList &list, size_t max, const std::string &property,
+                               const std::string &value, const bool active = true,
+                               const std::optional<std::string> device = std::nullopt,
+                               const std::optional<std::string> type = std::nullopt) const override
+    {
+      std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+      auto matches = [&](const AssetNode &a) {
+        return (!active || !a.isRemoved()) && (!device || a.getDeviceUuid() == *device) &&
+               (!type || a.getType() == *type);
+      };
+
+      auto collect = [&](const auto &range) {
+        for (auto it = range.first; it != range.second && list.size() < max; it++)
+        {
+          if (matches(*it))
+            list.push_back(it->m_asset);
+        }
+      };
+
+      if (property == "serialNumber")
+      {
+        collect(m_index.get<BySerialNumber>().equal_range(value));
+      }
+      else if (property == "toolId")
+      {
+        collect(m_index.get<ByToolId>().equal_range(value));
+      }
+      else
+      {
+        AssetList candidates;
+        getAssets(candidates, std::numeric_limits<size_t>::max(), active, device, type);
+        for (const auto &a : candidates)
+        {
+          if (list.size() >= max)
+            break;
+          const auto &v = a->getProperty(property);
+          if (std::holds_alternative<std::string>(v) && std::get<std::string>(v) == value)
+            list.push_back(a);
+        }
+      }
+
+      return list.size();
+    }
+
     size_t getCountForDeviceAndType(const std::string &device, const std::string &type,
                                     bool active = true) const override
     {
@@ -263,7 +372,8 @@ namespace mtconnect::asset {
 
       std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
 
-      return boost::count_if(m_index.get<ByType>().equal_range(type), activePredicate(active));
+      return boost::count_if(m_index.get<ByType>().equal_range(std::make_tuple(type)),
+                             activePredicate(active));
     }
 
     size_t getCountForDevice(const std::string &device, bool active = true) const override
@@ -284,7 +394,7 @@ namespace mtconnect::asset {
       {
         int delta = 0;
         auto &type = it->getType();
-        auto rng = idx.equal_range(type);
+        auto rng = idx.equal_range(std::make_tuple(type));
         if (active)
         {
           auto cit = m_typeRemoveCount.find(type);
@@ -402,6 +512,7 @@ namespace mtconnect::asset {
 
   protected:
     size_t m_removedAssets {0};
+    uint64_t m_order {0};
     AssetIndex m_index;
 
     RemoveCountByDeviceAndType m_deviceRemoveCount;
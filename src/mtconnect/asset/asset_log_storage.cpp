@@ -0,0 +1,870 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#include "asset_log_storage.hpp"
+
+#include <boost/crc.hpp>
+
+#include "mtconnect/entity/xml_parser.hpp"
+#include "mtconnect/entity/xml_printer.hpp"
+#include "mtconnect/logging.hpp"
+#include "mtconnect/printer/xml_printer_helper.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace mtconnect::asset {
+  namespace {
+    /// @brief The type of log record
+    enum class Op : uint8_t
+    {
+      ADD = 1,    ///< The complete asset
+      DELETE = 2  ///< The asset was deleted from storage
+    };
+
+    /// @brief Size of the length and CRC preceding the record payload
+    constexpr size_t HeaderSize = 8;
+    /// @brief Records larger than this are considered corrupt
+    constexpr uint32_t MaxRecordSize = 1 << 30;
+
+    /// @brief Write the primitives of a log record
+    class RecordWriter
+    {
+    public:
+      RecordWriter()
+      {
+        // Reserve space for the length and CRC
+        m_out.resize(HeaderSize);
+      }
+
+      void byte(uint8_t v) { m_out.push_back(char(v)); }
+      void u32(uint32_t v)
+      {
+        for (int i = 0; i < 4; i++, v >>= 8)
+          m_out.push_back(char(v & 0xFF));
+      }
+      void i64(int64_t v)
+      {
+        auto u = uint64_t(v);
+        for (int i = 0; i < 8; i++, u >>= 8)
+          m_out.push_back(char(u & 0xFF));
+      }
+      void str(const string &s)
+      {
+        u32(uint32_t(s.size()));
+        m_out.append(s);
+      }
+
+      /// @brief fill in the header and return the record
+      string finish()
+      {
+        auto size = uint32_t(m_out.size() - HeaderSize);
+        boost::crc_32_type crc;
+        crc.process_bytes(m_out.data() + HeaderSize, size);
+        auto sum = uint32_t(crc.checksum());
+        for (int i = 0; i < 4; i++)
+        {
+          m_out[i] = char((size >> (i * 8)) & 0xFF);
+          m_out[4 + i] = char((sum >> (i * 8)) & 0xFF);
+        }
+        return std::move(m_out);
+      }
+
+    protected:
+      string m_out;
+    };
+
+    /// @brief Read the primitives of a log record payload
+    class RecordReader
+    {
+    public:
+      RecordReader(const string &payload) : m_payload(payload) {}
+
+      uint8_t byte() { return uint8_t(m_payload.at(m_pos++)); }
+      uint32_t u32()
+      {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; i++)
+          v |= uint32_t(byte()) << (i * 8);
+        return v;
+      }
+      int64_t i64()
+      {
+        uint64_t v = 0;
+        for (int i = 0; i < 8; i++)
+          v |= uint64_t(byte()) << (i * 8);
+        return int64_t(v);
+      }
+      string str()
+      {
+        auto len = u32();
+        if (m_pos + len > m_payload.size())
+          throw out_of_range("record string exceeds payload");
+        auto s = m_payload.substr(m_pos, len);
+        m_pos += len;
+        return s;
+      }
+
+    protected:
+      const string &m_payload;
+      size_t m_pos {0};
+    };
+
+    uint32_t readU32(const char *p)
+    {
+      uint32_t v = 0;
+      for (int i = 0; i < 4; i++)
+        v |= uint32_t(uint8_t(p[i])) << (i * 8);
+      return v;
+    }
+
+    string stringProperty(const AssetPtr &asset, const string &key)
+    {
+      const auto &v = asset->getProperty(key);
+      if (holds_alternative<string>(v))
+        return get<string>(v);
+      else
+        return "";
+    }
+
+    /// @brief Read the record at an offset from the log and return the payload
+    bool readRecord(istream &in, uint64_t offset, string &payload)
+    {
+      char header[HeaderSize];
+      in.clear();
+      in.seekg(offset);
+      if (!in.read(header, HeaderSize))
+        return false;
+
+      auto size = readU32(header);
+      auto sum = readU32(header + 4);
+      if (size > MaxRecordSize)
+        return false;
+      payload.resize(size);
+      if (!in.read(payload.data(), size))
+        return false;
+
+      boost::crc_32_type crc;
+      crc.process_bytes(payload.data(), payload.size());
+      return crc.checksum() == sum;
+    }
+  }  // namespace
+
+  AssetLogStorage::AssetLogStorage(const fs::path &directory, size_t max, size_t cacheSize)
+    : AssetStorage(max), m_path(directory / "assets.log"), m_cacheSize(cacheSize)
+  {
+    fs::create_directories(directory);
+    if (!fs::exists(m_path))
+      ofstream(m_path, ios::binary).close();
+
+    replay();
+
+    // Remove the oldest assets if the maximum has been reduced
+    while (m_index.size() > m_maxAssets)
+      deleteOldest();
+
+    if (m_deadBytes > 0)
+      compactLocked();
+
+    startWriter();
+  }
+
+  AssetLogStorage::~AssetLogStorage()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_queueLock);
+      m_running = false;
+    }
+    m_queueReady.notify_all();
+    if (m_writer.joinable())
+      m_writer.join();
+  }
+
+  void AssetLogStorage::replay()
+  {
+    ifstream in(m_path, ios::binary);
+    uint64_t offset = 0;
+    string payload;
+    while (readRecord(in, offset, payload))
+    {
+      auto size = uint32_t(HeaderSize + payload.size());
+      try
+      {
+        RecordReader reader(payload);
+        auto op = Op(reader.byte());
+        auto id = reader.str();
+
+        auto &idx = m_index.get<ByAssetId>();
+        auto existing = idx.find(id);
+        if (existing != idx.end())
+        {
+          m_deadBytes += existing->m_size;
+          adjustCounts(*existing, -1, existing->m_removed ? -1 : 0);
+          if (existing->m_removed)
+            m_removedAssets--;
+          idx.erase(existing);
+        }
+
+        if (op == Op::ADD)
+        {
+          Entry entry;
+          entry.m_assetId = id;
+          entry.m_type = reader.str();
+          entry.m_deviceUuid = reader.str();
+          entry.m_serialNumber = reader.str();
+          entry.m_toolId = reader.str();
+          entry.m_timestamp = Timestamp(chrono::microseconds(reader.i64()));
+          entry.m_removed = reader.byte() != 0;
+          entry.m_order = ++m_order;
+          entry.m_offset = offset;
+          entry.m_size = size;
+
+          adjustCounts(entry, 1, entry.m_removed ? 1 : 0);
+          if (entry.m_removed)
+            m_removedAssets++;
+          m_index.insert(entry);
+        }
+        else
+        {
+          m_deadBytes += size;
+        }
+      }
+      catch (std::exception &e)
+      {
+        LOG(warning) << "Invalid asset log record at " << offset << ": " << e.what();
+        break;
+      }
+
+      offset += size;
+    }
+
+    in.close();
+    if (offset < fs::file_size(m_path))
+    {
+      LOG(warning) << "Truncating asset log " << m_path << " to " << offset
+                   << " bytes after an incomplete record";
+      fs::resize_file(m_path, offset);
+    }
+
+    m_endOffset = m_writtenOffset = offset;
+    LOG(info) << "Loaded " << m_index.size() << " assets from " << m_path;
+  }
+
+  void AssetLogStorage::startWriter()
+  {
+    m_out.open(m_path, ios::binary | ios::app);
+    m_in.open(m_path, ios::binary);
+    m_running = true;
+    m_writer = std::thread([this]() { writer(); });
+  }
+
+  void AssetLogStorage::writer()
+  {
+    while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock(m_queueLock);
+        m_queueReady.wait(lock, [this]() { return !m_queue.empty() || !m_running; });
+        if (m_queue.empty() && !m_running)
+          break;
+      }
+
+      // Everything queued while the previous batch was written is written together
+      std::lock_guard<std::mutex> write(m_writeLock);
+      std::vector<Pending> batch;
+      {
+        std::lock_guard<std::mutex> lock(m_queueLock);
+        batch.swap(m_queue);
+      }
+
+      writeBatch(batch);
+    }
+  }
+
+  void AssetLogStorage::writeBatch(std::vector<Pending> &batch)
+  {
+    if (batch.empty())
+      return;
+
+    // Write the batch with a single write to the log
+    string buffer;
+    for (auto &p : batch)
+      buffer.append(p.m_record);
+    m_out.write(buffer.data(), buffer.size());
+    m_out.flush();
+    if (!m_out)
+      LOG(error) << "Cannot write to asset log " << m_path;
+
+    auto end = batch.back().m_offset + batch.back().m_record.size();
+    {
+      std::lock_guard<std::mutex> lock(m_queueLock);
+      m_writtenOffset = end;
+    }
+    m_written.notify_all();
+  }
+
+  void AssetLogStorage::flush()
+  {
+    // Prevent compaction from changing the offsets while waiting
+    std::lock_guard<std::recursive_mutex> buffer(m_bufferLock);
+    std::unique_lock<std::mutex> lock(m_queueLock);
+    auto end = m_queue.empty() ? m_writtenOffset
+                               : m_queue.back().m_offset + m_queue.back().m_record.size();
+    m_written.wait(lock, [this, end]() { return m_writtenOffset >= end || !m_running; });
+  }
+
+  void AssetLogStorage::compact()
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+    compactLocked();
+  }
+
+  void AssetLogStorage::compactLocked()
+  {
+    std::lock_guard<std::mutex> write(m_writeLock);
+
+    // Write anything waiting so the offsets in the index are all in the log
+    std::vector<Pending> batch;
+    {
+      std::lock_guard<std::mutex> lock(m_queueLock);
+      batch.swap(m_queue);
+    }
+    if (m_out.is_open())
+      writeBatch(batch);
+    m_unwritten.clear();
+
+    auto tmp = m_path;
+    tmp += ".tmp";
+    ifstream in(m_path, ios::binary);
+    ofstream out(tmp, ios::binary | ios::trunc);
+
+    // Copy the current records in the order they were written
+    std::vector<const Entry *> entries;
+    for (const auto &e : m_index)
+      entries.push_back(&e);
+    sort(entries.begin(), entries.end(),
+         [](const Entry *a, const Entry *b) { return a->m_offset < b->m_offset; });
+
+    uint64_t offset = 0;
+    std::vector<pair<string, uint64_t>> moved;
+    string record;
+    for (const auto *e : entries)
+    {
+      record.resize(e->m_size);
+      in.clear();
+      in.seekg(e->m_offset);
+      in.read(record.data(), e->m_size);
+      out.write(record.data(), e->m_size);
+      moved.emplace_back(e->m_assetId, offset);
+      offset += e->m_size;
+    }
+    out.close();
+    in.close();
+
+    if (!out)
+    {
+      LOG(error) << "Cannot compact asset log " << m_path;
+      fs::remove(tmp);
+      return;
+    }
+
+    m_out.close();
+    m_in.close();
+    fs::rename(tmp, m_path);
+
+    auto &idx = m_index.get<ByAssetId>();
+    for (const auto &[id, off] : moved)
+    {
+      auto it = idx.find(id);
+      idx.modify(it, [off = off](Entry &e) { e.m_offset = off; });
+    }
+
+    LOG(debug) << "Compacted asset log " << m_path << " from " << m_endOffset << " to " << offset
+               << " bytes";
+
+    {
+      std::lock_guard<std::mutex> lock(m_queueLock);
+      m_endOffset = m_writtenOffset = offset;
+    }
+    m_written.notify_all();
+    m_deadBytes = 0;
+
+    if (m_running)
+    {
+      m_out.open(m_path, ios::binary | ios::app);
+      m_in.open(m_path, ios::binary);
+    }
+  }
+
+  AssetLogStorage::Entry AssetLogStorage::makeEntry(const AssetPtr &asset) const
+  {
+    Entry entry;
+    entry.m_assetId = asset->getAssetId();
+    entry.m_type = asset->getType();
+    entry.m_deviceUuid = asset->getDeviceUuid().value_or("UNKNOWN");
+    entry.m_serialNumber = stringProperty(asset, "serialNumber");
+    entry.m_toolId = stringProperty(asset, "toolId");
+    entry.m_timestamp = asset->getTimestamp().value_or(Timestamp());
+    entry.m_removed = asset->isRemoved();
+    return entry;
+  }
+
+  void AssetLogStorage::append(Entry &entry, const std::string &record, const AssetPtr &asset)
+  {
+    entry.m_offset = m_endOffset;
+    entry.m_size = uint32_t(record.size());
+    m_endOffset += record.size();
+
+    {
+      std::lock_guard<std::mutex> lock(m_queueLock);
+      m_queue.push_back({entry.m_offset, record});
+
+      // Assets with written records can be read from the log
+      m_unwritten.erase(m_unwritten.begin(), m_unwritten.lower_bound(m_writtenOffset));
+    }
+    if (asset)
+      m_unwritten[entry.m_offset] = asset;
+    m_queueReady.notify_one();
+  }
+
+  void AssetLogStorage::compactIfNeeded()
+  {
+    // Compact when the dead records take more space than the current assets. Called after the
+    // index is updated so the record just appended is copied to the compacted log.
+    if (m_deadBytes > 1024 * 1024 && m_deadBytes > m_endOffset - m_deadBytes)
+      compactLocked();
+  }
+
+  namespace {
+    string serialize(const AssetPtr &asset, const string &type, const string &device,
+                     const string &serialNumber, const string &toolId, const Timestamp &ts)
+    {
+      printer::XmlWriter writer(false);
+      entity::XmlPrinter printer;
+      printer.print(writer, asset, {});
+
+      RecordWriter record;
+      record.byte(uint8_t(Op::ADD));
+      record.str(asset->getAssetId());
+      record.str(type);
+      record.str(device);
+      record.str(serialNumber);
+      record.str(toolId);
+      record.i64(chrono::duration_cast<chrono::microseconds>(ts.time_since_epoch()).count());
+      record.byte(asset->isRemoved() ? 1 : 0);
+      record.str(writer.getFragment());
+      return record.finish();
+    }
+  }  // namespace
+
+  AssetPtr AssetLogStorage::addAsset(AssetPtr asset)
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+
+    if (!asset->getTimestamp())
+    {
+      asset->setProperty("timestamp", getCurrentTime(GMT_UV_SEC));
+    }
+
+    if (!asset->hasProperty("assetId"))
+    {
+      throw entity::PropertyError("Asset does not have an asset id");
+    }
+
+    auto entry = makeEntry(asset);
+    entry.m_order = ++m_order;
+    auto record = serialize(asset, entry.m_type, entry.m_deviceUuid, entry.m_serialNumber,
+                            entry.m_toolId, entry.m_timestamp);
+
+    AssetPtr old;
+    auto &idx = m_index.get<ByAssetId>();
+    auto existing = idx.find(entry.m_assetId);
+    if (existing != idx.end())
+    {
+      old = load(*existing);
+      m_deadBytes += existing->m_size;
+      adjustCounts(*existing, -1, existing->m_removed ? -1 : 0);
+      if (existing->m_removed)
+        m_removedAssets--;
+      idx.erase(existing);
+    }
+
+    append(entry, record, asset);
+    adjustCounts(entry, 1, entry.m_removed ? 1 : 0);
+    if (entry.m_removed)
+      m_removedAssets++;
+    m_index.insert(entry);
+    cache(asset);
+
+    if (!old && m_index.size() > m_maxAssets)
+    {
+      auto &fifo = m_index.get<ByOrder>();
+      old = load(*prev(fifo.end()));
+      deleteOldest();
+    }
+    compactIfNeeded();
+
+    return old;
+  }
+
+  void AssetLogStorage::deleteOldest()
+  {
+    auto &fifo = m_index.get<ByOrder>();
+    auto oldest = prev(fifo.end());
+
+    RecordWriter record;
+    record.byte(uint8_t(Op::DELETE));
+    record.str(oldest->m_assetId);
+    auto text = record.finish();
+
+    m_deadBytes += oldest->m_size + text.size();
+    adjustCounts(*oldest, -1, oldest->m_removed ? -1 : 0);
+    if (oldest->m_removed)
+      m_removedAssets--;
+    if (auto it = m_cache.find(oldest->m_assetId); it != m_cache.end())
+    {
+      m_lru.erase(it->second);
+      m_cache.erase(it);
+    }
+    fifo.erase(oldest);
+
+    if (m_running)
+    {
+      Entry entry;
+      append(entry, text, nullptr);
+    }
+    else
+    {
+      // Opening the log, write directly
+      ofstream out(m_path, ios::binary | ios::app);
+      out.write(text.data(), text.size());
+      m_endOffset += text.size();
+      m_writtenOffset = m_endOffset;
+    }
+    compactIfNeeded();
+  }
+
+  AssetPtr AssetLogStorage::removeAsset(const std::string &id,
+                                        const std::optional<Timestamp> &time)
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+
+    auto &idx = m_index.get<ByAssetId>();
+    auto it = idx.find(id);
+    if (it == idx.end())
+      return nullptr;
+
+    auto asset = load(*it);
+    if (asset && !asset->isRemoved())
+    {
+      Timestamp ts = time ? *time : std::chrono::system_clock::now();
+      asset->setProperty("removed", true);
+      asset->setProperty("timestamp", ts);
+
+      auto entry = makeEntry(asset);
+      entry.m_order = it->m_order;
+      auto record = serialize(asset, entry.m_type, entry.m_deviceUuid, entry.m_serialNumber,
+                              entry.m_toolId, entry.m_timestamp);
+
+      m_deadBytes += it->m_size;
+      adjustCounts(*it, 0, 1);
+      m_removedAssets++;
+      append(entry, record, asset);
+      idx.replace(it, entry);
+      compactIfNeeded();
+    }
+
+    return asset;
+  }
+
+  size_t AssetLogStorage::removeAll(AssetList &list, const std::optional<std::string> device,
+                                    const std::optional<std::string> type,
+                                    const std::optional<Timestamp> &time)
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+    getAssets(list, std::numeric_limits<size_t>().max(), false, device, type);
+    for (auto &a : list)
+      removeAsset(a->getAssetId(), time);
+
+    return list.size();
+  }
+
+  void AssetLogStorage::cache(const AssetPtr &asset) const
+  {
+    if (m_cacheSize == 0)
+      return;
+
+    const auto &id = asset->getAssetId();
+    auto it = m_cache.find(id);
+    if (it != m_cache.end())
+    {
+      *it->second = asset;
+      m_lru.splice(m_lru.begin(), m_lru, it->second);
+      return;
+    }
+
+    m_lru.push_front(asset);
+    m_cache.emplace(id, m_lru.begin());
+    if (m_lru.size() > m_cacheSize)
+    {
+      m_cache.erase(m_lru.back()->getAssetId());
+      m_lru.pop_back();
+    }
+  }
+
+  AssetPtr AssetLogStorage::load(const Entry &entry) const
+  {
+    if (auto it = m_cache.find(entry.m_assetId); it != m_cache.end())
+    {
+      m_lru.splice(m_lru.begin(), m_lru, it->second);
+      return *it->second;
+    }
+
+    if (auto it = m_unwritten.find(entry.m_offset); it != m_unwritten.end())
+    {
+      cache(it->second);
+      return it->second;
+    }
+
+    // Make sure the record has been written
+    if (entry.m_offset + entry.m_size > m_writtenOffset)
+      const_cast<AssetLogStorage *>(this)->flush();
+
+    string payload;
+    if (!readRecord(m_in, entry.m_offset, payload))
+    {
+      LOG(error) << "Cannot read asset " << entry.m_assetId << " from " << m_path;
+      return nullptr;
+    }
+
+    try
+    {
+      RecordReader reader(payload);
+      reader.byte();
+      for (int i = 0; i < 5; i++)
+        reader.str();
+      reader.i64();
+      reader.byte();
+      auto xml = reader.str();
+
+      entity::ErrorList errors;
+      auto asset = dynamic_pointer_cast<Asset>(
+          entity::XmlParser::parse(Asset::getRoot(), xml, errors));
+      if (!asset)
+      {
+        LOG(error) << "Cannot parse asset " << entry.m_assetId << " from " << m_path;
+        return nullptr;
+      }
+
+      cache(asset);
+      return asset;
+    }
+    catch (std::exception &e)
+    {
+      LOG(error) << "Invalid record for asset " << entry.m_assetId << ": " << e.what();
+      return nullptr;
+    }
+  }
+
+  AssetPtr AssetLogStorage::getAsset(const std::string &id) const
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+    const auto &idx = m_index.get<ByAssetId>();
+    auto it = idx.find(id);
+    if (it != idx.end())
+      return load(*it);
+    else
+      return nullptr;
+  }
+
+  size_t AssetLogStorage::getAssets(AssetList &list, size_t max, const bool active,
+                                    const std::optional<std::string> device,
+                                    const std::optional<std::string> type) const
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+
+    if (device)
+    {
+      auto &idx = m_index.get<ByDeviceAndType>();
+      auto [first, last] = type ? idx.equal_range(std::make_tuple(*device, *type))
+                                : idx.equal_range(std::make_tuple(*device));
+      collect(list, max, active, first, last);
+    }
+    else if (type)
+    {
+      auto [first, last] = m_index.get<ByType>().equal_range(std::make_tuple(*type));
+      collect(list, max, active, first, last);
+    }
+    else
+    {
+      auto &idx = m_index.get<ByOrder>();
+      collect(list, max, active, idx.begin(), idx.end());
+    }
+
+    return list.size();
+  }
+
+  size_t AssetLogStorage::getAssets(AssetList &list, const std::list<std::string> &ids) const
+  {
+    for (auto &id : ids)
+    {
+      if (auto asset = getAsset(id); asset)
+        list.emplace_back(asset);
+    }
+
+    return list.size();
+  }
+
+  size_t AssetLogStorage::getAssetsByProperty(AssetList &list, size_t max,
+                                              const std::string &property,
+                                              const std::string &value, const bool active,
+                                              const std::optional<std::string> device,
+                                              const std::optional<std::string> type) const
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+    auto matches = [&](const Entry &e) {
+      return (!device || e.m_deviceUuid == *device) && (!type || e.m_type == *type);
+    };
+
+    auto select = [&](const auto &range) {
+      for (auto it = range.first; it != range.second && list.size() < max; it++)
+      {
+        if ((!active || !it->m_removed) && matches(*it))
+        {
+          if (auto asset = load(*it))
+            list.push_back(asset);
+        }
+      }
+    };
+
+    if (property == "serialNumber")
+    {
+      select(m_index.get<BySerialNumber>().equal_range(value));
+    }
+    else if (property == "toolId")
+    {
+      select(m_index.get<ByToolId>().equal_range(value));
+    }
+    else
+    {
+      // Properties that are not indexed require the assets
+      for (const auto &e : m_index.get<ByOrder>())
+      {
+        if (list.size() >= max)
+          break;
+        if ((!active || !e.m_removed) && matches(e))
+        {
+          auto asset = load(e);
+          if (!asset)
+            continue;
+          const auto &v = asset->getProperty(property);
+          if (holds_alternative<string>(v) && get<string>(v) == value)
+            list.push_back(asset);
+        }
+      }
+    }
+
+    return list.size();
+  }
+
+  void AssetLogStorage::adjustCounts(const Entry &entry, int total, int removed)
+  {
+    auto &type = m_typeCounts[entry.m_type];
+    type.m_total += total;
+    type.m_removed += removed;
+    if (type.m_total == 0)
+      m_typeCounts.erase(entry.m_type);
+
+    auto &device = m_deviceCounts[entry.m_deviceUuid];
+    auto &counts = device[entry.m_type];
+    counts.m_total += total;
+    counts.m_removed += removed;
+    if (counts.m_total == 0)
+    {
+      device.erase(entry.m_type);
+      if (device.empty())
+        m_deviceCounts.erase(entry.m_deviceUuid);
+    }
+  }
+
+  size_t AssetLogStorage::getCount(bool active) const
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+    if (active)
+      return m_index.size() - m_removedAssets;
+    else
+      return m_index.size();
+  }
+
+  AssetStorage::TypeCount AssetLogStorage::getCountsByType(bool active) const
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+    TypeCount res;
+    for (const auto &[type, counts] : m_typeCounts)
+    {
+      if (auto count = counts.get(active); count > 0)
+        res[type] = count;
+    }
+    return res;
+  }
+
+  size_t AssetLogStorage::getCountForDeviceAndType(const std::string &device,
+                                                   const std::string &type, bool active) const
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+    auto dit = m_deviceCounts.find(device);
+    if (dit == m_deviceCounts.end())
+      return 0;
+    auto tit = dit->second.find(type);
+    return tit == dit->second.end() ? 0 : tit->second.get(active);
+  }
+
+  size_t AssetLogStorage::getCountForType(const std::string &type, bool active) const
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+    auto it = m_typeCounts.find(type);
+    return it == m_typeCounts.end() ? 0 : it->second.get(active);
+  }
+
+  size_t AssetLogStorage::getCountForDevice(const std::string &device, bool active) const
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+    size_t count = 0;
+    if (auto dit = m_deviceCounts.find(device); dit != m_deviceCounts.end())
+    {
+      for (const auto &[type, counts] : dit->second)
+        count += counts.get(active);
+    }
+    return count;
+  }
+
+  AssetStorage::TypeCount AssetLogStorage::getCountsByTypeForDevice(const std::string &device,
+                                                                    bool active) const
+  {
+    std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+    TypeCount res;
+    if (auto dit = m_deviceCounts.find(device); dit != m_deviceCounts.end())
+    {
+      for (const auto &[type, counts] : dit->second)
+      {
+        if (auto count = counts.get(active); count > 0)
+          res[type] = count;
+      }
+    }
+    return res;
+  }
+}  // namespace mtconnect::asset
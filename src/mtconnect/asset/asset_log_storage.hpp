@@ -0,0 +1,247 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/key.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index_container.hpp>
+
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "asset.hpp"
+#include "asset_storage.hpp"
+#include "mtconnect/config.hpp"
+#include "mtconnect/utilities.hpp"
+
+namespace mtconnect::asset {
+  namespace mic = boost::multi_index;
+
+  /// @brief Asset storage persisted in an append only log file
+  ///
+  /// Every change to an asset appends the complete asset, serialized as XML, to `assets.log` in
+  /// the storage directory. Each record carries the indexed properties of the asset so the
+  /// index can be rebuilt when the agent starts without parsing the assets. Only the index and
+  /// a least recently used cache of assets are kept in memory; other assets are read from the
+  /// log when they are requested.
+  ///
+  /// Records are written in batches by a writer thread. Until a record is written, the asset is
+  /// served from memory. The counts by device and type are maintained as assets change.
+  ///
+  /// The log is compacted when the agent starts and when the records of replaced and deleted
+  /// assets take more space than the current assets.
+  class AGENT_LIB_API AssetLogStorage : public AssetStorage
+  {
+  public:
+    /// @brief Create or open the asset log in a directory
+    /// @param directory the directory for the log file, created if it does not exist
+    /// @param max the maximum number of assets
+    /// @param cacheSize the number of assets to keep in memory
+    AssetLogStorage(const std::filesystem::path &directory, size_t max, size_t cacheSize = 1024);
+    ~AssetLogStorage() override;
+
+    size_t getCount(bool active = true) const override;
+    TypeCount getCountsByType(bool active = true) const override;
+
+    AssetPtr addAsset(AssetPtr asset) override;
+    AssetPtr removeAsset(const std::string &id,
+                         const std::optional<Timestamp> &time = std::nullopt) override;
+    size_t removeAll(AssetList &list, const std::optional<std::string> device = std::nullopt,
+                     const std::optional<std::string> type = std::nullopt,
+                     const std::optional<Timestamp> &time = std::nullopt) override;
+
+    AssetPtr getAsset(const std::string &id) const override;
+    size_t getAssets(AssetList &list, size_t max, const bool active = true,
+                     const std::optional<std::string> device = std::nullopt,
+                     const std::optional<std::string> type = std::nullopt) const override;
+    size_t getAssets(AssetList &list, const std::list<std::string> &ids) const override;
+    size_t getAssetsByProperty(AssetList &list, size_t max, const std::string &property,
+                               const std::string &value, const bool active = true,
+                               const std::optional<std::string> device = std::nullopt,
+                               const std::optional<std::string> type = std::nullopt) const override;
+
+    size_t getCountForDeviceAndType(const std::string &device, const std::string &type,
+                                    bool active = true) const override;
+    size_t getCountForType(const std::string &type, bool active = true) const override;
+    size_t getCountForDevice(const std::string &device, bool active = true) const override;
+    TypeCount getCountsByTypeForDevice(const std::string &device,
+                                       bool active = true) const override;
+
+    /// @brief Wait until all pending records are written to the log
+    void flush();
+    /// @brief Rewrite the log with only the records of the current assets
+    void compact();
+
+    /// @brief get the path of the log file
+    /// @return the path
+    const auto &getPath() const { return m_path; }
+    /// @brief get the size of the log including pending records
+    /// @return the size in bytes
+    uint64_t getLogSize() const
+    {
+      std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+      return m_endOffset;
+    }
+    /// @brief get the size of the records for replaced and deleted assets
+    /// @return the size in bytes
+    uint64_t getDeadBytes() const
+    {
+      std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+      return m_deadBytes;
+    }
+    /// @brief get the number of assets in the in-memory cache
+    /// @return the number of cached assets
+    size_t getCachedCount() const
+    {
+      std::lock_guard<std::recursive_mutex> lock(m_bufferLock);
+      return m_cache.size();
+    }
+
+  protected:
+    /// @brief The indexed properties of an asset and the location of its record
+    struct Entry
+    {
+      std::string m_assetId;
+      std::string m_type;
+      std::string m_deviceUuid;
+      std::string m_serialNumber;
+      std::string m_toolId;
+      Timestamp m_timestamp;
+      bool m_removed {false};
+      uint64_t m_order {0};  //< Increases every time an asset is added or updated
+      uint64_t m_offset {0};
+      uint32_t m_size {0};
+    };
+
+    struct ByAssetId
+    {};
+    struct ByOrder
+    {};
+    struct ByDeviceAndType
+    {};
+    struct ByType
+    {};
+    struct BySerialNumber
+    {};
+    struct ByToolId
+    {};
+
+    using EntryIndex = mic::multi_index_container<
+        Entry,
+        mic::indexed_by<
+            mic::hashed_unique<mic::tag<ByAssetId>, mic::key<&Entry::m_assetId>>,
+            mic::ordered_unique<mic::tag<ByOrder>, mic::key<&Entry::m_order>,
+                                std::greater<uint64_t>>,
+            mic::ordered_non_unique<
+                mic::tag<ByDeviceAndType>,
+                mic::key<&Entry::m_deviceUuid, &Entry::m_type, &Entry::m_timestamp,
+                         &Entry::m_order>,
+                mic::composite_key_compare<std::less<std::string>, std::less<std::string>,
+                                           std::greater<Timestamp>, std::greater<uint64_t>>>,
+            mic::ordered_non_unique<
+                mic::tag<ByType>, mic::key<&Entry::m_type, &Entry::m_timestamp, &Entry::m_order>,
+                mic::composite_key_compare<std::less<std::string>, std::greater<Timestamp>,
+                                           std::greater<uint64_t>>>,
+            mic::hashed_non_unique<mic::tag<BySerialNumber>, mic::key<&Entry::m_serialNumber>>,
+            mic::hashed_non_unique<mic::tag<ByToolId>, mic::key<&Entry::m_toolId>>>>;
+
+    /// @brief Total and removed counts
+    struct Counts
+    {
+      size_t m_total {0};
+      size_t m_removed {0};
+      size_t get(bool active) const { return active ? m_total - m_removed : m_total; }
+    };
+
+    /// @brief A record waiting for the writer thread
+    struct Pending
+    {
+      uint64_t m_offset;
+      std::string m_record;
+    };
+
+    void replay();
+    void startWriter();
+    void writer();
+    void writeBatch(std::vector<Pending> &batch);
+    void compactLocked();
+    void compactIfNeeded();
+
+    Entry makeEntry(const AssetPtr &asset) const;
+    void append(Entry &entry, const std::string &record, const AssetPtr &asset);
+    void deleteOldest();
+    void adjustCounts(const Entry &entry, int total, int removed);
+    AssetPtr load(const Entry &entry) const;
+    void cache(const AssetPtr &asset) const;
+
+    template <typename I>
+    void collect(AssetList &list, size_t max, bool active, I first, I last) const
+    {
+      for (auto it = first; it != last && list.size() < max; it++)
+      {
+        if (!active || !it->m_removed)
+        {
+          if (auto asset = load(*it))
+            list.push_back(asset);
+        }
+      }
+    }
+
+  protected:
+    std::filesystem::path m_path;
+    size_t m_cacheSize;
+
+    EntryIndex m_index;
+    uint64_t m_order {0};
+    uint64_t m_endOffset {0};
+    uint64_t m_deadBytes {0};
+    size_t m_removedAssets {0};
+
+    std::map<std::string, Counts> m_typeCounts;
+    std::unordered_map<std::string, std::map<std::string, Counts>> m_deviceCounts;
+
+    // Least recently used assets, the most recent are at the front
+    mutable std::list<AssetPtr> m_lru;
+    mutable std::unordered_map<std::string, std::list<AssetPtr>::iterator> m_cache;
+
+    // Assets with records that have not been written, by offset of the record
+    std::map<uint64_t, AssetPtr> m_unwritten;
+
+    // Writer thread state
+    std::mutex m_writeLock;
+    std::mutex m_queueLock;
+    std::condition_variable m_queueReady;
+    std::condition_variable m_written;
+    std::vector<Pending> m_queue;
+    uint64_t m_writtenOffset {0};
+    bool m_running {false};
+    std::thread m_writer;
+    std::ofstream m_out;
+    mutable std::ifstream m_in;
+  };
+}  // namespace mtconnect::asset
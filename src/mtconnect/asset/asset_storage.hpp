@@ -114,6 +114,23 @@ namespace mtconnect {
       /// @param[in] ids assetIds to find
       /// @return the number of assets found
       virtual size_t getAssets(AssetList &list, const std::list<std::string> &ids) const = 0;
+      /// @brief get a list of assets with a property value
+      ///
+      /// Storage may index common properties, such as `serialNumber` and `toolId`, to find the
+      /// assets without scanning.
+      ///
+      /// @param[out] list returned list of assets
+      /// @param[in] max maximum number of assets to find
+      /// @param[in] property the property name
+      /// @param[in] value the value of the property
+      /// @param[in] active `true` to skip removed assets
+      /// @param[in] device optional device uuid to select
+      /// @param[in] type optional type to select
+      /// @return the number of assets found
+      virtual size_t getAssetsByProperty(
+          AssetList &list, size_t max, const std::string &property, const std::string &value,
+          const bool active = true, const std::optional<std::string> device = std::nullopt,
+          const std::optional<std::string> type = std::nullopt) const = 0;
       ///@}
 
       /// @name Count related methods
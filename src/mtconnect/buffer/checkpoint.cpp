@@ -47,29 +47,19 @@ namespace mtconnect {
       if (cond->getLevel() != Condition::NORMAL && event->getLevel() != Condition::NORMAL &&
           cond->getLevel() != Condition::UNAVAILABLE && event->getLevel() != Condition::UNAVAILABLE)
       {
-        // Check to see if the native code matches an existing
-        // active condition
-        if (auto e = cond->find(event->getCode()))
-        {
-          // Replace in chain.
-          old = cond->deepCopyAndRemove(e);
-          // Check if this is the only event...
-          // ??
-        }
-
-        // Chain the event
-        if (old)
-          event->appendTo(dynamic_pointer_cast<Condition>(old));
+        // Add the event to the active conditions, replacing an active condition
+        // with the same native code
+        event->activateAfter(dynamic_pointer_cast<Condition>(old));
       }
       else if (event->getLevel() == Condition::NORMAL)
       {
         // Check for a normal that clears an active condition by code
         if (!event->getCode().empty())
         {
-          if (auto e = cond->find(event->getCode()))
+          if (cond->find(event->getCode()))
           {
-            // Clear the one condition by removing it from the chain
-            old = cond->deepCopyAndRemove(e);
+            // Clear the one condition by removing it from the active conditions
+            old = cond->copyAndClear(event->getCode());
 
             if (!old)
             {
@@ -178,10 +168,10 @@ namespace mtconnect {
     {
       if (obs->getDataItem()->isCondition())
       {
-        for (auto ev = dynamic_pointer_cast<Condition>(obs); ev; ev = ev->getPrev())
-        {
-          list.push_back(ev);
-        }
+        // Most recent condition first
+        ConditionList conditions;
+        dynamic_pointer_cast<Condition>(obs)->getConditionList(conditions);
+        list.insert(list.end(), conditions.rbegin(), conditions.rend());
       }
       else
       {
@@ -166,30 +166,6 @@ namespace mtconnect::buffer {
       return m_observations;
     }
 
-    /// @brief updates the data item reference of an observation in a checkpoint
-    ///
-    /// Used when the device model is modified and data items may have been removed or
-    /// changed. The new data item shared pointer will replace the old.
-    ///
-    /// @param[in] diMap the map of data ids to data item pointers
-    void updateDataItems(std::unordered_map<std::string, WeakDataItemPtr> &diMap)
-    {
-      auto iter = m_observations.begin();
-      while (iter != m_observations.end())
-      {
-        auto item = *iter;
-        if (item.second->isOrphan())
-        {
-          iter = m_observations.erase(iter);
-        }
-        else
-        {
-          item.second->updateDataItem(diMap);
-          iter++;
-        }
-      }
-    }
-
     /// @brief Get a list of observations from the checkpoint
     /// @param[in,out] list the list to add the observations to
     /// @param[in] filter an optional filter for the observations
@@ -24,9 +24,12 @@
 #include <mutex>
 
 #include "checkpoint.hpp"
+#include "compact_observation.hpp"
+#include "history_store.hpp"
 #include "mtconnect/config.hpp"
 #include "mtconnect/entity/requirement.hpp"
 #include "mtconnect/logging.hpp"
+#include "mtconnect/metrics/latency.hpp"
 #include "mtconnect/observation/observation.hpp"
 #include "mtconnect/utilities.hpp"
 
@@ -40,11 +43,15 @@ namespace mtconnect::buffer {
     /// @brief Create a circular buffer
     /// @param bufferSize the size of the circular buffer
     /// @param checkpointFreq how often to create checkpoints
-    CircularBuffer(unsigned int bufferSize, int checkpointFreq)
+    /// @param compact store fixed size compact records instead of observations. Observations
+    /// are materialized when they are read from the buffer.
+    CircularBuffer(unsigned int bufferSize, int checkpointFreq, bool compact = false)
       : m_sequence(1ull),
         m_firstSequence(m_sequence),
         m_slidingBufferSize(1 << bufferSize),
-        m_slidingBuffer(m_slidingBufferSize),
+        m_compact(compact),
+        m_slidingBuffer(compact ? 0 : m_slidingBufferSize),
+        m_compactBuffer(compact ? m_slidingBufferSize : 0),
         m_checkpointFreq(checkpointFreq),
         m_checkpointCount(m_slidingBufferSize / checkpointFreq),
         m_checkpoints(m_checkpointCount)
@@ -58,8 +65,8 @@ namespace mtconnect::buffer {
     observation::ObservationPtr getFromBuffer(uint64_t seq) const
     {
       auto off = seq - m_firstSequence;
-      if (off < m_slidingBufferSize)
-        return m_slidingBuffer[off];
+      if (off < bufferedCount())
+        return observationAt(off);
       else
         return observation::ObservationPtr();
     }
@@ -75,33 +82,43 @@ namespace mtconnect::buffer {
     /// @brief get the buffer size
     /// @return the buffer size
     unsigned int getBufferSize() const { return m_slidingBufferSize; }
+    /// @brief check if the buffer stores compact records
+    /// @return `true` if compact
+    bool isCompact() const { return m_compact; }
 
     /// @brief get the first sequence number in the circular buffer
     /// @return first sequence
     SequenceNumber_t getFirstSequence() const { return m_firstSequence; }
 
-    /// @brief update the data item references when device model changes
-    /// @param diMap the map of data item ids to new data item entities
-    void updateDataItems(std::unordered_map<std::string, WeakDataItemPtr> &diMap)
+    /// @brief get the first sequence number that can be requested
+    ///
+    /// If a history store is attached, this is the first sequence in the store, otherwise it is
+    /// the first sequence in the circular buffer.
+    ///
+    /// @return first available sequence
+    SequenceNumber_t getFirstAvailableSequence() const
     {
-      for (auto &o : m_slidingBuffer)
-      {
-        if (o->isOrphan())
-        {
-          continue;
-        }
-        o->updateDataItem(diMap);
-      }
-
-      // checkpoints will remove orphans from its observations
-      m_first.updateDataItems(diMap);
-      m_latest.updateDataItems(diMap);
+      std::lock_guard<std::recursive_mutex> lock(m_sequenceLock);
+      if (m_history && !m_history->empty())
+        return std::min(m_history->getFirstSequence(), m_firstSequence);
+      else
+        return m_firstSequence;
+    }
 
-      for (auto &cp : m_checkpoints)
-      {
-        cp->updateDataItems(diMap);
-      }
+    /// @brief Attach a history store to receive observations evicted from the buffer
+    /// @param store the history store
+    void setHistoryStore(std::unique_ptr<HistoryStore> &&store)
+    {
+      std::lock_guard<std::recursive_mutex> lock(m_sequenceLock);
+      m_history = std::move(store);
     }
+    /// @brief get the history store
+    /// @return pointer to the history store or `nullptr` if there is none
+    HistoryStore *getHistoryStore() const { return m_history.get(); }
+
+    /// @brief Measure how long `addToBuffer` waits for the sequence lock
+    /// @param latency the histogram or `nullptr` to stop measuring
+    void setLockWaitLatency(metrics::Histogram *latency) { m_lockWait = latency; }
 
     /// @brief Set the sequence number
     ///
@@ -112,7 +129,7 @@ namespace mtconnect::buffer {
     {
       m_sequence = seq;
       if (seq > m_slidingBufferSize)
-        m_firstSequence = seq - m_slidingBuffer.size();
+        m_firstSequence = seq - bufferedCount();
     }
 
     /// @brief Add an observation to the circular buffer
@@ -130,24 +147,34 @@ namespace mtconnect::buffer {
       DataItemPtr dataItem;
 
       {
-        std::lock_guard<std::recursive_mutex> lock(m_sequenceLock);
+        std::unique_lock<std::recursive_mutex> lock(m_sequenceLock, std::defer_lock);
+        metrics::lockTimed(lock, m_lockWait);
         dataItem = observation->getDataItem();
         seq = m_sequence;
 
         observation->setSequence(seq);
-        m_slidingBuffer.push_back(observation);
+        // The observation about to be overwritten moves to the history store
+        if (m_history && isFull())
+        {
+          if (auto evicted = observationAt(0))
+            m_history->append(evicted);
+        }
+        if (m_compact)
+          m_compactBuffer.push_back(m_encoder.encode(observation));
+        else
+          m_slidingBuffer.push_back(observation);
         m_latest.addObservation(observation);
 
         // Special case for the first event in the series to prime the first checkpoint.
         if (seq == 1)
           m_first.addObservation(observation);
-        else if (m_slidingBuffer.full())
+        else if (isFull())
         {
-          observation::ObservationPtr old = m_slidingBuffer.front();
-          m_first.addObservation(old);
-          if (old->getSequence() > 1)
+          if (auto old = observationAt(0))
+            m_first.addObservation(old);
+          if (sequenceAt(0) > 1)
             m_firstSequence++;
-          // assert(old->getSequence() == m_firstSequence);
+          // assert(sequenceAt(0) == m_firstSequence);
         }
 
         // Checkpoint management
@@ -205,8 +232,7 @@ namespace mtconnect::buffer {
       int dt = int(in - fi) - 1;
 
       std::unique_ptr<Checkpoint> check;
-      decltype(m_slidingBuffer.cbegin()) iter;
-      decltype(m_slidingBuffer.cend()) end;
+      size_t index, end;
 
       if (dt < 0)
       {
@@ -214,8 +240,8 @@ namespace mtconnect::buffer {
         if (at == m_firstSequence)
           return check;
 
-        iter = m_slidingBuffer.cbegin();
-        end = iter + (at - m_firstSequence) + 1;
+        index = 0;
+        end = index + (at - m_firstSequence) + 1;
       }
       else
       {
@@ -225,15 +251,15 @@ namespace mtconnect::buffer {
         if (at == cps)
           return check;
 
-        auto ind = cps - m_firstSequence;
-        iter = m_slidingBuffer.cbegin() + ind;
-        end = iter + (at - cps) + 1;
+        index = cps - m_firstSequence;
+        end = index + (at - cps) + 1;
       }
 
       // Roll forward from the checkpoint.
-      while (iter != end)
+      while (index != end)
       {
-        check->addObservation(*iter++);
+        if (auto obs = observationAt(index++))
+          check->addObservation(obs);
       }
 
       return check;
@@ -241,6 +267,12 @@ namespace mtconnect::buffer {
     ///@}
 
     /// @brief Get a list of observations from the circular buffer
+    ///
+    /// If a history store is attached, the part of a forward request that begins before the
+    /// circular buffer is read from the history store. The buffered range is copied under the
+    /// sequence lock and the history store is read after it is released, so callers must not
+    /// hold the buffer lock across this call.
+    ///
     /// @param[in] count maximum number of observations to get
     /// @param[in] filterSet optional filter set of data item ids
     /// @param[in] start optional starting sequence
@@ -256,63 +288,109 @@ namespace mtconnect::buffer {
     {
       auto results = std::make_unique<observation::ObservationList>();
 
-      std::lock_guard<std::recursive_mutex> lock(m_sequenceLock);
-      firstSeq = m_firstSequence;
-      int limit, inc;
-
-      SequenceNumber_t first;
-      size_t max = m_slidingBuffer.size();
-
-      // Determine where to start and direction of iteration.
-      if (count >= 0)
+      bool history;
+      SequenceNumber_t bufferFirst;
       {
-        if (to)
+        std::lock_guard<std::recursive_mutex> lock(m_sequenceLock);
+        firstSeq = bufferFirst = m_firstSequence;
+        int limit, inc;
+
+        SequenceNumber_t first;
+        size_t max = bufferedCount();
+
+        // The evicted part of a forward range is read from the history store after the
+        // lock is released, so scan the circular buffer from its first sequence.
+        auto from = start;
+        history = m_history && !m_history->empty() && count >= 0 && start &&
+                  *start < m_firstSequence;
+        if (history && !to)
+          from = m_firstSequence;
+
+        // Determine where to start and direction of iteration.
+        if (count >= 0)
         {
-          if (start && *start > m_firstSequence)
-            firstSeq = *start;
-          first = *to;
-          inc = -1;
+          if (to)
+          {
+            if (from && *from > m_firstSequence)
+              firstSeq = *from;
+            first = *to;
+            inc = -1;
+          }
+          else
+          {
+            first = (from && *from > firstSeq) ? *from : firstSeq;
+            inc = 1;
+          }
+          limit = count;
         }
         else
         {
-          first = (start && *start > firstSeq) ? *start : firstSeq;
-          inc = 1;
+          first = (from && *from < m_sequence) ? *from : m_sequence - 1;
+          limit = -count;
+          inc = -1;
         }
-        limit = count;
-      }
-      else
-      {
-        first = (start && *start < m_sequence) ? *start : m_sequence - 1;
-        limit = -count;
-        inc = -1;
-      }
 
-      size_t min = firstSeq - m_firstSequence;
-      size_t i = first - m_firstSequence;
-      for (int added = 0; added < limit && i < max && i >= min; i += inc)
-      {
-        // Filter out according to if it exists in the list
-        auto &event = m_slidingBuffer[i];
-        if (!event->isOrphan())
+        size_t min = firstSeq - m_firstSequence;
+        size_t i = first - m_firstSequence;
+        for (int added = 0; added < limit && i < max && i >= min; i += inc)
         {
-          const std::string &dataId = event->getDataItem()->getId();
-          if (!filterSet || filterSet->count(dataId) > 0)
+          // Filter out according to if it exists in the list
+          if (included(i, filterSet))
           {
-            results->push_back(event);
-            added++;
+            if (auto event = observationAt(i))
+            {
+              results->push_back(event);
+              added++;
+            }
           }
         }
+
+        if (to)
+          end = first < m_sequence ? first + 1 : m_sequence;
+        else
+          end = m_firstSequence + i;
+
+        if (count >= 0)
+          endOfBuffer = i + m_firstSequence >= m_sequence;
+        else
+          endOfBuffer = i + m_firstSequence <= m_firstSequence;
       }
 
-      if (to)
-        end = first < m_sequence ? first + 1 : m_sequence;
-      else
-        end = m_firstSequence + i;
+      if (!history)
+        return results;
 
-      if (count >= 0)
-        endOfBuffer = i + m_firstSequence >= m_sequence;
-      else
-        endOfBuffer = i + m_firstSequence <= m_firstSequence;
+      if (!to)
+      {
+        // Read the evicted part of the range and keep as much of the buffered part as the
+        // count allows.
+        observation::ObservationList evicted;
+        auto next = m_history->getObservations(evicted, *start, bufferFirst, count, filterSet);
+        if (int(evicted.size()) >= count)
+        {
+          results->swap(evicted);
+          end = next;
+          endOfBuffer = false;
+        }
+        else
+        {
+          size_t keep = count - evicted.size();
+          if (results->size() > keep)
+          {
+            results->resize(keep);
+            end = results->back()->getSequence() + 1;
+            endOfBuffer = false;
+          }
+          results->insert(results->begin(), evicted.begin(), evicted.end());
+        }
+      }
+      else if (int(results->size()) < count)
+      {
+        // Continue a reverse scan into the history store
+        auto upper = std::min(*to + 1, bufferFirst);
+        m_history->getObservations(*results, *start, upper, count - int(results->size()),
+                                   filterSet, false);
+      }
+      firstSeq = getFirstAvailableSequence();
 
       return results;
     }
@@ -328,6 +406,40 @@ namespace mtconnect::buffer {
     auto try_lock() { return m_sequenceLock.try_lock(); }
     ///@}
 
+  protected:
+    /// @name Access to the sliding buffer in either representation
+    ///@{
+    size_t bufferedCount() const
+    {
+      return m_compact ? m_compactBuffer.size() : m_slidingBuffer.size();
+    }
+    bool isFull() const { return m_compact ? m_compactBuffer.full() : m_slidingBuffer.full(); }
+    observation::ObservationPtr observationAt(size_t index) const
+    {
+      return m_compact ? m_encoder.materialize(m_compactBuffer[index]) : m_slidingBuffer[index];
+    }
+    SequenceNumber_t sequenceAt(size_t index) const
+    {
+      return m_compact ? m_compactBuffer[index].m_sequence
+                       : m_slidingBuffer[index]->getSequence();
+    }
+    bool included(size_t index, const FilterSetOpt &filterSet) const
+    {
+      if (m_compact)
+      {
+        const auto &record = m_compactBuffer[index];
+        return !m_encoder.isOrphan(record) &&
+               (!filterSet || filterSet->count(m_encoder.getDataItemId(record)) > 0);
+      }
+      else
+      {
+        const auto &event = m_slidingBuffer[index];
+        return !event->isOrphan() &&
+               (!filterSet || filterSet->count(event->getDataItem()->getId()) > 0);
+      }
+    }
+    ///@}
+
   protected:
     // Access control to the buffer
     mutable std::recursive_mutex m_sequenceLock;
@@ -338,8 +450,13 @@ namespace mtconnect::buffer {
 
     // The sliding/circular buffer to hold all of the events/sample data
     unsigned int m_slidingBufferSize;
+    bool m_compact;
     boost::circular_buffer<observation::ObservationPtr> m_slidingBuffer;
 
+    // Compact representation used instead of the sliding buffer when enabled
+    boost::circular_buffer<CompactObservation> m_compactBuffer;
+    CompactEncoder m_encoder;
+
     // Checkpoints
     SequenceNumber_t m_checkpointFreq;
     SequenceNumber_t m_checkpointCount;
@@ -347,5 +464,9 @@ namespace mtconnect::buffer {
     Checkpoint m_latest;
     Checkpoint m_first;
     boost::circular_buffer<std::unique_ptr<Checkpoint>> m_checkpoints;
+
+    // Optional storage for observations evicted from the sliding buffer
+    std::unique_ptr<HistoryStore> m_history;
+    metrics::Histogram *m_lockWait {nullptr};
   };
 }  // namespace mtconnect::buffer
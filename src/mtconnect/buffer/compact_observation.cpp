@@ -0,0 +1,159 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#include "compact_observation.hpp"
+
+#include "mtconnect/device_model/data_item/data_item.hpp"
+#include "mtconnect/logging.hpp"
+
+using namespace std;
+
+namespace mtconnect {
+  using namespace observation;
+  using namespace entity;
+  namespace buffer {
+    uint32_t CompactEncoder::dataItemIndex(const DataItemPtr &dataItem)
+    {
+      auto [it, added] =
+          m_dataItemIndex.try_emplace(dataItem->getId(), uint32_t(m_dataItems.size()));
+      if (added)
+      {
+        m_dataItems.emplace_back(dataItem->getSlot());
+        m_dataItemIds.emplace_back(dataItem->getId());
+      }
+      else if (m_dataItems[it->second] != dataItem->getSlot())
+      {
+        m_dataItems[it->second] = dataItem->getSlot();
+      }
+
+      return it->second;
+    }
+
+    CompactObservation CompactEncoder::encode(const ObservationPtr &observation)
+    {
+      using Kind = CompactObservation::Kind;
+
+      CompactObservation record;
+      auto dataItem = observation->getDataItem();
+      record.m_sequence = observation->getSequence();
+      record.m_timestamp = observation->getTimestamp().time_since_epoch().count();
+      record.m_dataItem = dataItemIndex(dataItem);
+
+      auto overflow = [&]() {
+        record.m_kind = Kind::OVERFLOW_PTR;
+        record.m_overflow = observation;
+        return record;
+      };
+
+      if (dataItem->isCondition())
+        return overflow();
+
+      // Only observations where every other property comes from the data item can be compacted
+      const auto &diProps = dataItem->getObservationProperties();
+      for (const auto &[key, value] : observation->getProperties())
+      {
+        if (key != "VALUE" && key != "timestamp" && key != "sequence" && diProps.count(key) == 0)
+          return overflow();
+      }
+
+      if (observation->isUnavailable())
+      {
+        record.m_kind = Kind::UNAVAILABLE;
+        return record;
+      }
+
+      const auto &value = observation->getValue();
+      if (holds_alternative<double>(value))
+      {
+        record.m_kind = Kind::DOUBLE;
+        record.m_value.m_double = get<double>(value);
+      }
+      else if (holds_alternative<int64_t>(value))
+      {
+        record.m_kind = Kind::INTEGER;
+        record.m_value.m_integer = get<int64_t>(value);
+      }
+      else if (holds_alternative<string>(value))
+      {
+        const auto &s = get<string>(value);
+        auto it = m_stringIndex.find(s);
+        if (it == m_stringIndex.end())
+        {
+          if (m_strings.size() >= m_maxStrings)
+            return overflow();
+          it = m_stringIndex.emplace(s, uint32_t(m_strings.size())).first;
+          m_strings.push_back(s);
+        }
+        record.m_kind = Kind::STRING;
+        record.m_value.m_string = it->second;
+      }
+      else
+      {
+        return overflow();
+      }
+
+      return record;
+    }
+
+    ObservationPtr CompactEncoder::materialize(const CompactObservation &record) const
+    {
+      using Kind = CompactObservation::Kind;
+
+      if (record.m_kind == Kind::OVERFLOW_PTR)
+        return record.m_overflow;
+
+      auto dataItem = m_dataItems[record.m_dataItem]->m_dataItem.lock();
+      if (!dataItem)
+        return nullptr;
+
+      Properties props;
+      switch (record.m_kind)
+      {
+        case Kind::DOUBLE:
+          props.emplace("VALUE", record.m_value.m_double);
+          break;
+
+        case Kind::INTEGER:
+          props.emplace("VALUE", record.m_value.m_integer);
+          break;
+
+        case Kind::STRING:
+          props.emplace("VALUE", m_strings[record.m_value.m_string]);
+          break;
+
+        default:
+          break;
+      }
+
+      try
+      {
+        ErrorList errors;
+        auto obs = Observation::make(
+            dataItem, props, Timestamp(Timestamp::duration(record.m_timestamp)), errors);
+        obs->setSequence(record.m_sequence);
+        return obs;
+      }
+      catch (EntityError &e)
+      {
+        LOG(warning) << "Cannot materialize observation " << record.m_sequence << " for "
+                     << dataItem->getId() << ": " << e.what();
+      }
+
+      return nullptr;
+    }
+  }  // namespace buffer
+}  // namespace mtconnect
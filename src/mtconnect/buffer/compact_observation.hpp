@@ -0,0 +1,118 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mtconnect/config.hpp"
+#include "mtconnect/observation/observation.hpp"
+#include "mtconnect/utilities.hpp"
+
+namespace mtconnect::buffer {
+  /// @brief Fixed size representation of an observation in the circular buffer
+  ///
+  /// Scalar samples and events are stored as a data item index, timestamp, sequence and value.
+  /// Observations that cannot be represented this way, such as conditions, data sets, time
+  /// series or observations with additional properties, are kept in the overflow pointer.
+  struct CompactObservation
+  {
+    /// @brief The kind of value stored in the record
+    enum class Kind : uint8_t
+    {
+      OVERFLOW_PTR,  //! the observation is held in `m_overflow`
+      UNAVAILABLE,   //! the observation is unavailable
+      DOUBLE,        //! `m_value.m_double`
+      INTEGER,       //! `m_value.m_integer`
+      STRING         //! `m_value.m_string` is an index into the string table
+    };
+
+    observation::ObservationPtr m_overflow;
+    uint64_t m_sequence {0};
+    int64_t m_timestamp {0};
+    union
+    {
+      double m_double;
+      int64_t m_integer;
+      uint64_t m_string;
+    } m_value {0};
+    uint32_t m_dataItem {0};
+    Kind m_kind {Kind::OVERFLOW_PTR};
+  };
+
+  /// @brief Converts observations to and from the compact representation
+  ///
+  /// Holds the data item table and the interned string values referenced by the compact
+  /// records.
+  class AGENT_LIB_API CompactEncoder
+  {
+  public:
+    /// @brief Create an encoder
+    /// @param maxStrings the maximum number of distinct string values to intern. Once the limit
+    /// is reached, observations with new string values are stored in the overflow pointer.
+    CompactEncoder(size_t maxStrings = 4096) : m_maxStrings(maxStrings) {}
+
+    /// @brief Encode an observation
+    /// @param observation the observation with its sequence number set
+    /// @return the compact record
+    CompactObservation encode(const observation::ObservationPtr &observation);
+
+    /// @brief Create an observation from a compact record
+    /// @param record the record
+    /// @return the observation or `nullptr` if the data item no longer exists
+    observation::ObservationPtr materialize(const CompactObservation &record) const;
+
+    /// @brief get the data item id of a record without materializing it
+    /// @param record the record
+    /// @return the data item id
+    const std::string &getDataItemId(const CompactObservation &record) const
+    {
+      return m_dataItemIds[record.m_dataItem];
+    }
+
+    /// @brief check if the data item for the record has been removed
+    /// @param record the record
+    /// @return `true` if the data item no longer exists
+    bool isOrphan(const CompactObservation &record) const
+    {
+      if (record.m_kind == CompactObservation::Kind::OVERFLOW_PTR)
+        return record.m_overflow->isOrphan();
+      else
+        return m_dataItems[record.m_dataItem]->m_dataItem.expired();
+    }
+
+    /// @brief get the number of interned strings
+    /// @return number of strings
+    size_t getStringCount() const { return m_strings.size(); }
+
+  protected:
+    uint32_t dataItemIndex(const DataItemPtr &dataItem);
+
+  protected:
+    size_t m_maxStrings;
+
+    std::vector<DataItemSlotPtr> m_dataItems;
+    std::vector<std::string> m_dataItemIds;
+    std::unordered_map<std::string, uint32_t> m_dataItemIndex;
+
+    std::vector<std::string> m_strings;
+    std::unordered_map<std::string, uint32_t> m_stringIndex;
+  };
+}  // namespace mtconnect::buffer
@@ -0,0 +1,793 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#include "history_store.hpp"
+
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#include "mtconnect/device_model/data_item/data_item.hpp"
+#include "mtconnect/logging.hpp"
+
+using namespace std;
+
+namespace mtconnect {
+  using namespace observation;
+  using namespace entity;
+  namespace buffer {
+    namespace fs = std::filesystem;
+    namespace io = boost::iostreams;
+
+    static constexpr char BLOCK_MAGIC[] = {'M', 'T', 'C', 'H'};
+    static constexpr uint8_t BLOCK_VERSION = 1;
+    static constexpr const char *BLOCK_EXTENSION = ".mtch";
+
+    /// @brief Type tags for encoded property values
+    enum class ValueTag : uint8_t
+    {
+      EMPTY = 0,
+      STRING = 1,
+      INTEGER = 2,
+      DOUBLE = 3,
+      BOOL = 4,
+      VECTOR = 5,
+      DATA_SET = 6,
+      TIMESTAMP = 7
+    };
+
+    namespace {
+      /// @brief Append only byte encoder for the block columns
+      class Encoder
+      {
+      public:
+        void byte(uint8_t b) { m_buffer.push_back(char(b)); }
+        void varint(uint64_t v)
+        {
+          while (v >= 0x80)
+          {
+            byte(uint8_t(v) | 0x80);
+            v >>= 7;
+          }
+          byte(uint8_t(v));
+        }
+        void zigzag(int64_t v) { varint((uint64_t(v) << 1) ^ uint64_t(v >> 63)); }
+        void real(double d)
+        {
+          char b[sizeof(double)];
+          memcpy(b, &d, sizeof(double));
+          m_buffer.append(b, sizeof(double));
+        }
+        void string(const std::string &s)
+        {
+          varint(s.size());
+          m_buffer.append(s);
+        }
+
+        std::string m_buffer;
+      };
+
+      /// @brief Decoder for the block columns, throws if the block is truncated
+      class Decoder
+      {
+      public:
+        Decoder(const std::string &buffer) : m_buffer(buffer) {}
+
+        uint8_t byte()
+        {
+          if (m_pos >= m_buffer.size())
+            throw std::out_of_range("History block truncated");
+          return uint8_t(m_buffer[m_pos++]);
+        }
+        uint64_t varint()
+        {
+          uint64_t v = 0;
+          for (int shift = 0; shift < 64; shift += 7)
+          {
+            auto b = byte();
+            v |= uint64_t(b & 0x7F) << shift;
+            if ((b & 0x80) == 0)
+              break;
+          }
+          return v;
+        }
+        int64_t zigzag()
+        {
+          auto v = varint();
+          return int64_t(v >> 1) ^ -int64_t(v & 1);
+        }
+        double real()
+        {
+          if (m_pos + sizeof(double) > m_buffer.size())
+            throw std::out_of_range("History block truncated");
+          double d;
+          memcpy(&d, m_buffer.data() + m_pos, sizeof(double));
+          m_pos += sizeof(double);
+          return d;
+        }
+        std::string string()
+        {
+          auto len = varint();
+          if (m_pos + len > m_buffer.size())
+            throw std::out_of_range("History block truncated");
+          std::string s(m_buffer.data() + m_pos, len);
+          m_pos += len;
+          return s;
+        }
+
+        const std::string &m_buffer;
+        size_t m_pos {0};
+      };
+
+      /// @brief Assigns dense indexes to the strings used in a block
+      struct Dictionary
+      {
+        uint32_t index(const std::string &s)
+        {
+          auto [it, added] = m_map.try_emplace(s, uint32_t(m_strings.size()));
+          if (added)
+            m_strings.push_back(s);
+          return it->second;
+        }
+
+        std::unordered_map<std::string, uint32_t> m_map;
+        std::vector<std::string> m_strings;
+      };
+
+      template <typename V>
+      void encodeCell(Encoder &enc, const V &value)
+      {
+        enc.byte(uint8_t(value.index()));
+        visit(overloaded {[](const monostate &) {}, [&enc](const std::string &s) { enc.string(s); },
+                          [&enc](const int64_t &i) { enc.zigzag(i); },
+                          [&enc](const double &d) { enc.real(d); },
+                          [&enc](const TableRow &row) {
+                            enc.varint(row.size());
+                            for (const auto &cell : row)
+                            {
+                              enc.string(cell.m_key);
+                              enc.byte(cell.m_removed ? 1 : 0);
+                              encodeCell(enc, cell.m_value);
+                            }
+                          }},
+              value);
+      }
+
+      TableCellValue decodeTableCell(Decoder &dec)
+      {
+        switch (dec.byte())
+        {
+          case 1:
+            return dec.string();
+          case 2:
+            return dec.zigzag();
+          case 3:
+            return dec.real();
+          default:
+            return monostate {};
+        }
+      }
+
+      DataSetValue decodeDataSetValue(Decoder &dec)
+      {
+        switch (DataSetValueType(dec.byte()))
+        {
+          case DataSetValueType::TABLE_ROW:
+          {
+            TableRow row;
+            auto n = dec.varint();
+            for (uint64_t i = 0; i < n; i++)
+            {
+              auto key = dec.string();
+              bool removed = dec.byte() != 0;
+              row.emplace(key, decodeTableCell(dec), removed);
+            }
+            return row;
+          }
+          case DataSetValueType::STRING:
+            return dec.string();
+          case DataSetValueType::INTEGER:
+            return dec.zigzag();
+          case DataSetValueType::DOUBLE:
+            return dec.real();
+          default:
+            return monostate {};
+        }
+      }
+
+      /// @brief encode a property value, returns `false` if the type cannot be stored
+      bool encodeValue(Encoder &enc, Dictionary &dict, const Value &value)
+      {
+        return visit(
+            overloaded {[&enc](const monostate &) {
+                          enc.byte(uint8_t(ValueTag::EMPTY));
+                          return true;
+                        },
+                        [&enc, &dict](const std::string &s) {
+                          enc.byte(uint8_t(ValueTag::STRING));
+                          enc.varint(dict.index(s));
+                          return true;
+                        },
+                        [&enc](const int64_t &i) {
+                          enc.byte(uint8_t(ValueTag::INTEGER));
+                          enc.zigzag(i);
+                          return true;
+                        },
+                        [&enc](const double &d) {
+                          enc.byte(uint8_t(ValueTag::DOUBLE));
+                          enc.real(d);
+                          return true;
+                        },
+                        [&enc](const bool &b) {
+                          enc.byte(uint8_t(ValueTag::BOOL));
+                          enc.byte(b ? 1 : 0);
+                          return true;
+                        },
+                        [&enc](const Vector &v) {
+                          enc.byte(uint8_t(ValueTag::VECTOR));
+                          enc.varint(v.size());
+                          for (auto d : v)
+                            enc.real(d);
+                          return true;
+                        },
+                        [&enc](const DataSet &ds) {
+                          enc.byte(uint8_t(ValueTag::DATA_SET));
+                          enc.varint(ds.size());
+                          for (const auto &e : ds)
+                          {
+                            enc.string(e.m_key);
+                            enc.byte(e.m_removed ? 1 : 0);
+                            encodeCell(enc, e.m_value);
+                          }
+                          return true;
+                        },
+                        [&enc](const Timestamp &ts) {
+                          enc.byte(uint8_t(ValueTag::TIMESTAMP));
+                          enc.zigzag(ts.time_since_epoch().count());
+                          return true;
+                        },
+                        [](const auto &) { return false; }},
+            value);
+      }
+
+      Value decodeValue(Decoder &dec, const vector<std::string> &dict)
+      {
+        switch (ValueTag(dec.byte()))
+        {
+          case ValueTag::STRING:
+            return dict.at(dec.varint());
+          case ValueTag::INTEGER:
+            return dec.zigzag();
+          case ValueTag::DOUBLE:
+            return dec.real();
+          case ValueTag::BOOL:
+            return dec.byte() != 0;
+          case ValueTag::VECTOR:
+          {
+            Vector v(dec.varint());
+            for (auto &d : v)
+              d = dec.real();
+            return v;
+          }
+          case ValueTag::DATA_SET:
+          {
+            DataSet ds;
+            auto n = dec.varint();
+            for (uint64_t i = 0; i < n; i++)
+            {
+              auto key = dec.string();
+              bool removed = dec.byte() != 0;
+              ds.emplace(key, decodeDataSetValue(dec), removed);
+            }
+            return ds;
+          }
+          case ValueTag::TIMESTAMP:
+            return Timestamp(Timestamp::duration(dec.zigzag()));
+          default:
+            return monostate {};
+        }
+      }
+    }  // namespace
+
+    HistoryStore::HistoryStore(const fs::path &directory, size_t blockSize, size_t maxBlocks)
+      : m_directory(directory), m_blockSize(std::max<size_t>(blockSize, 1)), m_maxBlocks(maxBlocks)
+    {
+      NAMED_SCOPE("HistoryStore::HistoryStore");
+
+      // Sequence numbers restart with the agent, so blocks from a previous run are discarded
+      fs::create_directories(m_directory);
+      for (const auto &entry : fs::directory_iterator(m_directory))
+      {
+        if (entry.is_regular_file() && entry.path().extension() == BLOCK_EXTENSION)
+        {
+          std::error_code ec;
+          fs::remove(entry.path(), ec);
+        }
+      }
+
+      m_pending.reserve(m_blockSize);
+      m_writer = std::thread([this]() { writer(); });
+      LOG(info) << "History store in " << m_directory << " with " << m_blockSize
+                << " observations per block";
+    }
+
+    HistoryStore::~HistoryStore()
+    {
+      {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+        m_running = false;
+      }
+      m_ready.notify_all();
+      if (m_writer.joinable())
+        m_writer.join();
+
+      for (const auto &block : m_blocks)
+      {
+        std::error_code ec;
+        fs::remove(block.second.m_path, ec);
+      }
+    }
+
+    void HistoryStore::append(const ObservationPtr &observation)
+    {
+      std::lock_guard<std::recursive_mutex> lock(m_mutex);
+      if (observation->isOrphan())
+        return;
+
+      m_pending.push_back(observation);
+      if (m_pending.size() >= m_blockSize)
+        seal();
+    }
+
+    void HistoryStore::flush()
+    {
+      {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+        if (!m_pending.empty())
+          seal();
+      }
+      wait();
+    }
+
+    void HistoryStore::wait() const
+    {
+      std::unique_lock<std::recursive_mutex> lock(m_mutex);
+      m_written.wait(lock, [this]() { return m_sealing.empty() || !m_running; });
+    }
+
+    SequenceNumber_t HistoryStore::getFirstSequence() const
+    {
+      std::lock_guard<std::recursive_mutex> lock(m_mutex);
+      if (!m_blocks.empty())
+        return m_blocks.begin()->first;
+      else if (!m_sealing.empty())
+        return m_sealing.front()->front()->getSequence();
+      else if (!m_pending.empty())
+        return m_pending.front()->getSequence();
+      else
+        return 0;
+    }
+
+    SequenceNumber_t HistoryStore::getEndSequence() const
+    {
+      std::lock_guard<std::recursive_mutex> lock(m_mutex);
+      if (!m_pending.empty())
+        return m_pending.back()->getSequence() + 1;
+      else if (!m_sealing.empty())
+        return m_sealing.back()->back()->getSequence() + 1;
+      else if (!m_blocks.empty())
+        return m_blocks.rbegin()->second.m_last + 1;
+      else
+        return 0;
+    }
+
+    void HistoryStore::seal()
+    {
+      // The block stays readable from memory until the writer has it on disk
+      m_sealing.emplace_back(make_shared<const vector<ObservationPtr>>(std::move(m_pending)));
+      m_pending = {};
+      m_pending.reserve(m_blockSize);
+      m_ready.notify_one();
+    }
+
+    void HistoryStore::writer()
+    {
+      std::unique_lock<std::recursive_mutex> lock(m_mutex);
+      while (true)
+      {
+        m_ready.wait(lock, [this]() { return !m_sealing.empty() || !m_running; });
+        if (!m_running)
+          break;
+
+        auto pending = m_sealing.front();
+        lock.unlock();
+        auto block = write(*pending);
+        lock.lock();
+
+        if (block)
+        {
+          m_storedBytes += block->m_bytes;
+          m_blocks.emplace(block->m_first, std::move(*block));
+        }
+        m_sealing.pop_front();
+
+        while (m_maxBlocks > 0 && m_blocks.size() > m_maxBlocks)
+        {
+          auto oldest = m_blocks.begin();
+          std::error_code ec;
+          fs::remove(oldest->second.m_path, ec);
+          m_storedBytes -= oldest->second.m_bytes;
+          if (m_cached && m_cached->m_first == oldest->first)
+            m_cached.reset();
+          m_blocks.erase(oldest);
+        }
+
+        m_written.notify_all();
+      }
+      m_written.notify_all();
+    }
+
+    std::optional<HistoryStore::Block> HistoryStore::write(
+        const std::vector<ObservationPtr> &observations) const
+    {
+      NAMED_SCOPE("HistoryStore::write");
+
+      // Data items may have been removed while the observations were pending
+      std::vector<ObservationPtr> pending;
+      pending.reserve(observations.size());
+      for (const auto &obs : observations)
+        if (!obs->isOrphan())
+          pending.push_back(obs);
+      if (pending.empty())
+        return std::nullopt;
+
+      Dictionary dict;
+      Encoder seqs, times, ids, props;
+
+      SequenceNumber_t first = pending.front()->getSequence();
+      SequenceNumber_t lastSeq = first;
+      auto lastTime = pending.front()->getTimestamp().time_since_epoch().count();
+
+      for (const auto &obs : pending)
+      {
+        auto di = obs->getDataItem();
+        seqs.varint(obs->getSequence() - lastSeq);
+        lastSeq = obs->getSequence();
+        auto ts = obs->getTimestamp().time_since_epoch().count();
+        times.zigzag(ts - lastTime);
+        lastTime = ts;
+        ids.varint(dict.index(di->getId()));
+
+        // Only the properties that cannot be recovered from the data item are stored
+        const auto &diProps = di->getObservationProperties();
+        Encoder values;
+        uint64_t count = 0;
+        if (di->isCondition())
+        {
+          static const std::string levels[] = {"NORMAL", "WARNING", "FAULT", "UNAVAILABLE"};
+          auto cond = dynamic_pointer_cast<Condition>(obs);
+          values.varint(dict.index("level"));
+          encodeValue(values, dict, levels[cond->getLevel()]);
+          count++;
+        }
+        for (const auto &[key, value] : obs->getProperties())
+        {
+          if (key == "timestamp" || key == "sequence" || diProps.count(key) > 0)
+            continue;
+
+          Encoder enc;
+          if (encodeValue(enc, dict, value))
+          {
+            values.varint(dict.index(key.str()));
+            values.m_buffer.append(enc.m_buffer);
+            count++;
+          }
+        }
+        props.varint(count);
+        props.m_buffer.append(values.m_buffer);
+      }
+
+      Encoder block;
+      block.varint(pending.size());
+      block.varint(first);
+      block.zigzag(pending.front()->getTimestamp().time_since_epoch().count());
+      block.varint(dict.m_strings.size());
+      for (const auto &s : dict.m_strings)
+        block.string(s);
+      block.m_buffer.append(seqs.m_buffer);
+      block.m_buffer.append(times.m_buffer);
+      block.m_buffer.append(ids.m_buffer);
+      block.m_buffer.append(props.m_buffer);
+
+      std::string compressed(BLOCK_MAGIC, sizeof(BLOCK_MAGIC));
+      compressed.push_back(char(BLOCK_VERSION));
+      {
+        io::filtering_ostream out;
+        out.push(io::zlib_compressor(io::zlib::best_speed));
+        out.push(io::back_inserter(compressed));
+        out.write(block.m_buffer.data(), block.m_buffer.size());
+      }
+
+      Block index {first, lastSeq, pending.size(), compressed.size(),
+                   m_directory / (std::to_string(first) + BLOCK_EXTENSION)};
+      std::ofstream file(index.m_path, std::ios::binary | std::ios::trunc);
+      file.write(compressed.data(), compressed.size());
+      file.close();
+      if (!file)
+      {
+        LOG(error) << "Cannot write history block " << index.m_path
+                   << ", observations from " << first << " to " << lastSeq << " are discarded";
+        return std::nullopt;
+      }
+
+      LOG(trace) << "Sealed history block " << index.m_path << ": " << index.m_count
+                 << " observations in " << index.m_bytes << " bytes";
+      return index;
+    }
+
+    HistoryStore::DecodedPtr HistoryStore::load(const Block &block) const
+    {
+      NAMED_SCOPE("HistoryStore::load");
+
+      {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+        if (m_cached && m_cached->m_first == block.m_first)
+          return m_cached;
+      }
+
+      try
+      {
+        std::ifstream file(block.m_path, std::ios::binary);
+        if (!file)
+        {
+          // The writer removed the block after the index was copied
+          LOG(debug) << "History block was removed: " << block.m_path;
+          return nullptr;
+        }
+        std::string compressed((std::istreambuf_iterator<char>(file)),
+                               std::istreambuf_iterator<char>());
+        if (compressed.size() <= sizeof(BLOCK_MAGIC) ||
+            memcmp(compressed.data(), BLOCK_MAGIC, sizeof(BLOCK_MAGIC)) != 0 ||
+            uint8_t(compressed[sizeof(BLOCK_MAGIC)]) != BLOCK_VERSION)
+        {
+          LOG(error) << "Invalid history block: " << block.m_path;
+          return nullptr;
+        }
+
+        std::string buffer;
+        {
+          auto offset = sizeof(BLOCK_MAGIC) + 1;
+          io::filtering_istream in;
+          in.push(io::zlib_decompressor());
+          in.push(io::array_source(compressed.data() + offset, compressed.size() - offset));
+          io::copy(in, io::back_inserter(buffer));
+        }
+
+        Decoder dec(buffer);
+        auto decoded = make_shared<Decoded>();
+        auto count = dec.varint();
+        decoded->m_first = dec.varint();
+        auto time = dec.zigzag();
+        auto dictSize = dec.varint();
+        decoded->m_dictionary.reserve(dictSize);
+        for (uint64_t i = 0; i < dictSize; i++)
+          decoded->m_dictionary.emplace_back(dec.string());
+
+        decoded->m_records.resize(count);
+        auto seq = decoded->m_first;
+        for (auto &rec : decoded->m_records)
+          rec.m_sequence = seq += dec.varint();
+        for (auto &rec : decoded->m_records)
+          rec.m_timestamp = Timestamp(Timestamp::duration(time += dec.zigzag()));
+        for (auto &rec : decoded->m_records)
+          rec.m_dataItem = uint32_t(dec.varint());
+        for (auto &rec : decoded->m_records)
+        {
+          auto n = dec.varint();
+          for (uint64_t i = 0; i < n; i++)
+          {
+            const auto &key = decoded->m_dictionary.at(dec.varint());
+            rec.m_properties.insert_or_assign(key, decodeValue(dec, decoded->m_dictionary));
+          }
+        }
+
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+        m_cached = decoded;
+        return decoded;
+      }
+      catch (std::exception &e)
+      {
+        LOG(error) << "Cannot read history block " << block.m_path << ": " << e.what();
+      }
+
+      return nullptr;
+    }
+
+    ObservationPtr HistoryStore::materialize(const Decoded &block, const Record &record) const
+    {
+      if (!m_resolver)
+        return nullptr;
+
+      auto di = m_resolver(block.m_dictionary[record.m_dataItem]);
+      if (!di)
+        return nullptr;
+
+      try
+      {
+        ErrorList errors;
+        auto obs = Observation::make(di, record.m_properties, record.m_timestamp, errors);
+        obs->setSequence(record.m_sequence);
+        return obs;
+      }
+      catch (EntityError &e)
+      {
+        LOG(warning) << "Cannot restore observation " << record.m_sequence << " for "
+                     << di->getId() << ": " << e.what();
+      }
+
+      return nullptr;
+    }
+
+    bool HistoryStore::collect(ObservationList &list, const Decoded &block, const Record &record,
+                               const FilterSetOpt &filterSet) const
+    {
+      if (filterSet && filterSet->count(block.m_dictionary[record.m_dataItem]) == 0)
+        return false;
+
+      auto obs = materialize(block, record);
+      if (!obs)
+        return false;
+
+      list.push_back(obs);
+      return true;
+    }
+
+    SequenceNumber_t HistoryStore::getObservations(ObservationList &list, SequenceNumber_t from,
+                                                   SequenceNumber_t to, int count,
+                                                   const FilterSetOpt &filterSet,
+                                                   bool forward) const
+    {
+      NAMED_SCOPE("HistoryStore::getObservations");
+
+      int added = 0;
+      if (from >= to || count <= 0)
+        return forward ? from : to;
+
+      auto pendingMatch = [&](const ObservationPtr &obs) {
+        auto di = obs->getDataItem();
+        return di && (!filterSet || filterSet->count(di->getId()) > 0);
+      };
+
+      // Copy the index entries for the range and the blocks waiting for the writer and the
+      // pending observations, in sequence order, so the blocks are read and decoded without
+      // holding the lock that `append` needs.
+      std::vector<Block> blocks;
+      std::vector<PendingBlock> memory;
+      {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+        if (forward)
+        {
+          auto it = m_blocks.upper_bound(from);
+          if (it != m_blocks.begin())
+            it--;
+          for (; it != m_blocks.end() && it->first < to; it++)
+          {
+            if (it->second.m_last >= from)
+              blocks.push_back(it->second);
+          }
+        }
+        else
+        {
+          for (auto it = m_blocks.lower_bound(to); it != m_blocks.begin();)
+          {
+            it--;
+            if (it->second.m_last < from)
+              break;
+            blocks.push_back(it->second);
+          }
+        }
+
+        memory.assign(m_sealing.begin(), m_sealing.end());
+        if (!m_pending.empty() && m_pending.front()->getSequence() < to)
+          memory.push_back(make_shared<const vector<ObservationPtr>>(m_pending));
+      }
+
+      if (forward)
+      {
+        for (const auto &index : blocks)
+        {
+          auto block = load(index);
+          if (!block)
+            continue;
+          for (const auto &rec : block->m_records)
+          {
+            if (rec.m_sequence < from)
+              continue;
+            if (rec.m_sequence >= to)
+              return to;
+            if (collect(list, *block, rec, filterSet) && ++added >= count)
+              return rec.m_sequence + 1;
+          }
+        }
+
+        for (const auto &observations : memory)
+        {
+          for (const auto &obs : *observations)
+          {
+            auto seq = obs->getSequence();
+            if (seq < from)
+              continue;
+            if (seq >= to)
+              return to;
+            if (pendingMatch(obs))
+            {
+              list.push_back(obs);
+              if (++added >= count)
+                return seq + 1;
+            }
+          }
+        }
+
+        return to;
+      }
+      else
+      {
+        for (auto observations = memory.rbegin(); observations != memory.rend(); observations++)
+        {
+          for (auto it = (*observations)->rbegin(); it != (*observations)->rend(); it++)
+          {
+            auto seq = (*it)->getSequence();
+            if (seq >= to)
+              continue;
+            if (seq < from)
+              return seq + 1;
+            if (pendingMatch(*it))
+            {
+              list.push_back(*it);
+              if (++added >= count)
+                return seq;
+            }
+          }
+        }
+
+        for (const auto &index : blocks)
+        {
+          auto block = load(index);
+          if (!block)
+            continue;
+          for (auto rec = block->m_records.rbegin(); rec != block->m_records.rend(); rec++)
+          {
+            if (rec->m_sequence >= to)
+              continue;
+            if (rec->m_sequence < from)
+              return from;
+            if (collect(list, *block, *rec, filterSet) && ++added >= count)
+              return rec->m_sequence;
+          }
+        }
+
+        return from;
+      }
+    }
+  }  // namespace buffer
+}  // namespace mtconnect
@@ -0,0 +1,187 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mtconnect/config.hpp"
+#include "mtconnect/observation/observation.hpp"
+#include "mtconnect/utilities.hpp"
+
+namespace mtconnect::buffer {
+  using SequenceNumber_t = uint64_t;
+
+  /// @brief Second tier of observation storage for observations evicted from the circular buffer
+  ///
+  /// Observations are accumulated in memory until a block is full. The block is then handed to
+  /// a writer thread and sealed there, so the caller never waits on compression or disk I/O. The
+  /// observations are encoded column by column (sequence deltas, timestamp deltas,
+  /// dictionary coded data item ids, value type tags, typed values and the remaining
+  /// properties), compressed with zlib, and written to a single file in the history directory.
+  /// An in-memory index of the sequence range of each block is used to find the blocks for a
+  /// request and the most recently decoded block is cached. Observations are only materialized
+  /// when they are requested. Blocks waiting for the writer are served from memory.
+  class AGENT_LIB_API HistoryStore
+  {
+  public:
+    /// @brief Function used to map a data item id back to the current data item
+    using DataItemResolver = std::function<DataItemPtr(const std::string &id)>;
+
+    /// @brief Create a history store
+    /// @param directory the directory for the block files. Existing block files are removed.
+    /// @param blockSize the number of observations in a block
+    /// @param maxBlocks the maximum number of blocks to retain, `0` is unlimited
+    HistoryStore(const std::filesystem::path &directory, size_t blockSize = 4096,
+                 size_t maxBlocks = 0);
+    ~HistoryStore();
+
+    /// @brief Set the resolver used to find the data item when materializing observations
+    /// @param resolver the resolver
+    void setResolver(DataItemResolver resolver)
+    {
+      std::lock_guard<std::recursive_mutex> lock(m_mutex);
+      m_resolver = std::move(resolver);
+    }
+
+    /// @brief Add an observation evicted from the circular buffer
+    ///
+    /// Observations must be appended in sequence order.
+    ///
+    /// @param observation the observation
+    void append(const observation::ObservationPtr &observation);
+
+    /// @brief Seal the pending observations into a block and wait until it is written
+    void flush();
+    /// @brief Wait until the full blocks handed to the writer thread are written
+    void wait() const;
+
+    /// @brief get the first sequence number in the store
+    /// @return the first sequence or `0` if the store is empty
+    SequenceNumber_t getFirstSequence() const;
+    /// @brief get the sequence number after the last observation in the store
+    /// @return one greater than the last sequence or `0` if the store is empty
+    SequenceNumber_t getEndSequence() const;
+    /// @brief check if the store has any observations
+    /// @return `true` if there are no observations
+    bool empty() const { return getFirstSequence() == 0; }
+
+    /// @brief get the number of sealed blocks
+    /// @return the number of blocks
+    size_t getBlockCount() const
+    {
+      std::lock_guard<std::recursive_mutex> lock(m_mutex);
+      return m_blocks.size();
+    }
+    /// @brief get the number of bytes written for the sealed blocks
+    /// @return the number of bytes on disk
+    size_t getStoredBytes() const
+    {
+      std::lock_guard<std::recursive_mutex> lock(m_mutex);
+      return m_storedBytes;
+    }
+    /// @brief get the block size
+    /// @return the number of observations per block
+    size_t getBlockSize() const { return m_blockSize; }
+    /// @brief get the directory where the blocks are written
+    /// @return the directory path
+    const auto &getDirectory() const { return m_directory; }
+
+    /// @brief Get observations from the store for a sequence range
+    /// @param[out] list the list to append the observations to
+    /// @param[in] from the first sequence number
+    /// @param[in] to the sequence number after the last sequence to consider
+    /// @param[in] count the maximum number of observations to add
+    /// @param[in] filterSet optional filter set of data item ids
+    /// @param[in] forward `true` appends in ascending sequence order from `from`, `false` appends
+    /// in descending order from `to - 1`
+    /// @return for forward requests, the sequence after the last observation added or `to` if
+    /// the range was exhausted. For reverse requests, the sequence where the scan stopped.
+    SequenceNumber_t getObservations(observation::ObservationList &list, SequenceNumber_t from,
+                                     SequenceNumber_t to, int count,
+                                     const FilterSetOpt &filterSet, bool forward = true) const;
+
+  protected:
+    /// @brief An entry in the block index
+    struct Block
+    {
+      SequenceNumber_t m_first;
+      SequenceNumber_t m_last;
+      size_t m_count;
+      size_t m_bytes;
+      std::filesystem::path m_path;
+    };
+
+    /// @brief A decoded, but not materialized, record from a block
+    struct Record
+    {
+      SequenceNumber_t m_sequence;
+      Timestamp m_timestamp;
+      uint32_t m_dataItem;
+      entity::Properties m_properties;
+    };
+
+    /// @brief A decoded block
+    struct Decoded
+    {
+      SequenceNumber_t m_first;
+      std::vector<std::string> m_dictionary;
+      std::vector<Record> m_records;
+    };
+    using DecodedPtr = std::shared_ptr<const Decoded>;
+
+    using PendingBlock = std::shared_ptr<const std::vector<observation::ObservationPtr>>;
+
+    void seal();
+    void writer();
+    std::optional<Block> write(const std::vector<observation::ObservationPtr> &observations) const;
+    DecodedPtr load(const Block &block) const;
+    observation::ObservationPtr materialize(const Decoded &block, const Record &record) const;
+    bool collect(observation::ObservationList &list, const Decoded &block, const Record &record,
+                 const FilterSetOpt &filterSet) const;
+
+  protected:
+    mutable std::recursive_mutex m_mutex;
+
+    std::filesystem::path m_directory;
+    size_t m_blockSize;
+    size_t m_maxBlocks;
+    size_t m_storedBytes {0};
+    DataItemResolver m_resolver;
+
+    std::vector<observation::ObservationPtr> m_pending;
+    std::deque<PendingBlock> m_sealing;
+    std::map<SequenceNumber_t, Block> m_blocks;
+    mutable DecodedPtr m_cached;
+
+    bool m_running {true};
+    std::condition_variable_any m_ready;
+    mutable std::condition_variable_any m_written;
+    std::thread m_writer;
+  };
+}  // namespace mtconnect::buffer
@@ -42,6 +42,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <csignal>
 #include <date/date.h>
 #include <errno.h>
 #include <filesystem>
@@ -58,9 +59,13 @@
 #include "mtconnect/configuration/config_options.hpp"
 #include "mtconnect/device_model/device.hpp"
 #include "mtconnect/printer/xml_printer.hpp"
+#include "mtconnect/sink/historian_sink/historian_sink.hpp"
 #include "mtconnect/sink/mqtt_entity_sink/mqtt_entity_sink.hpp"
 #include "mtconnect/sink/mqtt_sink/mqtt_service.hpp"
 #include "mtconnect/sink/rest_sink/rest_service.hpp"
+#ifndef _WINDOWS
+#include "mtconnect/sink/shm_sink/shm_sink.hpp"
+#endif
 #include "mtconnect/source/adapter/agent_adapter/agent_adapter.hpp"
 #include "mtconnect/source/adapter/mqtt/mqtt_adapter.hpp"
 #include "mtconnect/source/adapter/shdr/shdr_adapter.hpp"
@@ -113,6 +118,10 @@ namespace mtconnect::configuration {
     sink::mqtt_sink::MqttService::registerFactory(m_sinkFactory);
     sink::rest_sink::RestService::registerFactory(m_sinkFactory);
     sink::mqtt_entity_sink::MqttEntitySink::registerFactory(m_sinkFactory);
+    sink::historian_sink::HistorianSink::registerFactory(m_sinkFactory);
+#ifndef _WINDOWS
+    sink::shm_sink::ShmSink::registerFactory(m_sinkFactory);
+#endif
     adapter::shdr::ShdrAdapter::registerFactory(m_sourceFactory);
     adapter::mqtt_adapter::MqttAdapter::registerFactory(m_sourceFactory);
     adapter::agent_adapter::AgentAdapter::registerFactory(m_sourceFactory);
@@ -154,6 +163,21 @@ namespace mtconnect::configuration {
 #endif
   }
 
+  static AgentConfiguration::FileFormat ConfigFileFormat(const fs::path &file)
+  {
+    if (file.string().ends_with("json"))
+    {
+      LOG(debug) << "Parsing json configuration";
+      return AgentConfiguration::JSON;
+    }
+    else if (file.string().ends_with("xml"))
+    {
+      LOG(debug) << "Parsing xml configuration";
+      return AgentConfiguration::XML;
+    }
+    return AgentConfiguration::MTCONNECT;
+  }
+
   void AgentConfiguration::initialize(const boost::program_options::variables_map &options)
   {
     NAMED_SCOPE("AgentConfiguration::initialize");
@@ -184,18 +208,7 @@ namespace mtconnect::configuration {
         std::stringstream buffer;
         buffer << file.rdbuf();
 
-        FileFormat fmt = MTCONNECT;
-        if (m_configFile.string().ends_with("json"))
-        {
-          LOG(debug) << "Parsing json configuration";
-          fmt = JSON;
-        }
-        else if (m_configFile.string().ends_with("xml"))
-        {
-          LOG(debug) << "Parsing xml configuration";
-          fmt = XML;
-        }
-        loadConfig(buffer.str(), fmt);
+        loadConfig(buffer.str(), ConfigFileFormat(m_configFile));
 
         return;
       }
@@ -327,32 +340,19 @@ namespace mtconnect::configuration {
       if (cfgTime != *m_configTime)
       {
         LOG(warning) << "Monitor thread has detected change in configuration files.";
-        LOG(warning) << ".... Restarting agent: " << m_configFile;
-
-        m_beforeStopHooks.exec(*this);
-        m_agent->stop();
-
-        m_context->pause(
-            [this](AsyncContext &context) {
-              m_agent.reset();
-              m_configTime.reset();
-              m_deviceTime.reset();
-
-              // Re initialize
-              boost::program_options::variables_map options;
-              boost::program_options::variable_value value(
-                  boost::optional<string>(m_configFile.string()), false);
-              options.insert(make_pair("config-file"s, value));
-              initialize(options);
-              m_beforeStartHooks.exec(*this);
-              m_agent->start();
-
-              if (m_monitorFiles)
-              {
-                scheduleMonitorTimer();
-              }
-            },
-            true);
+
+        m_context->pause([this, cfgTime](AsyncContext &context) {
+          if (reloadConfig())
+          {
+            // A change to the devices file will be picked up on the next check
+            m_configTime.emplace(cfgTime);
+            scheduleMonitorTimer();
+          }
+          else
+          {
+            boost::asio::post(context.get(), [this]() { restartAgent(); });
+          }
+        });
       }
       else if (devTime != *m_deviceTime)
       {
@@ -384,6 +384,57 @@ namespace mtconnect::configuration {
     return;
   }
 
+  bool AgentConfiguration::reloadConfig()
+  {
+    NAMED_SCOPE("AgentConfiguration::reloadConfig");
+
+    try
+    {
+      ifstream file(m_configFile.c_str());
+      std::stringstream buffer;
+      buffer << file.rdbuf();
+
+      return updateConfig(buffer.str(), ConfigFileFormat(m_configFile));
+    }
+    catch (std::exception &e)
+    {
+      LOG(warning) << "Cannot apply configuration changes from " << m_configFile << ": "
+                   << e.what();
+    }
+
+    return false;
+  }
+
+  void AgentConfiguration::restartAgent()
+  {
+    LOG(warning) << ".... Restarting agent: " << m_configFile;
+
+    m_beforeStopHooks.exec(*this);
+    m_agent->stop();
+
+    m_context->pause(
+        [this](AsyncContext &context) {
+          m_agent.reset();
+          m_configTime.reset();
+          m_deviceTime.reset();
+
+          // Re initialize
+          boost::program_options::variables_map options;
+          boost::program_options::variable_value value(
+              boost::optional<string>(m_configFile.string()), false);
+          options.insert(make_pair("config-file"s, value));
+          initialize(options);
+          m_beforeStartHooks.exec(*this);
+          m_agent->start();
+
+          if (m_monitorFiles)
+          {
+            scheduleMonitorTimer();
+          }
+        },
+        true);
+  }
+
   void AgentConfiguration::scheduleMonitorTimer()
   {
     using namespace chrono;
@@ -411,7 +462,22 @@ namespace mtconnect::configuration {
       AgentConfiguration::monitorFiles(ec);
     }
 
+    LOG(info) << "Starting " << m_workerThreadCount << " worker threads using "
+              << AsyncContext::IoBackend << " on " << m_context->getShardCount() << " io contexts";
     m_context->setThreadCount(m_workerThreadCount);
+#ifdef AGENT_PGO_GENERATE
+    if (!m_isService)
+    {
+      m_signals.emplace(m_context->get(), SIGTERM);
+      m_signals->async_wait([this](boost::system::error_code ec, int) {
+        if (!ec)
+        {
+          LOG(warning) << "terminate signal catched, stopping the agent";
+          stop();
+        }
+      });
+    }
+#endif
     m_beforeStartHooks.exec(*this);
     m_agent->start();
     return m_context->start();
@@ -422,6 +488,10 @@ namespace mtconnect::configuration {
     LOG(info) << "Agent stopping";
     m_beforeStopHooks.exec(*this);
     m_monitorTimer.cancel();
+#ifdef AGENT_PGO_GENERATE
+    if (m_signals)
+      m_signals->cancel();
+#endif
     m_restart = false;
     if (m_agent)
       m_agent->stop();
@@ -768,11 +838,8 @@ namespace mtconnect::configuration {
     ExpandValues(values, config);
   }
 
-  void AgentConfiguration::loadConfig(const std::string &text, FileFormat fmt)
+  pt::ptree AgentConfiguration::parseConfig(const std::string &text, FileFormat fmt)
   {
-    NAMED_SCOPE("AgentConfiguration::loadConfig");
-
-    // Now get our configuration
     boost::property_tree::ptree config;
 
     try
@@ -808,6 +875,16 @@ namespace mtconnect::configuration {
       throw;
     }
 
+    return config;
+  }
+
+  void AgentConfiguration::loadConfig(const std::string &text, FileFormat fmt)
+  {
+    NAMED_SCOPE("AgentConfiguration::loadConfig");
+
+    // Now get our configuration
+    auto config = parseConfig(text, fmt);
+
     if (m_logChannels.empty())
     {
       configureLogger(config);
@@ -826,7 +903,13 @@ namespace mtconnect::configuration {
                 {configuration::Devices, "Devices.xml"s},
                 {configuration::BufferSize, int(DEFAULT_SLIDING_BUFFER_EXP)},
                 {configuration::MaxAssets, int(DEFAULT_MAX_ASSETS)},
+                {configuration::AssetStoragePath, ""s},
+                {configuration::AssetCacheSize, 1024},
                 {configuration::CheckpointFrequency, 1000},
+                {configuration::CompactBuffer, false},
+                {configuration::HistoryPath, ""s},
+                {configuration::HistoryBlockSize, 4096},
+                {configuration::HistoryMaxBlocks, 0},
                 {configuration::LegacyTimeout, 600s},
                 {configuration::CreateUniqueIds, false},
                 {configuration::ReconnectInterval, 10000ms},
@@ -841,15 +924,26 @@ namespace mtconnect::configuration {
                 {configuration::EnableSourceDeviceModels, false},
                 {configuration::MinimumConfigReloadAge, 15s},
                 {configuration::Pretty, false},
+                {configuration::ObservationRenderCache, false},
+                {configuration::AssetRenderCache, false},
+                {configuration::LatencyMetrics, false},
                 {configuration::PidFile, "agent.pid"s},
                 {configuration::Port, 5000},
                 {configuration::MaxCachedFileSize, "20k"s},
                 {configuration::MinCompressFileSize, "100k"s},
+                {configuration::PrecompressFiles, false},
+                {configuration::MaxStreamBytesInFlight, "0"s},
+                {configuration::MaxStreamChunksInFlight, 0},
+                {configuration::MaxStreamLag, 0},
                 {configuration::ServiceName, "MTConnect Agent"s},
                 {configuration::SchemaVersion, ""s},
                 {configuration::LogStreams, false},
                 {configuration::ShdrVersion, 1},
                 {configuration::WorkerThreads, 1},
+                {configuration::WorkerSharding, "none"s},
+                {configuration::WorkerAffinity, false},
+                {configuration::WebsocketCompression, false},
+                {configuration::WebsocketCompressionLevel, 6},
                 {configuration::Sender, ""s},
                 {configuration::TlsCertificateChain, ""s},
                 {configuration::TlsPrivateKey, ""s},
@@ -865,6 +959,7 @@ namespace mtconnect::configuration {
                 {configuration::CorrectTimestamps, false}});
 
     m_workerThreadCount = *GetOption<int>(options, configuration::WorkerThreads);
+    configureWorkers(options);
     m_monitorFiles = *GetOption<bool>(options, configuration::MonitorConfigFiles);
     m_monitorInterval = *GetOption<Seconds>(options, configuration::MonitorInterval);
     m_monitorDelay = *GetOption<Seconds>(options, configuration::MinimumConfigReloadAge);
@@ -946,6 +1041,12 @@ namespace mtconnect::configuration {
         options[configuration::Sender] = name;
     }
 
+    // Keep the configuration to compare when the file changes
+    m_config = config;
+    m_options = options;
+    m_configuredSources.clear();
+    m_configuredSinks.clear();
+
     // Make the Agent
     m_agent = make_unique<Agent>(getAsyncContext(), m_devicesFile, options);
     m_afterAgentHooks.exec(*this);
@@ -979,6 +1080,143 @@ namespace mtconnect::configuration {
 #endif
   }
 
+  /// @brief The blocks of a configuration section that differ between two configurations
+  struct BlockChanges
+  {
+    std::set<std::string> m_removed;                   ///< removed or changed blocks
+    std::list<const pt::ptree::value_type *> m_added;  ///< added or changed blocks
+  };
+
+  /// @brief compare the named blocks of a section
+  /// @return `false` if a block name is repeated and the blocks cannot be matched
+  static bool DiffBlocks(const pt::ptree &from, const pt::ptree &to, const std::string &section,
+                         BlockChanges &changes)
+  {
+    std::map<std::string, const pt::ptree *> previous;
+    if (auto blocks = from.get_child_optional(section))
+    {
+      for (const auto &block : *blocks)
+      {
+        if (!previous.emplace(block.first, &block.second).second)
+          return false;
+      }
+    }
+
+    std::set<std::string> current;
+    if (auto blocks = to.get_child_optional(section))
+    {
+      for (const auto &block : *blocks)
+      {
+        if (!current.insert(block.first).second)
+          return false;
+
+        auto it = previous.find(block.first);
+        if (it == previous.end())
+        {
+          changes.m_added.push_back(&block);
+        }
+        else if (*it->second != block.second)
+        {
+          changes.m_removed.insert(block.first);
+          changes.m_added.push_back(&block);
+        }
+      }
+    }
+
+    for (const auto &block : previous)
+    {
+      if (current.count(block.first) == 0)
+        changes.m_removed.insert(block.first);
+    }
+
+    return true;
+  }
+
+  bool AgentConfiguration::updateConfig(const std::string &text, FileFormat fmt)
+  {
+    NAMED_SCOPE("AgentConfiguration::updateConfig");
+
+    if (!m_agent)
+      return false;
+
+    auto config = parseConfig(text, fmt);
+
+    // Any change outside of the Adapters and Sinks blocks requires a restart
+    auto global = [](ptree tree) {
+      tree.erase("Adapters");
+      tree.erase("Sinks");
+      return tree;
+    };
+    auto hasAdapters = [](const ptree &tree) { return bool(tree.get_child_optional("Adapters")); };
+    if (global(config) != global(m_config) || hasAdapters(config) != hasAdapters(m_config))
+    {
+      LOG(info) << "Configuration changed outside of the Adapters and Sinks";
+      return false;
+    }
+
+    BlockChanges adapters, sinks;
+    if (!DiffBlocks(m_config, config, "Adapters", adapters) ||
+        !DiffBlocks(m_config, config, "Sinks", sinks))
+    {
+      LOG(info) << "Adapters or Sinks have duplicate names, cannot match changes";
+      return false;
+    }
+
+    // Touching the configuration without changing it restarts the agent
+    if (adapters.m_removed.empty() && adapters.m_added.empty() && sinks.m_removed.empty() &&
+        sinks.m_added.empty())
+    {
+      LOG(info) << "No changes to the Adapters or Sinks";
+      return false;
+    }
+
+    // The REST service is configured from the top level options
+    auto isRest = [](const std::string &block) {
+      auto [factory, name] = entity::QName(block).getPair();
+      return (factory.empty() ? name : factory) == "RestService";
+    };
+    if (std::any_of(sinks.m_removed.begin(), sinks.m_removed.end(), isRest) ||
+        std::any_of(sinks.m_added.begin(), sinks.m_added.end(),
+                    [&isRest](auto block) { return isRest(block->first); }))
+    {
+      LOG(info) << "The RestService configuration changed";
+      return false;
+    }
+
+    for (const auto &name : sinks.m_removed)
+    {
+      if (auto it = m_configuredSinks.find(name); it != m_configuredSinks.end())
+      {
+        LOG(info) << "Removing sink: " << name;
+        m_agent->removeSink(it->second);
+        m_configuredSinks.erase(it);
+      }
+    }
+
+    for (const auto &name : adapters.m_removed)
+    {
+      if (auto it = m_configuredSources.find(name); it != m_configuredSources.end())
+      {
+        LOG(info) << "Removing adapter: " << name;
+        m_agent->removeSource(it->second);
+        m_configuredSources.erase(it);
+      }
+    }
+
+    for (auto block : sinks.m_added)
+      loadSink(config, *block, m_options, true);
+
+    for (auto block : adapters.m_added)
+      loadAdapter(config, *block, m_options, true);
+
+    LOG(info) << "Configuration updated: " << adapters.m_added.size() << " adapters and "
+              << sinks.m_added.size() << " sinks started, " << adapters.m_removed.size()
+              << " adapters and " << sinks.m_removed.size() << " sinks stopped";
+
+    m_config = std::move(config);
+    return true;
+  }
+
   void parseUrl(ConfigOptions &options)
   {
     using namespace mtconnect::url;
@@ -1006,6 +1244,25 @@ namespace mtconnect::configuration {
     }
   }
 
+  void AgentConfiguration::configureWorkers(const ConfigOptions &options)
+  {
+    NAMED_SCOPE("AgentConfiguration::configureWorkers");
+
+    m_context->setThreadCount(m_workerThreadCount);
+    m_context->setAffinity(*GetOption<bool>(options, configuration::WorkerAffinity));
+
+    auto sharding = *GetOption<string>(options, configuration::WorkerSharding);
+    if (sharding == "round_robin")
+      m_context->setSharding(Sharding::ROUND_ROBIN);
+    else if (sharding == "device_hash")
+      m_context->setSharding(Sharding::DEVICE_HASH);
+    else if (sharding != "none")
+      LOG(warning) << "Unknown WorkerSharding '" << sharding << "', worker threads are not sharded";
+
+    // A reload keeps the thread count of sharded workers
+    m_workerThreadCount = m_context->getThreadCount();
+  }
+
   void AgentConfiguration::loadAdapters(const pt::ptree &config, const ConfigOptions &options)
   {
     using namespace source::adapter;
@@ -1019,133 +1276,152 @@ namespace mtconnect::configuration {
     {
       for (const auto &block : *adapters)
       {
-        ConfigOptions adapterOptions = options;
+        loadAdapter(config, block, options);
+      }
+    }
+    else if ((device = getDefaultDevice()))
+    {
+      ConfigOptions adapterOptions {options};
 
-        GetOptions(block.second, adapterOptions, options);
-        // Erase the host and port so they can be properly defaulted.
-        adapterOptions.erase(configuration::Host);
-        adapterOptions.erase(configuration::Port);
+      auto deviceName = *device->getComponentName();
+      adapterOptions[configuration::Device] = deviceName;
+      LOG(info) << "Adding default adapter for " << device->getName() << " on localhost:7878";
 
-        AddOptions(block.second, adapterOptions,
-                   {{configuration::Url, string()},
-                    {configuration::Device, string()},
-                    {configuration::UUID, string()},
-                    {configuration::Host, string()},
-                    {configuration::Port, int32_t()},
-                    {configuration::Heartbeat, std::chrono::milliseconds()},
-                    {configuration::Uuid, string()}});
+      auto source = m_sourceFactory.make("shdr", "default", m_context->place(deviceName),
+                                         m_pipelineContext, adapterOptions, ptree {});
+      m_agent->addSource(source, false);
+    }
+    else if (m_agent->getDevices().size() > 1)
+    {
+      throw runtime_error("Adapters must be defined if more than one device is present");
+    }
+    else
+    {
+      LOG(warning) << "Starting with no devices or adapters";
+    }
+  }
 
-        if (HasOption(adapterOptions, configuration::Uuid) &&
-            !HasOption(adapterOptions, configuration::UUID))
-          adapterOptions[configuration::UUID] = adapterOptions[configuration::Uuid];
+  void AgentConfiguration::loadAdapter(const pt::ptree &config, const pt::ptree::value_type &block,
+                                       const ConfigOptions &options, bool start)
+  {
+    using namespace source::adapter;
+    using namespace pipeline;
 
-        auto qname = entity::QName(block.first);
-        auto [factory, name] = qname.getPair();
+    NAMED_SCOPE("AgentConfiguration::loadAdapter");
 
-        auto deviceName = GetOption<string>(adapterOptions, configuration::Device).value_or(name);
-        device = m_agent->getDeviceByName(deviceName);
+    ConfigOptions adapterOptions = options;
 
-        if (!device)
-        {
-          LOG(warning) << "Cannot locate device name '" << deviceName << "', trying default";
-          device = getDefaultDevice();
-          if (device)
-          {
-            deviceName = *device->getUuid();
-            adapterOptions[configuration::Device] = deviceName;
-            LOG(info) << "Assigning default device " << deviceName << " to adapter";
-          }
-        }
-        else
-        {
-          adapterOptions[configuration::Device] = *device->getUuid();
-        }
+    GetOptions(block.second, adapterOptions, options);
+    // Erase the host and port so they can be properly defaulted.
+    adapterOptions.erase(configuration::Host);
+    adapterOptions.erase(configuration::Port);
 
-        if (!device)
-        {
-          LOG(warning) << "Cannot locate device name '" << deviceName << "', assuming dynamic";
-        }
-        else if (auto uuid = GetOption<string>(adapterOptions, configuration::UUID))
-        {
-          // Set the UUID of the device
-          m_agent->deviceChanged(device, *uuid);
-          adapterOptions[configuration::Device] = *uuid;
-        }
+    AddOptions(block.second, adapterOptions,
+               {{configuration::Url, string()},
+                {configuration::Device, string()},
+                {configuration::UUID, string()},
+                {configuration::Host, string()},
+                {configuration::Port, int32_t()},
+                {configuration::Heartbeat, std::chrono::milliseconds()},
+                {configuration::Uuid, string()}});
 
-        auto preserve = GetOption<bool>(adapterOptions, configuration::PreserveUUID);
-        if (preserve && device)
-        {
-          device->setPreserveUuid(*preserve);
-        }
+    if (HasOption(adapterOptions, configuration::Uuid) &&
+        !HasOption(adapterOptions, configuration::UUID))
+      adapterOptions[configuration::UUID] = adapterOptions[configuration::Uuid];
 
-        auto additional = block.second.get_optional<string>(configuration::AdditionalDevices);
-        if (additional)
-        {
-          ConfigOption def {StringList()};
-          adapterOptions[configuration::AdditionalDevices] =
-              ConvertOption(*additional, def, options);
-        }
+    auto qname = entity::QName(block.first);
+    auto [factory, name] = qname.getPair();
 
-        // Get protocol, hosts, and topics from URL
-        if (HasOption(adapterOptions, configuration::Url))
-        {
-          parseUrl(adapterOptions);
-        }
+    auto deviceName = GetOption<string>(adapterOptions, configuration::Device).value_or(name);
+    auto device = m_agent->getDeviceByName(deviceName);
 
-        // Override if protocol if not specified
-        AddDefaultedOptions(block.second, adapterOptions, {{configuration::Protocol, "shdr"s}});
-        auto protocol = *GetOption<string>(adapterOptions, configuration::Protocol);
-
-        if (factory.empty())
-          factory = protocol;
-
-        if (!m_sourceFactory.hasFactory(factory) && !loadPlugin(factory, block.second))
-          continue;
+    if (!device)
+    {
+      LOG(warning) << "Cannot locate device name '" << deviceName << "', trying default";
+      device = getDefaultDevice();
+      if (device)
+      {
+        deviceName = *device->getUuid();
+        adapterOptions[configuration::Device] = deviceName;
+        LOG(info) << "Assigning default device " << deviceName << " to adapter";
+      }
+    }
+    else
+    {
+      adapterOptions[configuration::Device] = *device->getUuid();
+    }
 
-        auto blockOptions = block.second;
-        if (!blockOptions.get_child_optional("logger_config"))
-        {
-          auto logger = config.get_child_optional("logger_config");
-          if (logger)
-            blockOptions.add_child("logger_config", *logger);
-        }
+    if (!device)
+    {
+      LOG(warning) << "Cannot locate device name '" << deviceName << "', assuming dynamic";
+    }
+    else if (auto uuid = GetOption<string>(adapterOptions, configuration::UUID))
+    {
+      // Set the UUID of the device
+      m_agent->deviceChanged(device, *uuid);
+      adapterOptions[configuration::Device] = *uuid;
+    }
 
-        auto source = m_sourceFactory.make(factory, name, getAsyncContext(), m_pipelineContext,
-                                           adapterOptions, blockOptions);
+    auto preserve = GetOption<bool>(adapterOptions, configuration::PreserveUUID);
+    if (preserve && device)
+    {
+      device->setPreserveUuid(*preserve);
+    }
 
-        if (source)
-        {
-          m_agent->addSource(source, false);
-          LOG(info) << protocol << ": Adding adapter for " << deviceName << ": " << block.first;
-        }
-      }
+    auto additional = block.second.get_optional<string>(configuration::AdditionalDevices);
+    if (additional)
+    {
+      ConfigOption def {StringList()};
+      adapterOptions[configuration::AdditionalDevices] = ConvertOption(*additional, def, options);
     }
-    else if ((device = getDefaultDevice()))
+
+    // Get protocol, hosts, and topics from URL
+    if (HasOption(adapterOptions, configuration::Url))
     {
-      ConfigOptions adapterOptions {options};
+      parseUrl(adapterOptions);
+    }
 
-      auto deviceName = *device->getComponentName();
-      adapterOptions[configuration::Device] = deviceName;
-      LOG(info) << "Adding default adapter for " << device->getName() << " on localhost:7878";
+    // Override if protocol if not specified
+    AddDefaultedOptions(block.second, adapterOptions, {{configuration::Protocol, "shdr"s}});
+    auto protocol = *GetOption<string>(adapterOptions, configuration::Protocol);
 
-      auto source = m_sourceFactory.make("shdr", "default", getAsyncContext(), m_pipelineContext,
-                                         adapterOptions, ptree {});
-      m_agent->addSource(source, false);
-    }
-    else if (m_agent->getDevices().size() > 1)
+    if (factory.empty())
+      factory = protocol;
+
+    if (!m_sourceFactory.hasFactory(factory) && !loadPlugin(factory, block.second))
+      return;
+
+    auto blockOptions = block.second;
+    if (!blockOptions.get_child_optional("logger_config"))
     {
-      throw runtime_error("Adapters must be defined if more than one device is present");
+      auto logger = config.get_child_optional("logger_config");
+      if (logger)
+        blockOptions.add_child("logger_config", *logger);
     }
-    else
+
+    auto source = m_sourceFactory.make(factory, name, m_context->place(deviceName),
+                                       m_pipelineContext, adapterOptions, blockOptions);
+
+    if (source)
     {
-      LOG(warning) << "Starting with no devices or adapters";
+      m_agent->addSource(source, start);
+      m_configuredSources[block.first] = source;
+      LOG(info) << protocol << ": Adding adapter for " << deviceName << ": " << block.first;
     }
   }
 
 #ifdef WITH_PYTHON
   void AgentConfiguration::configurePython(const ptree &tree, ConfigOptions &options)
   {
-    m_python = make_unique<python::Embedded>(m_agent.get(), options);
+    ConfigOptions pythonOptions = options;
+
+    auto python = tree.get_child_optional("Python");
+    if (python)
+    {
+      GetOptions(*python, pythonOptions, options);
+      AddOptions(*python, pythonOptions, {{"Module", string()}, {"module", string()}});
+    }
+    m_python = make_unique<python::Embedded>(this, pythonOptions);
   }
 #endif
 
@@ -1177,42 +1453,7 @@ namespace mtconnect::configuration {
     {
       for (const auto &sinkBlock : *sinks)
       {
-        auto qname = entity::QName(sinkBlock.first);
-        auto [factory, name] = qname.getPair();
-
-        if (factory.empty())
-          factory = name;
-
-        if (!m_sinkFactory.hasFactory(factory))
-        {
-          if (!loadPlugin(factory, sinkBlock.second))
-            continue;
-        }
-
-        ConfigOptions sinkOptions = options;
-
-        GetOptions(sinkBlock.second, sinkOptions, options);
-        AddOptions(sinkBlock.second, sinkOptions, {{"Name", string()}});
-
-        ptree sinkBlockOptions = sinkBlock.second;
-        if (!sinkBlockOptions.get_child_optional("logger_config"))
-        {
-          auto logger = config.get_child_optional("logger_config");
-          if (logger)
-            sinkBlockOptions.add_child("logger_config", *logger);
-        }
-
-        auto sinkName = GetOption<string>(sinkOptions, "Name").value_or(name);
-        auto sinkContract = makeSinkContract();
-        sinkContract->m_pipelineContext = m_pipelineContext;
-
-        auto sink = m_sinkFactory.make(factory, sinkName, getAsyncContext(),
-                                       std::move(sinkContract), options, sinkBlockOptions);
-        if (sink)
-        {
-          m_agent->addSink(sink);
-          LOG(info) << "Loaded sink plugin " << sinkBlock.first;
-        }
+        loadSink(config, sinkBlock, options);
       }
     }
 
@@ -1229,6 +1470,50 @@ namespace mtconnect::configuration {
     }
   }
 
+  void AgentConfiguration::loadSink(const ptree &config, const ptree::value_type &sinkBlock,
+                                    ConfigOptions &options, bool start)
+  {
+    NAMED_SCOPE("AgentConfiguration::loadSink");
+
+    auto qname = entity::QName(sinkBlock.first);
+    auto [factory, name] = qname.getPair();
+
+    if (factory.empty())
+      factory = name;
+
+    if (!m_sinkFactory.hasFactory(factory))
+    {
+      if (!loadPlugin(factory, sinkBlock.second))
+        return;
+    }
+
+    ConfigOptions sinkOptions = options;
+
+    GetOptions(sinkBlock.second, sinkOptions, options);
+    AddOptions(sinkBlock.second, sinkOptions, {{"Name", string()}});
+
+    ptree sinkBlockOptions = sinkBlock.second;
+    if (!sinkBlockOptions.get_child_optional("logger_config"))
+    {
+      auto logger = config.get_child_optional("logger_config");
+      if (logger)
+        sinkBlockOptions.add_child("logger_config", *logger);
+    }
+
+    auto sinkName = GetOption<string>(sinkOptions, "Name").value_or(name);
+    auto sinkContract = makeSinkContract();
+    sinkContract->m_pipelineContext = m_pipelineContext;
+
+    auto sink = m_sinkFactory.make(factory, sinkName, getAsyncContext(),
+                                   std::move(sinkContract), options, sinkBlockOptions);
+    if (sink)
+    {
+      m_agent->addSink(sink, start);
+      m_configuredSinks[sinkBlock.first] = sink;
+      LOG(info) << "Loaded sink plugin " << sinkBlock.first;
+    }
+  }
+
   void AgentConfiguration::loadPlugins(const ptree &plugins)
   {
     NAMED_SCOPE("AgentConfiguration::loadPlugins");
@@ -130,6 +130,17 @@ namespace mtconnect {
       /// @param[in] fmt the file format, can be MTCONNECT, JSON, or XML
       void loadConfig(const std::string &text, FileFormat fmt = MTCONNECT);
 
+      /// @brief apply a changed configuration to the running agent
+      ///
+      /// Only the `Adapters` and `Sinks` blocks can change. The adapters and sinks whose blocks
+      /// were added, removed or changed are started or stopped; the buffers, sequence numbers and
+      /// instance id are preserved.
+      /// @param[in] text the configuration text loaded from a file
+      /// @param[in] fmt the file format, can be MTCONNECT, JSON, or XML
+      /// @return `true` if the changes were applied, `false` if nothing changed or the agent must
+      /// be restarted
+      bool updateConfig(const std::string &text, FileFormat fmt = MTCONNECT);
+
       /// @brief assign the agent associated with this configuration
       /// @param[in] agent the agent the configuration will take ownership of
       void setAgent(std::unique_ptr<Agent> &agent) { m_agent = std::move(agent); }
@@ -274,8 +285,16 @@ namespace mtconnect {
 
     protected:
       DevicePtr getDefaultDevice();
+      ptree parseConfig(const std::string &text, FileFormat fmt);
+      bool reloadConfig();
+      void restartAgent();
+      void configureWorkers(const ConfigOptions &options);
       void loadAdapters(const ptree &tree, const ConfigOptions &options);
+      void loadAdapter(const ptree &tree, const ptree::value_type &block,
+                       const ConfigOptions &options, bool start = false);
       void loadSinks(const ptree &sinks, ConfigOptions &options);
+      void loadSink(const ptree &tree, const ptree::value_type &block, ConfigOptions &options,
+                    bool start = false);
 
 #ifdef WITH_PYTHON
       void configurePython(const ptree &tree, ConfigOptions &options);
@@ -383,6 +402,12 @@ namespace mtconnect {
       pipeline::PipelineContextPtr m_pipelineContext;
       std::unique_ptr<source::adapter::Handler> m_adapterHandler;
 
+      // The loaded configuration and the sources and sinks created from its blocks
+      ptree m_config;
+      ConfigOptions m_options;
+      std::map<std::string, source::SourcePtr> m_configuredSources;
+      std::map<std::string, sink::SinkPtr> m_configuredSinks;
+
       std::string m_version;
       std::string m_devicesFile;
       std::filesystem::path m_exePath;
@@ -408,6 +433,11 @@ namespace mtconnect {
 
       int m_workerThreadCount {1};
 
+#ifdef AGENT_PGO_GENERATE
+      // Stops an instrumented agent on SIGTERM so it writes its profile when main returns
+      std::optional<boost::asio::signal_set> m_signals;
+#endif
+
       // Reference to the global logger
       boost::log::trivial::logger_type *m_logger {nullptr};
 
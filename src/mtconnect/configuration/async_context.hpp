@@ -20,12 +20,70 @@
 #include <boost/asio.hpp>
 #include <boost/thread/thread.hpp>
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include "mtconnect/config.hpp"
 #include "mtconnect/logging.hpp"
 #include "mtconnect/utilities.hpp"
 
 namespace mtconnect::configuration {
 
+  /// @brief How adapters and sessions are assigned to the io contexts of sharded worker threads
+  enum class Sharding
+  {
+    NONE,         ///< All worker threads share one io context
+    ROUND_ROBIN,  ///< Adapters and sessions are assigned in turn
+    DEVICE_HASH   ///< Adapters are assigned by the hash of their device, sessions in turn
+  };
+
+  /// @brief The io contexts of sharded worker threads
+  ///
+  /// Registered as a service of the primary io context so the servers and sources created on it
+  /// can place their connections on a shard without knowing about the AsyncContext.
+  class AGENT_LIB_API IoShards : public boost::asio::execution_context::service
+  {
+  public:
+    using key_type = IoShards;
+    static inline boost::asio::execution_context::id id;
+
+    /// @brief Construct the service for the primary io context
+    /// @param context the primary io context
+    IoShards(boost::asio::execution_context &context)
+      : boost::asio::execution_context::service(context)
+    {}
+
+    /// @brief Get the io context for a new adapter or session
+    /// @param key the device of an adapter, used when the placement is by device hash
+    /// @return the io context
+    boost::asio::io_context &place(const std::string &key = "")
+    {
+      if (m_placement == Sharding::DEVICE_HASH && !key.empty())
+        return *m_contexts[std::hash<std::string> {}(key) % m_contexts.size()];
+      else
+        return *m_contexts[m_next++ % m_contexts.size()];
+    }
+
+    /// @brief get the number of io contexts
+    /// @return the number of io contexts
+    auto size() const { return m_contexts.size(); }
+
+  protected:
+    friend class AsyncContext;
+    void shutdown() override {}
+
+  protected:
+    Sharding m_placement {Sharding::ROUND_ROBIN};
+    std::vector<boost::asio::io_context *> m_contexts;
+    std::atomic_size_t m_next {0};
+  };
+
   /// @brief Manages the boost asio context and allows for a syncronous
   ///        callback to execute when all the worker threads have stopped.
   class AGENT_LIB_API AsyncContext
@@ -34,6 +92,19 @@ namespace mtconnect::configuration {
     using SyncCallback = std::function<void(AsyncContext &context)>;
     using WorkGuard = boost::asio::executor_work_guard<boost::asio::io_context::executor_type>;
 
+    /// @brief The asio I/O backend the agent was built with
+#if defined(BOOST_ASIO_HAS_IO_URING) && defined(BOOST_ASIO_DISABLE_EPOLL)
+    static constexpr const char *IoBackend = "io_uring";
+#elif defined(BOOST_ASIO_HAS_EPOLL)
+    static constexpr const char *IoBackend = "epoll";
+#elif defined(BOOST_ASIO_HAS_KQUEUE)
+    static constexpr const char *IoBackend = "kqueue";
+#elif defined(BOOST_ASIO_HAS_IOCP)
+    static constexpr const char *IoBackend = "iocp";
+#else
+    static constexpr const char *IoBackend = "select";
+#endif
+
     /// @brief creates an asio context and a guard to prevent it from
     ///        stopping
     AsyncContext() { m_guard.emplace(m_context.get_executor()); }
@@ -60,8 +131,76 @@ namespace mtconnect::configuration {
     operator boost::asio::io_context &() { return m_context; }
 
     /// @brief sets the number of theads for asio thread pool
+    ///
+    /// Each shard has one thread, so the count cannot change once the workers are sharded.
     /// @param[in] threads number of threads
-    void setThreadCount(int threads) { m_threadCount = threads; }
+    void setThreadCount(int threads)
+    {
+      if (!m_shards.empty() && threads != m_threadCount)
+      {
+        LOG(warning) << "Worker threads are sharded, keeping " << m_threadCount
+                     << " threads until the agent process is restarted";
+        return;
+      }
+      m_threadCount = threads;
+    }
+    /// @brief get the number of threads for the asio thread pool
+    /// @return the number of threads
+    auto getThreadCount() const { return m_threadCount; }
+
+    /// @brief give each worker thread its own io context. Must be called after the thread count
+    ///        is set and before any adapters or servers are created.
+    ///
+    /// The first worker runs the primary context, which has the agent, sinks and timers. The
+    /// adapters and accepted sessions are spread over all the contexts, so the handlers of one
+    /// adapter or session never compete with other threads for the scheduler.
+    ///
+    /// The shards are kept for the life of the process. When the configuration is reloaded only
+    /// the placement of new adapters and sessions can change.
+    /// @param[in] placement how adapters and sessions are assigned to the contexts
+    void setSharding(Sharding placement)
+    {
+      if (!m_shards.empty())
+      {
+        if (placement == Sharding::NONE)
+          LOG(warning) << "Worker threads are sharded until the agent process is restarted";
+        else
+          boost::asio::use_service<IoShards>(m_context).m_placement = placement;
+        return;
+      }
+      if (placement == Sharding::NONE || m_threadCount < 2)
+        return;
+
+      auto &shards = boost::asio::make_service<IoShards>(m_context);
+      shards.m_placement = placement;
+      shards.m_contexts.push_back(&m_context);
+      for (int i = 1; i < m_threadCount; i++)
+      {
+        auto &context = m_shards.emplace_back(std::make_unique<boost::asio::io_context>(1));
+        m_shardGuards.emplace_back(context->get_executor());
+        shards.m_contexts.push_back(context.get());
+      }
+    }
+
+    /// @brief pin the worker threads to CPUs, worker `n` runs on CPU `n` modulo the number of
+    ///        CPUs. Only supported on Linux.
+    /// @param[in] affinity `true` to pin the threads
+    void setAffinity(bool affinity) { m_affinity = affinity; }
+
+    /// @brief get the number of io contexts the worker threads run
+    /// @return the number of io contexts
+    auto getShardCount() const { return m_shards.size() + 1; }
+
+    /// @brief get the io context for a new adapter or session
+    /// @param[in] key the device of an adapter, used when the placement is by device hash
+    /// @return the io context, the primary context if the workers are not sharded
+    boost::asio::io_context &place(const std::string &key = "")
+    {
+      if (m_shards.empty())
+        return m_context;
+      else
+        return boost::asio::use_service<IoShards>(m_context).place(key);
+    }
 
     /// @brief start `m_threadCount` worker threads
     /// @returns the exit code
@@ -76,10 +215,11 @@ namespace mtconnect::configuration {
         {
           for (int i = 0; i < m_threadCount; i++)
           {
-            m_workers.emplace_back(boost::thread([this]() {
+            auto &context = i == 0 || m_shards.empty() ? m_context : *m_shards[i - 1];
+            auto &worker = m_workers.emplace_back(boost::thread([this, &context]() {
               try
               {
-                m_context.run();
+                context.run();
               }
 
               catch (FatalException &e)
@@ -101,6 +241,8 @@ namespace mtconnect::configuration {
                 m_exitCode = 1;
               }
             }));
+            if (m_affinity)
+              pin(worker, i);
           }
           auto &first = m_workers.front();
           while (m_running && !m_paused)
@@ -108,7 +250,7 @@ namespace mtconnect::configuration {
             if (!first.try_join_for(boost::chrono::seconds(5)) && !m_running)
             {
               if (!first.try_join_for(boost::chrono::seconds(5)))
-                m_context.stop();
+                stopContexts();
             }
           }
 
@@ -165,9 +307,9 @@ namespace mtconnect::configuration {
       m_paused = true;
       m_syncCallback = callback;
       if (safeStop && m_guard)
-        m_guard.reset();
+        resetGuards();
       else
-        m_context.stop();
+        stopContexts();
     }
 
     /// @brief stop the worker threads
@@ -176,9 +318,9 @@ namespace mtconnect::configuration {
     {
       m_running = false;
       if (safeStop && m_guard)
-        m_guard.reset();
+        resetGuards();
       else
-        m_context.stop();
+        stopContexts();
     }
 
     /// @brief restarts the worker threads when paused
@@ -188,6 +330,12 @@ namespace mtconnect::configuration {
       if (!m_guard)
         m_guard.emplace(m_context.get_executor());
       m_context.restart();
+      for (auto &shard : m_shards)
+      {
+        if (m_shardGuards.size() < m_shards.size())
+          m_shardGuards.emplace_back(shard->get_executor());
+        shard->restart();
+      }
     }
 
     /// @name Cover methods for asio io_context
@@ -231,6 +379,34 @@ namespace mtconnect::configuration {
   private:
     void operator=(const AsyncContext &) {}
 
+  protected:
+    void resetGuards()
+    {
+      m_guard.reset();
+      m_shardGuards.clear();
+    }
+
+    void stopContexts()
+    {
+      m_context.stop();
+      for (auto &shard : m_shards)
+        shard->stop();
+    }
+
+    static void pin(boost::thread &worker, int index)
+    {
+#if defined(__linux__)
+      cpu_set_t cpus;
+      CPU_ZERO(&cpus);
+      auto cpu = index % std::max(1u, std::thread::hardware_concurrency());
+      CPU_SET(cpu, &cpus);
+      if (pthread_setaffinity_np(worker.native_handle(), sizeof(cpus), &cpus) != 0)
+        LOG(warning) << "Cannot pin worker thread " << index << " to CPU " << cpu;
+#else
+      LOG(warning) << "Worker thread affinity is not supported on this platform";
+#endif
+    }
+
   protected:
     boost::asio::io_context m_context;
     std::list<boost::thread> m_workers;
@@ -238,7 +414,11 @@ namespace mtconnect::configuration {
     std::optional<WorkGuard> m_guard;
     std::thread m_delayedStop;
 
+    std::vector<std::unique_ptr<boost::asio::io_context>> m_shards;
+    std::list<WorkGuard> m_shardGuards;
+
     int m_threadCount = 1;
+    bool m_affinity = false;
     bool m_running = false;
     bool m_paused = false;
     int m_exitCode = 0;
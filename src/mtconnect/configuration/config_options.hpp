@@ -46,19 +46,32 @@ namespace mtconnect {
     DECLARE_CONFIGURATION(DisableAgentDevice);
     DECLARE_CONFIGURATION(AllowPut);
     DECLARE_CONFIGURATION(AllowPutFrom);
+    DECLARE_CONFIGURATION(AssetCacheSize);
+    DECLARE_CONFIGURATION(AssetRenderCache);
+    DECLARE_CONFIGURATION(AssetStoragePath);
     DECLARE_CONFIGURATION(BufferSize);
     DECLARE_CONFIGURATION(CheckpointFrequency);
+    DECLARE_CONFIGURATION(CompactBuffer);
     DECLARE_CONFIGURATION(Devices);
+    DECLARE_CONFIGURATION(HistoryBlockSize);
+    DECLARE_CONFIGURATION(HistoryMaxBlocks);
+    DECLARE_CONFIGURATION(HistoryPath);
     DECLARE_CONFIGURATION(HttpHeaders);
     DECLARE_CONFIGURATION(JsonVersion);
+    DECLARE_CONFIGURATION(LatencyMetrics);
     DECLARE_CONFIGURATION(LogStreams);
     DECLARE_CONFIGURATION(MaxAssets);
     DECLARE_CONFIGURATION(MaxCachedFileSize);
+    DECLARE_CONFIGURATION(MaxStreamBytesInFlight);
+    DECLARE_CONFIGURATION(MaxStreamChunksInFlight);
+    DECLARE_CONFIGURATION(MaxStreamLag);
     DECLARE_CONFIGURATION(MinCompressFileSize);
     DECLARE_CONFIGURATION(MinimumConfigReloadAge);
     DECLARE_CONFIGURATION(MonitorConfigFiles);
     DECLARE_CONFIGURATION(MonitorInterval);
+    DECLARE_CONFIGURATION(ObservationRenderCache);
     DECLARE_CONFIGURATION(PidFile);
+    DECLARE_CONFIGURATION(PrecompressFiles);
     DECLARE_CONFIGURATION(Port);
     DECLARE_CONFIGURATION(Pretty);
     DECLARE_CONFIGURATION(SchemaVersion);
@@ -75,7 +88,11 @@ namespace mtconnect {
     DECLARE_CONFIGURATION(CreateUniqueIds);
     DECLARE_CONFIGURATION(VersionDeviceXml);
     DECLARE_CONFIGURATION(EnableSourceDeviceModels);
+    DECLARE_CONFIGURATION(WebsocketCompression);
+    DECLARE_CONFIGURATION(WebsocketCompressionLevel);
     DECLARE_CONFIGURATION(WorkerThreads);
+    DECLARE_CONFIGURATION(WorkerSharding);
+    DECLARE_CONFIGURATION(WorkerAffinity);
     DECLARE_CONFIGURATION(Validation);
     DECLARE_CONFIGURATION(CorrectTimestamps);
     ///@}
@@ -112,6 +129,23 @@ namespace mtconnect {
     DECLARE_CONFIGURATION(AssetTopicPrefix);
     ///@}
 
+    /// @name Shared Memory Sink Configuration
+    ///@{
+    DECLARE_CONFIGURATION(ShmName);
+    DECLARE_CONFIGURATION(ShmSlotCount);
+    DECLARE_CONFIGURATION(ShmTableSize);
+    ///@}
+
+    /// @name Historian Sink Configuration
+    ///@{
+    DECLARE_CONFIGURATION(HistorianPath);
+    DECLARE_CONFIGURATION(HistorianSegmentDuration);
+    DECLARE_CONFIGURATION(HistorianSegmentSize);
+    DECLARE_CONFIGURATION(HistorianFlushInterval);
+    DECLARE_CONFIGURATION(HistorianRetention);
+    DECLARE_CONFIGURATION(HistorianCompression);
+    ///@}
+
     /// @name Adapter Configuration
     ///@{
     DECLARE_CONFIGURATION(AdapterIdentity);
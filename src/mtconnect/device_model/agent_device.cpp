@@ -21,6 +21,7 @@
 #include "data_item/data_item.hpp"
 #include "mtconnect/configuration/config_options.hpp"
 #include "mtconnect/logging.hpp"
+#include "mtconnect/metrics/latency.hpp"
 #include "mtconnect/source/adapter/adapter.hpp"
 
 using namespace std;
@@ -78,6 +79,16 @@ namespace mtconnect {
           GetOption<bool>(adapter->getOptions(), config::SuppressIPAddress).value_or(false);
       auto id = adapter->getIdentity();
 
+      // An adapter that was reconfigured with the same identity keeps its component
+      if (auto children = m_adapters->getChildren())
+      {
+        for (const auto &child : *children)
+        {
+          if (child->maybeGet<std::string>("id") == id)
+            return;
+        }
+      }
+
       ErrorList errors;
       Properties attrs {{"id", id}};
       if (!suppress)
@@ -153,6 +164,85 @@ namespace mtconnect {
                                  errors);
         comp->addDataItem(di, errors);
       }
+
+      if (metrics::Registry::global().isEnabled())
+      {
+        for (const auto &stage : {"tokenize"s, "map"s, "filter"s, "deliver"s})
+        {
+          ErrorList errors;
+          auto subType = stage;
+          auto di = DataItem::make({{"type", "x:PIPELINE_LATENCY"s},
+                                    {"subType", toUpperCase(subType)},
+                                    {"id", id + "_" + stage + "_latency"},
+                                    {"units", "SECOND"s},
+                                    {"category", "SAMPLE"s}},
+                                   errors);
+          comp->addDataItem(di, errors);
+        }
+      }
+    }
+
+    ComponentPtr AgentDevice::removeAdapter(const source::adapter::AdapterPtr adapter)
+    {
+      auto id = adapter->getIdentity();
+      auto children = m_adapters->getChildren();
+      if (!children)
+        return nullptr;
+
+      for (const auto &child : *children)
+      {
+        if (child->maybeGet<std::string>("id") == id)
+        {
+          auto comp = dynamic_pointer_cast<Component>(child);
+          m_adapters->removeFromList("Components", child);
+
+          // Rebuild the indexes without the adapter's data items
+          Device::initialize();
+          return comp;
+        }
+      }
+
+      return nullptr;
+    }
+
+    void AgentDevice::addStreamMetrics()
+    {
+      using namespace entity;
+      using namespace device_model::data_item;
+      ErrorList errors;
+
+      auto lagging = DataItem::make(
+          {{"type", "x:LAGGING_STREAMS"s}, {"id", "lagging_streams"s}, {"category", "EVENT"s}},
+          errors);
+      addDataItem(lagging, errors);
+
+      auto coalesced = DataItem::make(
+          {{"type", "x:COALESCED_CHUNKS"s}, {"id", "coalesced_chunks"s}, {"category", "EVENT"s}},
+          errors);
+      addDataItem(coalesced, errors);
+    }
+
+    void AgentDevice::addLatencyMetrics()
+    {
+      using namespace entity;
+      using namespace device_model::data_item;
+
+      auto add = [this](const string &type, const optional<string> &subType, const string &id) {
+        ErrorList errors;
+        Properties props {
+            {"type", type}, {"id", id}, {"units", "SECOND"s}, {"category", "SAMPLE"s}};
+        if (subType)
+          props["subType"] = *subType;
+        addDataItem(DataItem::make(props, errors), errors);
+      };
+
+      add("x:BUFFER_LOCK_WAIT", nullopt, "buffer_lock_wait");
+      for (const auto &request : {"probe"s, "current"s, "sample"s, "assets"s})
+      {
+        auto subType = request;
+        add("x:RENDER_LATENCY", toUpperCase(subType), request + "_render_latency");
+      }
+      add("x:SESSION_WRITE_LATENCY", nullopt, "session_write_latency");
     }
 
     void AgentDevice::addRequiredDataItems()
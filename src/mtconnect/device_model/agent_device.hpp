@@ -56,6 +56,18 @@ namespace mtconnect {
       /// @brief Add an adapter and create a component to track it
       /// @param adapter the adapter
       void addAdapter(const source::adapter::AdapterPtr adapter);
+      /// @brief Remove the component tracking an adapter and its data items
+      /// @param adapter the adapter
+      /// @return the removed component or `nullptr` if the adapter does not have one
+      ComponentPtr removeAdapter(const source::adapter::AdapterPtr adapter);
+
+      /// @brief Add the data items counting streaming sessions that are lagging and the
+      /// coalesced chunks sent to them
+      void addStreamMetrics();
+
+      /// @brief Add the data items for the 99th percentile of the buffer lock wait, the render
+      /// time of each request and the session write time
+      void addLatencyMetrics();
 
       /// @brief get the connection status data item for an addapter
       /// @param adapter the adapter name
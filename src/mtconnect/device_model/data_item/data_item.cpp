@@ -74,6 +74,8 @@ namespace mtconnect {
             {"ResetTrigger", false}});
         factory->setFunction([](const std::string &name, Properties &props) -> EntityPtr {
           auto ptr = make_shared<DataItem>(name, props);
+          ptr->m_slot = make_shared<DataItemSlot>();
+          ptr->m_slot->m_dataItem = ptr;
           return dynamic_pointer_cast<Entity>(ptr);
         });
 
@@ -44,6 +44,17 @@ namespace mtconnect {
 
     /// @brief DataItem related entities
     namespace data_item {
+      class DataItem;
+
+      /// @brief Stable reference to a data item held by observations
+      ///
+      /// When a device model is updated, the slot is handed to the replacement data item with
+      /// the same id, so buffered observations resolve to the new data item without being visited.
+      struct DataItemSlot
+      {
+        std::weak_ptr<DataItem> m_dataItem;
+      };
+
       /// @brief Data Item entity
       class AGENT_LIB_API DataItem : public entity::Entity, public observation::ChangeSignaler
       {
@@ -178,6 +189,22 @@ namespace mtconnect {
         bool hasInitialValue() const { return bool(m_initialValue); }
         ///@}
 
+        /// @brief get the slot observations use to refer to this data item
+        /// @return shared pointer to the slot
+        const auto &getSlot() const { return m_slot; }
+        /// @brief take over the slot of the data item this one replaces
+        ///
+        /// Observations that referred to `previous` will refer to this data item.
+        /// @param[in] previous the data item being replaced
+        void rebind(DataItem &previous)
+        {
+          if (m_slot == previous.m_slot)
+            return;
+          auto self = m_slot->m_dataItem;
+          m_slot = previous.m_slot;
+          m_slot->m_dataItem = self;
+        }
+
         void makeDiscrete()
         {
           setProperty("discrete", true);
@@ -318,6 +345,9 @@ namespace mtconnect {
 
         // Conversions
         std::unique_ptr<UnitConversion> m_converter;
+
+        // Reference held by observations
+        std::shared_ptr<DataItemSlot> m_slot;
       };
 
       using DataItemPtr = std::shared_ptr<DataItem>;
@@ -325,5 +355,6 @@ namespace mtconnect {
   }    // namespace device_model
   using DataItemPtr = std::shared_ptr<device_model::data_item::DataItem>;
   using WeakDataItemPtr = std::weak_ptr<device_model::data_item::DataItem>;
+  using DataItemSlotPtr = std::shared_ptr<device_model::data_item::DataItemSlot>;
 
 }  // namespace mtconnect
@@ -21,7 +21,11 @@
 
 // #define BOOST_SPIRIT_DEBUG 1
 
+#include <cctype>
+#include <charconv>
 #include <ostream>
+#include <sstream>
+#include <vector>
 
 // Parser section
 #include <boost/config/warning_disable.hpp>
@@ -247,12 +251,153 @@ namespace mtconnect::entity {
     qi::rule<It, DataSetEntry()> m_tableEntry;
   };
 
+  /// @brief Scanner for data sets that only contain whitespace separated `key=value` pairs with
+  /// numeric or unquoted string values.
+  ///
+  /// This is the common case for adapter data and avoids the grammar. Anything the scanner is not
+  /// certain it interprets the same way as the grammar, such as quotes, braces, exponents without
+  /// a fraction or non-ASCII characters, is left to the grammar.
+  namespace SimpleDataSetScanner {
+    inline static bool isSpace(char c) { return std::isspace(static_cast<unsigned char>(c)); }
+    inline static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    /// @brief Check if the text only uses the simple syntax
+    inline static bool isSimple(const std::string &text)
+    {
+      for (const char c : text)
+      {
+        if ((c & 0x80) != 0 || c == '"' || c == '\'' || c == '{' || c == '}' || c == '|' ||
+            c == '\\')
+          return false;
+      }
+      return true;
+    }
+
+    /// @brief Convert the value of an entry
+    /// @return `false` if the grammar is required for the value
+    inline static bool convert(const char *first, const char *last, DataSetValue &value)
+    {
+      auto cp = first;
+      if (*cp == '+' || *cp == '-')
+        cp++;
+
+      auto digits = cp;
+      while (cp != last && isDigit(*cp))
+        cp++;
+      auto whole = cp - digits;
+
+      if (cp == last && whole > 0)
+      {
+        // Integer, use the grammar if it does not fit in 64 bits
+        int64_t v;
+        auto [ptr, ec] = std::from_chars(*first == '+' ? first + 1 : first, last, v);
+        if (ec != std::errc() || ptr != last)
+          return false;
+        value = v;
+        return true;
+      }
+      else if (whole > 0 && *cp == '.')
+      {
+        cp++;
+        auto fraction = cp;
+        while (cp != last && isDigit(*cp))
+          cp++;
+        if (cp == fraction)
+          return false;
+
+        if (cp != last && (*cp == 'e' || *cp == 'E'))
+        {
+          cp++;
+          if (cp != last && (*cp == '+' || *cp == '-'))
+            cp++;
+          auto exponent = cp;
+          while (cp != last && isDigit(*cp))
+            cp++;
+          if (cp == exponent)
+            return false;
+        }
+
+        double v;
+        if (cp != last || parseDouble(first, last, v) != last)
+          return false;
+        value = v;
+        return true;
+      }
+      else if (cp == first && *first != '.' && !isDigit(*first) && *first != 'n' &&
+               *first != 'N' && *first != 'i' && *first != 'I')
+      {
+        value.emplace<std::string>(first, last);
+        return true;
+      }
+
+      // Signs without numbers, partial numbers, nan and inf are left to the grammar
+      return false;
+    }
+
+    /// @brief Scan the text into a list of entries
+    /// @return `false` if the grammar is required
+    inline static bool scan(const std::string &text, std::vector<DataSetEntry> &entries)
+    {
+      if (!isSimple(text))
+        return false;
+
+      const char *cp = text.data();
+      const char *end = cp + text.size();
+      while (cp != end)
+      {
+        if (isSpace(*cp))
+        {
+          cp++;
+          continue;
+        }
+
+        auto key = cp;
+        while (cp != end && *cp != '=' && !isSpace(*cp))
+          cp++;
+        if (cp == key)
+          return false;
+
+        auto &entry = entries.emplace_back(std::string(key, cp));
+        if (cp == end || *cp != '=')
+        {
+          entry.m_removed = true;
+          continue;
+        }
+
+        auto value = ++cp;
+        while (cp != end && !isSpace(*cp))
+          cp++;
+
+        if (cp == value)
+          entry.m_removed = true;
+        else if (!convert(value, cp, entry.m_value))
+          return false;
+      }
+
+      return true;
+    }
+  }  // namespace SimpleDataSetScanner
+
   bool DataSet::parse(const std::string &text, bool table)
   {
     using boost::spirit::ascii::space;
 
+    if (!table)
+    {
+      std::vector<DataSetEntry> entries;
+      if (SimpleDataSetScanner::scan(text, entries))
+      {
+        for (auto &entry : entries)
+          emplace(std::move(entry));
+        return true;
+      }
+    }
+
+    // Building the grammar is expensive, so keep one of each kind per thread
     using Iterator = std::string::const_iterator;
-    DataSetParser<Iterator> parser(table);
+    static thread_local DataSetParser<Iterator> dataSetParser(false);
+    static thread_local DataSetParser<Iterator> tableParser(true);
+    auto &parser = table ? tableParser : dataSetParser;
 
     auto s = text.begin();
     auto e = text.end();
@@ -269,4 +414,55 @@ namespace mtconnect::entity {
       return false;
     }
   }
+
+  namespace {
+    struct DataSetFormatter
+    {
+      template <typename T>
+      void entries(const T &set)
+      {
+        bool first = true;
+        for (const auto &entry : set)
+        {
+          if (!first)
+            m_out << ' ';
+          first = false;
+          m_out << entry.m_key;
+          if (!entry.m_removed)
+          {
+            m_out << '=';
+            std::visit(*this, entry.m_value);
+          }
+        }
+      }
+
+      void operator()(const std::monostate &) {}
+      void operator()(const TableRow &row)
+      {
+        m_out << '{';
+        entries(row);
+        m_out << '}';
+      }
+      void operator()(const std::string &s)
+      {
+        if (s.find_first_of(" \t") == std::string::npos)
+          m_out << s;
+        else if (s.find('"') == std::string::npos)
+          m_out << '"' << s << '"';
+        else
+          m_out << '\'' << s << '\'';
+      }
+      void operator()(int64_t v) { m_out << v; }
+      void operator()(double v) { m_out << v; }
+
+      std::ostream &m_out;
+    };
+  }  // namespace
+
+  std::string DataSet::format() const
+  {
+    std::ostringstream out;
+    DataSetFormatter {out}.entries(*this);
+    return out.str();
+  }
 }  // namespace mtconnect::entity
@@ -239,5 +239,9 @@ namespace mtconnect::entity {
     /// @brief Split the data set entries by space delimiters and account for the
     /// use of single and double quotes as well as curly braces
     bool parse(const std::string &s, bool table);
+
+    /// @brief Format the entries in the SHDR `key=value` syntax accepted by `parse`
+    /// @returns the formatted text
+    std::string format() const;
   };
 }  // namespace mtconnect::entity
@@ -280,13 +280,13 @@ namespace mtconnect {
       /// @param entity entity to add
       /// @param errors errors if add fails
       /// @return `true` if successful
-      bool addToList(const std::string &name, FactoryPtr factory, EntityPtr entity,
-                     ErrorList &errors);
+      virtual bool addToList(const std::string &name, FactoryPtr factory, EntityPtr entity,
+                             ErrorList &errors);
       /// @brief Remove an entity from an entity list
       /// @param name the key for the entity list
       /// @param entity the entity to remove
       /// @return `true` if successful
-      bool removeFromList(const std::string &name, EntityPtr entity);
+      virtual bool removeFromList(const std::string &name, EntityPtr entity);
 
       /// @brief sets the `VALUE` property
       /// @param v the value
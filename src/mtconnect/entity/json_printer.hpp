@@ -25,13 +25,20 @@ namespace mtconnect::entity {
   using namespace mtconnect::printer;
 
   /// @brief Serializes entities as JSON text
-  template <typename T>
+  ///
+  /// The writer type selects pretty printing at compile time. When `Version` is not `0` the
+  /// printer is specialized for that JSON version and the version checks are resolved when it is
+  /// compiled, otherwise the version is given when the printer is created.
+  ///
+  /// @tparam T the rapidjson writer type
+  /// @tparam Version the JSON version or `0` for the version given to the constructor
+  template <typename T, uint32_t Version = 0>
   class AGENT_LIB_API JsonPrinter
   {
   protected:
     struct PropertyVisitor
     {
-      PropertyVisitor(T &writer, JsonPrinter<T> &printer, std::optional<AutoJsonObject<T>> &obj,
+      PropertyVisitor(T &writer, JsonPrinter &printer, std::optional<AutoJsonObject<T>> &obj,
                       const EntityPtr &entity)
         : m_obj(obj), m_printer(printer), m_entity(entity), m_writer(writer)
       {}
@@ -47,7 +54,7 @@ namespace mtconnect::entity {
         bool isPropertyList = *m_key != "LIST";
         if (m_entity->hasListWithAttribute())
         {
-          if (m_printer.m_version == 1)
+          if (m_printer.version() == 1)
           {
             m_obj->Key("list");
             m_printer.printEntityList(arg);
@@ -101,7 +108,7 @@ namespace mtconnect::entity {
       }
 
       std::optional<AutoJsonObject<T>> &m_obj;
-      JsonPrinter<T> &m_printer;
+      JsonPrinter &m_printer;
       const EntityPtr &m_entity;
       T &m_writer;
 
@@ -114,7 +121,19 @@ namespace mtconnect::entity {
     /// - Version 1 has a repreated objects in arrays for collections of objects
     /// - Version 2 combines arrays of objects by type
     JsonPrinter(T &writer, uint32_t version, bool includeHidden = false)
-      : m_version(version), m_writer(writer), m_includeHidden(includeHidden) {};
+      : m_version(Version == 0 ? version : Version),
+        m_writer(writer),
+        m_includeHidden(includeHidden) {};
+
+    /// @brief get the JSON version
+    /// @return the version, a constant if the printer is specialized for a version
+    uint32_t version() const
+    {
+      if constexpr (Version != 0)
+        return Version;
+      else
+        return m_version;
+    }
 
     /// @brief create a json object from an entity
     ///
@@ -150,15 +169,77 @@ namespace mtconnect::entity {
       }
     }
 
+    /// @brief Write an entity that only has scalar properties directly to the writer
+    ///
+    /// Most observations are samples, events and conditions with string, number and timestamp
+    /// properties. Their keys and values are written without the property visitor. Entities with
+    /// nested entities, lists, vectors or data sets are left for `printEntity()`.
+    ///
+    /// @param entity the entity
+    /// @return `true` if the entity was written, `false` if it has a complex property
+    bool printScalarEntity(const EntityPtr &entity)
+    {
+      const auto &properties = entity->getProperties();
+      for (const auto &prop : properties)
+      {
+        auto type = ValueType(prop.second.index());
+        if (type == ValueType::ENTITY || type == ValueType::ENTITY_LIST ||
+            type == ValueType::VECTOR || type == ValueType::DATA_SET)
+          return false;
+      }
+
+      JsonHelper<T> helper(m_writer);
+      m_writer.StartObject();
+      for (const auto &[key, value] : properties)
+      {
+        if (!m_includeHidden && entity->isHidden(key))
+          continue;
+
+        switch (ValueType(value.index()))
+        {
+          case ValueType::STRING:
+            printScalarKey(helper, key);
+            helper.Add(std::get<std::string>(value));
+            break;
+
+          case ValueType::INTEGER:
+            printScalarKey(helper, key);
+            m_writer.Int64(std::get<int64_t>(value));
+            break;
+
+          case ValueType::DOUBLE:
+            printScalarKey(helper, key);
+            helper.Add(std::get<double>(value));
+            break;
+
+          case ValueType::BOOL:
+            printScalarKey(helper, key);
+            m_writer.Bool(std::get<bool>(value));
+            break;
+
+          case ValueType::TIMESTAMP:
+            printScalarKey(helper, key);
+            print(std::get<Timestamp>(value));
+            break;
+
+          default:
+            break;
+        }
+      }
+      m_writer.EndObject();
+
+      return true;
+    }
+
     /// @brief Helper method to serialize a list entity list using json version 1 format
     /// @param[in] list a list of EntityPtr objects
     /// @tparam T2 Type of iterable collection must contain Entity subclass
     template <typename T2>
     void printEntityList(const T2 &list, bool embed = false)
     {
-      if (m_version == 1)
+      if (version() == 1)
         printEntityList1(list);
-      else if (m_version == 2)
+      else if (version() == 2)
         printEntityList2(list, embed);
       else
         throw std::runtime_error("Invalid json printer version");
@@ -227,6 +308,14 @@ namespace mtconnect::entity {
         obj.Key(key);
     }
 
+    void printScalarKey(JsonHelper<T> &helper, const PropertyKey &key)
+    {
+      if (key == "VALUE" || key == "RAW")
+        helper.Key("value");
+      else
+        helper.Key(key.str());
+    }
+
     struct DataSetVisitor
     {
       DataSetVisitor(T &writer, JsonPrinter &printer, AutoJsonObject<T> &obj)
@@ -283,7 +372,12 @@ namespace mtconnect::entity {
         }
       }
     }
-    void print(const Timestamp &t) { m_writer.String(format(t).c_str()); }
+    void print(const Timestamp &t)
+    {
+      char buffer[32];
+      auto text = formatTimestamp(t, buffer);
+      m_writer.String(text.data(), rapidjson::SizeType(text.size()));
+    }
 
   protected:
     uint32_t m_version;
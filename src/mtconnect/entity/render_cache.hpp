@@ -0,0 +1,119 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mtconnect/config.hpp"
+
+namespace mtconnect::entity {
+  /// @brief Cache of the serialized forms of an entity
+  ///
+  /// Holds the text generated by a printer so it can be reused for every document the entity
+  /// appears in. The entries are keyed by the printer format and version. Copying an entity does
+  /// not copy the cache since copies are made to be modified. The entries are only allocated
+  /// when the first text is added, so an entity that is never cached only pays for a pointer.
+  class AGENT_LIB_API RenderCache
+  {
+  public:
+    using Text = std::shared_ptr<const std::string>;
+
+    RenderCache() = default;
+    RenderCache(const RenderCache &) {}
+    RenderCache &operator=(const RenderCache &)
+    {
+      clear();
+      return *this;
+    }
+    ~RenderCache() { delete m_entries.load(std::memory_order_acquire); }
+
+    /// @brief get the cached text for a key
+    /// @param key the format key
+    /// @return the text or `nullptr` if it has not been rendered
+    Text get(uint32_t key) const
+    {
+      auto entries = m_entries.load(std::memory_order_acquire);
+      if (!entries)
+        return nullptr;
+
+      SpinLock lock(entries->m_lock);
+      for (const auto &[k, text] : entries->m_texts)
+        if (k == key)
+          return text;
+      return nullptr;
+    }
+
+    /// @brief add the rendered text for a key
+    /// @param key the format key
+    /// @param text the text
+    void put(uint32_t key, Text text) const
+    {
+      auto entries = m_entries.load(std::memory_order_acquire);
+      if (!entries)
+      {
+        // Another thread may be adding the first text at the same time
+        auto created = new Entries;
+        if (m_entries.compare_exchange_strong(entries, created, std::memory_order_acq_rel))
+          entries = created;
+        else
+          delete created;
+      }
+
+      SpinLock lock(entries->m_lock);
+      for (const auto &entry : entries->m_texts)
+        if (entry.first == key)
+          return;
+      entries->m_texts.emplace_back(key, std::move(text));
+    }
+
+    /// @brief remove all cached text
+    void clear()
+    {
+      // The entries are kept since a concurrent reader may be using them
+      if (auto entries = m_entries.load(std::memory_order_acquire))
+      {
+        SpinLock lock(entries->m_lock);
+        entries->m_texts.clear();
+      }
+    }
+
+  protected:
+    struct SpinLock
+    {
+      SpinLock(std::atomic_flag &flag) : m_flag(flag)
+      {
+        while (m_flag.test_and_set(std::memory_order_acquire))
+          ;
+      }
+      ~SpinLock() { m_flag.clear(std::memory_order_release); }
+      std::atomic_flag &m_flag;
+    };
+
+    struct Entries
+    {
+      std::atomic_flag m_lock = ATOMIC_FLAG_INIT;
+      std::vector<std::pair<uint32_t, Text>> m_texts;
+    };
+
+    mutable std::atomic<Entries *> m_entries {nullptr};
+  };
+}  // namespace mtconnect::entity
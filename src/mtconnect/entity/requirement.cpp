@@ -19,6 +19,7 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <algorithm>
 #include <cctype>
 #include <chrono>
 #include <cstdlib>
@@ -200,18 +201,24 @@ namespace mtconnect {
         if (arg.empty())
           return;
 
-        char *np(nullptr);
-        const char *cp = arg.c_str();
+        const char *cp = arg.data();
+        const char *end = cp + arg.size();
 
-        while (cp && *cp != '\0')
+        // Time series can have thousands of values, size the vector once assuming the values are
+        // separated by single spaces or tabs.
+        auto separators = std::count_if(cp, end, [](char c) { return c == ' ' || c == '\t'; });
+        r.reserve(r.size() + separators + 1);
+
+        while (cp != end)
         {
-          if (isspace(*cp))
+          if (isspace(static_cast<unsigned char>(*cp)))
           {
             cp++;
           }
           else
           {
-            double v = strtod(cp, &np);
+            double v;
+            auto np = parseDouble(cp, end, v);
             if (cp == np)
             {
               throw PropertyError("cannot convert string '" + arg + "' to vector");
@@ -0,0 +1,278 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#include "latency.hpp"
+
+#include <boost/asio/bind_executor.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <utility>
+
+#include "mtconnect/logging.hpp"
+
+using namespace std;
+
+namespace mtconnect::metrics {
+  uint64_t HistogramSnapshot::quantile(double q) const
+  {
+    if (m_count == 0)
+      return 0;
+
+    auto target = max<uint64_t>(1, uint64_t(ceil(q * double(m_count))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < m_counts.size(); i++)
+    {
+      seen += m_counts[i];
+      if (seen >= target)
+      {
+        auto limit = Histogram::bucketLimit(i);
+        return m_max > 0 ? min(limit, m_max) : limit;
+      }
+    }
+
+    return m_max;
+  }
+
+  void HistogramSnapshot::merge(const HistogramSnapshot &other)
+  {
+    if (m_counts.size() < other.m_counts.size())
+      m_counts.resize(other.m_counts.size());
+    for (size_t i = 0; i < other.m_counts.size(); i++)
+      m_counts[i] += other.m_counts[i];
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_max = max(m_max, other.m_max);
+  }
+
+  HistogramSnapshot HistogramSnapshot::since(const HistogramSnapshot &earlier) const
+  {
+    HistogramSnapshot res;
+    res.m_counts = m_counts;
+    for (size_t i = 0; i < earlier.m_counts.size() && i < res.m_counts.size(); i++)
+      res.m_counts[i] -= earlier.m_counts[i];
+    res.m_count = m_count - earlier.m_count;
+    res.m_sum = m_sum - earlier.m_sum;
+    return res;
+  }
+
+  size_t Histogram::bucketFor(uint64_t ns)
+  {
+    if (ns < LinearBuckets)
+      return size_t(ns);
+
+    ns = min(ns, (uint64_t(1) << MaxExponent) - 1);
+    unsigned exponent = std::bit_width(ns) - 1;
+    auto sub = (ns >> (exponent - SubBucketBits)) - SubBuckets;
+    return LinearBuckets + (exponent - SubBucketBits - 1) * SubBuckets + size_t(sub);
+  }
+
+  uint64_t Histogram::bucketLimit(size_t bucket)
+  {
+    if (bucket < LinearBuckets)
+      return uint64_t(bucket);
+
+    auto exponent = unsigned((bucket - LinearBuckets) / SubBuckets) + SubBucketBits + 1;
+    auto sub = uint64_t((bucket - LinearBuckets) % SubBuckets);
+    auto width = uint64_t(1) << (exponent - SubBucketBits);
+    return (SubBuckets + sub) * width + width - 1;
+  }
+
+  size_t Histogram::shardIndex()
+  {
+    static atomic<size_t> next {0};
+    thread_local size_t index = next++ % ShardCount;
+    return index;
+  }
+
+  void Histogram::record(uint64_t ns)
+  {
+    auto &shard = m_shards[shardIndex()];
+    shard.m_counts[bucketFor(ns)].fetch_add(1, memory_order_relaxed);
+    shard.m_sum.fetch_add(ns, memory_order_relaxed);
+
+    auto max = shard.m_max.load(memory_order_relaxed);
+    while (ns > max && !shard.m_max.compare_exchange_weak(max, ns, memory_order_relaxed))
+    {}
+  }
+
+  HistogramSnapshot Histogram::snapshot() const
+  {
+    HistogramSnapshot res;
+    res.m_counts.resize(BucketCount);
+    for (const auto &shard : m_shards)
+    {
+      for (size_t i = 0; i < BucketCount; i++)
+      {
+        auto c = shard.m_counts[i].load(memory_order_relaxed);
+        res.m_counts[i] += c;
+        res.m_count += c;
+      }
+      res.m_sum += shard.m_sum.load(memory_order_relaxed);
+      res.m_max = max(res.m_max, shard.m_max.load(memory_order_relaxed));
+    }
+    return res;
+  }
+
+  Clock::duration StageTimer::exchangeNested(Clock::duration nested)
+  {
+    thread_local Clock::duration current {Clock::duration::zero()};
+    return std::exchange(current, nested);
+  }
+
+  Registry &Registry::global()
+  {
+    static Registry registry;
+    return registry;
+  }
+
+  Histogram *Registry::histogram(const std::string &name, const std::string &help,
+                                 const Labels &labels, const std::optional<std::string> &dataItem)
+  {
+    if (!m_enabled)
+      return nullptr;
+
+    lock_guard<mutex> lock(m_lock);
+    auto &family = m_families[name];
+    if (family.m_help.empty())
+      family.m_help = help;
+
+    auto &entry = family.m_entries[labels];
+    if (!entry.m_histogram)
+    {
+      entry.m_histogram = make_unique<Histogram>();
+      entry.m_dataItem = dataItem;
+    }
+    return entry.m_histogram.get();
+  }
+
+  namespace {
+    void printLabels(std::ostream &out, const Labels &labels, const char *quantile = nullptr)
+    {
+      if (labels.empty() && !quantile)
+        return;
+
+      out << '{';
+      bool first = true;
+      for (const auto &[key, value] : labels)
+      {
+        if (!first)
+          out << ',';
+        first = false;
+        out << key << "=\"";
+        for (auto c : value)
+        {
+          if (c == '\\' || c == '"')
+            out << '\\' << c;
+          else if (c == '\n')
+            out << "\\n";
+          else
+            out << c;
+        }
+        out << '"';
+      }
+      if (quantile)
+        out << (first ? "" : ",") << "quantile=\"" << quantile << '"';
+      out << '}';
+    }
+  }  // namespace
+
+  void Registry::printPrometheus(std::ostream &out) const
+  {
+    static constexpr pair<const char *, double> quantiles[] {
+        {"0.5", 0.5}, {"0.9", 0.9}, {"0.99", 0.99}, {"0.999", 0.999}};
+
+    lock_guard<mutex> lock(m_lock);
+    for (const auto &[name, family] : m_families)
+    {
+      out << "# HELP " << name << ' ' << family.m_help << '\n';
+      out << "# TYPE " << name << " summary\n";
+      for (const auto &[labels, entry] : family.m_entries)
+      {
+        auto snapshot = entry.m_histogram->snapshot();
+        for (const auto &[text, q] : quantiles)
+        {
+          out << name;
+          printLabels(out, labels, text);
+          out << ' ' << double(snapshot.quantile(q)) / 1e9 << '\n';
+        }
+        out << name << "_sum";
+        printLabels(out, labels);
+        out << ' ' << double(snapshot.m_sum) / 1e9 << '\n';
+        out << name << "_count";
+        printLabels(out, labels);
+        out << ' ' << snapshot.m_count << '\n';
+      }
+    }
+  }
+
+  std::map<std::string, HistogramSnapshot> Registry::snapshotByDataItem() const
+  {
+    std::map<std::string, HistogramSnapshot> res;
+    lock_guard<mutex> lock(m_lock);
+    for (const auto &[name, family] : m_families)
+    {
+      for (const auto &[labels, entry] : family.m_entries)
+      {
+        if (entry.m_dataItem)
+          res[*entry.m_dataItem].merge(entry.m_histogram->snapshot());
+      }
+    }
+    return res;
+  }
+
+  void LatencyReporter::start()
+  {
+    m_running = true;
+    m_last = m_registry.snapshotByDataItem();
+    schedule();
+  }
+
+  void LatencyReporter::stop()
+  {
+    m_running = false;
+    m_timer.cancel();
+  }
+
+  void LatencyReporter::schedule()
+  {
+    m_timer.expires_after(m_interval);
+    m_timer.async_wait(boost::asio::bind_executor(
+        m_strand, [self = shared_from_this()](boost::system::error_code ec) {
+          if (!ec && self->m_running)
+          {
+            self->report();
+            self->schedule();
+          }
+        }));
+  }
+
+  void LatencyReporter::report()
+  {
+    NAMED_SCOPE("LatencyReporter::report");
+
+    auto current = m_registry.snapshotByDataItem();
+    for (const auto &[id, snapshot] : current)
+    {
+      auto interval = snapshot.since(m_last[id]);
+      if (interval.m_count > 0)
+        m_publish(id, double(interval.quantile(0.99)) / 1e9);
+    }
+    m_last = std::move(current);
+  }
+}  // namespace mtconnect::metrics
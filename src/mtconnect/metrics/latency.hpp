@@ -0,0 +1,297 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <boost/asio/io_context_strand.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "mtconnect/config.hpp"
+
+namespace mtconnect {
+  /// @brief Low overhead latency instrumentation
+  namespace metrics {
+    using Clock = std::chrono::steady_clock;
+    using Labels = std::map<std::string, std::string>;
+
+    /// @brief The merged counts of a histogram at a point in time
+    struct AGENT_LIB_API HistogramSnapshot
+    {
+      /// @brief get the value at a quantile
+      /// @param q the quantile from 0 to 1
+      /// @return the largest value in nanoseconds of the bucket holding the quantile
+      uint64_t quantile(double q) const;
+      /// @brief add the counts of another snapshot
+      /// @param other the other snapshot
+      void merge(const HistogramSnapshot &other);
+      /// @brief get the counts recorded after an earlier snapshot
+      /// @param earlier an earlier snapshot of the same histogram
+      /// @return the difference, the maximum is not known for the interval
+      HistogramSnapshot since(const HistogramSnapshot &earlier) const;
+
+      std::vector<uint64_t> m_counts;
+      uint64_t m_count {0};
+      uint64_t m_sum {0};  ///< Sum of the values in nanoseconds
+      uint64_t m_max {0};  ///< Largest value in nanoseconds, `0` if not known
+    };
+
+    /// @brief A histogram of latencies with logarithmic buckets
+    ///
+    /// Values are in nanoseconds. Values below 32ns have their own bucket, above that each power
+    /// of two is divided into 16 buckets so a value is reported within 1/16 of its magnitude.
+    /// Each thread records into one of a few shards to keep the writers apart, the shards are
+    /// merged when the histogram is read.
+    class AGENT_LIB_API Histogram
+    {
+    public:
+      static constexpr unsigned SubBucketBits = 4;
+      static constexpr unsigned SubBuckets = 1u << SubBucketBits;
+      static constexpr unsigned LinearBuckets = 2u * SubBuckets;
+      /// @brief Values are capped at 2^40ns, about 18 minutes
+      static constexpr unsigned MaxExponent = 40;
+      static constexpr size_t BucketCount =
+          LinearBuckets + (MaxExponent - SubBucketBits - 1) * SubBuckets;
+      static constexpr size_t ShardCount = 4;
+
+      /// @brief record a value
+      /// @param ns the value in nanoseconds
+      void record(uint64_t ns);
+      /// @brief record a duration
+      /// @param d the duration, negative durations are recorded as `0`
+      void record(Clock::duration d)
+      {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+        record(ns > 0 ? uint64_t(ns) : uint64_t(0));
+      }
+
+      /// @brief merge the shards
+      /// @return the snapshot
+      HistogramSnapshot snapshot() const;
+
+      /// @brief get the bucket for a value
+      /// @param ns the value in nanoseconds
+      /// @return the bucket index
+      static size_t bucketFor(uint64_t ns);
+      /// @brief get the largest value in a bucket
+      /// @param bucket the bucket index
+      /// @return the value in nanoseconds
+      static uint64_t bucketLimit(size_t bucket);
+
+    protected:
+      struct alignas(64) Shard
+      {
+        std::array<std::atomic<uint64_t>, BucketCount> m_counts {};
+        std::atomic<uint64_t> m_sum {0};
+        std::atomic<uint64_t> m_max {0};
+      };
+
+      static size_t shardIndex();
+
+    protected:
+      std::array<Shard, ShardCount> m_shards;
+    };
+
+    /// @brief Record the time from construction to destruction
+    class AGENT_LIB_API ScopedTimer
+    {
+    public:
+      /// @param histogram the histogram, nothing is measured if it is `nullptr`
+      ScopedTimer(Histogram *histogram) : m_histogram(histogram)
+      {
+        if (m_histogram)
+          m_start = Clock::now();
+      }
+      ~ScopedTimer()
+      {
+        if (m_histogram)
+          m_histogram->record(Clock::now() - m_start);
+      }
+
+    protected:
+      Histogram *m_histogram;
+      Clock::time_point m_start;
+    };
+
+    /// @brief Record the time of a stage without the time of the stages nested in it
+    ///
+    /// Pipeline transforms call the following transform, so the time spent in nested stages on
+    /// the same thread is subtracted to get the time of the stage itself.
+    class AGENT_LIB_API StageTimer
+    {
+    public:
+      /// @param histogram the histogram, nothing is measured if it is `nullptr`
+      StageTimer(Histogram *histogram) : m_histogram(histogram)
+      {
+        if (m_histogram)
+        {
+          m_outer = exchangeNested(Clock::duration::zero());
+          m_start = Clock::now();
+        }
+      }
+      ~StageTimer()
+      {
+        if (m_histogram)
+        {
+          auto elapsed = Clock::now() - m_start;
+          auto nested = exchangeNested(m_outer + elapsed);
+          m_histogram->record(elapsed - nested);
+        }
+      }
+
+    protected:
+      /// @brief replace the time of the nested stages for this thread
+      static Clock::duration exchangeNested(Clock::duration nested);
+
+    protected:
+      Histogram *m_histogram;
+      Clock::time_point m_start;
+      Clock::duration m_outer;
+    };
+
+    /// @brief Lock a mutex and record how long the lock waited
+    ///
+    /// An uncontended lock is recorded as `0` without reading the clock.
+    /// @param lock the unlocked lock
+    /// @param histogram the histogram, the lock is not measured if it is `nullptr`
+    template <typename Lock>
+    void lockTimed(Lock &lock, Histogram *histogram)
+    {
+      if (!histogram)
+      {
+        lock.lock();
+      }
+      else if (lock.try_lock())
+      {
+        histogram->record(uint64_t(0));
+      }
+      else
+      {
+        auto start = Clock::now();
+        lock.lock();
+        histogram->record(Clock::now() - start);
+      }
+    }
+
+    /// @brief The histograms of the agent by name and labels
+    ///
+    /// Histograms are only created when the registry is enabled, so instrumented code checks for
+    /// `nullptr` and does not read the clock when metrics are off.
+    class AGENT_LIB_API Registry
+    {
+    public:
+      /// @brief get the registry for the process
+      /// @return the registry
+      static Registry &global();
+
+      /// @brief enable or disable the creation of histograms
+      /// @param enabled `true` to create histograms
+      void setEnabled(bool enabled) { m_enabled = enabled; }
+      /// @brief are histograms created
+      /// @return `true` if enabled
+      bool isEnabled() const { return m_enabled; }
+
+      /// @brief get or create a histogram
+      ///
+      /// Histograms are never removed, so the pointer can be kept for the life of the process.
+      /// @param name the metric name
+      /// @param help the description of the metric
+      /// @param labels the labels for this histogram
+      /// @param dataItem optional id of an Agent device data item for the histogram
+      /// @return the histogram or `nullptr` if the registry is disabled
+      Histogram *histogram(const std::string &name, const std::string &help,
+                           const Labels &labels = {},
+                           const std::optional<std::string> &dataItem = std::nullopt);
+
+      /// @brief write all the histograms as Prometheus summaries in seconds
+      /// @param out the output stream
+      void printPrometheus(std::ostream &out) const;
+
+      /// @brief merge the histograms of each data item
+      /// @return the snapshots by data item id
+      std::map<std::string, HistogramSnapshot> snapshotByDataItem() const;
+
+    protected:
+      struct Entry
+      {
+        std::optional<std::string> m_dataItem;
+        std::unique_ptr<Histogram> m_histogram;
+      };
+      struct Family
+      {
+        std::string m_help;
+        std::map<Labels, Entry> m_entries;
+      };
+
+      mutable std::mutex m_lock;
+      std::atomic_bool m_enabled {false};
+      std::map<std::string, Family> m_families;
+    };
+
+    /// @brief Periodically publish the 99th percentile of the histograms with data items
+    class AGENT_LIB_API LatencyReporter : public std::enable_shared_from_this<LatencyReporter>
+    {
+    public:
+      /// @brief Publish a value in seconds to a data item
+      using Publish = std::function<void(const std::string &dataItem, double seconds)>;
+
+      /// @brief Create a reporter
+      /// @param st the strand for the timer
+      /// @param registry the registry to read
+      /// @param publish function to publish the values
+      /// @param interval the reporting interval
+      LatencyReporter(boost::asio::io_context::strand &st, Registry &registry, Publish publish,
+                      std::chrono::milliseconds interval = std::chrono::seconds(10))
+        : m_strand(st),
+          m_timer(st.context()),
+          m_registry(registry),
+          m_publish(publish),
+          m_interval(interval)
+      {}
+
+      /// @brief start reporting
+      void start();
+      /// @brief stop reporting
+      void stop();
+      /// @brief publish the values recorded since the last report
+      void report();
+
+    protected:
+      void schedule();
+
+    protected:
+      boost::asio::io_context::strand &m_strand;
+      boost::asio::steady_timer m_timer;
+      Registry &m_registry;
+      Publish m_publish;
+      std::chrono::milliseconds m_interval;
+      std::map<std::string, HistogramSnapshot> m_last;
+      bool m_running {false};
+    };
+  }  // namespace metrics
+}  // namespace mtconnect
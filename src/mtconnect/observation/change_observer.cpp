@@ -17,11 +17,192 @@
 
 #include "change_observer.hpp"
 
+#include <bit>
+
 #include "mtconnect/buffer/circular_buffer.hpp"
 
 using namespace std;
 
 namespace mtconnect::observation {
+  namespace {
+    thread_local int t_batchDepth {0};
+  }
+
+  ChangeNotifier &ChangeNotifier::instance()
+  {
+    static ChangeNotifier notifier;
+    return notifier;
+  }
+
+  ChangeNotifier::Batch::Batch() { t_batchDepth++; }
+
+  ChangeNotifier::Batch::~Batch()
+  {
+    if (--t_batchDepth == 0)
+      ChangeNotifier::instance().flush();
+  }
+
+  uint32_t ChangeNotifier::allocate()
+  {
+    std::lock_guard<std::mutex> lock(m_indexMutex);
+    if (!m_freeIndexes.empty())
+    {
+      auto index = m_freeIndexes.back();
+      m_freeIndexes.pop_back();
+      return index;
+    }
+
+    auto index = m_nextIndex;
+    auto page = index / PageSize;
+    if (page >= MaxPages)
+    {
+      LOG(fatal) << "Too many change signalers, cannot allocate more than " << MaxPages * PageSize;
+      throw std::runtime_error("Too many change signalers");
+    }
+    if (m_pages[page].load(std::memory_order_acquire) == nullptr)
+      m_pages[page].store(new Page, std::memory_order_release);
+
+    m_nextIndex++;
+    return index;
+  }
+
+  void ChangeNotifier::release(uint32_t index)
+  {
+    {
+      std::unique_lock<std::shared_mutex> lock(m_mutex);
+      for (auto observer : m_observers)
+      {
+        auto word = index / 64;
+        if (word < observer->m_subscription.size())
+          observer->m_subscription[word] &= ~(1ull << (index % 64));
+      }
+    }
+
+    m_pages[index / PageSize].load(std::memory_order_acquire)->m_first[index % PageSize].store(0);
+
+    std::lock_guard<std::mutex> lock(m_indexMutex);
+    m_freeIndexes.push_back(index);
+  }
+
+  void ChangeNotifier::subscribe(ChangeObserver *observer, uint32_t index)
+  {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    auto &bits = observer->m_subscription;
+    if (bits.empty() &&
+        std::find(m_observers.begin(), m_observers.end(), observer) == m_observers.end())
+      m_observers.push_back(observer);
+
+    auto word = index / 64;
+    if (word >= bits.size())
+      bits.resize(word + 1, 0);
+    bits[word] |= 1ull << (index % 64);
+  }
+
+  void ChangeNotifier::unsubscribe(ChangeObserver *observer, uint32_t index)
+  {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    if (std::find(m_observers.begin(), m_observers.end(), observer) == m_observers.end())
+      return;
+
+    auto word = index / 64;
+    if (word < observer->m_subscription.size())
+      observer->m_subscription[word] &= ~(1ull << (index % 64));
+  }
+
+  void ChangeNotifier::unsubscribe(ChangeObserver *observer)
+  {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    if (std::erase(m_observers, observer) > 0)
+      observer->m_subscription.clear();
+  }
+
+  bool ChangeNotifier::isSubscribed(ChangeObserver *observer, uint32_t index) const
+  {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    if (std::find(m_observers.begin(), m_observers.end(), observer) == m_observers.end())
+      return false;
+    return observer->isSubscribed(index);
+  }
+
+  void ChangeNotifier::publish(uint32_t index, uint64_t sequence)
+  {
+    auto page = index / PageSize;
+    auto slot = index % PageSize;
+    auto pp = m_pages[page].load(std::memory_order_acquire);
+
+    // Keep the earliest sequence since the last delivery
+    auto &first = pp->m_first[slot];
+    auto current = first.load(std::memory_order_relaxed);
+    while ((current == 0 || sequence < current) &&
+           !first.compare_exchange_weak(current, sequence, std::memory_order_acq_rel))
+      ;
+
+    pp->m_dirty[slot / 64].fetch_or(1ull << (slot % 64), std::memory_order_release);
+    m_dirtyPages[page / 64].fetch_or(1ull << (page % 64), std::memory_order_release);
+
+    if (t_batchDepth == 0)
+      flush();
+  }
+
+  void ChangeNotifier::signal(uint32_t index, uint64_t sequence)
+  {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    for (auto observer : m_observers)
+    {
+      if (observer->isSubscribed(index))
+        observer->signal(sequence);
+    }
+  }
+
+  void ChangeNotifier::flush()
+  {
+    // Collect the indexes that changed since the last delivery
+    thread_local std::vector<std::pair<uint32_t, uint64_t>> changes;
+    changes.clear();
+
+    for (uint32_t pw = 0; pw < m_dirtyPages.size(); pw++)
+    {
+      auto pages = m_dirtyPages[pw].exchange(0, std::memory_order_acq_rel);
+      while (pages != 0)
+      {
+        auto page = pw * 64 + std::countr_zero(pages);
+        pages &= pages - 1;
+
+        auto pp = m_pages[page].load(std::memory_order_acquire);
+        for (uint32_t sw = 0; sw < pp->m_dirty.size(); sw++)
+        {
+          auto slots = pp->m_dirty[sw].exchange(0, std::memory_order_acq_rel);
+          while (slots != 0)
+          {
+            auto slot = sw * 64 + std::countr_zero(slots);
+            slots &= slots - 1;
+
+            auto sequence = pp->m_first[slot].exchange(0, std::memory_order_acq_rel);
+            if (sequence != 0)
+              changes.emplace_back(page * PageSize + slot, sequence);
+          }
+        }
+      }
+    }
+
+    if (changes.empty())
+      return;
+
+    // Signal each observer once with the earliest sequence it subscribes to
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    for (auto observer : m_observers)
+    {
+      uint64_t sequence = UINT64_MAX;
+      for (const auto &[index, seq] : changes)
+      {
+        if (seq < sequence && observer->isSubscribed(index))
+          sequence = seq;
+      }
+      if (sequence != UINT64_MAX)
+        observer->signal(sequence);
+    }
+  }
+
   void AsyncObserver::observe(const std::optional<SequenceNumber_t> &from, Resolver resolver)
   {
     using std::placeholders::_1;
@@ -29,16 +210,18 @@ namespace mtconnect::observation {
     SequenceNumber_t firstSeq, next;
     {
       std::lock_guard<buffer::CircularBuffer> lock(m_buffer);
-      firstSeq = m_buffer.getFirstSequence();
+      firstSeq = m_buffer.getFirstAvailableSequence();
       next = m_buffer.getSequence();
     }
 
-    std::lock_guard<ChangeObserver> lock(m_observer);
-    m_observer.m_handler = boost::bind(&AsyncObserver::handleSignal, getptr(), _1);
+    {
+      std::lock_guard<ChangeObserver> lock(m_observer);
+      m_observer.m_handler = boost::bind(&AsyncObserver::handleSignal, getptr(), _1);
+    }
 
-    // This object will automatically clean up all the observer from the
-    // signalers in an exception proof manor.
-    // Add observers
+    // The change observer removes its subscriptions when it is cleared or destroyed. The
+    // subscriptions are added without the observer lock since the notifier holds its lock when
+    // it signals the observer.
     for (const auto &item : m_filter)
     {
       auto cs = resolver(item);
@@ -46,6 +229,8 @@ namespace mtconnect::observation {
         cs->addObserver(&m_observer);
     }
 
+    std::lock_guard<ChangeObserver> lock(m_observer);
+
     // If we are starting from the beginning of the buffer, signal the handler
     // to set the sequence to the fisrt sequence in the buffer to avoid a race
     // condition.
@@ -129,7 +314,7 @@ namespace mtconnect::observation {
 
     /// Check if we're falling too far behind. If we are, generate an
     /// MTConnectError and return.
-    if (m_sequence != 0 && m_sequence < m_buffer.getFirstSequence())
+    if (m_sequence != 0 && m_sequence < m_buffer.getFirstAvailableSequence())
     {
       LOG(warning) << "Client fell too far behind, disconnecting";
       fail(boost::beast::http::status::not_found, "Client fell too far behind, disconnecting");
@@ -22,9 +22,11 @@
 #include <boost/bind/bind.hpp>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <shared_mutex>
 #include <vector>
 
 #include "mtconnect/config.hpp"
@@ -37,6 +39,7 @@ namespace mtconnect::buffer {
 
 namespace mtconnect::observation {
   class ChangeSignaler;
+  class ChangeNotifier;
 
   /// @brief A class to observe a data item and signal when data changes
   class AGENT_LIB_API ChangeObserver
@@ -158,43 +161,115 @@ namespace mtconnect::observation {
     mutable std::recursive_mutex m_mutex;
     boost::asio::steady_timer m_timer;
 
-    std::vector<ChangeSignaler *> m_signalers;
     std::atomic<uint64_t> m_sequence {UINT64_MAX};
     bool m_noCancelOnSignal {false};
 
   protected:
-    friend class ChangeSignaler;
-    void addSignaler(ChangeSignaler *sig)
+    friend class ChangeNotifier;
+
+    /// @brief Bitset of the signaler indexes this observer subscribes to. Guarded by the
+    /// notifier's mutex.
+    std::vector<uint64_t> m_subscription;
+
+    bool isSubscribed(uint32_t index) const
     {
-      std::unique_lock<std::recursive_mutex> lock(m_mutex);
-      m_signalers.emplace_back(sig);
+      auto word = index / 64;
+      return word < m_subscription.size() && (m_subscription[word] & (1ull << (index % 64))) != 0;
     }
-    bool removeSignaler(ChangeSignaler *sig)
+  };
+
+  /// @brief Delivers changes from signalers to the observers subscribed to them
+  ///
+  /// Every signaler has an index. An observer subscribes with a bitset of the indexes it is
+  /// interested in. When an observation is added, the writer records the first sequence number
+  /// for the signaler's index in an atomic slot and marks the index as dirty, no mutex is taken.
+  /// The dirty indexes are delivered to the observers when the ingest batch completes, so each
+  /// observer is signaled at most once per batch with the earliest sequence number it is
+  /// subscribed to. Outside of a batch, changes are delivered immediately.
+  class AGENT_LIB_API ChangeNotifier
+  {
+  public:
+    /// @brief the process wide notifier
+    static ChangeNotifier &instance();
+
+    /// @brief Scope of an ingest batch. Changes are delivered when the outermost batch on the
+    /// thread ends.
+    class AGENT_LIB_API Batch
     {
-      std::lock_guard<std::recursive_mutex> lock(m_mutex);
-      return std::erase(m_signalers, sig) > 0;
-    }
+    public:
+      Batch();
+      ~Batch();
+    };
+
+    /// @brief allocate an index for a signaler
+    uint32_t allocate();
+    /// @brief release the index of a signaler and remove it from all subscriptions
+    void release(uint32_t index);
+
+    /// @brief subscribe an observer to a signaler index
+    void subscribe(ChangeObserver *observer, uint32_t index);
+    /// @brief remove the subscription to a signaler index
+    void unsubscribe(ChangeObserver *observer, uint32_t index);
+    /// @brief remove all the subscriptions of an observer
+    void unsubscribe(ChangeObserver *observer);
+    /// @brief check if an observer is subscribed to a signaler index
+    bool isSubscribed(ChangeObserver *observer, uint32_t index) const;
+
+    /// @brief record a change for the index
+    /// @param index the signaler index
+    /// @param sequence the sequence number of the observation
+    void publish(uint32_t index, uint64_t sequence);
+    /// @brief signal all subscribers of an index immediately
+    void signal(uint32_t index, uint64_t sequence);
+    /// @brief deliver the pending changes to the subscribed observers
+    void flush();
+
+  protected:
+    static constexpr uint32_t PageSize {4096};
+    static constexpr uint32_t MaxPages {4096};
+
+    /// @brief the first sequence and dirty bits for a range of indexes
+    struct Page
+    {
+      std::array<std::atomic<uint64_t>, PageSize> m_first {};
+      std::array<std::atomic<uint64_t>, PageSize / 64> m_dirty {};
+    };
+
+    ChangeNotifier() = default;
+
+    std::array<std::atomic<Page *>, MaxPages> m_pages {};
+    std::array<std::atomic<uint64_t>, MaxPages / 64> m_dirtyPages {};
+
+    std::mutex m_indexMutex;
+    uint32_t m_nextIndex {0};
+    std::vector<uint32_t> m_freeIndexes;
+
+    mutable std::shared_mutex m_mutex;
+    std::vector<ChangeObserver *> m_observers;
   };
 
   /// @brief A signaler of waiting observers
+  ///
+  /// The observers are kept as subscriptions in the `ChangeNotifier` using the signaler's index.
   class AGENT_LIB_API ChangeSignaler
   {
   public:
+    ChangeSignaler() : m_signalIndex(ChangeNotifier::instance().allocate()) {}
+    ChangeSignaler(const ChangeSignaler &) = delete;
+    ~ChangeSignaler() { ChangeNotifier::instance().release(m_signalIndex); }
+
     /// @brief add an observer to the list
     /// @param[in] observer an observer
     void addObserver(ChangeObserver *observer)
     {
-      std::lock_guard<std::recursive_mutex> lock(m_observerMutex);
-      m_observers.emplace_back(observer);
-      observer->addSignaler(this);
+      ChangeNotifier::instance().subscribe(observer, m_signalIndex);
     }
     /// @brief remove an observer
     /// @param[in] observer an observer
     /// @return `true` if the observer was removed
     bool removeObserver(ChangeObserver *observer)
     {
-      std::lock_guard<std::recursive_mutex> lock(m_observerMutex);
-      std::erase(m_observers, observer);
+      ChangeNotifier::instance().unsubscribe(observer, m_signalIndex);
       return true;
     }
     /// @brief check if an observer is in the list
@@ -202,52 +277,41 @@ namespace mtconnect::observation {
     /// @return `true` if the observer is in the list
     bool hasObserver(ChangeObserver *observer) const
     {
-      std::lock_guard<std::recursive_mutex> lock(m_observerMutex);
-      auto foundPos = std::find(m_observers.begin(), m_observers.end(), observer);
-      return foundPos != m_observers.end();
+      return ChangeNotifier::instance().isSubscribed(observer, m_signalIndex);
     }
     /// @brief signal observers with a sequence number
+    ///
+    /// A sequence number of `0` signals the observers immediately without changing their
+    /// sequence.
+    ///
     /// @param[in] sequence the sequence number
     void signalObservers(uint64_t sequence) const
     {
-      std::lock_guard<std::recursive_mutex> lock(m_observerMutex);
-      for (const auto observer : m_observers)
-        observer->signal(sequence);
+      if (sequence == 0)
+        ChangeNotifier::instance().signal(m_signalIndex, sequence);
+      else
+        ChangeNotifier::instance().publish(m_signalIndex, sequence);
     }
 
-    ~ChangeSignaler()
-    {
-      std::lock_guard<std::recursive_mutex> lock(m_observerMutex);
-      for (const auto observer : m_observers)
-        observer->removeSignaler(this);
-    }
+    /// @brief get the index of this signaler in the notifier
+    /// @return the index
+    uint32_t getSignalIndex() const { return m_signalIndex; }
 
   protected:
-    // Observer Lists
-    mutable std::recursive_mutex m_observerMutex;
-    std::vector<ChangeObserver *> m_observers;
+    uint32_t m_signalIndex;
   };
 
-  // -- Deferred ChangeObserver method definitions (need complete ChangeSignaler) --
+  // -- Deferred ChangeObserver method definitions (need complete ChangeNotifier) --
 
-  inline ChangeObserver::~ChangeObserver()
-  {
-    std::lock_guard<std::recursive_mutex> scopedLock(m_mutex);
-    clear();
-  }
+  inline ChangeObserver::~ChangeObserver() { clear(); }
 
   inline void ChangeObserver::clear()
   {
+    // Remove the subscriptions before taking the observer lock, the notifier holds its lock while
+    // signaling observers.
+    ChangeNotifier::instance().unsubscribe(this);
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     m_timer.cancel();
-    decltype(m_signalers) signalers;
-    {
-      std::unique_lock<std::recursive_mutex> lock(m_mutex);
-      signalers = m_signalers;
-    }
-    for (const auto signaler : signalers)
-      signaler->removeObserver(this);
-    std::unique_lock<std::recursive_mutex> lock(m_mutex);
-    m_signalers.clear();
   }
 
   /// @brief Abstract class for asynchronous timers
@@ -0,0 +1,212 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#include "condition_table.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace mtconnect::observation {
+  /// @brief An immutable AVL tree node
+  struct ConditionTable::Node
+  {
+    string m_code;
+    ConditionPtr m_condition;
+    uint64_t m_order;  ///< When the condition was activated
+    NodePtr m_left;
+    NodePtr m_right;
+    int m_height;
+    size_t m_size;
+    uint64_t m_newest;  ///< The largest order in this subtree
+  };
+
+  namespace {
+    using Node = ConditionTable::Node;
+    using NodePtr = ConditionTable::NodePtr;
+
+    inline int height(const NodePtr &node) { return node ? node->m_height : 0; }
+    inline size_t size(const NodePtr &node) { return node ? node->m_size : 0; }
+    inline uint64_t newest(const NodePtr &node) { return node ? node->m_newest : 0; }
+
+    NodePtr make(const string &code, const ConditionPtr &condition, uint64_t order,
+                 const NodePtr &left, const NodePtr &right)
+    {
+      auto node = make_shared<Node>();
+      node->m_code = code;
+      node->m_condition = condition;
+      node->m_order = order;
+      node->m_left = left;
+      node->m_right = right;
+      node->m_height = 1 + max(height(left), height(right));
+      node->m_size = 1 + size(left) + size(right);
+      node->m_newest = max({order, newest(left), newest(right)});
+      return node;
+    }
+
+    // Copy the entry of node with new children
+    inline NodePtr with(const NodePtr &node, const NodePtr &left, const NodePtr &right)
+    {
+      return make(node->m_code, node->m_condition, node->m_order, left, right);
+    }
+
+    // Copy the entry of node with new children, rotating if they differ in height by two
+    NodePtr balance(const NodePtr &node, const NodePtr &left, const NodePtr &right)
+    {
+      auto diff = height(left) - height(right);
+      if (diff > 1)
+      {
+        if (height(left->m_left) >= height(left->m_right))
+          return with(left, left->m_left, with(node, left->m_right, right));
+
+        const auto &lr = left->m_right;
+        return with(lr, with(left, left->m_left, lr->m_left), with(node, lr->m_right, right));
+      }
+      else if (diff < -1)
+      {
+        if (height(right->m_right) >= height(right->m_left))
+          return with(right, with(node, left, right->m_left), right->m_right);
+
+        const auto &rl = right->m_left;
+        return with(rl, with(node, left, rl->m_left), with(right, rl->m_right, right->m_right));
+      }
+
+      return with(node, left, right);
+    }
+
+    NodePtr insert(const NodePtr &node, const string &code, const ConditionPtr &condition,
+                   uint64_t order)
+    {
+      if (!node)
+        return make(code, condition, order, nullptr, nullptr);
+
+      if (code < node->m_code)
+        return balance(node, insert(node->m_left, code, condition, order), node->m_right);
+      else if (node->m_code < code)
+        return balance(node, node->m_left, insert(node->m_right, code, condition, order));
+      else
+        return make(code, condition, order, node->m_left, node->m_right);
+    }
+
+    NodePtr removeMin(const NodePtr &node, NodePtr &min)
+    {
+      if (!node->m_left)
+      {
+        min = node;
+        return node->m_right;
+      }
+
+      return balance(node, removeMin(node->m_left, min), node->m_right);
+    }
+
+    NodePtr removeCode(const NodePtr &node, const string &code, bool &found)
+    {
+      if (!node)
+        return node;
+
+      if (code < node->m_code)
+      {
+        auto left = removeCode(node->m_left, code, found);
+        return found ? balance(node, left, node->m_right) : node;
+      }
+      else if (node->m_code < code)
+      {
+        auto right = removeCode(node->m_right, code, found);
+        return found ? balance(node, node->m_left, right) : node;
+      }
+
+      found = true;
+      if (!node->m_left)
+        return node->m_right;
+      if (!node->m_right)
+        return node->m_left;
+
+      NodePtr min;
+      auto right = removeMin(node->m_right, min);
+      return balance(min, node->m_left, right);
+    }
+
+    void collect(const NodePtr &node, vector<pair<uint64_t, ConditionPtr>> &entries)
+    {
+      if (node)
+      {
+        collect(node->m_left, entries);
+        entries.emplace_back(node->m_order, node->m_condition);
+        collect(node->m_right, entries);
+      }
+    }
+  }  // namespace
+
+  size_t ConditionTable::size() const { return observation::size(m_root); }
+
+  ConditionPtr ConditionTable::find(const string &code) const
+  {
+    auto node = m_root.get();
+    while (node != nullptr)
+    {
+      if (code < node->m_code)
+        node = node->m_left.get();
+      else if (node->m_code < code)
+        node = node->m_right.get();
+      else
+        return node->m_condition;
+    }
+
+    return nullptr;
+  }
+
+  ConditionPtr ConditionTable::newest() const
+  {
+    auto node = m_root.get();
+    while (node != nullptr)
+    {
+      if (node->m_order == node->m_newest)
+        return node->m_condition;
+      else if (observation::newest(node->m_left) == node->m_newest)
+        node = node->m_left.get();
+      else
+        node = node->m_right.get();
+    }
+
+    return nullptr;
+  }
+
+  void ConditionTable::set(const string &code, const ConditionPtr &condition)
+  {
+    m_root = insert(m_root, code, condition, m_next++);
+  }
+
+  bool ConditionTable::erase(const string &code)
+  {
+    bool found = false;
+    m_root = removeCode(m_root, code, found);
+    return found;
+  }
+
+  void ConditionTable::getConditionList(ConditionList &list) const
+  {
+    vector<pair<uint64_t, ConditionPtr>> entries;
+    entries.reserve(size());
+    collect(m_root, entries);
+    sort(entries.begin(), entries.end(),
+         [](const auto &a, const auto &b) { return a.first < b.first; });
+    for (auto &entry : entries)
+      list.emplace_back(std::move(entry.second));
+  }
+}  // namespace mtconnect::observation
@@ -0,0 +1,79 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "mtconnect/config.hpp"
+
+namespace mtconnect::observation {
+  class Condition;
+  using ConditionPtr = std::shared_ptr<Condition>;
+  using ConditionList = std::list<ConditionPtr>;
+
+  /// @brief A persistent map of native code to active condition
+  ///
+  /// The map is a balanced tree whose nodes are never modified. Setting or erasing a code
+  /// copies the `O(log n)` nodes on the path to the code and shares the rest with the
+  /// previous version, so a copy of a table is a pointer copy and is not affected by changes
+  /// to the original. The table remembers the order the conditions were activated in.
+  class AGENT_LIB_API ConditionTable
+  {
+  public:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    /// @brief create an empty table
+    ConditionTable() = default;
+
+    /// @brief are there any active conditions
+    /// @return `true` if the table is empty
+    bool empty() const { return !m_root; }
+    /// @brief get the number of active conditions
+    /// @return the number of conditions
+    size_t size() const;
+
+    /// @brief find the condition for a native code
+    /// @param[in] code the native code
+    /// @return shared pointer to the condition if found
+    ConditionPtr find(const std::string &code) const;
+    /// @brief get the most recently activated condition
+    /// @return shared pointer to the condition or `nullptr` if the table is empty
+    ConditionPtr newest() const;
+
+    /// @brief activate a condition, replacing the condition with the same code
+    /// @param[in] code the native code
+    /// @param[in] condition the condition
+    void set(const std::string &code, const ConditionPtr &condition);
+    /// @brief clear the condition for a native code
+    /// @param[in] code the native code
+    /// @return `true` if the code was active
+    bool erase(const std::string &code);
+
+    /// @brief Get the conditions in the order they were activated
+    /// @param[out] list the list to append the conditions to
+    void getConditionList(ConditionList &list) const;
+
+  protected:
+    NodePtr m_root;
+    uint64_t m_next {1};
+  };
+}  // namespace mtconnect::observation
@@ -162,7 +162,7 @@ namespace mtconnect {
 
       auto obs = dynamic_pointer_cast<Observation>(ent);
       obs->m_timestamp = timestamp;
-      obs->m_dataItem = dataItem;
+      obs->m_slot = dataItem->getSlot();
 
       if (unavailable)
         obs->makeUnavailable();
@@ -426,51 +426,34 @@ namespace mtconnect {
       return factory;
     }
 
-    bool Condition::replace(ConditionPtr &old, ConditionPtr &_new)
+    void Condition::activateAfter(const ConditionPtr &last)
     {
-      if (!m_prev)
-        return false;
-
-      if (m_prev == old)
-      {
-        _new->m_prev = old->m_prev;
-        m_prev = _new;
-        return true;
-      }
-
-      return m_prev->replace(old, _new);
-    }
-
-    ConditionPtr Condition::deepCopy()
-    {
-      auto n = make_shared<Condition>(*this);
-
-      if (m_prev)
-      {
-        n->m_prev = m_prev->deepCopy();
-      }
-
-      return n;
+      m_active = last->m_active;
+      m_active.set(last->m_code, last);
+      m_active.erase(m_code);
     }
 
-    ConditionPtr Condition::deepCopyAndRemove(ConditionPtr &old)
+    ConditionPtr Condition::copyAndClear(const std::string &code)
     {
-      if (this->getptr() == old)
+      auto active = m_active;
+      if (m_code != code)
       {
-        if (m_prev)
-          return m_prev->deepCopy();
-        else
-          return nullptr;
+        active.erase(code);
+        auto n = make_shared<Condition>(*this);
+        n->m_active = std::move(active);
+        return n;
       }
 
-      auto n = make_shared<Condition>(*this);
-
-      if (m_prev)
+      // The most recent of the remaining conditions becomes the last active condition
+      if (auto newest = active.newest())
       {
-        n->m_prev = m_prev->deepCopyAndRemove(old);
+        active.erase(newest->m_code);
+        auto n = make_shared<Condition>(*newest);
+        n->m_active = std::move(active);
+        return n;
       }
 
-      return n;
+      return nullptr;
     }
   }  // namespace observation
 }  // namespace mtconnect
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cmath>
 #include <date/date.h>
 #include <set>
@@ -25,10 +26,12 @@
 #include <variant>
 #include <vector>
 
+#include "condition_table.hpp"
 #include "mtconnect/config.hpp"
 #include "mtconnect/device_model/component.hpp"
 #include "mtconnect/device_model/data_item/data_item.hpp"
 #include "mtconnect/entity/entity.hpp"
+#include "mtconnect/entity/render_cache.hpp"
 #include "mtconnect/utilities.hpp"
 
 /// @brief Observation namespace
@@ -38,6 +41,12 @@ namespace mtconnect::observation {
   using ConstObservationPtr = std::shared_ptr<const Observation>;
   using ObservationList = std::vector<ObservationPtr>;
 
+  /// @brief Cache of the serialized forms of an observation
+  ///
+  /// Observations do not change once they are added to the buffer, so the text generated by a
+  /// printer can be reused for every document the observation appears in.
+  using RenderCache = entity::RenderCache;
+
   /// @brief Abstract observation
   class AGENT_LIB_API Observation : public entity::Entity
   {
@@ -74,29 +83,23 @@ namespace mtconnect::observation {
     /// @param[in] dataItem the data item
     void setDataItem(const DataItemPtr dataItem)
     {
-      m_dataItem = dataItem;
+      m_slot = dataItem->getSlot();
       setProperties(dataItem, m_properties);
     }
 
     /// @brief get the associated data item
+    ///
+    /// Observations refer to the data item through its slot, so the data item that replaced it
+    /// in a device model update is returned.
     /// @return shared pointer to the data item
-    const auto getDataItem() const { return m_dataItem.lock(); }
+    const DataItemPtr getDataItem() const
+    {
+      return m_slot ? m_slot->m_dataItem.lock() : DataItemPtr();
+    }
     /// @brief get the sequence number of the observation
     /// @return the sequence number
     auto getSequence() const { return m_sequence; }
 
-    /// @brief update related data item when the device is updated
-    /// @param[in] diMap a map of data item ids to data items
-    void updateDataItem(std::unordered_map<std::string, WeakDataItemPtr> &diMap)
-    {
-      auto old = m_dataItem.lock();
-      auto ndi = diMap.find(old->getId());
-      if (ndi != diMap.end())
-        m_dataItem = ndi->second;
-      else
-        LOG(trace) << "Observation cannot find data item: " << old->getId();
-    }
-
     /// @brief set the timestamp
     /// @param[in] ts the timestamp
     void setTimestamp(const Timestamp &ts)
@@ -128,7 +131,7 @@ namespace mtconnect::observation {
     /// @brief set the entity name (QName) from the data item observation name
     virtual void setEntityName()
     {
-      auto di = m_dataItem.lock();
+      auto di = getDataItem();
       if (di)
         Entity::setQName(di->getObservationName());
     }
@@ -139,10 +142,10 @@ namespace mtconnect::observation {
     /// @return `true` if this observation is less than `another`
     bool operator<(const Observation &another) const
     {
-      auto di = m_dataItem.lock();
+      auto di = getDataItem();
       if (!di)
         return false;
-      auto odi = another.m_dataItem.lock();
+      auto odi = another.getDataItem();
       if (!odi)
         return true;
 
@@ -159,13 +162,13 @@ namespace mtconnect::observation {
     bool isOrphan() const
     {
 #ifdef NDEBUG
-      return m_dataItem.expired();
+      return !m_slot || m_slot->m_dataItem.expired();
 #else
-      if (m_dataItem.expired())
+      auto di = getDataItem();
+      if (!di)
         return true;
-      if (m_dataItem.lock()->isOrphan())
+      if (di->isOrphan())
       {
-        auto di = m_dataItem.lock();
         LOG(trace) << "!!! DataItem " << di->getTopicName() << " orphaned";
         return true;
       }
@@ -176,11 +179,16 @@ namespace mtconnect::observation {
     /// @brief Clear the reset triggered state
     void clearResetTriggered() { m_properties.erase("resetTriggered"); }
 
+    /// @brief get the cache of the serialized forms of this observation
+    /// @return the render cache
+    const RenderCache &getRenderCache() const { return m_renderCache; }
+
   protected:
     Timestamp m_timestamp;
     bool m_unavailable {false};
-    std::weak_ptr<device_model::data_item::DataItem> m_dataItem;
+    DataItemSlotPtr m_slot;
     uint64_t m_sequence {0};
+    RenderCache m_renderCache;
   };
 
   /// @brief A MTConnect Sample with a double value
@@ -220,14 +228,11 @@ namespace mtconnect::observation {
     ObservationPtr copy() const override { return std::make_shared<Timeseries>(*this); }
   };
 
-  class Condition;
-  using ConditionPtr = std::shared_ptr<Condition>;
-  using ConditionList = std::list<ConditionPtr>;
-
   /// @brief An MTConnect Condition
   ///
-  /// Conditions are linked together to keep track of all the conditions that are
-  /// active at one time. When the normal condition arrives, the list is cleared.
+  /// Each condition has a table of the conditions that were active when it arrived, keyed by
+  /// native code, to keep track of all the conditions that are active at one time. When the
+  /// normal condition arrives, the table is cleared.
   class AGENT_LIB_API Condition : public Observation
   {
   public:
@@ -316,29 +321,15 @@ namespace mtconnect::observation {
       }
     }
 
-    /// @brief get the first condition in the chain
-    ///
-    /// Conditions are chained together to allow for mutiple conditions active at the same time
-    /// @return shared pointer the first condition in the chain
-    ConditionPtr getFirst()
-    {
-      if (m_prev)
-        return m_prev->getFirst();
-
-      return getptr();
-    }
-
-    /// @brief Get a list of all active conditions
+    /// @brief Get a list of all active conditions in the order they were activated
     /// @param[out] list the list condtions
     void getConditionList(ConditionList &list)
     {
-      if (m_prev)
-        m_prev->getConditionList(list);
-
+      m_active.getConditionList(list);
       list.emplace_back(getptr());
     }
 
-    /// @brief find a condition by code in the condition list
+    /// @brief find an active condition by code
     /// @param[in] code te code
     /// @return shared pointer to the condition if found
     ConditionPtr find(const std::string &code)
@@ -346,13 +337,10 @@ namespace mtconnect::observation {
       if (m_code == code)
         return getptr();
 
-      if (m_prev)
-        return m_prev->find(code);
-
-      return nullptr;
+      return m_active.find(code);
     }
 
-    /// @brief const find a condition by code in the condition list
+    /// @brief const find an active condition by code
     /// @param[in] code te code
     /// @return shared pointer to the condition if found
     const ConditionPtr find(const std::string &code) const
@@ -360,24 +348,18 @@ namespace mtconnect::observation {
       if (m_code == code)
         return std::dynamic_pointer_cast<Condition>(Entity::getptr());
 
-      if (m_prev)
-        return m_prev->find(code);
-
-      return nullptr;
+      return m_active.find(code);
     }
 
-    /// @brief replace a condition with another in the condition list
-    /// @param[in] old the condition to be placed
-    /// @param[in] _new the replacement condition
-    /// @return `true` if the old condition was found
-    bool replace(ConditionPtr &old, ConditionPtr &_new);
-    /// @brief copy the condition and all conditions in the list
-    /// @return a new shared condition pointer
-    ConditionPtr deepCopy();
-    /// @brief copy the condition and all conditions in the list removing one condition
-    /// @param[in] old the condition to skip
-    /// @return the new condition pointer
-    ConditionPtr deepCopyAndRemove(ConditionPtr &old);
+    /// @brief activate this condition after another condition
+    ///
+    /// This condition replaces an active condition with the same code.
+    /// @param[in] last the last active condition
+    void activateAfter(const ConditionPtr &last);
+    /// @brief copy the condition and clear the condition with a code
+    /// @param[in] code the code to clear
+    /// @return the last remaining active condition or `nullptr` if none remain
+    ConditionPtr copyAndClear(const std::string &code);
 
     /// @brief Get the code for the condition
     /// @return the code
@@ -385,17 +367,14 @@ namespace mtconnect::observation {
     /// @brief get the condition level
     /// @return the level
     Level getLevel() const { return m_level; }
-    /// @brief get the previous condition in the list
-    /// @return the previous condition if it exists
-    ConditionPtr getPrev() const { return m_prev; }
-    /// @brief make a condition as the previous condition linking it to the list
-    /// @param[in] cond the previous condition
-    void appendTo(ConditionPtr cond) { m_prev = cond; }
+    /// @brief get the conditions that were active before this condition
+    /// @return the table of active conditions
+    const ConditionTable &getActive() const { return m_active; }
 
   protected:
     std::string m_code;
     Level m_level {NORMAL};
-    ConditionPtr m_prev;
+    ConditionTable m_active;
   };
 
   /// @brief an MTConnect Event with a string value or controlled vocabulary
@@ -94,7 +94,8 @@ namespace mtconnect::parser {
     return !strncmp(aUrn, "urn:mtconnect.org:MTConnect", 27u);
   }
 
-  std::list<DevicePtr> XmlParser::parseFile(const std::string &filePath, XmlPrinter *aPrinter)
+  std::list<DevicePtr> XmlParser::parseFile(const std::string &filePath, XmlPrinter *aPrinter,
+                                            size_t threads)
   {
     using namespace boost::adaptors;
     using namespace boost::range;
@@ -196,12 +197,22 @@ namespace mtconnect::parser {
       else
       {
         xmlNodeSetPtr nodeset = devices->nodesetval;
-
-        entity::ErrorList errors;
-        for (int i = 0; i != nodeset->nodeNr; ++i)
+        size_t count = nodeset->nodeNr;
+
+        // The document is only read while the devices are created, so each device is
+        // converted on its own thread. The factories are created before the threads start.
+        auto factory = Device::getRoot();
+        std::vector<entity::EntityPtr> entities(count);
+        std::vector<entity::ErrorList> errorLists(count);
+        ParallelFor(count, threads, [&](size_t i) {
+          entities[i] =
+              entity::XmlParser::parseXmlNode(factory, nodeset->nodeTab[i], errorLists[i]);
+        });
+
+        for (size_t i = 0; i < count; ++i)
         {
-          auto device =
-              entity::XmlParser::parseXmlNode(Device::getRoot(), nodeset->nodeTab[i], errors);
+          auto &device = entities[i];
+          auto &errors = errorLists[i];
 
           if (device)
           {
@@ -49,9 +49,11 @@ namespace mtconnect::parser {
     /// @brief Parses a file and returns a list of devices
     /// @param[in] aPath to the file
     /// @param[in] aPrinter the printer to obtain and set namespaces
+    /// @param[in] threads the number of threads used to create the devices
     /// @returns a list of device pointers
     std::list<device_model::DevicePtr> parseFile(const std::string &aPath,
-                                                 printer::XmlPrinter *aPrinter);
+                                                 printer::XmlPrinter *aPrinter,
+                                                 size_t threads = 1);
     /// @brief Parses a single device fragment
     /// @param[in] deviceXml device xml of a single device
     /// @param[in] aPrinter the printer to obtain and set namespaces
@@ -132,9 +132,7 @@ namespace mtconnect::pipeline {
         if (!errors.empty())
         {
           for (auto &e : errors)
-          {
-            LOG(warning) << "Error while parsing json: " << e->what();
-          }
+            error(e->what());
 
           props.clear();
           props["VALUE"] = "UNAVAILABLE"s;
@@ -158,6 +156,14 @@ namespace mtconnect::pipeline {
       m_forward(std::move(asset));
     }
 
+    /// @brief log an error and record it against the current record
+    /// @param message the error message
+    void error(const std::string &message)
+    {
+      LOG(warning) << "Error while parsing json record " << m_record << ": " << message;
+      m_errors.emplace_back(m_record, message);
+    }
+
     void flush()
     {
       if (m_queue.empty())
@@ -183,6 +189,9 @@ namespace mtconnect::pipeline {
     PipelineContextPtr m_pipelineContext;
     Forward m_forward;
     std::list<pair<DataItemPtr, entity::Properties>> m_queue;
+
+    int64_t m_record {0};                      //!< Index of the top level object being parsed
+    std::list<pair<int64_t, string>> m_errors;  //!< Errors by record index
   };
 
   /// @brief consume value in case of error
@@ -696,11 +705,8 @@ namespace mtconnect::pipeline {
       auto res = parser.parse(Asset::getRoot(), string(sv), errors);
       if (!errors.empty())
       {
-        LOG(warning) << "Errors while parsing json asset: ";
         for (const auto &e : errors)
-        {
-          LOG(warning) << "  " << e->what();
-        }
+          m_context.error("Asset " + m_assetId + ": " + e->what());
         return false;
       }
 
@@ -805,7 +811,7 @@ namespace mtconnect::pipeline {
           m_dataItem = m_context.getDataItemForDevice(sv);
           if (!m_dataItem)
           {
-            LOG(warning) << "Cannot find data item for " << sv;
+            m_context.error("Cannot find data item for " + string(sv));
           }
           m_expectation = Expectation::VALUE;
         }
@@ -835,10 +841,11 @@ namespace mtconnect::pipeline {
     {
       while (!m_complete && !reader.IterativeParseComplete())
       {
-        // Consume the key
+        // Consume the key. If this object is the top level value and more documents follow,
+        // the reader reports an error after the object is complete.
         if (m_expectation == Expectation::KEY)
         {
-          if (!reader.IterativeParseNext<rj::kParseNanAndInfFlag>(buff, *this))
+          if (!reader.IterativeParseNext<rj::kParseNanAndInfFlag>(buff, *this) && !m_complete)
             return false;
         }
 
@@ -958,13 +965,14 @@ namespace mtconnect::pipeline {
     {
       while (!reader.IterativeParseComplete() && !m_complete)
       {
-        if (!reader.IterativeParseNext<rj::kParseNanAndInfFlag>(buff, *this))
-          return false;
+        if (!reader.IterativeParseNext<rj::kParseNanAndInfFlag>(buff, *this) || m_complete)
+          return m_complete;
 
         if (m_expectation == Expectation::OBJECT)
         {
           ObjectHandler handler(m_context);
-          handler(reader, buff);
+          if (handler(reader, buff))
+            m_context.m_record++;
         }
         else
         {
@@ -1012,7 +1020,8 @@ namespace mtconnect::pipeline {
         if (m_expectation == Expectation::OBJECT)
         {
           ObjectHandler handler(m_context);
-          handler(reader, buff);
+          if (handler(reader, buff))
+            m_context.m_record++;
         }
         else if (m_expectation == Expectation::ARRAY)
         {
@@ -1043,29 +1052,51 @@ namespace mtconnect::pipeline {
     DevicePtr device = json->m_device.lock();
     auto &body = entity->getValue<std::string>();
 
-    rj::StringStream buff(body.c_str());
-    rj::Reader reader;
-    reader.IterativeParseInit();
     ParserContext context(m_context);
     context.m_forward = [this](entity::EntityPtr &&entity) { next(std::move(entity)); };
     context.m_source = source;
-
-    TopLevelHandler handler(context);
     if (device)
-      handler.m_context.m_defaultDevice = device;
-    handler(reader, buff);
+      context.m_defaultDevice = device;
 
-    EntityPtr res;
-    if (reader.HasParseError())
+    // The body may contain a sequence of top level values, one per line for newline delimited
+    // json. The reader reports the trailing content as a non-singular root after each value is
+    // complete, so the parse restarts at the offset of the next value.
+    rj::Reader reader;
+    const char *start = body.c_str();
+    while (true)
     {
+      rj::StringStream buff(start);
+      reader.IterativeParseInit();
+      TopLevelHandler handler(context);
+      handler(reader, buff);
+
+      if (!reader.HasParseError())
+        break;
+
+      if (reader.GetParseErrorCode() == rj::kParseErrorDocumentRootNotSingular)
+      {
+        start += reader.GetErrorOffset();
+        continue;
+      }
+
       LOG(error) << "Error parsing json: " << body;
       LOG(error) << "Error code: " << GetParseError(reader.GetParseErrorCode()) << " at "
-                 << reader.GetErrorOffset();
+                 << (start - body.c_str()) + reader.GetErrorOffset();
+      // Handlers that stop the parse have already recorded the reason
+      if (context.m_errors.empty() || context.m_errors.back().first != context.m_record)
+        context.error(GetParseError(reader.GetParseErrorCode()));
+      break;
     }
-    else
+
+    EntityPtr res = std::make_shared<Entity>("JsonEntities");
+    res->setValue(context.m_entities);
+    if (!context.m_errors.empty())
     {
-      res = std::make_shared<Entity>("JsonEntities");
-      res->setValue(handler.m_context.m_entities);
+      EntityList errors;
+      for (auto &[record, message] : context.m_errors)
+        errors.emplace_back(std::make_shared<Entity>(
+            "Error", Properties {{"record", record}, {"VALUE", message}}));
+      res->setProperty("errors", errors);
     }
     return res;
   }
@@ -40,6 +40,11 @@ namespace mtconnect::pipeline {
 
     /// @brief Use rapidjson to parse the json content. If there is an error, output the text and
     /// log the error.
+    ///
+    /// The content can be a single object, an array of objects, or a sequence of newline
+    /// delimited objects. Each top level object or array member is a record. Returns a
+    /// `JsonEntities` entity with the mapped entities and, if any occurred, an `errors` list
+    /// with the `record` index and message for each error.
     EntityPtr operator()(entity::EntityPtr &&entity) override;
 
   protected:
@@ -22,6 +22,7 @@
 #include <future>
 
 #include "mtconnect/config.hpp"
+#include "mtconnect/observation/change_observer.hpp"
 #include "pipeline_context.hpp"
 #include "pipeline_contract.hpp"
 #include "transform.hpp"
@@ -283,9 +284,16 @@ namespace mtconnect {
       }
 
       /// @brief Sends the entity through the pipeline
+      ///
+      /// Observers waiting for changes are signaled once when the entity has been processed.
+      ///
       /// @param[in] entity the entity to send through the pipeline
       /// @return the entity returned from the transform
-      entity::EntityPtr run(entity::EntityPtr &&entity) { return m_start->next(std::move(entity)); }
+      entity::EntityPtr run(entity::EntityPtr &&entity)
+      {
+        observation::ChangeNotifier::Batch batch;
+        return m_start->next(std::move(entity));
+      }
 
       /// @brief Bind the transform to the start
       /// @param[in] transform the transform to bind
@@ -0,0 +1,481 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#include "sparkplug_mapper.hpp"
+
+#include <boost/algorithm/string.hpp>
+
+#include <cstring>
+#include <unordered_set>
+
+#include "mtconnect/logging.hpp"
+
+using namespace std;
+
+namespace mtconnect::pipeline {
+  using namespace entity;
+  using namespace observation;
+
+  namespace sparkplug {
+    namespace {
+      /// Protobuf wire types
+      enum WireType
+      {
+        VARINT = 0,
+        I64 = 1,
+        LEN = 2,
+        I32 = 5
+      };
+
+      /// Reads the protobuf wire format
+      class Reader
+      {
+      public:
+        Reader(string_view buffer) : m_buffer(buffer) {}
+
+        bool done() const { return m_pos >= m_buffer.size(); }
+
+        bool varint(uint64_t &value)
+        {
+          value = 0;
+          for (int shift = 0; shift < 64 && m_pos < m_buffer.size(); shift += 7)
+          {
+            auto byte = uint8_t(m_buffer[m_pos++]);
+            value |= uint64_t(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+              return true;
+          }
+          return false;
+        }
+
+        template <typename T>
+        bool fixed(T &value)
+        {
+          if (m_buffer.size() - m_pos < sizeof(T))
+            return false;
+          // The wire format is little endian
+          uint64_t bits = 0;
+          for (size_t i = 0; i < sizeof(T); i++)
+            bits |= uint64_t(uint8_t(m_buffer[m_pos + i])) << (8 * i);
+          m_pos += sizeof(T);
+
+          if constexpr (sizeof(T) == 4)
+          {
+            auto narrow = uint32_t(bits);
+            memcpy(&value, &narrow, sizeof(T));
+          }
+          else
+          {
+            memcpy(&value, &bits, sizeof(T));
+          }
+          return true;
+        }
+
+        bool bytes(string_view &value)
+        {
+          uint64_t len;
+          if (!varint(len) || m_buffer.size() - m_pos < len)
+            return false;
+          value = m_buffer.substr(m_pos, len);
+          m_pos += len;
+          return true;
+        }
+
+        bool tag(uint32_t &field, WireType &type)
+        {
+          uint64_t key;
+          if (!varint(key))
+            return false;
+          field = uint32_t(key >> 3);
+          type = WireType(key & 0x7);
+          return field != 0;
+        }
+
+        bool skip(WireType type)
+        {
+          uint64_t ignore;
+          string_view view;
+          switch (type)
+          {
+            case VARINT:
+              return varint(ignore);
+            case I64:
+              return fixed(ignore);
+            case LEN:
+              return bytes(view);
+            case I32:
+            {
+              uint32_t word;
+              return fixed(word);
+            }
+          }
+          return false;
+        }
+
+      protected:
+        string_view m_buffer;
+        size_t m_pos {0};
+      };
+
+      bool DecodeMetric(string_view buffer, Metric &metric)
+      {
+        Reader reader(buffer);
+        while (!reader.done())
+        {
+          uint32_t field;
+          WireType type;
+          if (!reader.tag(field, type))
+            return false;
+
+          uint64_t number;
+          string_view view;
+          bool ok = true;
+          switch (field)
+          {
+            case 1:  // name
+              if ((ok = type == LEN && reader.bytes(view)))
+                metric.m_name.emplace(view);
+              break;
+            case 2:  // alias
+              if ((ok = type == VARINT && reader.varint(number)))
+                metric.m_alias = number;
+              break;
+            case 3:  // timestamp
+              if ((ok = type == VARINT && reader.varint(number)))
+                metric.m_timestamp = number;
+              break;
+            case 4:  // datatype
+              if ((ok = type == VARINT && reader.varint(number)))
+                metric.m_datatype = DataType(number);
+              break;
+            case 7:  // is_null
+              if ((ok = type == VARINT && reader.varint(number)))
+                metric.m_isNull = number != 0;
+              break;
+            case 10:  // int_value
+            case 11:  // long_value
+              if ((ok = type == VARINT && reader.varint(number)))
+                metric.m_value = int64_t(number);
+              break;
+            case 12:  // float_value
+            {
+              float value;
+              if ((ok = type == I32 && reader.fixed(value)))
+                metric.m_value = double(value);
+              break;
+            }
+            case 13:  // double_value
+            {
+              double value;
+              if ((ok = type == I64 && reader.fixed(value)))
+                metric.m_value = value;
+              break;
+            }
+            case 14:  // boolean_value
+              if ((ok = type == VARINT && reader.varint(number)))
+                metric.m_value = number != 0;
+              break;
+            case 15:  // string_value
+              if ((ok = type == LEN && reader.bytes(view)))
+                metric.m_value = string(view);
+              break;
+            default:
+              ok = reader.skip(type);
+              break;
+          }
+
+          if (!ok)
+            return false;
+        }
+
+        return true;
+      }
+    }  // namespace
+
+    bool Decode(string_view buffer, Payload &payload)
+    {
+      Reader reader(buffer);
+      while (!reader.done())
+      {
+        uint32_t field;
+        WireType type;
+        if (!reader.tag(field, type))
+          return false;
+
+        uint64_t number;
+        string_view view;
+        bool ok = true;
+        switch (field)
+        {
+          case 1:  // timestamp
+            if ((ok = type == VARINT && reader.varint(number)))
+              payload.m_timestamp = number;
+            break;
+          case 2:  // metrics
+            if ((ok = type == LEN && reader.bytes(view)))
+              ok = DecodeMetric(view, payload.m_metrics.emplace_back());
+            break;
+          case 3:  // seq
+            if ((ok = type == VARINT && reader.varint(number)))
+              payload.m_seq = number;
+            break;
+          default:
+            ok = reader.skip(type);
+            break;
+        }
+
+        if (!ok)
+          return false;
+      }
+
+      return true;
+    }
+
+    entity::Value GetValue(const Metric &metric, DataType type)
+    {
+      if (metric.m_isNull)
+        return std::monostate();
+
+      if (auto raw = std::get_if<int64_t>(&metric.m_value))
+      {
+        // Signed integers are sent as their two's complement in an unsigned field
+        switch (type)
+        {
+          case DataType::INT8:
+            return int64_t(int8_t(*raw));
+          case DataType::INT16:
+            return int64_t(int16_t(*raw));
+          case DataType::INT32:
+            return int64_t(int32_t(*raw));
+          case DataType::UINT8:
+          case DataType::UINT16:
+          case DataType::UINT32:
+            return int64_t(uint32_t(*raw));
+          case DataType::UINT64:
+            if (*raw < 0)
+              return double(uint64_t(*raw));
+            return *raw;
+          case DataType::DATETIME:
+            return Timestamp(chrono::milliseconds(*raw));
+          default:
+            return *raw;
+        }
+      }
+
+      return metric.m_value;
+    }
+  }  // namespace sparkplug
+
+  using namespace sparkplug;
+
+  // Check if the table is for the edge node or device or one of the edge node's devices
+  static inline bool matches(const string &table, const string &key)
+  {
+    return table == key || (table.starts_with(key) && table[key.size()] == '/');
+  }
+
+  SparkplugMapper::SparkplugMapper(PipelineContextPtr context,
+                                   const std::optional<std::string> &device)
+    : Transform("SparkplugMapper"), m_context(context), m_defaultDevice(device)
+  {
+    m_guard = [](const Entity *entity) {
+      auto topic = entity->maybeGet<string>("topic");
+      if (entity->getName() == "Message" && topic && topic->starts_with(Namespace + '/'))
+        return RUN;
+      return CONTINUE;
+    };
+  }
+
+  DataItemPtr SparkplugMapper::resolve(const string &device, const string &name)
+  {
+    auto &contract = m_context->m_contract;
+    auto dataItem = contract->findDataItem(device, name);
+    if (!dataItem && m_defaultDevice)
+      dataItem = contract->findDataItem(*m_defaultDevice, name);
+
+    // Metric names are paths, try the last part of the path
+    if (auto pos = name.rfind('/'); !dataItem && pos != string::npos)
+      return resolve(device, name.substr(pos + 1));
+
+    return dataItem;
+  }
+
+  const SparkplugMapper::Binding *SparkplugMapper::lookup(AliasTable &table, const string &device,
+                                                          const Metric &metric, bool birth)
+  {
+    if (!birth && metric.m_alias)
+    {
+      if (auto it = table.m_aliases.find(*metric.m_alias); it != table.m_aliases.end())
+        return &it->second;
+    }
+
+    if (!metric.m_name)
+    {
+      LOG(debug) << "SparkplugMapper: unknown alias " << metric.m_alias.value_or(0) << " for "
+                 << device;
+      return nullptr;
+    }
+
+    auto it = table.m_names.find(*metric.m_name);
+    if (birth || it == table.m_names.end())
+    {
+      // Remember unresolved names so they are not resolved again
+      Binding binding {resolve(device, *metric.m_name), metric.m_datatype};
+      it = table.m_names.insert_or_assign(*metric.m_name, binding).first;
+      if (birth && metric.m_alias)
+        table.m_aliases.insert_or_assign(*metric.m_alias, binding);
+    }
+
+    return &it->second;
+  }
+
+  void SparkplugMapper::forward(const DataItemPtr &dataItem, Properties &&props,
+                                const Timestamp &timestamp, EntityList &entities)
+  {
+    try
+    {
+      ErrorList errors;
+      auto obs = Observation::make(dataItem, props, timestamp, errors);
+      if (errors.empty())
+      {
+        if (auto fwd = next(std::move(obs)))
+          entities.emplace_back(fwd);
+      }
+      for (auto &e : errors)
+        LOG(warning) << "SparkplugMapper: error creating observation for " << dataItem->getId()
+                     << ": " << e->what();
+    }
+    catch (entity::EntityError &e)
+    {
+      LOG(error) << "SparkplugMapper: could not create observation: " << e.what();
+    }
+  }
+
+  void SparkplugMapper::unavailable(const string &key, const Timestamp &timestamp,
+                                    EntityList &entities)
+  {
+    // The edge node and all of its devices
+    unordered_set<DataItemPtr> dataItems;
+    for (auto it = m_tables.begin(); it != m_tables.end();)
+    {
+      if (matches(it->first, key))
+      {
+        for (auto &[name, binding] : it->second.m_names)
+          if (auto dataItem = binding.m_dataItem.lock())
+            dataItems.insert(dataItem);
+        it = m_tables.erase(it);
+      }
+      else
+      {
+        it++;
+      }
+    }
+
+    for (auto &dataItem : dataItems)
+      forward(dataItem, {}, timestamp, entities);
+  }
+
+  EntityPtr SparkplugMapper::operator()(entity::EntityPtr &&entity)
+  {
+    NAMED_SCOPE("SparkplugMapper");
+
+    auto batch = make_shared<Observations>("Observations", Properties {});
+    batch->m_timestamp = chrono::system_clock::now();
+    EntityList entities;
+
+    // spBv1.0/<group>/<type>/<edge node>[/<device>]
+    vector<string> path;
+    const auto &topic = entity->get<string>("topic");
+    boost::split(path, topic, boost::is_any_of("/"));
+
+    Payload payload;
+    if (path.size() < 4 || path.size() > 5)
+    {
+      LOG(debug) << "SparkplugMapper: ignoring topic " << topic;
+    }
+    else if (!Decode(entity->getValue<string>(), payload))
+    {
+      LOG(warning) << "SparkplugMapper: invalid payload for topic " << topic;
+    }
+    else
+    {
+      if (payload.m_timestamp)
+        batch->m_timestamp = Timestamp(chrono::milliseconds(*payload.m_timestamp));
+
+      const auto &type = path[2];
+      auto key = path[1] + '/' + path[3];
+      const auto &device = path.size() == 5 ? path[4] : path[3];
+      if (path.size() == 5)
+        key += '/' + device;
+
+      bool birth = type == "NBIRTH" || type == "DBIRTH";
+      if (type == "NDEATH" || type == "DDEATH")
+      {
+        unavailable(key, batch->m_timestamp, entities);
+      }
+      else if (birth || type == "NDATA" || type == "DDATA")
+      {
+        // A node birth is followed by the births of its devices
+        if (type == "NBIRTH")
+          std::erase_if(m_tables, [&key](const auto &entry) { return matches(entry.first, key); });
+        else if (birth)
+          m_tables.erase(key);
+
+        auto &table = m_tables[key];
+        for (auto &metric : payload.m_metrics)
+        {
+          auto binding = lookup(table, device, metric, birth);
+          if (!binding)
+            continue;
+          auto dataItem = binding->m_dataItem.lock();
+          if (!dataItem)
+            continue;
+
+          auto value = GetValue(metric, metric.m_datatype == DataType::UNKNOWN
+                                            ? binding->m_datatype
+                                            : metric.m_datatype);
+          if (!metric.m_isNull && holds_alternative<std::monostate>(value))
+            continue;
+
+          // A null metric has no value and makes the data item unavailable
+          Properties props;
+          if (dataItem->isCondition() && !metric.m_isNull)
+          {
+            ConvertValueToType(value, ValueType::STRING);
+            props.insert_or_assign("level", boost::to_upper_copy(std::get<string>(value)));
+          }
+          else if (!metric.m_isNull)
+          {
+            props.insert_or_assign("VALUE", value);
+          }
+
+          auto timestamp = metric.m_timestamp
+                               ? Timestamp(chrono::milliseconds(*metric.m_timestamp))
+                               : batch->m_timestamp;
+          forward(dataItem, std::move(props), timestamp, entities);
+        }
+      }
+      else
+      {
+        LOG(trace) << "SparkplugMapper: ignoring " << type << " message";
+      }
+    }
+
+    batch->setValue(entities);
+    return next(batch);
+  }
+}  // namespace mtconnect::pipeline
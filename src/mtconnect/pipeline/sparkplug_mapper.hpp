@@ -0,0 +1,145 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "mtconnect/config.hpp"
+#include "mtconnect/device_model/device.hpp"
+#include "mtconnect/entity/entity.hpp"
+#include "mtconnect/observation/observation.hpp"
+#include "shdr_token_mapper.hpp"
+#include "transform.hpp"
+
+namespace mtconnect::pipeline {
+  /// @brief Sparkplug B payload decoding
+  namespace sparkplug {
+    /// @brief The topic namespace for Sparkplug B messages
+    inline const std::string Namespace {"spBv1.0"};
+
+    /// @brief Sparkplug B metric data types
+    enum class DataType : uint32_t
+    {
+      UNKNOWN = 0,
+      INT8 = 1,
+      INT16 = 2,
+      INT32 = 3,
+      INT64 = 4,
+      UINT8 = 5,
+      UINT16 = 6,
+      UINT32 = 7,
+      UINT64 = 8,
+      FLOAT = 9,
+      DOUBLE = 10,
+      BOOLEAN = 11,
+      STRING = 12,
+      DATETIME = 13,
+      TEXT = 14
+    };
+
+    /// @brief A metric from a Sparkplug B payload
+    ///
+    /// Integer values are kept as the raw bits sent on the wire. Use `GetValue()` to interpret
+    /// them with the data type from the metric or the birth certificate.
+    struct Metric
+    {
+      std::optional<std::string> m_name;
+      std::optional<uint64_t> m_alias;
+      std::optional<uint64_t> m_timestamp;  ///< milliseconds since the epoch
+      DataType m_datatype {DataType::UNKNOWN};
+      bool m_isNull {false};
+      entity::Value m_value;  ///< `int64_t`, `double`, `bool`, or `std::string`
+    };
+
+    /// @brief A Sparkplug B payload
+    struct Payload
+    {
+      std::optional<uint64_t> m_timestamp;  ///< milliseconds since the epoch
+      std::optional<uint64_t> m_seq;
+      std::vector<Metric> m_metrics;
+    };
+
+    /// @brief Decode the protobuf encoding of a Sparkplug B payload
+    ///
+    /// Fields not needed to map metrics to data items, such as properties, data sets, and
+    /// templates, are skipped.
+    /// @param[in] buffer the encoded payload
+    /// @param[out] payload the decoded payload
+    /// @return `true` if the payload was well formed
+    bool AGENT_LIB_API Decode(std::string_view buffer, Payload &payload);
+
+    /// @brief Get the value of a metric as a property value
+    /// @param[in] metric the metric
+    /// @param[in] type the data type of the metric
+    /// @return the value or `std::monostate` if the metric has no value
+    entity::Value AGENT_LIB_API GetValue(const Metric &metric, DataType type);
+  }  // namespace sparkplug
+
+  /// @brief Map Sparkplug B payloads to observations
+  ///
+  /// Handles messages with topics of the form `spBv1.0/<group>/<type>/<edge node>[/<device>]`.
+  /// The birth certificates (`NBIRTH` and `DBIRTH`) are used to build an alias table per edge
+  /// node and device that maps the metric aliases directly to data items so the data messages
+  /// do not need to be resolved by name. Metric names are matched to the data item names or
+  /// ids of the Sparkplug device, the edge node, or the default device, trying the last part of
+  /// the metric path if the full name does not match. Death certificates make the data items
+  /// of the edge node or device `UNAVAILABLE`.
+  ///
+  /// Each observation is forwarded and one `Observations` entity is returned per payload.
+  class AGENT_LIB_API SparkplugMapper : public Transform
+  {
+  public:
+    SparkplugMapper(const SparkplugMapper &) = default;
+    SparkplugMapper(PipelineContextPtr context,
+                    const std::optional<std::string> &device = std::nullopt);
+
+    EntityPtr operator()(entity::EntityPtr &&entity) override;
+
+  protected:
+    /// @brief A metric resolved to a data item
+    struct Binding
+    {
+      std::weak_ptr<device_model::data_item::DataItem> m_dataItem;
+      sparkplug::DataType m_datatype {sparkplug::DataType::UNKNOWN};
+    };
+
+    /// @brief The metrics of an edge node or device from its birth certificate
+    struct AliasTable
+    {
+      std::unordered_map<uint64_t, Binding> m_aliases;
+      std::unordered_map<std::string, Binding> m_names;
+    };
+
+    DataItemPtr resolve(const std::string &device, const std::string &name);
+    const Binding *lookup(AliasTable &table, const std::string &device,
+                          const sparkplug::Metric &metric, bool birth);
+    void unavailable(const std::string &key, const Timestamp &timestamp, EntityList &entities);
+    void forward(const DataItemPtr &dataItem, entity::Properties &&props,
+                 const Timestamp &timestamp, EntityList &entities);
+
+  protected:
+    PipelineContextPtr m_context;
+    std::optional<std::string> m_defaultDevice;
+    std::unordered_map<std::string, AliasTable> m_tables;  ///< By `<group>/<edge>[/<device>]`
+  };
+}  // namespace mtconnect::pipeline
@@ -23,6 +23,7 @@
 #include "guard.hpp"
 #include "mtconnect/config.hpp"
 #include "mtconnect/entity/entity.hpp"
+#include "mtconnect/metrics/latency.hpp"
 #include "pipeline_context.hpp"
 
 namespace mtconnect {
@@ -113,6 +114,11 @@ namespace mtconnect {
           switch (t->check(entity.get()))
           {
             case RUN:
+              if (t->m_latency)
+              {
+                metrics::StageTimer timer(t->m_latency);
+                return (*t)(std::move(entity));
+              }
               return (*t)(std::move(entity));
 
             case SKIP:
@@ -156,6 +162,10 @@ namespace mtconnect {
       /// @param guard a guard
       void setGuard(const Guard &guard) { m_guard = guard; }
 
+      /// @brief set the histogram for the time spent in this transform
+      /// @param latency the histogram or `nullptr` to stop measuring
+      void setLatency(metrics::Histogram *latency) { m_latency = latency; }
+
       using TransformPair = std::pair<TransformPtr, TransformPtr>;
       using ListOfTransforms = std::list<TransformPair>;
 
@@ -264,6 +274,7 @@ namespace mtconnect {
       std::string m_name;
       TransformList m_next;
       Guard m_guard;
+      metrics::Histogram *m_latency {nullptr};
     };
 
     /// @brief A transform that just returns the entity. It does not call next.
@@ -0,0 +1,320 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#include "binary_printer.hpp"
+
+#include <bit>
+#include <cstring>
+#include <unordered_map>
+
+#include "mtconnect/asset/asset.hpp"
+#include "mtconnect/device_model/data_item/data_item.hpp"
+#include "mtconnect/observation/observation.hpp"
+
+using namespace std;
+
+namespace mtconnect::printer {
+  using namespace observation;
+  using namespace entity;
+
+  namespace {
+    /// @brief Appends the primitive encodings of the binary frame to a string
+    class FrameWriter
+    {
+    public:
+      FrameWriter(string &out) : m_out(out) {}
+
+      void byte(uint8_t v) { m_out.push_back(char(v)); }
+
+      template <typename E>
+      void tag(E e)
+      {
+        byte(uint8_t(e));
+      }
+
+      void varint(uint64_t v)
+      {
+        while (v >= 0x80)
+        {
+          m_out.push_back(char((v & 0x7F) | 0x80));
+          v >>= 7;
+        }
+        m_out.push_back(char(v));
+      }
+
+      void svarint(int64_t v) { varint((uint64_t(v) << 1) ^ uint64_t(v >> 63)); }
+
+      void real(double v)
+      {
+        auto bits = std::bit_cast<uint64_t>(v);
+        for (int i = 0; i < 8; i++, bits >>= 8)
+          m_out.push_back(char(bits & 0xFF));
+      }
+
+      void str(const string &s)
+      {
+        varint(s.size());
+        m_out.append(s);
+      }
+
+      void header(BinaryPrinter::FrameType type, uint64_t instanceId, uint64_t bufferSize,
+                  uint64_t nextSeq, uint64_t firstSeq, uint64_t lastSeq,
+                  const optional<string> &requestId)
+      {
+        m_out.append("MTCB");
+        byte(BinaryPrinter::FrameVersion);
+        tag(type);
+        varint(instanceId);
+        varint(bufferSize);
+        varint(nextSeq);
+        varint(firstSeq);
+        varint(lastSeq);
+        str(requestId.value_or(""));
+      }
+
+      void micros(const Timestamp &ts)
+      {
+        svarint(chrono::duration_cast<chrono::microseconds>(ts.time_since_epoch()).count());
+      }
+
+      void value(const Value &v)
+      {
+        using VT = BinaryPrinter::ValueTag;
+        visit(overloaded {[this](const string &s) {
+                            tag(VT::STRING);
+                            str(s);
+                          },
+                          [this](const int64_t &i) {
+                            tag(VT::INTEGER);
+                            svarint(i);
+                          },
+                          [this](const double &d) {
+                            tag(VT::DOUBLE);
+                            real(d);
+                          },
+                          [this](const bool &b) {
+                            tag(VT::BOOL);
+                            byte(b ? 1 : 0);
+                          },
+                          [this](const Vector &vec) {
+                            tag(VT::VECTOR);
+                            varint(vec.size());
+                            for (auto d : vec)
+                              real(d);
+                          },
+                          [this](const DataSet &set) {
+                            tag(VT::DATA_SET);
+                            dataSet(set);
+                          },
+                          [this](const Timestamp &ts) {
+                            tag(VT::TIMESTAMP);
+                            micros(ts);
+                          },
+                          [this](const EntityPtr &e) {
+                            tag(VT::ENTITY);
+                            entity(e->getName(), e->getProperties());
+                          },
+                          [this](const EntityList &list) {
+                            tag(VT::ENTITY_LIST);
+                            varint(list.size());
+                            for (const auto &e : list)
+                              entity(e->getName(), e->getProperties());
+                          },
+                          [this](const auto &) { tag(VT::NIL); }},
+              v);
+      }
+
+      template <typename T>
+      void dataSet(const data_set::Set<T> &set)
+      {
+        using VT = BinaryPrinter::ValueTag;
+        varint(set.size());
+        for (const auto &e : set)
+        {
+          str(e.m_key);
+          byte(e.m_removed ? 1 : 0);
+          visit(overloaded {[this](const string &s) {
+                              tag(VT::STRING);
+                              str(s);
+                            },
+                            [this](const int64_t &i) {
+                              tag(VT::INTEGER);
+                              svarint(i);
+                            },
+                            [this](const double &d) {
+                              tag(VT::DOUBLE);
+                              real(d);
+                            },
+                            [this](const TableRow &row) {
+                              tag(VT::DATA_SET);
+                              dataSet(row);
+                            },
+                            [this](const monostate &) { tag(VT::NIL); }},
+                e.m_value);
+        }
+      }
+
+      /// @brief write an entity with the properties that are not in the skip set
+      void entity(const string &name, const Properties &props,
+                  const Properties *skip = nullptr)
+      {
+        auto included = [skip](const auto &key) {
+          return !skip || (skip->count(key) == 0 && key != "timestamp" && key != "sequence");
+        };
+
+        str(name);
+        varint(count_if(props.begin(), props.end(),
+                        [&](const auto &p) { return included(p.first); }));
+        for (const auto &[key, v] : props)
+        {
+          if (included(key))
+          {
+            str(key);
+            value(v);
+          }
+        }
+      }
+
+    protected:
+      string &m_out;
+    };
+  }  // namespace
+
+  std::string BinaryPrinter::printErrors(const uint64_t instanceId, const unsigned int bufferSize,
+                                         const uint64_t nextSeq, const entity::EntityList &list,
+                                         bool pretty,
+                                         const std::optional<std::string> requestId) const
+  {
+    string out;
+    FrameWriter writer(out);
+    writer.header(FrameType::ERRORS, instanceId, bufferSize, nextSeq, 0, 0, requestId);
+    writer.varint(list.size());
+    for (const auto &error : list)
+      writer.entity(error->getName(), error->getProperties());
+
+    return out;
+  }
+
+  std::string BinaryPrinter::printUnsupported(const uint64_t instanceId,
+                                              const unsigned int bufferSize,
+                                              const uint64_t nextSeq, const std::string &request,
+                                              const std::optional<std::string> &requestId) const
+  {
+    auto error = make_shared<Entity>(
+        "Error", Properties {{"errorCode", "UNSUPPORTED"s},
+                             {"ErrorMessage", "The binary format does not support "s + request}});
+    return printErrors(instanceId, bufferSize, nextSeq, EntityList {error}, false, requestId);
+  }
+
+  std::string BinaryPrinter::printProbe(const uint64_t instanceId, const unsigned int bufferSize,
+                                        const uint64_t nextSeq, const unsigned int assetBufferSize,
+                                        const unsigned int assetCount,
+                                        const std::list<DevicePtr> &devices,
+                                        const std::map<std::string, size_t> *count,
+                                        bool includeHidden, bool pretty,
+                                        const std::optional<std::string> requestId) const
+  {
+    return printUnsupported(instanceId, bufferSize, nextSeq, "probe", requestId);
+  }
+
+  std::string BinaryPrinter::printAssets(const uint64_t instanceId, const unsigned int bufferSize,
+                                         const unsigned int assetCount,
+                                         const asset::AssetList &asset, bool pretty,
+                                         const std::optional<std::string> requestId) const
+  {
+    return printUnsupported(instanceId, bufferSize, 0, "assets", requestId);
+  }
+
+  std::string BinaryPrinter::printSample(const uint64_t instanceId, const unsigned int bufferSize,
+                                         const uint64_t nextSeq, const uint64_t firstSeq,
+                                         const uint64_t lastSeq, ObservationList &observations,
+                                         bool pretty,
+                                         const std::optional<std::string> requestId) const
+  {
+    string out;
+    FrameWriter writer(out);
+    writer.header(FrameType::STREAMS, instanceId, bufferSize, nextSeq, firstSeq, lastSeq, requestId);
+
+    // Data item id table for this frame
+    unordered_map<const device_model::data_item::DataItem *, uint64_t> index;
+    vector<const string *> ids;
+    for (const auto &observation : observations)
+    {
+      auto dataItem = observation->getDataItem().get();
+      if (index.try_emplace(dataItem, ids.size()).second)
+        ids.push_back(&dataItem->getId());
+    }
+
+    writer.varint(ids.size());
+    for (const auto id : ids)
+      writer.str(*id);
+
+    writer.varint(observations.size());
+    int64_t sequence = firstSeq, timestamp = 0;
+    for (const auto &observation : observations)
+    {
+      auto dataItem = observation->getDataItem();
+      writer.varint(index[dataItem.get()]);
+
+      writer.svarint(int64_t(observation->getSequence()) - sequence);
+      sequence = observation->getSequence();
+      auto ts = chrono::duration_cast<chrono::microseconds>(
+                    observation->getTimestamp().time_since_epoch())
+                    .count();
+      writer.svarint(ts - timestamp);
+      timestamp = ts;
+
+      // Values that carry all their information in the value are written directly
+      const auto &diProps = dataItem->getObservationProperties();
+      bool simple = !dataItem->isCondition();
+      for (auto it = observation->getProperties().begin();
+           simple && it != observation->getProperties().end(); it++)
+      {
+        const auto &key = it->first;
+        simple = key == "VALUE" || key == "timestamp" || key == "sequence" || diProps.count(key);
+      }
+
+      const auto &value = observation->getValue();
+      if (simple && observation->isUnavailable())
+      {
+        writer.tag(Kind::UNAVAILABLE);
+      }
+      else if (simple && holds_alternative<double>(value))
+      {
+        writer.tag(Kind::DOUBLE);
+        writer.real(get<double>(value));
+      }
+      else if (simple && holds_alternative<int64_t>(value))
+      {
+        writer.tag(Kind::INTEGER);
+        writer.svarint(get<int64_t>(value));
+      }
+      else if (simple && holds_alternative<string>(value))
+      {
+        writer.tag(Kind::STRING);
+        writer.str(get<string>(value));
+      }
+      else
+      {
+        writer.tag(Kind::ENTITY);
+        writer.entity(observation->getName(), observation->getProperties(), &diProps);
+      }
+    }
+
+    return out;
+  }
+}  // namespace mtconnect::printer
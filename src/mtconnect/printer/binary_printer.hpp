@@ -0,0 +1,119 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include "mtconnect/config.hpp"
+#include "mtconnect/printer/printer.hpp"
+#include "mtconnect/utilities.hpp"
+
+namespace mtconnect::printer {
+  /// @brief Printer to generate compact binary frames for streaming observations
+  ///
+  /// The frame is defined and versioned by the agent. All integers are unsigned LEB128 varints,
+  /// signed integers are zig-zag encoded varints, doubles are 8 byte little endian IEEE 754, and
+  /// strings are a varint byte length followed by UTF-8 bytes.
+  ///
+  /// ```
+  /// frame       := "MTCB" version:u8 type:u8 header body
+  /// header      := instanceId bufferSize nextSequence firstSequence lastSequence requestId:string
+  /// body(1)     := count:varint dataItemId:string... count:varint observation...  (streams)
+  /// body(2)     := count:varint entity...                                       (errors)
+  /// observation := dataItem:varint sequence:delta timestamp:delta kind:u8 payload
+  /// kind        := Kind
+  /// entity      := name:string count:varint (key:string value)...
+  /// value       := tag:ValueTag payload
+  /// ```
+  ///
+  /// `dataItem` is the index into the data item id table of the frame. `sequence` is the
+  /// difference from the previous observation, starting from `firstSequence`, and `timestamp` is
+  /// the difference in microseconds from the previous observation, starting from the epoch.
+  /// Observations that have properties beyond their value, such as conditions, data sets and
+  /// tables, are sent as an entity with the observation element name and its properties.
+  ///
+  /// Only `sample` and `current` have a binary representation; other requests return an errors
+  /// frame with an `UNSUPPORTED` error.
+  class AGENT_LIB_API BinaryPrinter : public Printer
+  {
+  public:
+    /// @brief The version of the frame format
+    static constexpr uint8_t FrameVersion = 1;
+
+    /// @brief The type of frame following the version
+    enum class FrameType : uint8_t
+    {
+      STREAMS = 1,  ///< Observations from a sample or current request
+      ERRORS = 2    ///< A list of errors
+    };
+
+    /// @brief The encoding of an observation value
+    enum class Kind : uint8_t
+    {
+      UNAVAILABLE = 0,
+      DOUBLE = 1,
+      INTEGER = 2,
+      STRING = 3,
+      ENTITY = 4
+    };
+
+    /// @brief The tag for an entity property value
+    enum class ValueTag : uint8_t
+    {
+      NIL = 0,
+      STRING = 1,
+      INTEGER = 2,
+      DOUBLE = 3,
+      BOOL = 4,
+      VECTOR = 5,
+      DATA_SET = 6,
+      TIMESTAMP = 7,
+      ENTITY = 8,
+      ENTITY_LIST = 9
+    };
+
+    BinaryPrinter(bool validation = false) : Printer(false, validation) {}
+    ~BinaryPrinter() override = default;
+
+    std::string printErrors(
+        const uint64_t instanceId, const unsigned int bufferSize, const uint64_t nextSeq,
+        const entity::EntityList &list, bool pretty = false,
+        const std::optional<std::string> requestId = std::nullopt) const override;
+
+    std::string printProbe(
+        const uint64_t instanceId, const unsigned int bufferSize, const uint64_t nextSeq,
+        const unsigned int assetBufferSize, const unsigned int assetCount,
+        const std::list<DevicePtr> &devices, const std::map<std::string, size_t> *count = nullptr,
+        bool includeHidden = false, bool pretty = false,
+        const std::optional<std::string> requestId = std::nullopt) const override;
+
+    std::string printSample(
+        const uint64_t instanceId, const unsigned int bufferSize, const uint64_t nextSeq,
+        const uint64_t firstSeq, const uint64_t lastSeq, observation::ObservationList &results,
+        bool pretty = false,
+        const std::optional<std::string> requestId = std::nullopt) const override;
+    std::string printAssets(
+        const uint64_t anInstanceId, const unsigned int bufferSize, const unsigned int assetCount,
+        const asset::AssetList &asset, bool pretty = false,
+        const std::optional<std::string> requestId = std::nullopt) const override;
+    std::string mimeType() const override { return "application/vnd.mtconnect.binary"; }
+
+  protected:
+    std::string printUnsupported(const uint64_t instanceId, const unsigned int bufferSize,
+                                 const uint64_t nextSeq, const std::string &request,
+                                 const std::optional<std::string> &requestId) const;
+  };
+}  // namespace mtconnect::printer
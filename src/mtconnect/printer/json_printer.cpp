@@ -191,6 +191,64 @@ namespace mtconnect::printer {
     return string(output.GetString(), output.GetLength());
   }
 
+  /// @brief get the text of an asset from the render cache
+  ///
+  /// Version 1 caches the asset object with its name as the key and version 2 caches the
+  /// properties of the asset since the name is shared by all the assets of the same type.
+  inline entity::RenderCache::Text cachedAsset(uint32_t jsonVersion, const asset::AssetPtr &asset)
+  {
+    const auto &cache = asset->getRenderCache();
+    uint32_t key = JSON_ASSET | jsonVersion;
+    auto text = cache.get(key);
+    if (!text)
+    {
+      entity::JsonEntityPrinter printer(jsonVersion, false);
+      if (jsonVersion == 1)
+        text = make_shared<const string>(printer.print(asset));
+      else
+        text = make_shared<const string>(printer.printEntity(asset));
+      cache.put(key, text);
+    }
+    return text;
+  }
+
+  /// @brief write a list of assets using the text from their render caches
+  ///
+  /// Follows the layout of `entity::JsonPrinter::printEntityList()`.
+  template <typename T>
+  void printCachedAssets(T &writer, uint32_t jsonVersion, const asset::AssetList &assets)
+  {
+    if (jsonVersion == 1)
+    {
+      AutoJsonArray ary(writer);
+      for (const auto &asset : assets)
+      {
+        auto text = cachedAsset(jsonVersion, asset);
+        writer.RawValue(text->data(), text->size(), rapidjson::kObjectType);
+      }
+    }
+    else
+    {
+      AutoJsonObject obj(writer);
+      std::multimap<std::string_view, asset::AssetPtr> byName;
+      for (const auto &asset : assets)
+        byName.emplace(std::string_view(asset->getName()), asset);
+
+      for (auto it = byName.begin(); it != byName.end();)
+      {
+        auto next = byName.upper_bound(it->first);
+        obj.Key(it->first);
+
+        AutoJsonArray ary(writer);
+        for (; it != next; it++)
+        {
+          auto text = cachedAsset(jsonVersion, it->second);
+          writer.RawValue(text->data(), text->size(), rapidjson::kObjectType);
+        }
+      }
+    }
+  }
+
   std::string JsonPrinter::printAssets(const uint64_t instanceId, const unsigned int bufferSize,
                                        const unsigned int assetCount, const asset::AssetList &asset,
                                        bool pretty,
@@ -212,7 +270,10 @@ namespace mtconnect::printer {
       }
       {
         obj.Key("Assets");
-        printer.printEntityList(asset);
+        if (m_assetRenderCache && !(m_pretty || pretty))
+          printCachedAssets(writer, m_jsonVersion, asset);
+        else
+          printer.printEntityList(asset);
       }
     });
     return string(output.GetString(), output.GetLength());
@@ -258,14 +319,60 @@ namespace mtconnect::printer {
           const_mem_fun<ObservationRef, std::string_view, &ObservationRef::getType>,
           const_mem_fun<ObservationRef, SequenceNumber_t, &ObservationRef::getSequence>>>>>;
 
+  /// @brief write an observation with a printer specialized for the JSON version
+  ///
+  /// Samples, events and conditions with scalar values are written directly to the writer, only
+  /// observations with vectors or data sets use the generic entity walk. Version 1 wraps the
+  /// properties in an object keyed by the observation name.
+  template <uint32_t Version, typename T>
+  inline void printObservation(T &writer, entity::JsonPrinter<T, Version> &printer,
+                               const ObservationPtr &observation)
+  {
+    if constexpr (Version == 1)
+    {
+      AutoJsonObject obj(writer);
+      obj.Key(observation->getName());
+      if (!printer.printScalarEntity(observation))
+        printer.printEntity(observation);
+    }
+    else
+    {
+      if (!printer.printScalarEntity(observation))
+        printer.printEntity(observation);
+    }
+  }
+
+  /// @brief write an observation using the text from the render cache
+  ///
+  /// The text is rendered without pretty printing the first time the observation is written and
+  /// spliced into the document as a raw value.
+  template <uint32_t Version, typename T>
+  void printCachedObservation(T &writer, const ObservationPtr &observation)
+  {
+    const auto &cache = observation->getRenderCache();
+    uint32_t key = JSON_OBSERVATION | Version;
+    auto text = cache.get(key);
+    if (!text)
+    {
+      using PlainWriter = rapidjson::Writer<rapidjson::StringBuffer>;
+      rapidjson::StringBuffer output;
+      PlainWriter plain(output);
+      entity::JsonPrinter<PlainWriter, Version> printer(plain, Version);
+      printObservation(plain, printer, observation);
+      text = std::make_shared<const string>(output.GetString(), output.GetLength());
+      cache.put(key, text);
+    }
+    writer.RawValue(text->data(), text->size(), rapidjson::kObjectType);
+  }
+
   template <typename T>
-  void printSampleVersion1(T &writer, uint32_t jsonVersion, ObservationMap &observations)
+  void printSampleVersion1(T &writer, ObservationMap &observations, bool cache)
   {
     using WriterType = decltype(writer);
     using StackType = JsonStack<WriterType>;
 
     StackType stack(writer);
-    entity::JsonPrinter printer(writer, jsonVersion);
+    entity::JsonPrinter<T, 1> printer(writer, 1);
 
     AutoJsonArray streams(writer, "Streams");
 
@@ -313,14 +420,17 @@ namespace mtconnect::printer {
         stack.addArray(ref.m_dataItem->getCategoryText());
       }
 
-      printer.print(ref.m_observation);
+      if (cache)
+        printCachedObservation<1>(writer, ref.m_observation);
+      else
+        printObservation(writer, printer, ref.m_observation);
     }
 
     stack.clear();
   }
 
   template <typename T>
-  void printSampleVersion2(T &writer, uint32_t jsonVersion, ObservationMap &observations)
+  void printSampleVersion2(T &writer, ObservationMap &observations, bool cache)
   {
     using WriterType = decltype(writer);
     using StackType = JsonStack<WriterType>;
@@ -328,7 +438,7 @@ namespace mtconnect::printer {
     AutoJsonObject streams(writer, "Streams");
     AutoJsonArray devStream(writer, "DeviceStream");
     StackType stack(writer);
-    entity::JsonPrinter printer(writer, jsonVersion);
+    entity::JsonPrinter<T, 2> printer(writer, 2);
 
     std::string_view deviceId;
     std::string_view componentId;
@@ -385,7 +495,10 @@ namespace mtconnect::printer {
         stack.addArray(obsType);
       }
 
-      printer.printEntity(ref.m_observation);
+      if (cache)
+        printCachedObservation<2>(writer, ref.m_observation);
+      else
+        printObservation(writer, printer, ref.m_observation);
     }
 
     stack.clear();
@@ -421,10 +534,11 @@ namespace mtconnect::printer {
               obs.emplace(o);
           }
 
+          bool cache = m_renderCache && !(m_pretty || pretty);
           if (m_jsonVersion == 1)
-            printSampleVersion1(writer, m_jsonVersion, obs);
+            printSampleVersion1(writer, obs, cache);
           else if (m_jsonVersion == 2)
-            printSampleVersion2(writer, m_jsonVersion, obs);
+            printSampleVersion2(writer, obs, cache);
         }
         else
         {
@@ -43,6 +43,17 @@ namespace mtconnect {
 
     using ProtoErrorList = std::list<std::pair<std::string, std::string>>;
 
+    /// @brief Keys for the serialized observations and assets in the render caches
+    ///
+    /// The format is in the upper bits and is combined with the version in the lower 16 bits.
+    enum RenderCacheKey : uint32_t
+    {
+      XML_OBSERVATION = 0x10000,   //! XML element, combined with the integer schema version
+      JSON_OBSERVATION = 0x20000,  //! JSON value, combined with the JSON version
+      XML_ASSET = 0x30000,         //! XML element, combined with the integer schema version
+      JSON_ASSET = 0x40000         //! JSON value, combined with the JSON version
+    };
+
     /// @brief Abstract document generator interface
     class AGENT_LIB_API Printer
     {
@@ -163,9 +174,33 @@ namespace mtconnect {
       /// @param validation the validation state
       void setValidation(bool v) { m_validation = v; }
 
+      /// @brief enable reuse of the serialized observations across documents
+      ///
+      /// Pretty printed documents are always generated from the observations since the
+      /// indentation depends on the document.
+      ///
+      /// @param cache `true` to cache the serialized observations
+      void setRenderCache(bool cache) { m_renderCache = cache; }
+      /// @brief get the render cache state
+      /// @return `true` if serialized observations are cached
+      bool getRenderCache() const { return m_renderCache; }
+
+      /// @brief enable reuse of the serialized assets across documents
+      ///
+      /// An asset is serialized again after it changes. Pretty printed documents are always
+      /// generated from the assets.
+      ///
+      /// @param cache `true` to cache the serialized assets
+      void setAssetRenderCache(bool cache) { m_assetRenderCache = cache; }
+      /// @brief get the asset render cache state
+      /// @return `true` if serialized assets are cached
+      bool getAssetRenderCache() const { return m_assetRenderCache; }
+
     protected:
-      bool m_pretty;      //< Turns pretty printing on
-      bool m_validation;  //< Sets validation flag in header
+      bool m_pretty;               //< Turns pretty printing on
+      bool m_validation;           //< Sets validation flag in header
+      bool m_renderCache {false};       //< Reuse serialized observations
+      bool m_assetRenderCache {false};  //< Reuse serialized assets
       std::string m_modelChangeTime;
       std::optional<std::string> m_schemaVersion;
       std::string m_senderName {"localhost"};
@@ -309,10 +309,14 @@ namespace mtconnect::printer {
     try
     {
       XmlWriter writer(m_pretty || pretty);
-
       initXmlDoc(writer, eSTREAMS, instanceId, bufferSize, 0, 0, nextSeq, firstSeq, lastSeq,
                  nullptr, requestId);
 
+      // The markup depends on the schema version, so the version is part of the cache key
+      uint32_t cacheKey = 0;
+      if (m_renderCache && !(m_pretty || pretty))
+        cacheKey = XML_OBSERVATION | uint32_t(IntSchemaVersion(*m_schemaVersion));
+
       AutoElement streams(writer, "Streams");
 
       // Sort the vector by category.
@@ -357,7 +361,7 @@ namespace mtconnect::printer {
 
                 categoryElement.reset(dataItem->getCategoryText());
 
-                addObservation(writer, observation);
+                addObservation(writer, observation, cacheKey);
               }
             }
           }
@@ -392,13 +396,17 @@ namespace mtconnect::printer {
       initXmlDoc(writer, eASSETS, instanceId, 0u, bufferSize, assetCount, 0ull, 0, 0, nullptr,
                  requestId);
 
+      // The markup depends on the schema version, so the version is part of the cache key
+      uint32_t cacheKey = 0;
+      if (m_assetRenderCache && !(m_pretty || pretty))
+        cacheKey = XML_ASSET | uint32_t(IntSchemaVersion(*m_schemaVersion));
+
       {
         AutoElement ele(writer, "Assets");
-        entity::XmlPrinter printer;
 
         for (const auto &asset : asset)
         {
-          printer.print(writer, asset, m_assetNsSet);
+          addAsset(writer, asset, cacheKey);
         }
       }
 
@@ -416,10 +424,54 @@ namespace mtconnect::printer {
     return ret;
   }
 
-  void XmlPrinter::addObservation(xmlTextWriterPtr writer, ObservationPtr result) const
+  void XmlPrinter::addObservation(xmlTextWriterPtr writer, ObservationPtr result,
+                                  uint32_t cacheKey) const
+  {
+    entity::XmlPrinter printer;
+    if (cacheKey != 0)
+    {
+      // Render the element once and splice the text into every document
+      const auto &renderCache = result->getRenderCache();
+      auto text = renderCache.get(cacheKey);
+      if (!text)
+      {
+        XmlWriter fragment(false);
+        printer.print(fragment, result, m_streamsNsSet);
+        text = make_shared<const string>(fragment.getFragment());
+        renderCache.put(cacheKey, text);
+      }
+      THROW_IF_XML2_ERROR(
+          xmlTextWriterWriteRawLen(writer, BAD_CAST text->data(), int(text->size())));
+    }
+    else
+    {
+      printer.print(writer, result, m_streamsNsSet);
+    }
+  }
+
+  void XmlPrinter::addAsset(xmlTextWriterPtr writer, const AssetPtr &asset,
+                            uint32_t cacheKey) const
   {
     entity::XmlPrinter printer;
-    printer.print(writer, result, m_streamsNsSet);
+    if (cacheKey != 0)
+    {
+      // Render the asset once and splice the text into every document until it changes
+      const auto &renderCache = asset->getRenderCache();
+      auto text = renderCache.get(cacheKey);
+      if (!text)
+      {
+        XmlWriter fragment(false);
+        printer.print(fragment, asset, m_assetNsSet);
+        text = make_shared<const string>(fragment.getFragment());
+        renderCache.put(cacheKey, text);
+      }
+      THROW_IF_XML2_ERROR(
+          xmlTextWriterWriteRawLen(writer, BAD_CAST text->data(), int(text->size())));
+    }
+    else
+    {
+      printer.print(writer, asset, m_assetNsSet);
+    }
   }
 
   void XmlPrinter::initXmlDoc(xmlTextWriterPtr writer, EDocumentType aType,
@@ -183,7 +183,14 @@ namespace mtconnect {
       void printProbeHelper(xmlTextWriterPtr writer, device_model::ComponentPtr component,
                             const char *name) const;
       void printDataItem(xmlTextWriterPtr writer, DataItemPtr dataItem) const;
-      void addObservation(xmlTextWriterPtr writer, observation::ObservationPtr result) const;
+      /// @brief print an observation
+      /// @param cacheKey the render cache key or `0` to print without the render cache
+      void addObservation(xmlTextWriterPtr writer, observation::ObservationPtr result,
+                          uint32_t cacheKey = 0) const;
+      /// @brief print an asset
+      /// @param cacheKey the render cache key or `0` to print without the render cache
+      void addAsset(xmlTextWriterPtr writer, const asset::AssetPtr &asset,
+                    uint32_t cacheKey = 0) const;
 
     protected:
       std::map<std::string, SchemaNamespace> m_devicesNamespaces;
@@ -77,6 +77,15 @@ namespace mtconnect::printer {
       return std::string((char *)xmlBufferContent(m_buf), xmlBufferLength(m_buf));
     }
 
+    /// @brief Get the content written so far without ending the document. Used for elements
+    /// that are written without a document.
+    /// @return content as a string
+    std::string getFragment()
+    {
+      THROW_IF_XML2_ERROR(xmlTextWriterFlush(m_writer));
+      return std::string((char *)xmlBufferContent(m_buf), xmlBufferLength(m_buf));
+    }
+
   protected:
     xmlTextWriterPtr m_writer;
     xmlBufferPtr m_buf;
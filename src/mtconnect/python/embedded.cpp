@@ -17,6 +17,8 @@
 
 #include "embedded.hpp"
 
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/python.hpp>
 #include <boost/python/dict.hpp>
 #include <boost/python/extract.hpp>
@@ -24,15 +26,23 @@
 #include <boost/python/str.hpp>
 #include <boost/python/tuple.hpp>
 
-#include <iostream>
+#include <chrono>
+#include <filesystem>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
 #include <string>
 
-#include "adapter/adapter.hpp"
-#include "agent.hpp"
-#include "device_model/device.hpp"
-#include "entity.hpp"
-#include "pipeline/guard.hpp"
-#include "pipeline/transform.hpp"
+#include "mtconnect/agent.hpp"
+#include "mtconnect/configuration/agent_config.hpp"
+#include "mtconnect/device_model/device.hpp"
+#include "mtconnect/entity/entity.hpp"
+#include "mtconnect/logging.hpp"
+#include "mtconnect/observation/observation.hpp"
+#include "mtconnect/pipeline/guard.hpp"
+#include "mtconnect/pipeline/transform.hpp"
+#include "mtconnect/source/source.hpp"
 
 using namespace std;
 
@@ -52,6 +62,8 @@ namespace mtconnect {
       object m_entity;
       object m_transform;
       object m_pipeline;
+      object m_batch;
+      object m_sampleBuffer;
     };
     using ContextPtr = Context *;
 
@@ -61,6 +73,14 @@ namespace mtconnect {
       ContextPtr m_context;
     };
 
+    // Pipeline threads must hold the GIL while they call into Python
+    struct GilLock
+    {
+      GilLock() : m_state(PyGILState_Ensure()) {}
+      ~GilLock() { PyGILState_Release(m_state); }
+      PyGILState_STATE m_state;
+    };
+
     static object wrap(EntityPtr entity, ContextPtr context);
 
     struct EntityWrapper : Wrapper
@@ -139,18 +159,18 @@ namespace mtconnect {
           .def("get_list", &EntityWrapper::get_list);
     }
 
-    using TransformFun = function<const entity::EntityPtr(const entity::EntityPtr)>;
+    using TransformFun = function<entity::EntityPtr(entity::EntityPtr)>;
 
     class PythonTransform : public pipeline::Transform
     {
     public:
       using pipeline::Transform::Transform;
-      const entity::EntityPtr operator()(const entity::EntityPtr entity) override
+      entity::EntityPtr operator()(entity::EntityPtr &&entity) override
       {
         if (m_function)
-          return m_function(entity);
+          return m_function(std::move(entity));
         else
-          return entity;
+          return std::move(entity);
       }
 
       string name() { return m_name; }
@@ -166,13 +186,15 @@ namespace mtconnect {
       {
         m_transform = shared_ptr<PythonTransform>(new PythonTransform(name));
         m_transform->m_function = [this](const EntityPtr entity) {
+          GilLock lock;
           object ent = wrap(entity, m_context);
           auto res = run(ent);
           EntityWrapper &wrap = extract<EntityWrapper &>(res);
           return wrap.m_entity;
         };
-        m_transform->setGuard([this](const EntityPtr entity) {
-          object obj = wrap(entity, m_context);
+        m_transform->setGuard([this](const Entity *entity) {
+          GilLock lock;
+          object obj = wrap(entity->getptr(), m_context);
           return guard(obj);
         });
       }
@@ -180,7 +202,7 @@ namespace mtconnect {
       object next(object entity)
       {
         EntityWrapper &e = extract<EntityWrapper &>(entity);
-        auto res = m_transform->next(e.m_entity);
+        auto res = m_transform->next(EntityPtr(e.m_entity));
         return wrap(res, m_context);
       }
 
@@ -193,7 +215,7 @@ namespace mtconnect {
         else
         {
           EntityWrapper &e = extract<EntityWrapper &>(entity);
-          auto res = (*m_transform)(e.m_entity);
+          auto res = (*m_transform)(EntityPtr(e.m_entity));
           return wrap(res, m_context);
         }
       }
@@ -208,7 +230,7 @@ namespace mtconnect {
         else
         {
           EntityWrapper &e = extract<EntityWrapper &>(entity);
-          auto res = m_transform->check(e.m_entity);
+          auto res = m_transform->check(e.m_entity.get());
           return res;
         }
       }
@@ -218,20 +240,353 @@ namespace mtconnect {
       PythonTransformPtr m_transform;
     };
 
+    // A read only, one dimensional buffer of numbers that implements the Python buffer
+    // protocol. NumPy can use the memory without copying with numpy.frombuffer or
+    // numpy.asarray.
+    struct SampleBuffer
+    {
+      PyObject ob_base;
+      std::string *m_data;
+      const char *m_format;
+      Py_ssize_t m_shape;
+    };
+
+    static int sampleBufferGet(PyObject *self, Py_buffer *view, int flags)
+    {
+      auto buffer = reinterpret_cast<SampleBuffer *>(self);
+      if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE)
+      {
+        PyErr_SetString(PyExc_BufferError, "sample buffers are read only");
+        view->obj = nullptr;
+        return -1;
+      }
+
+      Py_INCREF(self);
+      view->obj = self;
+      view->buf = buffer->m_data->data();
+      view->len = buffer->m_data->size();
+      view->readonly = 1;
+      view->itemsize = sizeof(double);
+      view->format =
+          ((flags & PyBUF_FORMAT) == PyBUF_FORMAT) ? const_cast<char *>(buffer->m_format) : nullptr;
+      view->ndim = 1;
+      view->shape = ((flags & PyBUF_ND) == PyBUF_ND) ? &buffer->m_shape : nullptr;
+      view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? &view->itemsize : nullptr;
+      view->suboffsets = nullptr;
+      view->internal = nullptr;
+      return 0;
+    }
+
+    static Py_ssize_t sampleBufferLength(PyObject *self)
+    {
+      return reinterpret_cast<SampleBuffer *>(self)->m_shape;
+    }
+
+    static void sampleBufferFree(PyObject *self)
+    {
+      auto type = Py_TYPE(self);
+      delete reinterpret_cast<SampleBuffer *>(self)->m_data;
+      type->tp_free(self);
+      Py_DECREF(type);
+    }
+
+    static PyType_Slot SampleBufferSlots[] = {
+        {Py_bf_getbuffer, reinterpret_cast<void *>(sampleBufferGet)},
+        {Py_sq_length, reinterpret_cast<void *>(sampleBufferLength)},
+        {Py_tp_dealloc, reinterpret_cast<void *>(sampleBufferFree)},
+        {0, nullptr}};
+
+    static PyType_Spec SampleBufferSpec = {"pipeline.SampleBuffer", sizeof(SampleBuffer), 0,
+                                           Py_TPFLAGS_DEFAULT, SampleBufferSlots};
+
+    // Both doubles and int64 timestamps are eight bytes
+    static_assert(sizeof(double) == sizeof(int64_t));
+
+    static object makeSampleBuffer(ContextPtr context, std::string &&data, const char *format)
+    {
+      auto type = reinterpret_cast<PyTypeObject *>(context->m_sampleBuffer.ptr());
+      auto obj = type->tp_alloc(type, 0);
+      if (obj == nullptr)
+        throw_error_already_set();
+
+      auto buffer = reinterpret_cast<SampleBuffer *>(obj);
+      buffer->m_shape = data.size() / sizeof(double);
+      buffer->m_data = new std::string(std::move(data));
+      buffer->m_format = format;
+      return object(handle<>(obj));
+    }
+
+    // The observations of one flush of a batch transform. The values of scalar samples are
+    // grouped by data item so they can be used as arrays.
+    struct BatchWrapper : Wrapper
+    {
+      struct Samples
+      {
+        std::string m_values;
+        std::string m_timestamps;
+        object m_valueBuffer;
+        object m_timestampBuffer;
+      };
+
+      BatchWrapper() {}
+
+      void collect()
+      {
+        using namespace std::chrono;
+        for (auto &entity : m_entities)
+        {
+          auto sample = dynamic_pointer_cast<observation::Sample>(entity);
+          if (!sample || sample->isOrphan())
+            continue;
+
+          double value;
+          const auto &v = sample->getValue();
+          if (sample->isUnavailable())
+            value = numeric_limits<double>::quiet_NaN();
+          else if (holds_alternative<double>(v))
+            value = std::get<double>(v);
+          else if (holds_alternative<int64_t>(v))
+            value = double(std::get<int64_t>(v));
+          else
+            continue;
+
+          int64_t timestamp =
+              duration_cast<microseconds>(sample->getTimestamp().time_since_epoch()).count();
+          auto &samples = m_samples[sample->getDataItem()->getId()];
+          samples.m_values.append(reinterpret_cast<const char *>(&value), sizeof(value));
+          samples.m_timestamps.append(reinterpret_cast<const char *>(&timestamp),
+                                      sizeof(timestamp));
+        }
+      }
+
+      size_t size() { return m_entities.size(); }
+
+      object get(long index)
+      {
+        if (index < 0)
+          index += long(m_entities.size());
+        if (index < 0 || index >= long(m_entities.size()))
+        {
+          PyErr_SetString(PyExc_IndexError, "batch index out of range");
+          throw_error_already_set();
+        }
+        return wrap(*std::next(m_entities.begin(), index), m_context);
+      }
+
+      py::list entities()
+      {
+        py::list l;
+        for (auto &e : m_entities)
+          l.append(wrap(e, m_context));
+        return l;
+      }
+
+      py::list data_items()
+      {
+        py::list l;
+        for (auto &s : m_samples)
+          l.append(s.first);
+        return l;
+      }
+
+      // The values of the samples of a data item as doubles, UNAVAILABLE is NaN
+      object values(const std::string &id)
+      {
+        auto s = m_samples.find(id);
+        if (s == m_samples.end())
+          return None;
+        if (s->second.m_valueBuffer.is_none())
+          s->second.m_valueBuffer = makeSampleBuffer(m_context, std::move(s->second.m_values), "d");
+        return s->second.m_valueBuffer;
+      }
+
+      // The timestamps of the samples of a data item in microseconds since the epoch
+      object timestamps(const std::string &id)
+      {
+        auto s = m_samples.find(id);
+        if (s == m_samples.end())
+          return None;
+        if (s->second.m_timestampBuffer.is_none())
+          s->second.m_timestampBuffer =
+              makeSampleBuffer(m_context, std::move(s->second.m_timestamps), "q");
+        return s->second.m_timestampBuffer;
+      }
+
+      EntityList m_entities;
+      std::map<std::string, Samples> m_samples;
+    };
+
+    using BatchFun = function<EntityList(EntityList &&)>;
+
+    // Collects entities and hands them to Python in batches of up to m_size entities or
+    // after m_interval, so the GIL is taken once per batch instead of once per entity.
+    class PythonBatchTransform : public pipeline::Transform
+    {
+    public:
+      PythonBatchTransform(const std::string &name, size_t size, chrono::milliseconds interval)
+        : Transform(name), m_size(size), m_interval(interval)
+      {
+        m_guard = pipeline::TypeGuard<observation::Observation>(pipeline::RUN) ||
+                  pipeline::TypeGuard<Entity>(pipeline::SKIP);
+      }
+
+      // The timer runs on the pipeline strand so the results are delivered in order
+      void setStrand(boost::asio::io_context::strand &strand)
+      {
+        m_strand = &strand;
+        m_timer.emplace(strand.context());
+      }
+
+      entity::EntityPtr operator()(entity::EntityPtr &&entity) override
+      {
+        bool full;
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          m_pending.emplace_back(std::move(entity));
+          full = m_pending.size() >= m_size;
+          if (!full && m_pending.size() == 1 && m_timer)
+          {
+            m_timer->expires_after(m_interval);
+            m_timer->async_wait(boost::asio::bind_executor(
+                *m_strand, [ptr = getptr(), this](boost::system::error_code ec) {
+                  if (!ec)
+                    flush();
+                }));
+          }
+        }
+
+        if (full)
+          flush();
+
+        return EntityPtr();
+      }
+
+      void flush()
+      {
+        EntityList batch;
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          batch.swap(m_pending);
+          if (m_timer)
+            m_timer->cancel();
+        }
+        if (batch.empty())
+          return;
+
+        auto results = m_function ? m_function(std::move(batch)) : std::move(batch);
+        for (auto &entity : results)
+          next(std::move(entity));
+      }
+
+      void stop() override
+      {
+        flush();
+        Transform::stop();
+      }
+
+      BatchFun m_function;
+
+    protected:
+      size_t m_size;
+      chrono::milliseconds m_interval;
+      boost::asio::io_context::strand *m_strand {nullptr};
+      std::optional<boost::asio::steady_timer> m_timer;
+      std::mutex m_mutex;
+      EntityList m_pending;
+    };
+
+    using PythonBatchTransformPtr = shared_ptr<PythonBatchTransform>;
+
+    // Python subclasses override run and return a list of entities to forward, or None to
+    // forward the whole batch:
+    //
+    //   class Features(pipeline.BatchTransform):
+    //     def __init__(self):
+    //       super().__init__("Features", 1000, 100)  # name, batch size, interval ms
+    //     def run(self, batch):
+    //       for id in batch.data_items():
+    //         values = numpy.frombuffer(batch.values(id))
+    //       return None
+    struct BatchTransformWrapper : Wrapper, py::wrapper<BatchTransformWrapper>
+    {
+      BatchTransformWrapper() {}
+      BatchTransformWrapper(std::string name, size_t size, int interval)
+      {
+        m_transform = make_shared<PythonBatchTransform>(name, size, chrono::milliseconds(interval));
+        m_transform->m_function = [this](EntityList &&entities) {
+          GilLock lock;
+          try
+          {
+            object batch = m_context->m_batch();
+            BatchWrapper &wrapper = extract<BatchWrapper &>(batch);
+            wrapper.m_context = m_context;
+            wrapper.m_entities = std::move(entities);
+            wrapper.collect();
+
+            // None forwards the batch unchanged
+            object res = run(batch);
+            if (res.is_none())
+              return std::move(wrapper.m_entities);
+
+            EntityList results;
+            for (stl_input_iterator<object> it(res), end; it != end; ++it)
+            {
+              EntityWrapper &e = extract<EntityWrapper &>(*it);
+              results.push_back(e.m_entity);
+            }
+            return results;
+          }
+          catch (error_already_set const &)
+          {
+            PyErr_Print();
+            return EntityList();
+          }
+        };
+      }
+
+      virtual object run(object batch)
+      {
+        if (override f = get_override("run"))
+          return f(batch);
+        else
+          return None;
+      }
+
+      void flush() { m_transform->flush(); }
+
+      string name() { return m_transform->getName(); }
+
+      PythonBatchTransformPtr m_transform;
+    };
+
     struct PipelineWrapper : Wrapper
     {
       PipelineWrapper() : m_pipeline(nullptr) {}
 
-      bool splice_before(std::string target, object transform)
+      pipeline::TransformPtr transform(object transform)
       {
+        extract<BatchTransformWrapper &> batch(transform);
+        if (batch.check())
+        {
+          BatchTransformWrapper &xform = batch();
+          xform.m_context = m_context;
+          xform.m_transform->setStrand(m_pipeline->getStrand());
+          return xform.m_transform;
+        }
+
         TransformWrapper &xform = extract<TransformWrapper &>(transform);
-        return m_pipeline->spliceBefore(target, xform.m_transform);
+        xform.m_context = m_context;
+        return xform.m_transform;
       }
 
-      bool splice_after(std::string target, object transform)
+      bool splice_before(std::string target, object xform)
       {
-        TransformWrapper &xform = extract<TransformWrapper &>(transform);
-        return m_pipeline->spliceAfter(target, xform.m_transform);
+        return m_pipeline->spliceBefore(target, transform(xform));
+      }
+
+      bool splice_after(std::string target, object xform)
+      {
+        return m_pipeline->spliceAfter(target, transform(xform));
       }
 
       pipeline::Pipeline *m_pipeline;
@@ -249,6 +604,20 @@ namespace mtconnect {
           .def("guard", &TransformWrapper::guard)
           .def("next", &TransformWrapper::next);
 
+      class_<BatchWrapper>("Batch", init<>())
+          .def("__len__", &BatchWrapper::size)
+          .def("__getitem__", &BatchWrapper::get)
+          .def("entities", &BatchWrapper::entities)
+          .def("data_items", &BatchWrapper::data_items)
+          .def("values", &BatchWrapper::values)
+          .def("timestamps", &BatchWrapper::timestamps);
+
+      class_<BatchTransformWrapper, boost::noncopyable>("BatchTransform", init<>())
+          .def(init<std::string, size_t, int>())
+          .def("run", &BatchTransformWrapper::run)
+          .def("flush", &BatchTransformWrapper::flush)
+          .def("name", &BatchTransformWrapper::name);
+
       enum_<pipeline::GuardAction>("GuardAction")
           .value("run", pipeline::GuardAction::RUN)
           .value("continue", pipeline::GuardAction::CONTINUE)
@@ -270,7 +639,7 @@ namespace mtconnect {
         return pipe;
       }
 
-      SourcePtr m_source;
+      source::SourcePtr m_source;
     };
 
     BOOST_PYTHON_MODULE(source)
@@ -350,59 +719,103 @@ namespace mtconnect {
       Agent *m_agent {nullptr};
     };
 
-    Embedded::Embedded(Agent *agent, const ConfigOptions &options)
-      : m_agent(agent), m_context(new Context()), m_options(options)
+    Embedded::Embedded(configuration::AgentConfiguration *config, const ConfigOptions &options)
+      : m_agent(config->getAgent()), m_context(new Context()), m_options(options)
     {
-      try
-      {
-        PyConfig config;
-        PyConfig_InitPythonConfig(&config);
-        PyConfig_Read(&config);
-        config.dev_mode = true;
-        PyWideStringList_Append(&config.module_search_paths,
-                                L"/Users/will/projects/MTConnect/agent/cppagent/modules");
-        Py_InitializeFromConfig(&config);
-        PyConfig_Clear(&config);
-
-        wstring path(Py_GetPath());
-        string s(path.begin(), path.end());
-        cout << "Path: " << s << endl;
-
-        object main_module = import("__main__");
-        object main_namespace = main_module.attr("__dict__");
-        auto pipe = object(boost::python::handle<>(PyInit_pipeline()));
-        main_namespace["pipeline"] = pipe;
-        auto entity = object(boost::python::handle<>(PyInit_entity()));
-        main_namespace["entity"] = entity;
-        auto source = object(boost::python::handle<>(PyInit_source()));
-        main_namespace["source"] = source;
-
-        m_context->m_source = source.attr("__dict__")["Source"];
-        m_context->m_pipeline = pipe.attr("__dict__")["Pipeline"];
-        m_context->m_transform = pipe.attr("__dict__")["Transform"];
-        m_context->m_entity = entity.attr("__dict__")["Entity"];
-
-        auto agentClass = class_<AgentWrapper>("Agent", init<>())
-                              .def("get_device", &AgentWrapper::get_device)
-                              .def("get_source", &AgentWrapper::get_source)
-                              .def("get_sources", &AgentWrapper::get_sources);
-        main_namespace["Agent"] = agentClass;
-        auto pyagent = agentClass();
-        AgentWrapper &wrapper = extract<AgentWrapper &>(pyagent);
-        wrapper.m_agent = agent;
-        wrapper.m_context = m_context;
-
-        main_namespace["agent"] = pyagent;
-
-        // Py_RunMain();
-      }
-
-      catch (error_already_set const &)
-      {
-        PyErr_Print();
+      NAMED_SCOPE("Python::Embedded");
+
+      auto module = GetOption<string>(m_options, "Module");
+      if (!module)
+        module = GetOption<string>(m_options, "module");
+
+      std::optional<std::filesystem::path> modulePath;
+      if (module && !module->empty())
+      {
+        modulePath = config->findDataFile(*module);
+        if (!modulePath)
+          LOG(warning) << "Cannot find python module: " << *module;
+      }
+
+      // Boost.Python cannot finalize the interpreter, so it lives for the process and later
+      // instances reuse the modules in __main__. The GIL is released so the pipeline
+      // threads can run the transforms.
+      if (!Py_IsInitialized())
+      {
+        PyConfig pyConfig;
+        PyConfig_InitPythonConfig(&pyConfig);
+        Py_InitializeFromConfig(&pyConfig);
+        PyConfig_Clear(&pyConfig);
+        PyEval_SaveThread();
+      }
+
+      bool loaded = true;
+      {
+        GilLock lock;
+        try
+        {
+          object mainModule = import("__main__");
+          dict mainNamespace = extract<dict>(mainModule.attr("__dict__"));
+          if (!mainNamespace.has_key("pipeline"))
+          {
+            auto pipe = object(handle<>(PyInit_pipeline()));
+            pipe.attr("SampleBuffer") = object(handle<>(PyType_FromSpec(&SampleBufferSpec)));
+            mainNamespace["pipeline"] = pipe;
+            mainNamespace["entity"] = object(handle<>(PyInit_entity()));
+            mainNamespace["source"] = object(handle<>(PyInit_source()));
+            mainNamespace["Agent"] = class_<AgentWrapper>("Agent", init<>())
+                                         .def("get_device", &AgentWrapper::get_device)
+                                         .def("get_source", &AgentWrapper::get_source)
+                                         .def("get_sources", &AgentWrapper::get_sources);
+          }
+
+          object pipe = mainNamespace["pipeline"];
+          m_context->m_source = mainNamespace["source"].attr("Source");
+          m_context->m_pipeline = pipe.attr("Pipeline");
+          m_context->m_transform = pipe.attr("Transform");
+          m_context->m_batch = pipe.attr("Batch");
+          m_context->m_sampleBuffer = pipe.attr("SampleBuffer");
+          m_context->m_entity = mainNamespace["entity"].attr("Entity");
+
+          auto pyagent = mainNamespace["Agent"]();
+          AgentWrapper &wrapper = extract<AgentWrapper &>(pyagent);
+          wrapper.m_agent = m_agent;
+          wrapper.m_context = m_context;
+          mainNamespace["agent"] = pyagent;
+
+          if (modulePath)
+          {
+            LOG(info) << "Loading python module: " << *modulePath;
+
+            // Modules next to the configured module can be imported
+            py::list path = extract<py::list>(import("sys").attr("path"));
+            path.insert(0, modulePath->parent_path().string());
+            exec_file(py::str(modulePath->string()), mainNamespace, mainNamespace);
+          }
+        }
+
+        catch (error_already_set const &)
+        {
+          PyErr_Print();
+          loaded = false;
+        }
+      }
+
+      if (!loaded)
+      {
+        if (modulePath)
+        {
+          LOG(fatal) << "Failed to load python module: " << *modulePath;
+          throw FatalException("Fatal error loading module");
+        }
+        LOG(error) << "Failed to initialize python";
       }
     }
 
-    Embedded::~Embedded() { delete m_context; }
+    Embedded::~Embedded()
+    {
+      // The context holds Python objects
+      GilLock lock;
+      delete m_context;
+    }
   }  // namespace python
 }  // namespace mtconnect
@@ -19,17 +19,24 @@
 
 #include <string>
 
-#include "utilities.hpp"
+#include "mtconnect/config.hpp"
+#include "mtconnect/utilities.hpp"
 
 namespace mtconnect {
   class Agent;
+  namespace configuration {
+    class AgentConfiguration;
+  }
 
   namespace python {
     struct Context;
-    class Embedded
+    /// @brief Adds the agent, entity, source and pipeline types to an embedded Python
+    ///        interpreter and loads the configured module
+    class AGENT_LIB_API Embedded
     {
     public:
-      Embedded(Agent *agent, const ConfigOptions &options);
+      /// @brief Create the interpreter, or reuse the one created by an earlier instance
+      Embedded(configuration::AgentConfiguration *config, const ConfigOptions &options);
       ~Embedded();
 
     protected:
@@ -0,0 +1,568 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#include "arrow_ipc.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef AGENT_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace mtconnect::sink::historian_sink::arrow {
+  namespace {
+    /// @brief Builds a flatbuffer from the back to the front
+    ///
+    /// Objects must be complete before the tables that refer to them are started, offsets are
+    /// the distance of an object from the end of the buffer.
+    class FlatBuilder
+    {
+    public:
+      using Offset = uint32_t;
+
+      size_t size() const { return m_buffer.size() - m_head; }
+      const char *data() const { return m_buffer.data() + m_head; }
+
+      /// @brief pad so the size is aligned after `additional` bytes are added
+      void prep(size_t align, size_t additional)
+      {
+        m_minAlign = max(m_minAlign, align);
+        auto padding = (~(size() + additional) + 1) & (align - 1);
+        memset(space(padding), 0, padding);
+      }
+
+      template <typename T>
+      void push(T value)
+      {
+        memcpy(space(sizeof(T)), &value, sizeof(T));
+      }
+      void pushBytes(const void *bytes, size_t size) { memcpy(space(size), bytes, size); }
+
+      Offset referTo(Offset offset)
+      {
+        prep(sizeof(uint32_t), 0);
+        return Offset(size() + sizeof(uint32_t) - offset);
+      }
+
+      void startTable()
+      {
+        m_fields.clear();
+        m_tableStart = size();
+      }
+      template <typename T>
+      void add(uint16_t slot, T value)
+      {
+        prep(sizeof(T), 0);
+        push(value);
+        m_fields.emplace_back(slot, size());
+      }
+      void addOffset(uint16_t slot, Offset offset)
+      {
+        push(referTo(offset));
+        m_fields.emplace_back(slot, size());
+      }
+      Offset endTable()
+      {
+        prep(sizeof(int32_t), 0);
+        push(int32_t(0));
+        auto table = size();
+
+        uint16_t slots = 0;
+        for (auto &field : m_fields)
+          slots = max<uint16_t>(slots, field.first + 1);
+        vector<uint16_t> vtable(slots, 0);
+        for (auto &field : m_fields)
+          vtable[field.first] = uint16_t(table - field.second);
+        for (auto it = vtable.rbegin(); it != vtable.rend(); it++)
+          push(*it);
+        push(uint16_t(table - m_tableStart));
+        push(uint16_t((slots + 2) * sizeof(uint16_t)));
+
+        // The vtable precedes the table, so the offset to it is positive
+        auto soffset = int32_t(size() - table);
+        memcpy(m_buffer.data() + m_buffer.size() - table, &soffset, sizeof(soffset));
+        return Offset(table);
+      }
+
+      Offset createString(string_view s)
+      {
+        prep(sizeof(uint32_t), s.size() + 1);
+        push(uint8_t(0));
+        pushBytes(s.data(), s.size());
+        push(uint32_t(s.size()));
+        return Offset(size());
+      }
+      Offset createVector(const vector<Offset> &offsets)
+      {
+        prep(sizeof(uint32_t), offsets.size() * sizeof(uint32_t));
+        for (auto it = offsets.rbegin(); it != offsets.rend(); it++)
+          push(referTo(*it));
+        push(uint32_t(offsets.size()));
+        return Offset(size());
+      }
+      /// @brief create a vector of structs whose largest member is 8 bytes
+      Offset createStructs(const void *data, size_t count, size_t size)
+      {
+        prep(sizeof(uint32_t), count * size);
+        prep(sizeof(int64_t), count * size);
+        pushBytes(data, count * size);
+        push(uint32_t(count));
+        return Offset(this->size());
+      }
+
+      /// @brief add the root offset, the size is then a multiple of 8
+      void finish(Offset root)
+      {
+        prep(max<size_t>(m_minAlign, 8), sizeof(uint32_t));
+        push(referTo(root));
+      }
+
+    protected:
+      char *space(size_t n)
+      {
+        if (m_head < n)
+        {
+          auto used = size();
+          auto capacity = max(m_buffer.size() * 2, used + n + 256);
+          vector<char> buffer(capacity);
+          memcpy(buffer.data() + capacity - used, data(), used);
+          m_buffer.swap(buffer);
+          m_head = capacity - used;
+        }
+        m_head -= n;
+        return m_buffer.data() + m_head;
+      }
+
+    protected:
+      vector<char> m_buffer;
+      size_t m_head {0};
+      size_t m_minAlign {1};
+      size_t m_tableStart {0};
+      vector<pair<uint16_t, size_t>> m_fields;
+    };
+
+    // Values from the Arrow Schema.fbs, Message.fbs and File.fbs
+    constexpr int16_t MetadataV5 = 4;
+    constexpr uint8_t HeaderSchema = 1;
+    constexpr uint8_t HeaderDictionaryBatch = 2;
+    constexpr uint8_t HeaderRecordBatch = 3;
+    constexpr uint8_t TypeInt = 2;
+    constexpr uint8_t TypeFloatingPoint = 3;
+    constexpr uint8_t TypeUtf8 = 5;
+    constexpr uint8_t TypeBool = 6;
+    constexpr uint8_t TypeTimestamp = 10;
+    constexpr int16_t PrecisionDouble = 2;
+    constexpr int16_t TimeUnitMicrosecond = 2;
+    constexpr int8_t CompressionZstd = 1;
+
+    constexpr char Magic[8] = {'A', 'R', 'R', 'O', 'W', '1', 0, 0};
+    constexpr int32_t Continuation = -1;
+
+    FlatBuilder::Offset intType(FlatBuilder &fb, int32_t bits, bool isSigned)
+    {
+      fb.startTable();
+      fb.add<int32_t>(0, bits);
+      fb.add<uint8_t>(1, isSigned ? 1 : 0);
+      return fb.endTable();
+    }
+
+    FlatBuilder::Offset buildSchema(FlatBuilder &fb, const vector<Column> &columns,
+                                    const vector<pair<string, string>> &metadata)
+    {
+      vector<FlatBuilder::Offset> fields;
+      for (size_t i = 0; i < columns.size(); i++)
+      {
+        auto &column = columns[i];
+        auto name = fb.createString(column.m_name);
+        auto children = fb.createVector({});
+
+        uint8_t typeType;
+        FlatBuilder::Offset type, dictionary = 0;
+        switch (column.m_type)
+        {
+          case ColumnType::TIMESTAMP:
+          {
+            auto timezone = fb.createString("UTC");
+            fb.startTable();
+            fb.add<int16_t>(0, TimeUnitMicrosecond);
+            fb.addOffset(1, timezone);
+            type = fb.endTable();
+            typeType = TypeTimestamp;
+            break;
+          }
+
+          case ColumnType::UINT64:
+            type = intType(fb, 64, false);
+            typeType = TypeInt;
+            break;
+
+          case ColumnType::DOUBLE:
+            fb.startTable();
+            fb.add<int16_t>(0, PrecisionDouble);
+            type = fb.endTable();
+            typeType = TypeFloatingPoint;
+            break;
+
+          case ColumnType::BOOL:
+            fb.startTable();
+            type = fb.endTable();
+            typeType = TypeBool;
+            break;
+
+          case ColumnType::DICTIONARY:
+          {
+            auto index = intType(fb, 32, true);
+            fb.startTable();
+            fb.add<int64_t>(0, int64_t(i));
+            fb.addOffset(1, index);
+            dictionary = fb.endTable();
+          }
+            [[fallthrough]];
+
+          case ColumnType::UTF8:
+            fb.startTable();
+            type = fb.endTable();
+            typeType = TypeUtf8;
+            break;
+        }
+
+        fb.startTable();
+        fb.addOffset(0, name);
+        fb.add<uint8_t>(1, column.m_nullable ? 1 : 0);
+        fb.add<uint8_t>(2, typeType);
+        fb.addOffset(3, type);
+        if (dictionary != 0)
+          fb.addOffset(4, dictionary);
+        fb.addOffset(5, children);
+        fields.push_back(fb.endTable());
+      }
+      auto fieldVector = fb.createVector(fields);
+
+      vector<FlatBuilder::Offset> pairs;
+      for (auto &[key, value] : metadata)
+      {
+        auto k = fb.createString(key);
+        auto v = fb.createString(value);
+        fb.startTable();
+        fb.addOffset(0, k);
+        fb.addOffset(1, v);
+        pairs.push_back(fb.endTable());
+      }
+      auto metadataVector = fb.createVector(pairs);
+
+      fb.startTable();
+      fb.add<int16_t>(0, 0);  // Little endian
+      fb.addOffset(1, fieldVector);
+      fb.addOffset(2, metadataVector);
+      return fb.endTable();
+    }
+
+    /// @brief Build a RecordBatch table
+    FlatBuilder::Offset buildRecordBatch(FlatBuilder &fb, int64_t length,
+                                         const vector<pair<int64_t, int64_t>> &nodes,
+                                         const vector<pair<int64_t, int64_t>> &buffers,
+                                         Compression compression)
+    {
+      auto nodeVector = fb.createStructs(nodes.data(), nodes.size(), sizeof(nodes[0]));
+      auto bufferVector = fb.createStructs(buffers.data(), buffers.size(), sizeof(buffers[0]));
+      FlatBuilder::Offset bodyCompression = 0;
+      if (compression == Compression::ZSTD)
+      {
+        fb.startTable();
+        fb.add<int8_t>(0, CompressionZstd);
+        bodyCompression = fb.endTable();
+      }
+
+      fb.startTable();
+      fb.add<int64_t>(0, length);
+      fb.addOffset(1, nodeVector);
+      fb.addOffset(2, bufferVector);
+      if (bodyCompression != 0)
+        fb.addOffset(3, bodyCompression);
+      return fb.endTable();
+    }
+
+    /// @brief Finish a Message with a header
+    string finishMessage(FlatBuilder &fb, uint8_t headerType, FlatBuilder::Offset header,
+                         int64_t bodyLength)
+    {
+      fb.startTable();
+      fb.add<int64_t>(3, bodyLength);
+      fb.addOffset(2, header);
+      fb.add<int16_t>(0, MetadataV5);
+      fb.add<uint8_t>(1, headerType);
+      fb.finish(fb.endTable());
+      return string(fb.data(), fb.size());
+    }
+
+    static_assert(sizeof(pair<int64_t, int64_t>) == 16);
+  }  // namespace
+
+  void ColumnData::appendNull()
+  {
+    switch (m_type)
+    {
+      case ColumnType::TIMESTAMP:
+      case ColumnType::UINT64:
+        appendValue(int64_t(0));
+        break;
+
+      case ColumnType::DICTIONARY:
+        appendValue(int32_t(0));
+        break;
+
+      case ColumnType::DOUBLE:
+        appendValue(0.0);
+        break;
+
+      case ColumnType::BOOL:
+        appendValue(uint8_t(0));
+        break;
+
+      case ColumnType::UTF8:
+        appendString({});
+        break;
+    }
+    m_valid.back() = 0;
+    m_nulls++;
+  }
+
+  string ColumnData::pack(const string_view bytes)
+  {
+    string bits((bytes.size() + 7) / 8, '\0');
+    for (size_t i = 0; i < bytes.size(); i++)
+    {
+      if (bytes[i])
+        bits[i / 8] |= char(1 << (i % 8));
+    }
+    return bits;
+  }
+
+  void ColumnData::getBuffers(vector<string> &buffers) const
+  {
+    buffers.emplace_back(m_nulls > 0 ? pack(m_valid) : string());
+    switch (m_type)
+    {
+      case ColumnType::UTF8:
+        buffers.emplace_back(reinterpret_cast<const char *>(m_offsets.data()),
+                             m_offsets.size() * sizeof(int32_t));
+        buffers.emplace_back(m_values);
+        break;
+
+      case ColumnType::BOOL:
+        buffers.emplace_back(pack(m_values));
+        break;
+
+      default:
+        buffers.emplace_back(m_values);
+        break;
+    }
+  }
+
+  FileWriter::FileWriter(vector<Column> columns, vector<pair<string, string>> metadata,
+                         Compression compression)
+    : m_columns(std::move(columns)), m_metadata(std::move(metadata)), m_compression(compression)
+  {
+    if (!CompressionSupported(m_compression))
+      m_compression = Compression::NONE;
+  }
+
+  FileWriter::~FileWriter()
+  {
+    if (m_file.is_open())
+    {
+      m_file.close();
+      error_code ec;
+      fs::remove(m_tempPath, ec);
+    }
+  }
+
+  void FileWriter::writeBytes(const void *data, size_t size)
+  {
+    m_file.write(static_cast<const char *>(data), streamsize(size));
+    if (!m_file)
+      throw system_error(errno, generic_category(), "Cannot write " + m_tempPath.string());
+    m_offset += size;
+  }
+
+  FileWriter::Block FileWriter::writeMessage(const string &metadata, const string &body)
+  {
+    Block block {int64_t(m_offset), int32_t(8 + metadata.size()), 0, int64_t(body.size())};
+    writeBytes(&Continuation, sizeof(Continuation));
+    auto length = int32_t(metadata.size());
+    writeBytes(&length, sizeof(length));
+    writeBytes(metadata.data(), metadata.size());
+    writeBytes(body.data(), body.size());
+    return block;
+  }
+
+  string FileWriter::makeBody(const vector<string> &buffers,
+                              vector<pair<int64_t, int64_t>> &locations) const
+  {
+    string body;
+    string compressed;
+    for (auto &buffer : buffers)
+    {
+      auto offset = int64_t(body.size());
+      if (buffer.empty())
+      {
+        locations.emplace_back(offset, 0);
+        continue;
+      }
+
+#ifdef AGENT_WITH_ZSTD
+      if (m_compression == Compression::ZSTD)
+      {
+        // Each buffer is prefixed by its uncompressed length, or -1 if it is stored as is
+        compressed.resize(ZSTD_compressBound(buffer.size()));
+        auto size = ZSTD_compress(compressed.data(), compressed.size(), buffer.data(),
+                                  buffer.size(), ZSTD_CLEVEL_DEFAULT);
+        int64_t length = int64_t(buffer.size());
+        if (ZSTD_isError(size) || size >= buffer.size())
+        {
+          length = -1;
+          compressed = buffer;
+          size = buffer.size();
+        }
+        body.append(reinterpret_cast<const char *>(&length), sizeof(length));
+        body.append(compressed.data(), size);
+      }
+      else
+#endif
+      {
+        body.append(buffer);
+      }
+
+      locations.emplace_back(offset, int64_t(body.size()) - offset);
+      body.append((8 - body.size() % 8) % 8, '\0');
+    }
+    return body;
+  }
+
+  void FileWriter::open(const fs::path &path, const vector<vector<string>> &dictionaries)
+  {
+    m_path = path;
+    m_tempPath = path;
+    m_tempPath += ".tmp";
+    m_offset = 0;
+    m_dictionaryBlocks.clear();
+    m_recordBlocks.clear();
+
+    m_file.open(m_tempPath, ios::binary | ios::trunc);
+    if (!m_file)
+      throw system_error(errno, generic_category(), "Cannot create " + m_tempPath.string());
+
+    writeBytes(Magic, sizeof(Magic));
+
+    {
+      FlatBuilder fb;
+      auto schema = buildSchema(fb, m_columns, m_metadata);
+      writeMessage(finishMessage(fb, HeaderSchema, schema, 0), string());
+    }
+
+    auto dictionary = dictionaries.begin();
+    for (size_t i = 0; i < m_columns.size(); i++)
+    {
+      if (m_columns[i].m_type != ColumnType::DICTIONARY)
+        continue;
+      if (dictionary == dictionaries.end())
+        throw invalid_argument("Missing dictionary for " + m_columns[i].m_name);
+
+      ColumnData values(ColumnType::UTF8);
+      for (auto &value : *dictionary)
+        values.appendString(value);
+      dictionary++;
+
+      vector<string> buffers;
+      values.getBuffers(buffers);
+      vector<pair<int64_t, int64_t>> locations;
+      auto body = makeBody(buffers, locations);
+
+      FlatBuilder fb;
+      auto batch = buildRecordBatch(fb, int64_t(values.getRows()),
+                                    {{int64_t(values.getRows()), 0}}, locations, m_compression);
+      fb.startTable();
+      fb.add<int64_t>(0, int64_t(i));
+      fb.addOffset(1, batch);
+      auto header = fb.endTable();
+      m_dictionaryBlocks.push_back(writeMessage(
+          finishMessage(fb, HeaderDictionaryBatch, header, int64_t(body.size())), body));
+    }
+  }
+
+  void FileWriter::write(const vector<ColumnData> &columns)
+  {
+    if (columns.size() != m_columns.size())
+      throw invalid_argument("Record batch does not match the schema");
+
+    auto rows = columns.empty() ? 0 : columns.front().getRows();
+    vector<string> buffers;
+    vector<pair<int64_t, int64_t>> nodes;
+    for (auto &column : columns)
+    {
+      if (column.getRows() != rows)
+        throw invalid_argument("Columns of a record batch must have the same length");
+      nodes.emplace_back(int64_t(rows), int64_t(column.getNulls()));
+      column.getBuffers(buffers);
+    }
+
+    vector<pair<int64_t, int64_t>> locations;
+    auto body = makeBody(buffers, locations);
+
+    FlatBuilder fb;
+    auto batch = buildRecordBatch(fb, int64_t(rows), nodes, locations, m_compression);
+    m_recordBlocks.push_back(
+        writeMessage(finishMessage(fb, HeaderRecordBatch, batch, int64_t(body.size())), body));
+    m_file.flush();
+  }
+
+  void FileWriter::close()
+  {
+    if (!m_file.is_open())
+      return;
+
+    // End of stream marker
+    int32_t eos[2] = {Continuation, 0};
+    writeBytes(eos, sizeof(eos));
+
+    FlatBuilder fb;
+    auto records = fb.createStructs(m_recordBlocks.data(), m_recordBlocks.size(), sizeof(Block));
+    auto dictionaries =
+        fb.createStructs(m_dictionaryBlocks.data(), m_dictionaryBlocks.size(), sizeof(Block));
+    auto schema = buildSchema(fb, m_columns, m_metadata);
+    fb.startTable();
+    fb.addOffset(1, schema);
+    fb.addOffset(2, dictionaries);
+    fb.addOffset(3, records);
+    fb.add<int16_t>(0, MetadataV5);
+    fb.finish(fb.endTable());
+
+    writeBytes(fb.data(), fb.size());
+    auto length = int32_t(fb.size());
+    writeBytes(&length, sizeof(length));
+    writeBytes(Magic, 6);
+    m_file.close();
+
+    fs::rename(m_tempPath, m_path);
+  }
+}  // namespace mtconnect::sink::historian_sink::arrow
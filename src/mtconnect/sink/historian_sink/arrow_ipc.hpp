@@ -0,0 +1,205 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "mtconnect/config.hpp"
+
+/// @brief A writer for the Arrow IPC file format
+///
+/// Only the column types the historian needs are supported. The flatbuffer metadata is
+/// encoded by the writer, so there is no dependency on the Arrow libraries. Files can be read
+/// by any Arrow implementation, for example with `pyarrow.ipc.open_file`.
+namespace mtconnect::sink::historian_sink::arrow {
+  /// @brief The Arrow type of a column
+  enum class ColumnType
+  {
+    TIMESTAMP,   ///< `timestamp[us, tz=UTC]`
+    UINT64,      ///< `uint64`
+    DOUBLE,      ///< `double`
+    UTF8,        ///< `string`
+    BOOL,        ///< `bool`
+    DICTIONARY,  ///< `dictionary<values=string, indices=int32>`
+  };
+
+  /// @brief The name and type of a column
+  struct Column
+  {
+    std::string m_name;
+    ColumnType m_type;
+    bool m_nullable {false};
+  };
+
+  /// @brief Body buffer compression
+  enum class Compression
+  {
+    NONE,
+    ZSTD  ///< Only available when the agent is built with `AGENT_WITH_ZSTD`
+  };
+
+  /// @brief check if the agent was built with support for a compression
+  /// @param compression the compression
+  /// @return `true` if body buffers can be compressed
+  inline bool CompressionSupported(Compression compression)
+  {
+#ifdef AGENT_WITH_ZSTD
+    return true;
+#else
+    return compression == Compression::NONE;
+#endif
+  }
+
+  /// @brief The values of one column of a record batch
+  class AGENT_LIB_API ColumnData
+  {
+  public:
+    /// @brief Create an empty column
+    /// @param type the column type
+    ColumnData(ColumnType type) : m_type(type) { clear(); }
+
+    /// @brief Remove all values
+    void clear()
+    {
+      m_rows = 0;
+      m_nulls = 0;
+      m_valid.clear();
+      m_values.clear();
+      m_offsets.assign(1, 0);
+    }
+
+    /// @brief Append an integer to a `TIMESTAMP`, `UINT64` or `DICTIONARY` index column
+    void appendInteger(int64_t value)
+    {
+      if (m_type == ColumnType::DICTIONARY)
+        appendValue(int32_t(value));
+      else
+        appendValue(value);
+    }
+    /// @brief Append to a `DOUBLE` column
+    void appendDouble(double value) { appendValue(value); }
+    /// @brief Append to a `BOOL` column
+    void appendBool(bool value) { appendValue(uint8_t(value ? 1 : 0)); }
+    /// @brief Append to a `UTF8` column
+    void appendString(std::string_view value)
+    {
+      m_values.append(value.data(), value.size());
+      m_offsets.push_back(int32_t(m_values.size()));
+      m_valid.push_back(1);
+      m_rows++;
+    }
+    /// @brief Append a null value
+    void appendNull();
+
+    ColumnType getType() const { return m_type; }
+    size_t getRows() const { return m_rows; }
+    size_t getNulls() const { return m_nulls; }
+
+    /// @brief get the Arrow buffers of the column
+    ///
+    /// The validity buffer is empty if no value is null. Booleans and the validity are packed
+    /// into bits.
+    /// @param[out] buffers the validity buffer followed by the offsets and values
+    void getBuffers(std::vector<std::string> &buffers) const;
+
+  protected:
+    template <typename T>
+    void appendValue(T value)
+    {
+      m_values.append(reinterpret_cast<const char *>(&value), sizeof(T));
+      m_valid.push_back(1);
+      m_rows++;
+    }
+
+    static std::string pack(const std::string_view bytes);
+
+  protected:
+    ColumnType m_type;
+    size_t m_rows {0};
+    size_t m_nulls {0};
+    std::string m_valid;
+    std::string m_values;
+    std::vector<int32_t> m_offsets;
+  };
+
+  /// @brief Writes record batches to an Arrow IPC file
+  ///
+  /// The file is written to `<path>.tmp` and renamed to the path when it is closed, so
+  /// readers only see complete files.
+  class AGENT_LIB_API FileWriter
+  {
+  public:
+    /// @brief Create a writer for a schema
+    /// @param columns the columns of the schema
+    /// @param metadata key value pairs added to the schema
+    /// @param compression the body buffer compression, buffers are stored uncompressed if
+    ///                    the compression is not supported
+    FileWriter(std::vector<Column> columns,
+               std::vector<std::pair<std::string, std::string>> metadata,
+               Compression compression);
+    ~FileWriter();
+
+    /// @brief Create the file and write the schema and dictionaries
+    /// @param path the path of the completed file
+    /// @param dictionaries the values of each `DICTIONARY` column, in column order
+    void open(const std::filesystem::path &path,
+              const std::vector<std::vector<std::string>> &dictionaries);
+    /// @brief Write a record batch
+    /// @param columns the column data in schema order
+    void write(const std::vector<ColumnData> &columns);
+    /// @brief Write the footer and rename the file to its final path
+    void close();
+
+    bool isOpen() const { return m_file.is_open(); }
+    /// @brief get the bytes written to the file
+    uint64_t getSize() const { return m_offset; }
+    const std::filesystem::path &getPath() const { return m_path; }
+
+  protected:
+    struct Block
+    {
+      int64_t m_offset;
+      int32_t m_metadataLength;
+      int32_t m_padding;
+      int64_t m_bodyLength;
+    };
+
+    void writeBytes(const void *data, size_t size);
+    Block writeMessage(const std::string &metadata, const std::string &body);
+    std::string makeBody(const std::vector<std::string> &buffers,
+                         std::vector<std::pair<int64_t, int64_t>> &locations) const;
+
+  protected:
+    std::vector<Column> m_columns;
+    std::vector<std::pair<std::string, std::string>> m_metadata;
+    Compression m_compression;
+
+    std::filesystem::path m_path;
+    std::filesystem::path m_tempPath;
+    std::ofstream m_file;
+    uint64_t m_offset {0};
+    std::vector<Block> m_dictionaryBlocks;
+    std::vector<Block> m_recordBlocks;
+  };
+}  // namespace mtconnect::sink::historian_sink::arrow
@@ -0,0 +1,480 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#include "historian_sink.hpp"
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/post.hpp>
+
+#include <optional>
+
+#include "mtconnect/configuration/config_options.hpp"
+#include "mtconnect/device_model/device.hpp"
+#include "mtconnect/logging.hpp"
+
+using namespace std;
+using ptree = boost::property_tree::ptree;
+namespace fs = std::filesystem;
+
+namespace mtconnect::sink::historian_sink {
+  using namespace observation;
+  namespace config = ::mtconnect::configuration;
+
+  namespace {
+    enum ColumnIndex
+    {
+      TIMESTAMP_COL,
+      SEQUENCE_COL,
+      DATA_ITEM_COL,
+      NUMBER_COL,
+      TEXT_COL,
+      LEVEL_COL,
+      NATIVE_CODE_COL,
+      UNAVAILABLE_COL
+    };
+
+    const vector<arrow::Column> &Columns()
+    {
+      using arrow::ColumnType;
+      static const vector<arrow::Column> columns {
+          {"timestamp", ColumnType::TIMESTAMP},     {"sequence", ColumnType::UINT64},
+          {"data_item_id", ColumnType::DICTIONARY}, {"number", ColumnType::DOUBLE, true},
+          {"text", ColumnType::UTF8, true},         {"condition_level", ColumnType::UTF8, true},
+          {"native_code", ColumnType::UTF8, true},  {"unavailable", ColumnType::BOOL}};
+      return columns;
+    }
+
+    vector<arrow::ColumnData> MakeBatch()
+    {
+      vector<arrow::ColumnData> batch;
+      for (auto &column : Columns())
+        batch.emplace_back(column.m_type);
+      return batch;
+    }
+
+    /// @brief Flush a device early when its batch has this many rows
+    constexpr size_t MaxBatchRows = 65536;
+  }  // namespace
+
+  struct HistorianSink::Partition
+  {
+    string m_uuid;
+    string m_name;
+    string m_directory;
+
+    // Guarded by m_mutex
+    vector<string> m_dictionary;
+    unordered_map<string, int32_t> m_indexes;
+    vector<arrow::ColumnData> m_batch = MakeBatch();
+
+    // Guarded by m_fileMutex
+    unique_ptr<arrow::FileWriter> m_writer;
+    size_t m_dictionarySize {0};
+    int64_t m_window {0};
+    int m_segment {0};
+  };
+
+  HistorianSink::HistorianSink(boost::asio::io_context &context, sink::SinkContractPtr &&contract,
+                               const ConfigOptions &options, const ptree &block)
+    : Sink("HistorianSink", std::move(contract)),
+      m_options(options),
+      m_strand(context),
+      m_timer(context)
+  {
+    GetOptions(block, m_options, options);
+    AddDefaultedOptions(block, m_options,
+                        {{config::HistorianPath, "historian"s},
+                         {config::HistorianSegmentDuration, 3600s},
+                         {config::HistorianSegmentSize, 64 * 1024 * 1024},
+                         {config::HistorianFlushInterval, 10000ms},
+                         {config::HistorianRetention, 0s},
+                         {config::HistorianCompression,
+                          arrow::CompressionSupported(arrow::Compression::ZSTD) ? "zstd"s
+                                                                                : "none"s}});
+
+    m_path = *GetOption<string>(m_options, config::HistorianPath);
+    m_segmentDuration =
+        max(chrono::seconds(1), *GetOption<Seconds>(m_options, config::HistorianSegmentDuration));
+    m_segmentSize = uint64_t(max(1, *GetOption<int>(m_options, config::HistorianSegmentSize)));
+    m_flushInterval = max(chrono::milliseconds(10),
+                          *GetOption<Milliseconds>(m_options, config::HistorianFlushInterval));
+    m_retention = *GetOption<Seconds>(m_options, config::HistorianRetention);
+
+    auto compression = *GetOption<string>(m_options, config::HistorianCompression);
+    if (iequals(compression, "none"))
+      m_compression = arrow::Compression::NONE;
+    else
+    {
+      if (!iequals(compression, "zstd"))
+        LOG(warning) << "HistorianSink: unknown compression " << compression << ", using zstd";
+      m_compression = arrow::Compression::ZSTD;
+    }
+    if (!arrow::CompressionSupported(m_compression))
+    {
+      LOG(warning) << "HistorianSink: the agent was built without zstd, files are not compressed";
+      m_compression = arrow::Compression::NONE;
+    }
+  }
+
+  HistorianSink::~HistorianSink() = default;
+
+  void HistorianSink::start()
+  {
+    NAMED_SCOPE("HistorianSink::start");
+
+    error_code ec;
+    fs::create_directories(m_path, ec);
+    if (ec)
+      LOG(error) << "HistorianSink: cannot create " << m_path << ": " << ec.message();
+
+    {
+      lock_guard<mutex> lock(m_mutex);
+      for (auto &device : m_sinkContract->getDevices())
+        partition(device);
+    }
+
+    for (auto &entry : fs::directory_iterator(m_path, ec))
+    {
+      if (entry.is_directory())
+        removeExpired(entry.path());
+    }
+
+    LOG(info) << "Writing observations to " << m_path << " every " << m_flushInterval.count()
+              << "ms";
+
+    m_running = true;
+    scheduleFlush();
+  }
+
+  void HistorianSink::stop()
+  {
+    m_running = false;
+    m_timer.cancel();
+    flush();
+    closeFiles();
+  }
+
+  HistorianSink::Partition &HistorianSink::partition(const device_model::DevicePtr &device)
+  {
+    auto uuid = device->getUuid().value_or(device->getId());
+    auto it = m_partitions.find(uuid);
+    if (it != m_partitions.end())
+      return *it->second;
+
+    auto partition = make_unique<Partition>();
+    partition->m_uuid = uuid;
+    partition->m_name = device->getComponentName().value_or(uuid);
+    partition->m_directory = uuid;
+    for (auto &c : partition->m_directory)
+    {
+      if (c == '/' || c == '\\' || c == ':')
+        c = '_';
+    }
+    addDataItems(*partition, device);
+
+    return *m_partitions.emplace(uuid, std::move(partition)).first->second;
+  }
+
+  void HistorianSink::addDataItems(Partition &partition, const device_model::DevicePtr &device)
+  {
+    for (auto &weak : device->getDeviceDataItems())
+    {
+      if (auto di = weak.lock())
+      {
+        auto &id = di->getId();
+        if (partition.m_indexes.count(id) == 0)
+        {
+          partition.m_indexes.emplace(id, int32_t(partition.m_dictionary.size()));
+          partition.m_dictionary.push_back(id);
+        }
+      }
+    }
+  }
+
+  bool HistorianSink::publish(device_model::DevicePtr device)
+  {
+    lock_guard<mutex> lock(m_mutex);
+    addDataItems(partition(device), device);
+    return true;
+  }
+
+  bool HistorianSink::publish(observation::ObservationPtr &observation)
+  {
+    auto dataItem = observation->getDataItem();
+    if (!dataItem || observation->isOrphan())
+      return false;
+    auto component = dataItem->getComponent();
+    auto device = component ? component->getDevice() : nullptr;
+    if (!device)
+      return false;
+
+    // Convert the value before taking the lock
+    optional<double> number;
+    optional<string_view> text, code;
+    const char *level = nullptr;
+    string buffer;
+    bool unavailable = observation->isUnavailable();
+
+    if (auto cond = dynamic_pointer_cast<Condition>(observation); cond && !unavailable)
+    {
+      static const char *levels[] = {"NORMAL", "WARNING", "FAULT", "UNAVAILABLE"};
+      level = levels[cond->getLevel()];
+      if (!cond->getCode().empty())
+        code = cond->getCode();
+      if (auto message = get_if<string>(&cond->getValue()))
+        text = *message;
+    }
+    else if (!unavailable)
+    {
+      visit(overloaded {[&](const string &s) { text = s; },
+                        [&](int64_t v) { number = double(v); },
+                        [&](double v) { number = v; },
+                        [&](bool v) { number = v ? 1.0 : 0.0; },
+                        [&](const entity::Vector &v) {
+                          for (auto &d : v)
+                          {
+                            if (!buffer.empty())
+                              buffer.push_back(' ');
+                            buffer.append(format(d));
+                          }
+                          text = buffer;
+                        },
+                        [&](const entity::DataSet &set) {
+                          buffer = set.format();
+                          text = buffer;
+                        },
+                        [&](const Timestamp &ts) {
+                          buffer = format(ts);
+                          text = buffer;
+                        },
+                        [&](const auto &) {}},
+            observation->getValue());
+    }
+
+    auto timestamp =
+        chrono::duration_cast<chrono::microseconds>(observation->getTimestamp().time_since_epoch())
+            .count();
+
+    bool full;
+    {
+      lock_guard<mutex> lock(m_mutex);
+      auto &p = partition(device);
+      auto it = p.m_indexes.find(dataItem->getId());
+      if (it == p.m_indexes.end())
+      {
+        it = p.m_indexes.emplace(dataItem->getId(), int32_t(p.m_dictionary.size())).first;
+        p.m_dictionary.push_back(dataItem->getId());
+      }
+
+      auto &batch = p.m_batch;
+      auto optionalString = [](arrow::ColumnData &column, const optional<string_view> &value) {
+        if (value)
+          column.appendString(*value);
+        else
+          column.appendNull();
+      };
+      batch[TIMESTAMP_COL].appendInteger(timestamp);
+      batch[SEQUENCE_COL].appendInteger(int64_t(observation->getSequence()));
+      batch[DATA_ITEM_COL].appendInteger(it->second);
+      if (number)
+        batch[NUMBER_COL].appendDouble(*number);
+      else
+        batch[NUMBER_COL].appendNull();
+      optionalString(batch[TEXT_COL], text);
+      optionalString(batch[LEVEL_COL], level ? optional<string_view>(level) : nullopt);
+      optionalString(batch[NATIVE_CODE_COL], code);
+      batch[UNAVAILABLE_COL].appendBool(unavailable);
+
+      full = batch[TIMESTAMP_COL].getRows() >= MaxBatchRows;
+    }
+
+    if (full && m_running && !m_flushPending.exchange(true))
+    {
+      boost::asio::post(m_strand, [this, ptr = getptr()]() {
+        m_flushPending = false;
+        flush();
+      });
+    }
+
+    return true;
+  }
+
+  void HistorianSink::flush()
+  {
+    NAMED_SCOPE("HistorianSink::flush");
+
+    lock_guard<mutex> fileLock(m_fileMutex);
+    vector<Partition *> partitions;
+    {
+      lock_guard<mutex> lock(m_mutex);
+      for (auto &p : m_partitions)
+        partitions.push_back(p.second.get());
+    }
+
+    auto window = chrono::duration_cast<chrono::seconds>(
+                      chrono::system_clock::now().time_since_epoch()) /
+                  m_segmentDuration;
+    for (auto partition : partitions)
+    {
+      auto batch = MakeBatch();
+      vector<string> dictionary;
+      {
+        lock_guard<mutex> lock(m_mutex);
+        if (partition->m_batch.front().getRows() > 0)
+        {
+          batch.swap(partition->m_batch);
+          dictionary = partition->m_dictionary;
+        }
+      }
+
+      try
+      {
+        if (batch.front().getRows() > 0)
+        {
+          write(*partition, batch, dictionary);
+        }
+        else if (partition->m_writer && partition->m_writer->isOpen() &&
+                 partition->m_window != window)
+        {
+          // Close the file of an idle device at the end of its window
+          partition->m_writer->close();
+          removeExpired(m_path / partition->m_directory);
+        }
+      }
+      catch (exception &e)
+      {
+        LOG(error) << "HistorianSink: cannot write observations for " << partition->m_uuid
+                   << ": " << e.what();
+        partition->m_writer.reset();
+      }
+    }
+  }
+
+  void HistorianSink::write(Partition &partition, vector<arrow::ColumnData> &batch,
+                            const vector<string> &dictionary)
+  {
+    auto now = chrono::system_clock::now();
+    int64_t window =
+        chrono::duration_cast<chrono::seconds>(now.time_since_epoch()) / m_segmentDuration;
+    auto directory = m_path / partition.m_directory;
+
+    auto &writer = partition.m_writer;
+    if (writer && writer->isOpen() &&
+        (window != partition.m_window || writer->getSize() >= m_segmentSize ||
+         dictionary.size() != partition.m_dictionarySize))
+    {
+      writer->close();
+      removeExpired(directory);
+    }
+
+    if (!writer || !writer->isOpen())
+    {
+      if (window != partition.m_window)
+      {
+        partition.m_window = window;
+        partition.m_segment = 0;
+      }
+
+      fs::create_directories(directory);
+      Timestamp start {chrono::duration_cast<Timestamp::duration>(window * m_segmentDuration)};
+      auto stem = date::format("%Y%m%dT%H%M%SZ", date::floor<chrono::seconds>(start));
+      fs::path path;
+      do
+      {
+        path = directory / (stem + "_" + to_string(partition.m_segment++) + ".arrow");
+      } while (fs::exists(path) || fs::exists(path.string() + ".tmp"));
+
+      writer = make_unique<arrow::FileWriter>(
+          Columns(),
+          vector<pair<string, string>> {{"mtconnect.device.uuid", partition.m_uuid},
+                                        {"mtconnect.device.name", partition.m_name}},
+          m_compression);
+      writer->open(path, {dictionary});
+      partition.m_dictionarySize = dictionary.size();
+      LOG(debug) << "HistorianSink: writing " << path;
+    }
+
+    writer->write(batch);
+  }
+
+  void HistorianSink::closeFiles()
+  {
+    lock_guard<mutex> fileLock(m_fileMutex);
+    lock_guard<mutex> lock(m_mutex);
+    for (auto &p : m_partitions)
+    {
+      auto &partition = *p.second;
+      if (partition.m_writer && partition.m_writer->isOpen())
+      {
+        try
+        {
+          partition.m_writer->close();
+        }
+        catch (exception &e)
+        {
+          LOG(error) << "HistorianSink: cannot close " << partition.m_writer->getPath() << ": "
+                     << e.what();
+        }
+      }
+      partition.m_writer.reset();
+    }
+  }
+
+  void HistorianSink::removeExpired(const fs::path &directory)
+  {
+    if (m_retention.count() <= 0)
+      return;
+
+    auto limit = fs::file_time_type::clock::now() - m_retention;
+    error_code ec;
+    for (auto &entry : fs::directory_iterator(directory, ec))
+    {
+      if (entry.is_regular_file() && entry.path().extension() == ".arrow" &&
+          entry.last_write_time() < limit)
+      {
+        LOG(debug) << "HistorianSink: removing expired file " << entry.path();
+        fs::remove(entry.path(), ec);
+      }
+    }
+  }
+
+  void HistorianSink::scheduleFlush()
+  {
+    m_timer.expires_after(m_flushInterval);
+    m_timer.async_wait(boost::asio::bind_executor(
+        m_strand, [this, ptr = getptr()](boost::system::error_code ec) { flushTimer(ec); }));
+  }
+
+  void HistorianSink::flushTimer(boost::system::error_code ec)
+  {
+    if (ec || !m_running)
+      return;
+
+    flush();
+    scheduleFlush();
+  }
+
+  void HistorianSink::registerFactory(SinkFactory &factory)
+  {
+    factory.registerFactory(
+        "HistorianSink",
+        [](const std::string &name, boost::asio::io_context &io, SinkContractPtr &&contract,
+           const ConfigOptions &options, const boost::property_tree::ptree &block) -> SinkPtr {
+          return std::make_shared<HistorianSink>(io, std::move(contract), options, block);
+        });
+  }
+}  // namespace mtconnect::sink::historian_sink
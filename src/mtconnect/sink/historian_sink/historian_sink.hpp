@@ -0,0 +1,130 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include "boost/asio/io_context.hpp"
+#include <boost/asio/io_context_strand.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "arrow_ipc.hpp"
+#include "mtconnect/config.hpp"
+#include "mtconnect/observation/observation.hpp"
+#include "mtconnect/sink/sink.hpp"
+#include "mtconnect/utilities.hpp"
+
+namespace mtconnect::sink::historian_sink {
+  /// @brief Writes observations to rolling Arrow IPC files for a historian or data lake
+  ///
+  /// Observations are added to a record batch for their device when they are published. The
+  /// batches are written on the sink strand every `HistorianFlushInterval`, so the pipeline
+  /// only appends to memory. Each device has a directory with one file per
+  /// `HistorianSegmentDuration` window, a new file is started when a file reaches
+  /// `HistorianSegmentSize` bytes.
+  ///
+  /// The columns of the files are:
+  ///
+  /// | Column            | Type                                       |
+  /// |-------------------|--------------------------------------------|
+  /// | `timestamp`       | `timestamp[us, tz=UTC]`                    |
+  /// | `sequence`        | `uint64`                                   |
+  /// | `data_item_id`    | `dictionary<values=string, indices=int32>` |
+  /// | `number`          | `double`, numeric values                   |
+  /// | `text`            | `string`, other values and condition text  |
+  /// | `condition_level` | `string`, `NORMAL`, `WARNING` or `FAULT`   |
+  /// | `native_code`     | `string`, the condition native code        |
+  /// | `unavailable`     | `bool`                                     |
+  class AGENT_LIB_API HistorianSink : public sink::Sink
+  {
+  public:
+    /// @brief Create a historian sink
+    /// @param context the boost asio io_context
+    /// @param contract the Sink Contract from the agent
+    /// @param options configuration options
+    /// @param config additional configuration options
+    HistorianSink(boost::asio::io_context &context, sink::SinkContractPtr &&contract,
+                  const ConfigOptions &options, const boost::property_tree::ptree &config);
+    ~HistorianSink() override;
+
+    /// @brief Remove expired files and start the flush timer
+    void start() override;
+    /// @brief Write the pending observations and close the files
+    void stop() override;
+
+    /// @brief Add an observation to the batch of its device
+    /// @param observation shared pointer to the observation
+    /// @return `true` if the observation was added
+    bool publish(observation::ObservationPtr &observation) override;
+    /// @brief Assets are not published
+    /// @return `false`
+    bool publish(asset::AssetPtr asset) override { return false; }
+    /// @brief Add the data items of a new or changed device to its dictionary
+    /// @param device shared pointer to the device
+    /// @return `true`
+    bool publish(device_model::DevicePtr device) override;
+
+    /// @brief Register the Sink factory to create this sink
+    /// @param factory
+    static void registerFactory(SinkFactory &factory);
+
+    /// @brief Write the pending observations of every device
+    void flush();
+    /// @brief Close the open files so they can be read
+    void closeFiles();
+
+    /// @brief get the directory the files are written to
+    const std::filesystem::path &getPath() const { return m_path; }
+
+  protected:
+    struct Partition;
+
+    Partition &partition(const device_model::DevicePtr &device);
+    void addDataItems(Partition &partition, const device_model::DevicePtr &device);
+    void write(Partition &partition, std::vector<arrow::ColumnData> &batch,
+               const std::vector<std::string> &dictionary);
+    void removeExpired(const std::filesystem::path &directory);
+    void scheduleFlush();
+    void flushTimer(boost::system::error_code ec);
+
+  protected:
+    ConfigOptions m_options;
+    boost::asio::io_context::strand m_strand;
+    boost::asio::steady_timer m_timer;
+
+    std::filesystem::path m_path;
+    std::chrono::seconds m_segmentDuration;
+    uint64_t m_segmentSize;
+    std::chrono::milliseconds m_flushInterval;
+    std::chrono::seconds m_retention;
+    arrow::Compression m_compression;
+
+    std::mutex m_mutex;       ///< Guards the partitions and their batches
+    std::mutex m_fileMutex;   ///< Guards the files
+    std::map<std::string, std::unique_ptr<Partition>> m_partitions;
+    std::atomic_bool m_flushPending {false};
+    bool m_running {false};
+  };
+}  // namespace mtconnect::sink::historian_sink
@@ -529,7 +529,7 @@ namespace mtconnect {
           if (condition)
           {
             observation::ConditionList condList;
-            condition->getFirst()->getConditionList(condList);
+            condition->getConditionList(condList);
 
             for (auto& cond : condList)
             {
@@ -218,13 +218,14 @@ namespace mtconnect {
         SequenceNumber_t firstSeq, lastSeq;
 
         {
+          // The buffer locks itself and reads the history store after releasing the lock
           auto &buffer = m_sinkContract->getCircularBuffer();
-          std::lock_guard<buffer::CircularBuffer> lock(buffer);
-
-          lastSeq = buffer.getSequence() - 1;
           observations =
               buffer.getObservations(m_sampleCount, sampler->getFilter(), sampler->getSequence(),
                                      nullopt, end, firstSeq, observer->m_endOfBuffer);
+
+          std::lock_guard<buffer::CircularBuffer> lock(buffer);
+          lastSeq = buffer.getSequence() - 1;
         }
 
         doc = m_printer->printSample(m_instanceId,
@@ -273,7 +274,7 @@ namespace mtconnect {
             auto &buffer = m_sinkContract->getCircularBuffer();
             std::lock_guard<buffer::CircularBuffer> lock(buffer);
 
-            firstSeq = buffer.getFirstSequence();
+            firstSeq = buffer.getFirstAvailableSequence();
             seq = buffer.getSequence();
             m_sinkContract->getCircularBuffer().getLatest().getObservations(observations,
                                                                             filterSet);
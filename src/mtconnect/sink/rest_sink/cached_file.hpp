@@ -21,6 +21,8 @@
 #include <cstring>
 #include <filesystem>
 #include <memory>
+#include <mutex>
+#include <optional>
 
 #include "mtconnect/config.hpp"
 #include "mtconnect/utilities.hpp"
@@ -132,13 +134,35 @@ namespace mtconnect::sink::rest_sink {
       memset(m_buffer, 0, m_size + 1);
     }
 
+    /// @brief get the path of the gzipped file
+    ///
+    /// The cache updates the path while other sessions are serving the file, so it is only
+    /// accessed under a lock.
+    ///
+    /// @return the path if there is a current gzipped file
+    std::optional<std::filesystem::path> getPathGz() const
+    {
+      std::lock_guard<std::mutex> lock(m_pathGzLock);
+      return m_pathGz;
+    }
+    /// @brief set or clear the path of the gzipped file
+    /// @param path the path or `std::nullopt` if there is no current gzipped file
+    void setPathGz(const std::optional<std::filesystem::path> &path)
+    {
+      std::lock_guard<std::mutex> lock(m_pathGzLock);
+      m_pathGz = path;
+    }
+
     char *m_buffer {nullptr};
     size_t m_size {0};
     std::string m_mimeType;
     std::filesystem::path m_path;
-    std::optional<std::filesystem::path> m_pathGz;
     bool m_cached {true};
     std::filesystem::file_time_type m_lastWrite;
     std::optional<std::string> m_redirect;
+
+  protected:
+    mutable std::mutex m_pathGzLock;
+    std::optional<std::filesystem::path> m_pathGz;
   };
 }  // namespace mtconnect::sink::rest_sink
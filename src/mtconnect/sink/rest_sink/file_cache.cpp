@@ -27,6 +27,7 @@
 #include <boost/system/error_code.hpp>
 
 #include <chrono>
+#include <fstream>
 #include <future>
 #include <thread>
 
@@ -56,6 +57,15 @@ namespace mtconnect::sink::rest_sink {
     NAMED_SCOPE("file_cache");
   }
 
+  FileCache::~FileCache()
+  {
+    if (m_compressor)
+    {
+      m_compressor->stop();
+      m_compressor->join();
+    }
+  }
+
   namespace fs = std::filesystem;
 
   // Register a file
@@ -126,6 +136,8 @@ namespace mtconnect::sink::rest_sink {
     replace_copy(uri.begin(), uri.end(), gen.begin(), '\\', '/');
 
     m_fileMap.emplace(gen, fs::absolute(path));
+    if (m_precompress)
+      precompress(fs::absolute(path));
     string name = path.filename().string();
 
     // Check if the file name maps to a standard MTConnect schema file.
@@ -197,15 +209,7 @@ namespace mtconnect::sink::rest_sink {
           NAMED_SCOPE("work");
           LOG(debug) << "gzipping " << file->m_path << " to " << zipped;
 
-          ifstream input(file->m_path, ios_base::in | ios_base::binary);
-
-          io::filtering_ostream output;
-          output.push(io::gzip_compressor(io::gzip_params(io::gzip::best_compression)));
-          output.push(io::file_sink(zipped.string(), ios_base::out | ios_base::binary));
-
-          io::copy(input, output);
-
-          promise.set_value(true);
+          promise.set_value(gzipFile(file->m_path, zipped));
 
           LOG(debug) << "done";
         }
@@ -230,7 +234,7 @@ namespace mtconnect::sink::rest_sink {
       try
       {
         if (future.get())
-          file->m_pathGz.emplace(zipped);
+          file->setPathGz(zipped);
       }
       catch (std::runtime_error &e)
       {
@@ -250,13 +254,83 @@ namespace mtconnect::sink::rest_sink {
         fs::remove(zipped);
         compressFile(file, context);
       }
-      else if (!file->m_pathGz)
+      else if (!file->getPathGz())
       {
-        file->m_pathGz.emplace(zipped);
+        file->setPathGz(zipped);
       }
     }
   }
 
+  bool FileCache::gzipFile(const fs::path &from, const fs::path &to)
+  {
+    namespace io = boost::iostreams;
+
+    // Compress to a temporary file so a partial file is never served
+    fs::path temp(to.string() + ".tmp");
+    try
+    {
+      {
+        ifstream input(from, ios_base::in | ios_base::binary);
+
+        io::filtering_ostream output;
+        output.push(io::gzip_compressor(io::gzip_params(io::gzip::best_compression)));
+        output.push(io::file_sink(temp.string(), ios_base::out | ios_base::binary));
+
+        io::copy(input, output);
+      }
+      fs::rename(temp, to);
+      return true;
+    }
+    catch (std::exception &e)
+    {
+      LOG(error) << "Error occurred compressing file " << from << ": " << e.what();
+    }
+
+    std::error_code ec;
+    fs::remove(temp, ec);
+    return false;
+  }
+
+  void FileCache::precompress(const fs::path &path)
+  {
+    std::error_code ec;
+    auto ext = path.extension();
+    if (ext == ".gz" || ext == ".tmp" || fs::file_size(path, ec) < m_minCompressedFileSize || ec)
+      return;
+
+    fs::path zipped(path.string() + ".gz");
+    if (fs::exists(zipped, ec) && fs::last_write_time(zipped, ec) >= fs::last_write_time(path, ec))
+      return;
+
+    std::lock_guard<std::recursive_mutex> lock(m_cacheLock);
+    if (!m_compressing.insert(path).second)
+      return;
+
+    if (!m_compressor)
+      m_compressor = make_unique<boost::asio::thread_pool>(1);
+
+    boost::asio::post(*m_compressor, [this, path, zipped] {
+      NAMED_SCOPE("FileCache::precompress");
+      LOG(debug) << "gzipping " << path << " to " << zipped << " in the background";
+
+      gzipFile(path, zipped);
+
+      std::lock_guard<std::recursive_mutex> lock(m_cacheLock);
+      m_compressing.erase(path);
+    });
+  }
+
+  void FileCache::precompressDirectory(const fs::path &path)
+  {
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(path, ec);
+         !ec && it != fs::recursive_directory_iterator(); it.increment(ec))
+    {
+      if (it->is_regular_file(ec))
+        precompress(it->path());
+    }
+  }
+
   CachedFilePtr FileCache::findFileInDirectories(const std::string &name)
   {
     namespace fs = std::filesystem;
@@ -329,8 +403,8 @@ namespace mtconnect::sink::rest_sink {
             auto lastWrite = std::filesystem::last_write_time(fp->m_path);
             if (lastWrite == fp->m_lastWrite)
               file = fp;
-            else if (fp->m_pathGz && fs::exists(*fp->m_pathGz))
-              fs::remove(*fp->m_pathGz);
+            else if (auto gz = fp->getPathGz(); gz && fs::exists(*gz))
+              fs::remove(*gz);
           }
         }
 
@@ -355,9 +429,34 @@ namespace mtconnect::sink::rest_sink {
       if (file)
       {
         if (acceptEncoding && acceptEncoding->find("gzip") != string::npos &&
-            file->m_size >= m_minCompressedFileSize)
+            file->m_size >= m_minCompressedFileSize && !file->m_redirect)
         {
-          compressFile(file, context);
+          if (m_precompress)
+          {
+            // Use the compressed file if it is current, otherwise compress it in the background
+            // and return the uncompressed file for this request.
+            fs::path zipped(file->m_path.string() + ".gz");
+            std::error_code ec;
+            bool compressing;
+            {
+              std::lock_guard<std::recursive_mutex> lock(m_cacheLock);
+              compressing = m_compressing.count(file->m_path) > 0;
+            }
+            if (!compressing && fs::exists(zipped, ec) &&
+                fs::last_write_time(zipped, ec) >= fs::last_write_time(file->m_path, ec))
+            {
+              file->setPathGz(zipped);
+            }
+            else
+            {
+              file->setPathGz(std::nullopt);
+              precompress(file->m_path);
+            }
+          }
+          else
+          {
+            compressFile(file, context);
+          }
         }
       }
       else
@@ -387,6 +486,8 @@ namespace mtconnect::sink::rest_sink {
         boost::erase_last(root, "/");
       }
       m_directories.emplace(root, make_pair(fs::canonical(path), index));
+      if (m_precompress)
+        precompressDirectory(fs::canonical(path));
     }
     else
     {
@@ -19,7 +19,9 @@
 
 #include <filesystem>
 #include <list>
+#include <memory>
 #include <optional>
+#include <set>
 #include <string>
 
 #include "cached_file.hpp"
@@ -28,7 +30,8 @@
 namespace boost {
   namespace asio {
     class io_context;
-  }
+    class thread_pool;
+  }  // namespace asio
 }  // namespace boost
 
 namespace mtconnect::sink::rest_sink {
@@ -44,6 +47,8 @@ namespace mtconnect::sink::rest_sink {
     /// @brief Create a file cache
     /// @param max optional maxumimum size of the cache, defaults to 20k.
     FileCache(size_t max = 20 * 1024);
+    /// @brief Stops any pending background compression
+    ~FileCache();
 
     /// @brief register files to be served by the agent.
     /// @note Cover method for `registerDirectory()`.
@@ -121,6 +126,18 @@ namespace mtconnect::sink::rest_sink {
     /// @return the size
     auto getMinCompressedFileSize() const { return m_minCompressedFileSize; }
 
+    /// @brief Compress files in the background
+    ///
+    /// Registered files and the files in added directories larger than the minimum compressed
+    /// file size are gzipped in a background thread when they are registered. Requests never
+    /// compress on the calling thread; the uncompressed file is returned until the compressed
+    /// file is ready.
+    /// @param precompress `true` to compress in the background
+    void setPrecompress(bool precompress) { m_precompress = precompress; }
+    /// @brief Check if files are compressed in the background
+    /// @return `true` if files are compressed in the background
+    auto getPrecompress() const { return m_precompress; }
+
     /// @name Only used for testing
     ///@{
     /// @brief clean the file cache
@@ -140,6 +157,9 @@ namespace mtconnect::sink::rest_sink {
 
     CachedFilePtr redirect(const std::string &name, const Directory &directory);
     void compressFile(CachedFilePtr file, boost::asio::io_context *context);
+    void precompress(const std::filesystem::path &path);
+    void precompressDirectory(const std::filesystem::path &path);
+    static bool gzipFile(const std::filesystem::path &from, const std::filesystem::path &to);
 
   protected:
     std::map<std::string, std::pair<std::filesystem::path, std::string>> m_directories;
@@ -147,7 +167,12 @@ namespace mtconnect::sink::rest_sink {
     std::map<std::string, CachedFilePtr> m_fileCache;
     std::map<std::string, std::string> m_mimeTypes;
     size_t m_maxCachedFileSize;
-    size_t m_minCompressedFileSize;
+    size_t m_minCompressedFileSize {100 * 1024};
+
+    // Background compression
+    bool m_precompress {false};
+    std::unique_ptr<boost::asio::thread_pool> m_compressor;
+    std::set<std::filesystem::path> m_compressing;
 
     // Access control to the buffer
     mutable std::recursive_mutex m_cacheLock;
@@ -25,6 +25,7 @@
 #include "mtconnect/pipeline/shdr_token_mapper.hpp"
 #include "mtconnect/pipeline/shdr_tokenizer.hpp"
 #include "mtconnect/pipeline/timestamp_extractor.hpp"
+#include "mtconnect/printer/json_printer_helper.hpp"
 #include "mtconnect/printer/xml_printer.hpp"
 #include "server.hpp"
 
@@ -61,6 +62,11 @@ namespace mtconnect {
 
       m_fileCache.setMaxCachedFileSize(maxSize);
       m_fileCache.setMinCompressedFileSize(compressSize);
+      m_fileCache.setPrecompress(IsOptionSet(options, config::PrecompressFiles));
+
+      m_maxBytesInFlight = ConvertFileSize(options, config::MaxStreamBytesInFlight, 0);
+      m_maxChunksInFlight = GetOption<int>(options, config::MaxStreamChunksInFlight).value_or(0);
+      m_maxStreamLag = GetOption<int>(options, config::MaxStreamLag).value_or(0);
 
       // Unique id number for agent instance
       m_instanceId = getCurrentTimeInSec();
@@ -116,6 +122,8 @@ namespace mtconnect {
       createCurrentRoutings();
       createSampleRoutings();
       createAssetRoutings();
+      if (metrics::Registry::global().isEnabled())
+        createMetricsRoutings();
       createProbeRoutings();
       createPutObservationRoutings();
       createFileRoutings();
@@ -518,6 +526,39 @@ namespace mtconnect {
                     "device identified by `device` matching `name` or `uuid`.");
     }
 
+    void RestService::createMetricsRoutings()
+    {
+      using namespace rest_sink;
+      auto handler = [&](SessionPtr session, const RequestPtr request) -> bool {
+        stringstream out;
+        metrics::Registry::global().printPrometheus(out);
+        ResponsePtr response =
+            make_unique<Response>(status::ok, out.str(), "text/plain; version=0.0.4");
+        session->writeResponse(std::move(response));
+        return true;
+      };
+
+      m_server->addRouting({boost::beast::http::verb::get, "/metrics", handler})
+          .document("Agent latency metrics",
+                    "Latency histograms of the agent in the Prometheus text format");
+
+      // Resolve the render histograms now so requests do not take the registry lock
+      auto &registry = metrics::Registry::global();
+      static const std::array<std::string, RENDER_REQUESTS> requests {"probe", "current", "sample",
+                                                                     "assets"};
+      for (const auto &[name, printer] : m_sinkContract->getPrinters())
+      {
+        auto &histograms = m_renderLatency[printer.get()];
+        for (size_t i = 0; i < requests.size(); i++)
+        {
+          histograms[i] = registry.histogram(
+              "mtconnect_render_seconds", "Time to render a response document",
+              {{"request", requests[i]}, {"format", printer->mimeType()}},
+              requests[i] + "_render_latency");
+        }
+      }
+    }
+
     void RestService::createAssetRoutings()
     {
       using namespace rest_sink;
@@ -564,16 +605,24 @@ namespace mtconnect {
 
         request->m_request = "MTConnectAssets";
 
+        optional<pair<string, string>> property;
+        if (auto serialNumber = request->parameter<string>("serialNumber"))
+          property.emplace("serialNumber", *serialNumber);
+        else if (auto toolId = request->parameter<string>("toolId"))
+          property.emplace("toolId", *toolId);
+
         respond(session,
                 assetRequest(printer, count, removed, request->parameter<string>("type"),
-                             request->parameter<string>("device"), pretty, request->m_requestId),
+                             request->parameter<string>("device"), pretty, request->m_requestId,
+                             property),
                 request->m_requestId);
         return true;
       };
 
       string qp(
           "type={string}&removed={bool:false}&"
-          "count={integer:100}&device={string}&pretty={bool:false}&format={string}");
+          "count={integer:100}&device={string}&pretty={bool:false}&format={string}&"
+          "serialNumber={string}&toolId={string}");
       m_server->addRouting({boost::beast::http::verb::get, "/assets?" + qp, handler})
           .document("MTConnect assets request", "Returns up to `count` assets");
       m_server->addRouting({boost::beast::http::verb::get, "/{device}/assets?" + qp, handler})
@@ -819,6 +868,32 @@ namespace mtconnect {
 
       if (m_server->arePutsAllowed())
       {
+        auto bulkHandler = [&](SessionPtr session, RequestPtr request) -> bool {
+          auto format = request->parameter<string>("format");
+          auto printer = getPrinter(request->m_accepts, format);
+
+          respond(session,
+                  bulkObservationRequest(printer, request->m_body,
+                                         request->parameter<string>("device")),
+                  request->m_requestId);
+          return true;
+        };
+
+        // The bulk routings must precede /{device} so observations is not taken as a device
+        m_server
+            ->addRouting(
+                {boost::beast::http::verb::post, "/observations?format={string}", bulkHandler})
+            .document("Non-normative POST of a batch of json observations",
+                      "The body is a json object, an array of objects, or newline delimited "
+                      "objects. Returns the number of mapped entities and the errors by record")
+            .command("observations");
+        m_server
+            ->addRouting({boost::beast::http::verb::post, "/{device}/observations?format={string}",
+                          bulkHandler})
+            .document("Non-normative POST of a batch of json observations for `device`",
+                      "The body is a json object, an array of objects, or newline delimited "
+                      "objects. Returns the number of mapped entities and the errors by record");
+
         auto handler = [&](SessionPtr session, RequestPtr request) -> bool {
           if (!request->m_query.empty())
           {
@@ -885,6 +960,7 @@ namespace mtconnect {
 
       auto counts = m_sinkContract->getAssetStorage()->getCountsByType();
 
+      metrics::ScopedTimer timer(renderLatency(printer, PROBE));
       return make_unique<Response>(
           rest_sink::status::ok,
           printer->printProbe(m_instanceId, m_sinkContract->getCircularBuffer().getBufferSize(),
@@ -999,12 +1075,20 @@ namespace mtconnect {
       {
         observation::AsyncObserver::cancel();
         m_session.reset();
+        if (m_lagging)
+        {
+          m_lagging = false;
+          if (auto sink = m_sink.lock())
+            dynamic_pointer_cast<RestService>(sink)->streamLagChanged(false);
+        }
         return true;
       }
 
       std::weak_ptr<sink::Sink>
           m_sink;  //!  weak shared pointer to the sink. handles shutdown timer race
       int m_count {0};
+      bool m_live {false};     //! the stream has reached the end of the buffer
+      bool m_lagging {false};  //! the stream is being sent coalesced chunks
       const Printer *m_printer {nullptr};
       bool m_logStreamData {false};
       rest_sink::SessionPtr m_session;
@@ -1031,7 +1115,7 @@ namespace mtconnect {
       if (from)
       {
         std::lock_guard<CircularBuffer> lock(m_sinkContract->getCircularBuffer());
-        auto firstSeq = m_sinkContract->getCircularBuffer().getFirstSequence();
+        auto firstSeq = m_sinkContract->getCircularBuffer().getFirstAvailableSequence();
         auto seq = m_sinkContract->getCircularBuffer().getSequence();
         checkRange(printer, *from, firstSeq - 1, seq + 1, "from");
       }
@@ -1054,6 +1138,7 @@ namespace mtconnect {
       asyncResponse->m_pretty = pretty;
       asyncResponse->setRequestId(requestId);
       session->addObserver(asyncResponse);
+      session->setSendBudget(m_maxBytesInFlight, m_maxChunksInFlight);
 
       if (m_logStreamData)
       {
@@ -1094,10 +1179,40 @@ namespace mtconnect {
         if (asyncResponse->getSequence() > 0)
           from.emplace(asyncResponse->getSequence());
 
-        string content = fetchSampleData(asyncResponse->m_printer, asyncResponse->getFilter(),
-                                         asyncResponse->m_count, from, nullopt, end,
-                                         asyncObserver->m_endOfBuffer, asyncResponse->m_pretty,
-                                         asyncResponse->getRequestId());
+        // A client is lagging when more data is in flight than its send budget allows, or when
+        // a stream that was live falls more than the maximum lag behind the buffer.
+        auto &buffer = m_sinkContract->getCircularBuffer();
+        bool lagging = asyncResponse->m_session && asyncResponse->m_session->isOverSendBudget();
+        if (!lagging && m_maxStreamLag > 0 && asyncResponse->m_live && from)
+          lagging = buffer.getSequence() > *from + m_maxStreamLag;
+
+        if (lagging != asyncResponse->m_lagging)
+        {
+          asyncResponse->m_lagging = lagging;
+          streamLagChanged(lagging);
+        }
+
+        string content;
+        if (lagging)
+        {
+          // Send the latest values for the filter instead of the backlog and continue from
+          // the end of the buffer. Incremental sampling resumes once the client catches up.
+          // The count is published when a stream starts or stops lagging, an observation per
+          // chunk would signal every lagging stream that observes the agent device.
+          asyncObserver->m_endOfBuffer = true;
+          content = fetchCurrentData(asyncResponse->m_printer, asyncResponse->getFilter(), nullopt,
+                                     asyncResponse->m_pretty, asyncResponse->getRequestId(), &end);
+          m_coalescedChunks++;
+        }
+        else
+        {
+          content = fetchSampleData(asyncResponse->m_printer, asyncResponse->getFilter(),
+                                    asyncResponse->m_count, from, nullopt, end,
+                                    asyncObserver->m_endOfBuffer, asyncResponse->m_pretty,
+                                    asyncResponse->getRequestId());
+          if (asyncObserver->m_endOfBuffer)
+            asyncResponse->m_live = true;
+        }
 
         if (m_logStreamData)
           asyncResponse->m_log << content << endl;
@@ -1275,7 +1390,8 @@ namespace mtconnect {
                                           const bool removed,
                                           const std::optional<std::string> &type,
                                           const std::optional<std::string> &device, bool pretty,
-                                          const std::optional<std::string> &requestId)
+                                          const std::optional<std::string> &requestId,
+                                          const optional<pair<string, string>> &property)
     {
       using namespace rest_sink;
 
@@ -1288,7 +1404,14 @@ namespace mtconnect {
           uuid = d->getUuid();
       }
 
-      m_sinkContract->getAssetStorage()->getAssets(list, count, !removed, uuid, type);
+      auto storage = m_sinkContract->getAssetStorage();
+      if (property)
+        storage->getAssetsByProperty(list, count, property->first, property->second, !removed,
+                                     uuid, type);
+      else
+        storage->getAssets(list, count, !removed, uuid, type);
+
+      metrics::ScopedTimer timer(renderLatency(printer, ASSETS));
       return make_unique<Response>(
           status::ok,
           printer->printAssets(
@@ -1313,6 +1436,7 @@ namespace mtconnect {
       }
       else
       {
+        metrics::ScopedTimer timer(renderLatency(printer, ASSETS));
         return make_unique<Response>(
             status::ok,
             printer->printAssets(
@@ -1469,6 +1593,64 @@ namespace mtconnect {
       }
     }
 
+    void RestService::streamLagChanged(bool lagging)
+    {
+      auto count = lagging ? ++m_laggingStreams : --m_laggingStreams;
+      LOG(debug) << "Lagging streams: " << count;
+
+      if (auto di = m_sinkContract->getDataItemById("lagging_streams"))
+        m_loopback->receive(di, to_string(count));
+      if (auto di = m_sinkContract->getDataItemById("coalesced_chunks"))
+        m_loopback->receive(di, to_string(m_coalescedChunks.load()));
+    }
+
+    ResponsePtr RestService::bulkObservationRequest(const Printer *printer, const std::string &body,
+                                                    const std::optional<std::string> &device)
+    {
+      using namespace rest_sink;
+
+      DevicePtr dev;
+      if (device)
+        dev = checkDevice(printer, *device);
+
+      entity::EntityPtr res;
+      {
+        // Hold the buffer lock for the whole batch. The batch scope is opened first so the
+        // observers are signaled after the lock is released.
+        ChangeNotifier::Batch batch;
+        std::lock_guard<CircularBuffer> lock(m_sinkContract->getCircularBuffer());
+        res = m_loopback->receiveJson(body, dev);
+      }
+
+      if (!res)
+      {
+        auto error = Error::make(Error::ErrorCode::INTERNAL_ERROR, "Observations were not mapped");
+        throw RestError(error, printer);
+      }
+
+      size_t count = 0;
+      if (auto entities = res->maybeGetValue<entity::EntityList>())
+        count = entities->size();
+
+      rapidjson::StringBuffer output;
+      RenderJson(output, false, [&](auto &writer) {
+        AutoJsonObject obj(writer);
+        obj.AddPairs("entities", uint64_t(count));
+        AutoJsonArray errors(writer, "errors");
+        if (auto list = res->maybeGet<entity::EntityList>("errors"))
+        {
+          for (auto &error : *list)
+          {
+            AutoJsonObject eobj(writer);
+            eobj.AddPairs("record", error->get<int64_t>("record"), "message",
+                          error->getValue<string>());
+          }
+        }
+      });
+
+      return make_unique<Response>(status::ok, string(output.GetString()), "application/json");
+    }
+
     // For debugging
     void RestService::setLogStreamData(bool log) { m_logStreamData = log; }
 
@@ -1558,7 +1740,8 @@ namespace mtconnect {
 
     string RestService::fetchCurrentData(const Printer *printer, const FilterSetOpt &filterSet,
                                          const optional<SequenceNumber_t> &at, bool pretty,
-                                         const std::optional<std::string> &requestId)
+                                         const std::optional<std::string> &requestId,
+                                         SequenceNumber_t *next)
     {
       ObservationList observations;
       SequenceNumber_t firstSeq, seq;
@@ -1566,11 +1749,15 @@ namespace mtconnect {
       {
         std::lock_guard<CircularBuffer> lock(m_sinkContract->getCircularBuffer());
 
-        firstSeq = m_sinkContract->getCircularBuffer().getFirstSequence();
+        firstSeq = m_sinkContract->getCircularBuffer().getFirstAvailableSequence();
         seq = m_sinkContract->getCircularBuffer().getSequence();
+        if (next)
+          *next = seq;
         if (at)
         {
-          checkRange(printer, *at, firstSeq - 1, seq, "at");
+          // Checkpoints are only kept for the circular buffer
+          auto first = m_sinkContract->getCircularBuffer().getFirstSequence();
+          checkRange(printer, *at, first - 1, seq, "at");
 
           auto check = m_sinkContract->getCircularBuffer().getCheckpointAt(*at, filterSet);
           check->getObservations(observations);
@@ -1581,6 +1768,7 @@ namespace mtconnect {
         }
       }
 
+      metrics::ScopedTimer timer(renderLatency(printer, CURRENT));
       return printer->printSample(m_instanceId, m_sinkContract->getCircularBuffer().getBufferSize(),
                                   seq, firstSeq, seq - 1, observations, pretty, requestId);
     }
@@ -1596,7 +1784,7 @@ namespace mtconnect {
 
       {
         std::lock_guard<CircularBuffer> lock(m_sinkContract->getCircularBuffer());
-        firstSeq = m_sinkContract->getCircularBuffer().getFirstSequence();
+        firstSeq = m_sinkContract->getCircularBuffer().getFirstAvailableSequence();
         auto seq = m_sinkContract->getCircularBuffer().getSequence();
         lastSeq = seq - 1;
         int upperCountLimit = m_sinkContract->getCircularBuffer().getBufferSize() + 1;
@@ -1613,11 +1801,18 @@ namespace mtconnect {
           lowerCountLimit = 0;
         }
         checkRange(printer, count, lowerCountLimit, upperCountLimit, "count", true);
+      }
 
-        observations = m_sinkContract->getCircularBuffer().getObservations(
-            count, filterSet, from, to, end, firstSeq, endOfBuffer);
+      // The history store is read without the buffer lock. Take the last sequence afterwards so
+      // it is never before the next sequence.
+      observations = m_sinkContract->getCircularBuffer().getObservations(
+          count, filterSet, from, to, end, firstSeq, endOfBuffer);
+      {
+        std::lock_guard<CircularBuffer> lock(m_sinkContract->getCircularBuffer());
+        lastSeq = m_sinkContract->getCircularBuffer().getSequence() - 1;
       }
 
+      metrics::ScopedTimer timer(renderLatency(printer, SAMPLE));
       return printer->printSample(m_instanceId, m_sinkContract->getCircularBuffer().getBufferSize(),
                                   end, firstSeq, lastSeq, *observations, pretty, requestId);
     }
@@ -19,8 +19,12 @@
 
 #include <boost/asio/io_context.hpp>
 
+#include <array>
+#include <unordered_map>
+
 #include "mtconnect/buffer/circular_buffer.hpp"
 #include "mtconnect/config.hpp"
+#include "mtconnect/metrics/latency.hpp"
 #include "mtconnect/sink/sink.hpp"
 #include "mtconnect/source/loopback_source.hpp"
 #include "mtconnect/utilities.hpp"
@@ -90,6 +94,15 @@ namespace mtconnect {
       /// @return pointer to the file cache
       auto getFileCache() { return &m_fileCache; }
 
+      /// @brief Count a sample stream starting or stopping to lag and report the number of
+      /// lagging streams and coalesced chunks on the agent device
+      /// @param lagging `true` if the stream started lagging
+      void streamLagChanged(bool lagging);
+      /// @brief get the number of sample streams being sent coalesced chunks
+      auto getLaggingStreams() const { return m_laggingStreams.load(); }
+      /// @brief get the number of coalesced chunks sent to lagging streams
+      auto getCoalescedChunks() const { return m_coalescedChunks.load(); }
+
       /// @name MTConnect Request Handlers
       ///@{
 
@@ -177,6 +190,15 @@ namespace mtconnect {
       ResponsePtr putObservationRequest(const printer::Printer *p, const std::string &device,
                                         const QueryMap observations,
                                         const std::optional<std::string> &time = std::nullopt);
+      /// @brief Handler for a bulk post of json observations
+      ///
+      /// The observations are mapped as a single batch with one buffer lock.
+      /// @param[in] p printer for errors
+      /// @param[in] body a json object, array of objects, or newline delimited objects
+      /// @param[in] device optional default device
+      /// @return a json document with the count of mapped entities and per-record errors
+      ResponsePtr bulkObservationRequest(const printer::Printer *p, const std::string &body,
+                                         const std::optional<std::string> &device = std::nullopt);
 
       ///@}
 
@@ -206,12 +228,16 @@ namespace mtconnect {
       /// @param[in] type optional type of asset to filter
       /// @param[in] device optional device name or uuid
       /// @param[in] pretty `true` to ensure response is formatted
+      /// @param[in] requestId optional request id to include in the header
+      /// @param[in] property optional property name and value the assets must have, such as
+      ///            `serialNumber` or `toolId`
       /// @return MTConnect Assets response document
-      ResponsePtr assetRequest(const printer::Printer *p, const int32_t count, const bool removed,
-                               const std::optional<std::string> &type = std::nullopt,
-                               const std::optional<std::string> &device = std::nullopt,
-                               bool pretty = false,
-                               const std::optional<std::string> &requestId = std::nullopt);
+      ResponsePtr assetRequest(
+          const printer::Printer *p, const int32_t count, const bool removed,
+          const std::optional<std::string> &type = std::nullopt,
+          const std::optional<std::string> &device = std::nullopt, bool pretty = false,
+          const std::optional<std::string> &requestId = std::nullopt,
+          const std::optional<std::pair<std::string, std::string>> &property = std::nullopt);
 
       /// @brief Asset request handler using a list of asset ids
       /// @param[in] p printer for the response document
@@ -346,10 +372,33 @@ namespace mtconnect {
 
       void createAssetRoutings();
 
+      void createMetricsRoutings();
+
+      // Requests that record the time to render their document
+      enum RenderRequest
+      {
+        PROBE,
+        CURRENT,
+        SAMPLE,
+        ASSETS,
+        RENDER_REQUESTS
+      };
+
+      // Get the histogram for the time to render a request document
+      metrics::Histogram *renderLatency(const printer::Printer *printer,
+                                        RenderRequest request) const
+      {
+        auto it = m_renderLatency.find(printer);
+        if (it == m_renderLatency.end())
+          return nullptr;
+        return it->second[request];
+      }
+
       // Current Data Collection
       std::string fetchCurrentData(const printer::Printer *printer, const FilterSetOpt &filterSet,
                                    const std::optional<SequenceNumber_t> &at, bool pretty = false,
-                                   const std::optional<std::string> &requestId = std::nullopt);
+                                   const std::optional<std::string> &requestId = std::nullopt,
+                                   SequenceNumber_t *next = nullptr);
 
       // Sample data collection
       std::string fetchSampleData(const printer::Printer *printer, const FilterSetOpt &filterSet,
@@ -382,6 +431,18 @@ namespace mtconnect {
       // Buffers
       FileCache m_fileCache;
       bool m_logStreamData {false};
+
+      // Slow consumers
+      size_t m_maxBytesInFlight {0};
+      size_t m_maxChunksInFlight {0};
+      SequenceNumber_t m_maxStreamLag {0};
+      std::atomic_int64_t m_laggingStreams {0};
+      std::atomic_int64_t m_coalescedChunks {0};
+
+      // Render latency histograms for each printer, resolved once when the service is created
+      std::unordered_map<const printer::Printer *,
+                         std::array<metrics::Histogram *, RENDER_REQUESTS>>
+          m_renderLatency;
     };
   }  // namespace sink::rest_sink
 }  // namespace mtconnect
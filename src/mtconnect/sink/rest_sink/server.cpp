@@ -32,6 +32,7 @@
 
 #include <thread>
 
+#include "mtconnect/configuration/async_context.hpp"
 #include "mtconnect/logging.hpp"
 #include "mtconnect/printer/json_printer_helper.hpp"
 #include "session_impl.hpp"
@@ -48,6 +49,16 @@ namespace mtconnect::sink::rest_sink {
 
   using namespace std;
   using namespace rapidjson;
+
+  // Accepted sessions are spread over the io contexts when the worker threads are sharded
+  static net::io_context &SessionContext(net::io_context &context)
+  {
+    using configuration::IoShards;
+    if (net::has_service<IoShards>(context))
+      return net::use_service<IoShards>(context).place();
+    else
+      return context;
+  }
   using std::placeholders::_1;
   using std::placeholders::_2;
 
@@ -146,7 +157,7 @@ namespace mtconnect::sink::rest_sink {
     }
 
     m_listening = true;
-    m_acceptor.async_accept(net::make_strand(m_context),
+    m_acceptor.async_accept(net::make_strand(SessionContext(m_context)),
                             beast::bind_front_handler(&Server::accept, this));
   }
 
@@ -201,6 +212,8 @@ namespace mtconnect::sink::rest_sink {
         auto dectector =
             make_shared<TlsDector>(std::move(socket), m_sslContext, m_tlsOnly, m_allowPuts,
                                    m_allowPutsFrom, m_fields, dispatcher, m_errorFunction);
+        dectector->setWebsocketCompression(m_websocketCompression);
+        dectector->setWriteLatency(m_writeLatency);
 
         dectector->run();
       }
@@ -215,10 +228,12 @@ namespace mtconnect::sink::rest_sink {
           session->allowPutsFrom(m_allowPutsFrom);
         else if (m_allowPuts)
           session->allowPuts();
+        session->setWebsocketCompression(m_websocketCompression);
+        session->setWriteLatency(m_writeLatency);
 
         session->run();
       }
-      m_acceptor.async_accept(net::make_strand(m_context),
+      m_acceptor.async_accept(net::make_strand(SessionContext(m_context)),
                               beast::bind_front_handler(&Server::accept, this));
     }
   }
@@ -36,6 +36,7 @@
 #include "file_cache.hpp"
 #include "mtconnect/config.hpp"
 #include "mtconnect/configuration/config_options.hpp"
+#include "mtconnect/metrics/latency.hpp"
 #include "mtconnect/utilities.hpp"
 #include "response.hpp"
 #include "routing.hpp"
@@ -75,6 +76,15 @@ namespace mtconnect::sink::rest_sink {
       if (fields)
         setHttpHeaders(*fields);
 
+      if (IsOptionSet(options, configuration::WebsocketCompression))
+        m_websocketCompression =
+            GetOption<int>(options, configuration::WebsocketCompressionLevel).value_or(6);
+
+      // Resolved once, the registry is enabled by the agent before the sinks are created
+      m_writeLatency = metrics::Registry::global().histogram(
+          "mtconnect_session_write_seconds", "Time to write a response or chunk to a client", {},
+          "session_write_latency");
+
       m_errorFunction = [](SessionPtr session, const RestError &error) {
         ResponsePtr response =
             std::make_unique<Response>(error.getStatus(), error.what(), "text/plain");
@@ -326,6 +336,11 @@ namespace mtconnect::sink::rest_sink {
     bool m_allowPuts {false};
     std::set<boost::asio::ip::address> m_allowPutsFrom;
 
+    // Websocket permessage-deflate compression level
+    std::optional<int> m_websocketCompression;
+    // Shared by the sessions to measure write latency
+    metrics::Histogram *m_writeLatency {nullptr};
+
     std::list<Routing> m_routings;
     std::map<std::string, Routing *> m_commands;
     std::unique_ptr<FileCache> m_fileCache;
@@ -21,14 +21,21 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/beast/http/status.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <optional>
 
 #include "error.hpp"
 #include "mtconnect/config.hpp"
 #include "mtconnect/observation/change_observer.hpp"
 #include "routing.hpp"
 
+namespace mtconnect::metrics {
+  class Histogram;
+}
+
 namespace mtconnect::sink::rest_sink {
   struct Response;
   using ResponsePtr = std::unique_ptr<Response>;
@@ -121,12 +128,52 @@ namespace mtconnect::sink::rest_sink {
       m_unauthorized = true;
     }
 
+    /// @brief enable `permessage-deflate` for websocket connections upgraded from this session
+    /// @param level the zlib compression level, `std::nullopt` disables compression
+    void setWebsocketCompression(const std::optional<int> &level)
+    {
+      m_websocketCompression = level;
+    }
+    /// @brief get the websocket compression level
+    /// @return the compression level if compression is enabled
+    const auto &getWebsocketCompression() const { return m_websocketCompression; }
+
+    /// @brief measure how long writes to the client take
+    /// @param latency the histogram or `nullptr` if metrics are off
+    void setWriteLatency(metrics::Histogram *latency) { m_writeLatency = latency; }
+
     /// @brief Add an observer to the list for cleanup later.
     void addObserver(std::weak_ptr<observation::AsyncResponse> observer)
     {
       m_observers.push_back(observer);
     }
 
+    /// @name Send budget
+    ///
+    /// Streams check the budget to decide if the client is keeping up with the data.
+    ///@{
+
+    /// @brief set the data that can be in flight to the client before it is lagging
+    /// @param bytes maximum bytes in flight, `0` is unlimited
+    /// @param chunks maximum chunks in flight, `0` is unlimited
+    void setSendBudget(size_t bytes, size_t chunks)
+    {
+      m_maxBytesInFlight = bytes;
+      m_maxChunksInFlight = chunks;
+    }
+    /// @brief check if more data is in flight than the send budget allows
+    /// @return `true` if the client is over budget
+    bool isOverSendBudget() const
+    {
+      return (m_maxBytesInFlight > 0 && m_bytesInFlight > m_maxBytesInFlight) ||
+             (m_maxChunksInFlight > 0 && m_chunksInFlight > m_maxChunksInFlight);
+    }
+    /// @brief get the number of bytes queued or being written
+    size_t getBytesInFlight() const { return m_bytesInFlight; }
+    /// @brief get the number of chunks queued or being written
+    size_t getChunksInFlight() const { return m_chunksInFlight; }
+    ///@}
+
     bool cancelRequest(const std::string &requestId)
     {
       for (auto &obs : m_observers)
@@ -141,6 +188,21 @@ namespace mtconnect::sink::rest_sink {
       return false;
     }
 
+  protected:
+    /// @brief account for a chunk that has been queued or started writing
+    void chunkQueued(size_t bytes)
+    {
+      m_bytesInFlight += bytes;
+      m_chunksInFlight++;
+    }
+    /// @brief account for a chunk that has been written
+    void chunkSent(size_t bytes)
+    {
+      m_bytesInFlight -= std::min<size_t>(bytes, m_bytesInFlight);
+      if (m_chunksInFlight > 0)
+        m_chunksInFlight--;
+    }
+
   protected:
     Dispatch m_dispatch;
     ErrorFunction m_errorFunction;
@@ -151,6 +213,13 @@ namespace mtconnect::sink::rest_sink {
     std::set<boost::asio::ip::address> m_allowPutsFrom;
     boost::asio::ip::tcp::endpoint m_remote;
     std::list<std::weak_ptr<observation::AsyncResponse>> m_observers;
+    std::optional<int> m_websocketCompression;
+    metrics::Histogram *m_writeLatency {nullptr};
+
+    std::atomic_size_t m_bytesInFlight {0};
+    std::atomic_size_t m_chunksInFlight {0};
+    size_t m_maxBytesInFlight {0};
+    size_t m_maxChunksInFlight {0};
   };
 
 }  // namespace mtconnect::sink::rest_sink
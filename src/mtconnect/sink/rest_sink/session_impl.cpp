@@ -30,6 +30,12 @@
 #include <boost/uuid/random_generator.hpp>
 #include <boost/uuid/uuid_io.hpp>
 
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#endif
+
 #include "mtconnect/logging.hpp"
 #include "request.hpp"
 #include "response.hpp"
@@ -265,6 +271,15 @@ namespace mtconnect::sink::rest_sink {
   {
     NAMED_SCOPE("SessionImpl::sent");
 
+    if (m_writeLatency)
+      m_writeLatency->record(metrics::Clock::now() - m_writeStart);
+
+    if (m_chunkBytes > 0)
+    {
+      chunkSent(m_chunkBytes);
+      m_chunkBytes = 0;
+    }
+
     if (m_outgoing)
     {
       m_outgoing.reset();
@@ -322,6 +337,7 @@ namespace mtconnect::sink::rest_sink {
 
     auto sr = make_shared<response_serializer<empty_body>>(*res);
     m_serializer = sr;
+    writing();
     async_write_header(derived().stream(), *sr,
                        beast::bind_front_handler(&SessionImpl::sent, shared_ptr()));
   }
@@ -345,6 +361,10 @@ namespace mtconnect::sink::rest_sink {
         << to_string(field::content_length) << ": " << to_string(body.length()) << "\r\n\r\n"
         << body << "\r\n";
 
+    m_chunkBytes = m_streamBuffer->size();
+    chunkQueued(m_chunkBytes);
+
+    writing();
     async_write(derived().stream(), http::make_chunk(m_streamBuffer->data()),
                 beast::bind_front_handler(&SessionImpl::sent, shared_ptr()));
   }
@@ -356,6 +376,7 @@ namespace mtconnect::sink::rest_sink {
 
     m_complete = [this]() { close(); };
     http::fields trailer;
+    writing();
     async_write(derived().stream(), http::make_chunk_last(trailer),
                 beast::bind_front_handler(&SessionImpl::sent, shared_ptr()));
   }
@@ -403,23 +424,32 @@ namespace mtconnect::sink::rest_sink {
 
     m_complete = complete;
     m_outgoing = std::move(responsePtr);
+    writing();
 
     if (m_outgoing->m_file && !m_outgoing->m_file->m_cached)
     {
-      beast::error_code ec;
-      http::file_body::value_type body;
       fs::path path;
       optional<string> encoding;
-      if (m_request->m_acceptsEncoding.find("gzip") != string::npos && m_outgoing->m_file->m_pathGz)
+      auto pathGz = m_outgoing->m_file->getPathGz();
+      if (m_request->m_acceptsEncoding.find("gzip") != string::npos && pathGz)
       {
         encoding.emplace("gzip");
-        path = *m_outgoing->m_file->m_pathGz;
+        path = *pathGz;
       }
       else
       {
         path = m_outgoing->m_file->m_path;
       }
 
+      // Plain connections can hand the file to the kernel, TLS must encrypt in user space
+      if constexpr (is_same_v<Derived, HttpSession>)
+      {
+        if (sendFile(path, encoding))
+          return;
+      }
+
+      beast::error_code ec;
+      http::file_body::value_type body;
       body.open(path.string().c_str(), beast::file_mode::scan, ec);
 
       // Handle the case where the file doesn't exist
@@ -471,6 +501,98 @@ namespace mtconnect::sink::rest_sink {
     }
   }
 
+  template <class Derived>
+  bool SessionImpl<Derived>::sendFile(const std::filesystem::path &path,
+                                      const optional<string> &encoding)
+  {
+#ifdef __linux__
+    NAMED_SCOPE("SessionImpl::sendFile");
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+      ::close(fd);
+      return false;
+    }
+
+    closeSendFile();
+    m_sendFile = fd;
+    m_sendOffset = 0;
+    m_sendSize = st.st_size;
+
+    auto res = make_shared<http::response<http::empty_body>>(m_outgoing->m_status, 11);
+    res->set(http::field::content_type, m_outgoing->m_mimeType);
+    res->content_length(m_sendSize);
+    if (encoding)
+      res->set(http::field::content_encoding, *encoding);
+    addHeaders(*m_outgoing, res);
+
+    auto sr = make_shared<http::response_serializer<http::empty_body>>(*res);
+    m_response = res;
+    m_serializer = sr;
+
+    http::async_write_header(derived().stream(), *sr,
+                             [self = shared_ptr()](sys::error_code ec, size_t len) {
+                               self->sendFileData(ec);
+                             });
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  template <class Derived>
+  void SessionImpl<Derived>::sendFileData(sys::error_code ec)
+  {
+#ifdef __linux__
+    NAMED_SCOPE("SessionImpl::sendFileData");
+
+    auto &socket = beast::get_lowest_layer(derived().stream()).socket();
+    if (!ec)
+      socket.native_non_blocking(true, ec);
+
+    while (!ec && m_sendOffset < m_sendSize)
+    {
+      off_t offset = m_sendOffset;
+      auto n = ::sendfile(socket.native_handle(), m_sendFile, &offset,
+                          size_t(m_sendSize - m_sendOffset));
+      if (n > 0)
+      {
+        m_sendOffset = offset;
+      }
+      else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      {
+        // Wait for the socket to drain
+        socket.async_wait(tcp::socket::wait_write,
+                          [self = shared_ptr()](sys::error_code ec) { self->sendFileData(ec); });
+        return;
+      }
+      else if (n < 0 && errno == EINTR)
+      {
+        continue;
+      }
+      else if (n < 0)
+      {
+        ec.assign(errno, sys::system_category());
+      }
+      else
+      {
+        // The file was truncated after the content length was sent
+        ec = asio::error::eof;
+      }
+    }
+
+    auto len = m_sendOffset;
+    closeSendFile();
+    m_serializer.reset();
+    sent(ec, size_t(len));
+#endif
+  }
+
   template <class Derived>
   void SessionImpl<Derived>::writeFailureResponse(ResponsePtr &&response, Complete complete)
   {
@@ -599,7 +721,9 @@ namespace mtconnect::sink::rest_sink {
   void SessionImpl<Derived>::upgrade(RequestMessage &&msg)
   {
     LOG(debug) << "Upgrading session to websockets";
-    derived().upgradeToWebsocket(std::move(msg))->run();
+    auto session = derived().upgradeToWebsocket(std::move(msg));
+    session->setWebsocketCompression(m_websocketCompression);
+    session->run();
   }
 
   void TlsDector::run()
@@ -657,6 +781,8 @@ namespace mtconnect::sink::rest_sink {
         session->allowPutsFrom(m_allowPutsFrom);
       else if (m_allowPuts)
         session->allowPuts();
+      session->setWebsocketCompression(m_websocketCompression);
+      session->setWriteLatency(m_writeLatency);
 
       session->run();
     }
@@ -20,12 +20,18 @@
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
 
+#include <filesystem>
 #include <functional>
 #include <memory>
 #include <optional>
 
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
 #include "mtconnect/config.hpp"
 #include "mtconnect/configuration/config_options.hpp"
+#include "mtconnect/metrics/latency.hpp"
 #include "mtconnect/utilities.hpp"
 #include "session.hpp"
 
@@ -53,11 +59,13 @@ namespace mtconnect {
       /// @param error error function
       SessionImpl(boost::beast::flat_buffer &&buffer, const FieldList &list, Dispatch dispatch,
                   ErrorFunction error)
-        : Session(dispatch, error), m_fields(list), m_buffer(std::move(buffer))
+        : Session(dispatch, error),
+          m_fields(list),
+          m_buffer(std::move(buffer))
       {}
       /// @brief Sessions cannot be copied
       SessionImpl(const SessionImpl &) = delete;
-      virtual ~SessionImpl() {}
+      virtual ~SessionImpl() { closeSendFile(); }
 
       /// @brief get a shared pointer to this
       /// @return shared session impl
@@ -91,6 +99,40 @@ namespace mtconnect {
       void read();
       void reset();
       void upgrade(RequestMessage &&msg);
+      /// @brief note the start of a write to measure its latency
+      void writing()
+      {
+        if (m_writeLatency)
+          m_writeStart = metrics::Clock::now();
+      }
+
+      /// @name Zero copy file transfer
+      ///
+      /// Files that are not cached are sent from the file descriptor to the socket with
+      /// `sendfile` on plain TCP connections on Linux.
+      ///@{
+
+      /// @brief send the header and then the contents of the file without copying it through
+      /// user space
+      /// @param path the path of the file
+      /// @param encoding optional content encoding of the file
+      /// @return `false` if the file could not be opened and must be sent another way
+      bool sendFile(const std::filesystem::path &path, const std::optional<std::string> &encoding);
+      /// @brief send as much of the file as the socket will take and wait for it to be writable
+      /// @param ec the error code from the previous write
+      void sendFileData(boost::system::error_code ec);
+      /// @brief close the file being sent
+      void closeSendFile()
+      {
+#ifdef __linux__
+        if (m_sendFile >= 0)
+        {
+          ::close(m_sendFile);
+          m_sendFile = -1;
+        }
+#endif
+      }
+      ///@}
 
     protected:
       using RequestParser = boost::beast::http::request_parser<boost::beast::http::string_body>;
@@ -102,6 +144,15 @@ namespace mtconnect {
       std::string m_boundary;
       std::string m_mimeType;
       bool m_close {false};
+      size_t m_chunkBytes {0};
+
+      // For sendfile
+      int m_sendFile {-1};
+      int64_t m_sendOffset {0};
+      int64_t m_sendSize {0};
+
+      // Write latency
+      metrics::Clock::time_point m_writeStart;
 
       // Additional fields
       FieldList m_fields;
@@ -55,6 +55,16 @@ namespace mtconnect::sink::rest_sink {
 
     ~TlsDector() {}
 
+    /// @brief enable `permessage-deflate` for websocket connections
+    /// @param level the zlib compression level, `std::nullopt` disables compression
+    void setWebsocketCompression(const std::optional<int> &level)
+    {
+      m_websocketCompression = level;
+    }
+    /// @brief measure how long writes to the client take
+    /// @param latency the histogram or `nullptr` if metrics are off
+    void setWriteLatency(metrics::Histogram *latency) { m_writeLatency = latency; }
+
     /// @brief Method to call when TLS operation fails
     /// @param[in] ec the erro code
     /// @param[in] message the message
@@ -87,6 +97,8 @@ namespace mtconnect::sink::rest_sink {
     bool m_tlsOnly;
     bool m_allowPuts;
     std::set<boost::asio::ip::address> m_allowPutsFrom;
+    std::optional<int> m_websocketCompression;
+    metrics::Histogram *m_writeLatency {nullptr};
 
     FieldList m_fields;
     Dispatch m_dispatch;
@@ -25,6 +25,8 @@
 #include <optional>
 #include <rapidjson/document.h>
 #include <rapidjson/error/en.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
 #include <sstream>
 
 #include "session.hpp"
@@ -41,6 +43,7 @@ namespace mtconnect::sink::rest_sink {
       std::optional<boost::asio::streambuf> m_streamBuffer;  //! The streambuffer used in responses
       Complete m_complete;       //! A complete function when the request has finished
       bool m_streaming {false};  //! A flag to indicate the request is a streaming request
+      bool m_binary {false};     //! A flag to send the responses in binary frames
       RequestPtr m_request;      //! A pointer to the underlying incoming request
     };
 
@@ -167,6 +170,24 @@ namespace mtconnect::sink::rest_sink {
 
         for (auto &it : object)
         {
+          // The body member is passed as the request body, such as the documents for a bulk
+          // observations request
+          if (string_view(it.name.GetString()) == "body")
+          {
+            if (it.value.IsString())
+            {
+              request->m_body = it.value.GetString();
+            }
+            else
+            {
+              StringBuffer body;
+              Writer<StringBuffer> writer(body);
+              it.value.Accept(writer);
+              request->m_body = body.GetString();
+            }
+            continue;
+          }
+
           switch (it.value.GetType())
           {
             case rapidjson::kNullType:
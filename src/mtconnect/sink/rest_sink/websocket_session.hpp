@@ -103,6 +103,9 @@ namespace mtconnect::sink::rest_sink {
         return fail(status::bad_request, "Missing request Id", ec);
       }
 
+      if (auto req = m_requestManager.findRequest(*response->m_requestId))
+        req->m_binary = isBinary(response->m_mimeType);
+
       writeChunk(response->m_body, complete, response->m_requestId);
     }
 
@@ -122,6 +125,7 @@ namespace mtconnect::sink::rest_sink {
         if (req != nullptr)
         {
           req->m_streaming = true;
+          req->m_binary = isBinary(mimeType);
 
           if (complete)
           {
@@ -154,6 +158,7 @@ namespace mtconnect::sink::rest_sink {
         LOG(trace) << "Waiting for mutex";
         std::lock_guard<std::mutex> lock(m_mutex);
 
+        Session::chunkQueued(chunk.size());
         if (m_busy || m_messageQueue.size() > 0)
         {
           LOG(debug) << "Queuing Chunk for " << *requestId;
@@ -171,6 +176,14 @@ namespace mtconnect::sink::rest_sink {
       }
     }
 
+    /// @brief check if a document is sent in binary frames
+    /// @param mimeType the mime type of the document
+    /// @return `true` if the mime type is not a text format
+    static bool isBinary(const std::string &mimeType)
+    {
+      return mimeType == "application/octet-stream" || mimeType.ends_with("binary");
+    }
+
   protected:
     void send(const std::string body, Complete complete, const std::string &requestId)
     {
@@ -212,6 +225,7 @@ namespace mtconnect::sink::rest_sink {
         std::lock_guard<std::mutex> lock(m_mutex);
 
         LOG(trace) << "sent chunk for ws: " << id;
+        Session::chunkSent(len);
 
         auto req = m_requestManager.findRequest(id);
         if (req != nullptr)
@@ -295,6 +309,18 @@ namespace mtconnect::sink::rest_sink {
       derived().stream().set_option(
           websocket::stream_base::timeout::suggested(beast::role_type::server));
 
+      // Negotiate per-message compression if the client offers it. The compression context is
+      // kept between messages so repeated element names and keys compress across documents.
+      if (const auto &level = super::getWebsocketCompression())
+      {
+        websocket::permessage_deflate pmd;
+        pmd.server_enable = true;
+        pmd.compLevel = *level;
+        pmd.server_no_context_takeover = false;
+        pmd.client_no_context_takeover = false;
+        derived().stream().set_option(pmd);
+      }
+
       // Set a decorator to change the Server of the handshake
       derived().stream().set_option(
           websocket::stream_base::decorator([](websocket::response_type &res) {
@@ -336,7 +362,10 @@ namespace mtconnect::sink::rest_sink {
       auto ref = derived().shared_ptr();
 
       auto &requestId = request->m_requestId;
-      derived().stream().text(derived().stream().got_text());
+      if (request->m_binary)
+        derived().stream().binary(true);
+      else
+        derived().stream().text(derived().stream().got_text());
       derived().stream().async_write(
           request->m_streamBuffer->data(),
           beast::bind_handler([ref, requestId](beast::error_code ec,
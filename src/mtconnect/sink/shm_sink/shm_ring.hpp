@@ -0,0 +1,616 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+// This header only depends on the C++ standard library and POSIX so consumers can include it
+// without the rest of the agent.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// @brief Shared memory ring of observations for consumers on the same host
+///
+/// The segment is created with `shm_open` and has three regions, all integers are in the byte
+/// order of the host:
+///
+/// ```
+/// offset  size        region
+/// 0       4096        SegmentHeader
+/// 4096    tableSize   data item table
+/// slots   64 * count  record slots, slots = 4096 + tableSize rounded up to 64
+/// ```
+///
+/// The data item table is a sequence of entries of a `u16` length followed by the id bytes. An
+/// observation refers to a data item by its index in the table. Entries are only appended, the
+/// header `dataItemCount` is the number of complete entries.
+///
+/// A record takes one or more consecutive 64 byte slots. The first slot is a `RecordSlot` and
+/// the following slots are `ContinuationSlot`s that carry the rest of the payload. Positions
+/// increase forever, the slot of a position is `position % slotCount`.
+///
+/// ```
+/// RecordSlot        commit:u64 sequence:u64 timestamp:u64 dataItem:u32 kind:u8 flags:u8
+///                   level:u8 slots:u8 length:u32 payload:28 bytes
+/// ContinuationSlot  commit:u64 payload:56 bytes
+/// ```
+///
+/// `commit` is `position + 1` once the slot is written, with `ContinuationBit` set for
+/// continuation slots, and `0` while the writer is changing it. `sequence` is the agent
+/// sequence number and `timestamp` is in microseconds since the Unix epoch. The payload depends
+/// on the `Kind`:
+///
+/// - `UNAVAILABLE`: empty
+/// - `DOUBLE`: one `double`
+/// - `INTEGER`: one `int64_t`
+/// - `STRING`: UTF-8 bytes
+/// - `VECTOR`: `length / 8` `double`s
+/// - `CONDITION`: the native code, a `NUL`, and the message. `level` is the `ConditionLevel`
+/// - `DATA_SET`: the data set or table as `key=value` text in the SHDR format
+///
+/// There is a single writer. Readers never write to the segment, so any number of readers can
+/// follow the ring without locks. A reader checks the `commit` of each slot before and after
+/// copying it, if the writer has reused the slot the reader has been overrun and skips ahead.
+namespace mtconnect::sink::shm_sink {
+  static_assert(std::atomic<uint64_t>::is_always_lock_free);
+  static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+  /// @brief `MTSR` as a little endian `u32`
+  constexpr uint32_t RingMagic = 0x5253544D;
+  /// @brief The version of the segment layout
+  constexpr uint32_t RingVersion = 1;
+  constexpr size_t HeaderSize = 4096;
+  constexpr size_t SlotSize = 64;
+  /// @brief Set in the commit of continuation slots
+  constexpr uint64_t ContinuationBit = uint64_t(1) << 63;
+  /// @brief The data item index for an observation whose id did not fit in the table
+  constexpr uint32_t NoDataItem = UINT32_MAX;
+  /// @brief The most slots a record can use, larger payloads are truncated
+  constexpr size_t MaxRecordSlots = 64;
+
+  /// @brief The encoding of the observation value
+  enum class Kind : uint8_t
+  {
+    UNAVAILABLE = 0,
+    DOUBLE = 1,
+    INTEGER = 2,
+    STRING = 3,
+    VECTOR = 4,
+    CONDITION = 5,
+    DATA_SET = 6
+  };
+
+  /// @brief The level of a `CONDITION` record
+  enum class ConditionLevel : uint8_t
+  {
+    NORMAL = 0,
+    WARNING = 1,
+    FAULT = 2,
+    UNAVAILABLE = 3
+  };
+
+  /// @brief Record flags
+  enum Flags : uint8_t
+  {
+    TRUNCATED = 1  ///< The payload did not fit in `MaxRecordSlots`
+  };
+
+  /// @brief The header at the start of the segment
+  struct SegmentHeader
+  {
+    std::atomic<uint32_t> m_magic;  ///< `RingMagic`, written last when the segment is ready
+    uint32_t m_version;
+    uint32_t m_slotSize;
+    uint32_t m_slotCount;  ///< A power of two
+    uint64_t m_instanceId;
+    uint64_t m_tableOffset;
+    uint64_t m_tableSize;
+    uint64_t m_slotOffset;
+    alignas(64) std::atomic<uint64_t> m_writePosition;  ///< The position of the next record
+    alignas(64) std::atomic<uint32_t> m_dataItemCount;
+    std::atomic<uint32_t> m_tableUsed;  ///< Bytes used in the data item table
+  };
+  static_assert(sizeof(SegmentHeader) <= HeaderSize);
+
+  /// @brief The first slot of a record
+  struct RecordSlot
+  {
+    static constexpr size_t PayloadSize = 28;
+
+    std::atomic<uint64_t> m_commit;
+    uint64_t m_sequence;
+    uint64_t m_timestamp;
+    uint32_t m_dataItem;
+    Kind m_kind;
+    uint8_t m_flags;
+    uint8_t m_level;
+    uint8_t m_slots;
+    uint32_t m_length;
+    char m_payload[PayloadSize];
+  };
+  static_assert(sizeof(RecordSlot) == SlotSize);
+
+  /// @brief The following slots of a record
+  struct ContinuationSlot
+  {
+    static constexpr size_t PayloadSize = 56;
+
+    std::atomic<uint64_t> m_commit;
+    char m_payload[PayloadSize];
+  };
+  static_assert(sizeof(ContinuationSlot) == SlotSize);
+
+  /// @brief The number of slots needed for a payload
+  /// @param length the payload length in bytes
+  /// @return the number of slots
+  inline size_t SlotsFor(size_t length)
+  {
+    if (length <= RecordSlot::PayloadSize)
+      return 1;
+    return 1 + (length - RecordSlot::PayloadSize + ContinuationSlot::PayloadSize - 1) /
+                   ContinuationSlot::PayloadSize;
+  }
+
+  /// @brief A mapping of a shared memory segment
+  class ShmSegment
+  {
+  public:
+    ShmSegment() = default;
+    ShmSegment(const ShmSegment &) = delete;
+    ShmSegment &operator=(const ShmSegment &) = delete;
+    ~ShmSegment()
+    {
+      if (m_address)
+        ::munmap(m_address, m_size);
+    }
+
+    /// @brief map a shared memory object
+    ///
+    /// An existing object is unlinked before a new one is created, so readers of the old
+    /// object keep a valid mapping.
+    /// @param name the name of the object, starts with a `/`
+    /// @param size the size to create, `0` to open an existing object
+    void map(const std::string &name, size_t size)
+    {
+      bool create = size > 0;
+      if (create)
+        ::shm_unlink(name.c_str());
+      int fd = create ? ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644)
+                      : ::shm_open(name.c_str(), O_RDONLY, 0);
+      if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+
+      if (create)
+      {
+        if (::ftruncate(fd, off_t(size)) < 0)
+        {
+          auto error = errno;
+          ::close(fd);
+          ::shm_unlink(name.c_str());
+          throw std::system_error(error, std::generic_category(), "ftruncate " + name);
+        }
+      }
+      else
+      {
+        struct stat st;
+        if (::fstat(fd, &st) < 0 || size_t(st.st_size) < HeaderSize)
+        {
+          ::close(fd);
+          throw std::runtime_error("Shared memory ring " + name + " is not ready");
+        }
+        size = size_t(st.st_size);
+      }
+
+      auto address =
+          ::mmap(nullptr, size, create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+      auto error = errno;
+      ::close(fd);
+      if (address == MAP_FAILED)
+        throw std::system_error(error, std::generic_category(), "mmap " + name);
+
+      m_address = static_cast<char *>(address);
+      m_size = size;
+    }
+
+    char *data() const { return m_address; }
+    size_t size() const { return m_size; }
+
+  protected:
+    char *m_address {nullptr};
+    size_t m_size {0};
+  };
+
+  /// @brief Writes records into a new ring. Only one thread may write at a time.
+  class ShmRingWriter
+  {
+  public:
+    /// @brief Create the segment, replacing an existing one with the same name
+    /// @param name the shared memory name, starts with a `/`
+    /// @param slotCount the number of slots, rounded up to a power of two of at least 256
+    /// @param tableSize the bytes for data item ids
+    /// @param instanceId an id that changes every time the ring is created
+    ShmRingWriter(const std::string &name, size_t slotCount, size_t tableSize,
+                  uint64_t instanceId)
+      : m_name(name)
+    {
+      slotCount = std::max<size_t>(256, slotCount);
+      size_t count = 1;
+      while (count < slotCount)
+        count <<= 1;
+
+      auto slotOffset = (HeaderSize + tableSize + SlotSize - 1) / SlotSize * SlotSize;
+      m_segment.map(name, slotOffset + count * SlotSize);
+
+      m_header = new (m_segment.data()) SegmentHeader();
+      m_header->m_version = RingVersion;
+      m_header->m_slotSize = SlotSize;
+      m_header->m_slotCount = uint32_t(count);
+      m_header->m_instanceId = instanceId;
+      m_header->m_tableOffset = HeaderSize;
+      m_header->m_tableSize = tableSize;
+      m_header->m_slotOffset = slotOffset;
+      m_header->m_writePosition.store(0, std::memory_order_relaxed);
+      m_header->m_dataItemCount.store(0, std::memory_order_relaxed);
+      m_header->m_tableUsed.store(0, std::memory_order_relaxed);
+
+      m_table = m_segment.data() + HeaderSize;
+      m_slots = m_segment.data() + slotOffset;
+      m_mask = count - 1;
+      m_maxSlots = std::min(MaxRecordSlots, count / 4);
+
+      // The zero filled slots have a commit of 0, so they are not valid for any position
+      m_header->m_magic.store(RingMagic, std::memory_order_release);
+    }
+    ShmRingWriter(const ShmRingWriter &) = delete;
+    ShmRingWriter &operator=(const ShmRingWriter &) = delete;
+
+    /// @brief Unlinks the segment, readers keep their mapping
+    ~ShmRingWriter() { ::shm_unlink(m_name.c_str()); }
+
+    /// @brief append a data item id to the table
+    /// @param id the data item id
+    /// @return the index or `NoDataItem` if the table is full
+    uint32_t addDataItem(std::string_view id)
+    {
+      auto used = m_header->m_tableUsed.load(std::memory_order_relaxed);
+      auto length = std::min<size_t>(id.size(), UINT16_MAX);
+      if (used + 2 + length > m_header->m_tableSize)
+        return NoDataItem;
+
+      uint16_t len = uint16_t(length);
+      std::memcpy(m_table + used, &len, 2);
+      std::memcpy(m_table + used + 2, id.data(), length);
+      m_header->m_tableUsed.store(uint32_t(used + 2 + length), std::memory_order_relaxed);
+
+      auto index = m_header->m_dataItemCount.load(std::memory_order_relaxed);
+      m_header->m_dataItemCount.store(index + 1, std::memory_order_release);
+      return index;
+    }
+
+    /// @brief write a record
+    /// @param sequence the agent sequence number
+    /// @param timestamp microseconds since the Unix epoch
+    /// @param dataItem the data item index
+    /// @param kind the value encoding
+    /// @param level the condition level
+    /// @param payload the value bytes
+    /// @param length the number of bytes
+    void write(uint64_t sequence, uint64_t timestamp, uint32_t dataItem, Kind kind,
+               uint8_t level, const void *payload, size_t length)
+    {
+      uint8_t flags = 0;
+      auto slots = SlotsFor(length);
+      if (slots > m_maxSlots)
+      {
+        slots = m_maxSlots;
+        length = RecordSlot::PayloadSize + (slots - 1) * ContinuationSlot::PayloadSize;
+        flags |= TRUNCATED;
+      }
+
+      auto position = m_position;
+      auto bytes = static_cast<const char *>(payload);
+
+      // Invalidate every slot before it is changed so readers of the old records notice
+      for (size_t i = 0; i < slots; i++)
+        slot<RecordSlot>(position + i)->m_commit.store(0, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+
+      auto record = slot<RecordSlot>(position);
+      record->m_sequence = sequence;
+      record->m_timestamp = timestamp;
+      record->m_dataItem = dataItem;
+      record->m_kind = kind;
+      record->m_flags = flags;
+      record->m_level = level;
+      record->m_slots = uint8_t(slots);
+      record->m_length = uint32_t(length);
+
+      auto first = std::min(length, RecordSlot::PayloadSize);
+      if (first > 0)
+        std::memcpy(record->m_payload, bytes, first);
+      size_t offset = first;
+      for (size_t i = 1; i < slots; i++)
+      {
+        auto cont = slot<ContinuationSlot>(position + i);
+        auto size = std::min(length - offset, ContinuationSlot::PayloadSize);
+        std::memcpy(cont->m_payload, bytes + offset, size);
+        offset += size;
+        cont->m_commit.store((position + i + 1) | ContinuationBit, std::memory_order_release);
+      }
+
+      record->m_commit.store(position + 1, std::memory_order_release);
+      m_position = position + slots;
+      m_header->m_writePosition.store(m_position, std::memory_order_release);
+    }
+
+    /// @brief get the position of the next record
+    uint64_t getPosition() const { return m_position; }
+    /// @brief get the number of slots in the ring
+    size_t getSlotCount() const { return m_mask + 1; }
+
+  protected:
+    template <typename T>
+    T *slot(uint64_t position) const
+    {
+      return reinterpret_cast<T *>(m_slots + (position & m_mask) * SlotSize);
+    }
+
+  protected:
+    std::string m_name;
+    ShmSegment m_segment;
+    SegmentHeader *m_header {nullptr};
+    char *m_table {nullptr};
+    char *m_slots {nullptr};
+    uint64_t m_mask {0};
+    size_t m_maxSlots {1};
+    uint64_t m_position {0};
+  };
+
+  /// @brief A record copied out of the ring
+  struct Record
+  {
+    uint64_t m_sequence {0};
+    uint64_t m_timestamp {0};  ///< Microseconds since the Unix epoch
+    uint32_t m_dataItem {NoDataItem};
+    Kind m_kind {Kind::UNAVAILABLE};
+    uint8_t m_flags {0};
+    uint8_t m_level {0};
+    std::vector<char> m_payload;
+
+    double asDouble() const { return read<double>(); }
+    int64_t asInteger() const { return read<int64_t>(); }
+    std::string_view asString() const { return {m_payload.data(), m_payload.size()}; }
+    std::vector<double> asVector() const
+    {
+      std::vector<double> values(m_payload.size() / sizeof(double));
+      std::memcpy(values.data(), m_payload.data(), values.size() * sizeof(double));
+      return values;
+    }
+    /// @brief the native code of a `CONDITION`
+    std::string_view nativeCode() const { return asString().substr(0, split()); }
+    /// @brief the message of a `CONDITION`
+    std::string_view message() const
+    {
+      auto pos = split();
+      return pos < m_payload.size() ? asString().substr(pos + 1) : std::string_view();
+    }
+
+  protected:
+    template <typename T>
+    T read() const
+    {
+      T value {};
+      if (m_payload.size() >= sizeof(T))
+        std::memcpy(&value, m_payload.data(), sizeof(T));
+      return value;
+    }
+    size_t split() const
+    {
+      auto pos = asString().find('\0');
+      return pos == std::string_view::npos ? m_payload.size() : pos;
+    }
+  };
+
+  /// @brief Follows a ring without locks
+  class ShmRingReader
+  {
+  public:
+    /// @brief The result of a read
+    enum class Status
+    {
+      RECORD,  ///< A record was read
+      EMPTY,   ///< No new records
+      OVERRUN  ///< The writer overwrote records before they were read
+    };
+
+    /// @brief Open an existing ring
+    /// @param name the shared memory name, starts with a `/`
+    /// @param fromOldest start at the oldest record in the ring instead of the next new one
+    ShmRingReader(const std::string &name, bool fromOldest = false)
+    {
+      m_segment.map(name, 0);
+      m_header = reinterpret_cast<const SegmentHeader *>(m_segment.data());
+      if (m_header->m_magic.load(std::memory_order_acquire) != RingMagic ||
+          m_header->m_version != RingVersion || m_header->m_slotSize != SlotSize ||
+          m_header->m_slotOffset + uint64_t(m_header->m_slotCount) * SlotSize >
+              m_segment.size())
+        throw std::runtime_error("Shared memory " + name + " is not an observation ring");
+
+      m_table = m_segment.data() + m_header->m_tableOffset;
+      m_slots = m_segment.data() + m_header->m_slotOffset;
+      m_mask = m_header->m_slotCount - 1;
+
+      m_position = m_header->m_writePosition.load(std::memory_order_acquire);
+      if (fromOldest)
+      {
+        m_position = m_position > m_mask ? m_position - m_mask - 1 : 0;
+        resync(m_position);
+      }
+    }
+
+    /// @brief read the next record
+    /// @param[out] record the record
+    /// @return `RECORD` if the record was read
+    Status read(Record &record)
+    {
+      auto head = slot<RecordSlot>(m_position);
+      auto commit = head->m_commit.load(std::memory_order_acquire);
+      if (commit != m_position + 1)
+      {
+        if (m_header->m_writePosition.load(std::memory_order_acquire) <= m_position)
+          return Status::EMPTY;
+
+        // The record may have been committed after the first load
+        commit = head->m_commit.load(std::memory_order_acquire);
+        if (commit != m_position + 1)
+          return overrun();
+      }
+
+      record.m_sequence = head->m_sequence;
+      record.m_timestamp = head->m_timestamp;
+      record.m_dataItem = head->m_dataItem;
+      record.m_kind = head->m_kind;
+      record.m_flags = head->m_flags;
+      record.m_level = head->m_level;
+      size_t slots = head->m_slots;
+      size_t length = head->m_length;
+      if (slots == 0 || slots > std::min<size_t>(MaxRecordSlots, (m_mask + 1) / 4) ||
+          length > RecordSlot::PayloadSize + (slots - 1) * ContinuationSlot::PayloadSize)
+        return overrun();
+
+      record.m_payload.resize(length);
+      auto first = std::min(length, RecordSlot::PayloadSize);
+      std::memcpy(record.m_payload.data(), head->m_payload, first);
+      size_t offset = first;
+      for (size_t i = 1; i < slots; i++)
+      {
+        auto cont = slot<ContinuationSlot>(m_position + i);
+        auto size = std::min(length - offset, ContinuationSlot::PayloadSize);
+        std::memcpy(record.m_payload.data() + offset, cont->m_payload, size);
+        offset += size;
+      }
+
+      // The record is valid if none of its slots changed while it was copied
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (head->m_commit.load(std::memory_order_relaxed) != commit)
+        return overrun();
+      for (size_t i = 1; i < slots; i++)
+      {
+        auto cont = slot<ContinuationSlot>(m_position + i);
+        if (cont->m_commit.load(std::memory_order_relaxed) !=
+            ((m_position + i + 1) | ContinuationBit))
+          return overrun();
+      }
+
+      m_position += slots;
+      return Status::RECORD;
+    }
+
+    /// @brief get the id of a data item
+    /// @param index the index from a record
+    /// @return the id or an empty string if it is not known
+    const std::string &dataItemId(uint32_t index)
+    {
+      static const std::string empty;
+      if (index >= m_ids.size())
+        loadTable();
+      return index < m_ids.size() ? m_ids[index] : empty;
+    }
+
+    /// @brief get the number of times the reader was overrun
+    uint64_t getOverruns() const { return m_overruns; }
+    /// @brief get the number of slots skipped because of overruns
+    uint64_t getSkipped() const { return m_skipped; }
+    /// @brief get the instance id of the ring
+    uint64_t getInstanceId() const { return m_header->m_instanceId; }
+    /// @brief get the number of positions the reader is behind the writer
+    uint64_t getLag() const
+    {
+      return m_header->m_writePosition.load(std::memory_order_acquire) - m_position;
+    }
+
+  protected:
+    template <typename T>
+    const T *slot(uint64_t position) const
+    {
+      return reinterpret_cast<const T *>(m_slots + (position & m_mask) * SlotSize);
+    }
+
+    Status overrun()
+    {
+      m_overruns++;
+      // Leave a quarter of the ring so the writer does not lap the reader again right away
+      auto write = m_header->m_writePosition.load(std::memory_order_acquire);
+      auto keep = (m_mask + 1) * 3 / 4;
+      resync(std::max(m_position, write > keep ? write - keep : 0));
+      return Status::OVERRUN;
+    }
+
+    /// @brief move to the first record at or after a position
+    void resync(uint64_t position)
+    {
+      auto write = m_header->m_writePosition.load(std::memory_order_acquire);
+      for (; position < write; position++)
+      {
+        if (slot<RecordSlot>(position)->m_commit.load(std::memory_order_acquire) ==
+            position + 1)
+          break;
+      }
+      m_skipped += position - m_position;
+      m_position = position;
+    }
+
+    void loadTable()
+    {
+      auto count = m_header->m_dataItemCount.load(std::memory_order_acquire);
+      size_t offset = 0;
+      for (size_t i = 0; i < m_ids.size(); i++)
+        offset += 2 + m_ids[i].size();
+      while (m_ids.size() < count)
+      {
+        uint16_t len;
+        std::memcpy(&len, m_table + offset, 2);
+        m_ids.emplace_back(m_table + offset + 2, len);
+        offset += 2 + len;
+      }
+    }
+
+  protected:
+    ShmSegment m_segment;
+    const SegmentHeader *m_header {nullptr};
+    const char *m_table {nullptr};
+    const char *m_slots {nullptr};
+    uint64_t m_mask {0};
+    uint64_t m_position {0};
+    uint64_t m_overruns {0};
+    uint64_t m_skipped {0};
+    std::vector<std::string> m_ids;
+  };
+}  // namespace mtconnect::sink::shm_sink
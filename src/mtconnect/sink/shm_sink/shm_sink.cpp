@@ -0,0 +1,196 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#include "shm_sink.hpp"
+
+#include <chrono>
+
+#include "mtconnect/configuration/config_options.hpp"
+#include "mtconnect/logging.hpp"
+#include "shm_ring.hpp"
+
+using namespace std;
+using ptree = boost::property_tree::ptree;
+
+namespace mtconnect::sink::shm_sink {
+  using namespace observation;
+  namespace config = ::mtconnect::configuration;
+
+  ShmSink::ShmSink(boost::asio::io_context &context, sink::SinkContractPtr &&contract,
+                   const ConfigOptions &options, const ptree &block)
+    : Sink("ShmSink", std::move(contract)), m_options(options)
+  {
+    GetOptions(block, m_options, options);
+    AddDefaultedOptions(block, m_options,
+                        {{config::ShmName, "/mtconnect_observations"s},
+                         {config::ShmSlotCount, 65536},
+                         {config::ShmTableSize, 262144}});
+
+    m_shmName = *GetOption<string>(m_options, config::ShmName);
+    if (m_shmName.empty() || m_shmName[0] != '/')
+      m_shmName.insert(0, "/");
+  }
+
+  ShmSink::~ShmSink() = default;
+
+  void ShmSink::start()
+  {
+    NAMED_SCOPE("ShmSink::start");
+
+    lock_guard<mutex> lock(m_mutex);
+    try
+    {
+      auto instanceId = uint64_t(chrono::duration_cast<chrono::microseconds>(
+                                     chrono::system_clock::now().time_since_epoch())
+                                     .count());
+      m_writer = make_unique<ShmRingWriter>(
+          m_shmName, size_t(*GetOption<int>(m_options, config::ShmSlotCount)),
+          size_t(*GetOption<int>(m_options, config::ShmTableSize)), instanceId);
+      m_indexes.clear();
+    }
+    catch (std::exception &e)
+    {
+      LOG(error) << "Cannot create shared memory ring " << m_shmName << ": " << e.what();
+      return;
+    }
+
+    // Give the data items of the devices the lowest indexes in model order
+    for (auto &device : m_sinkContract->getDevices())
+    {
+      for (auto &weak : device->getDeviceDataItems())
+      {
+        if (auto di = weak.lock())
+          dataItemIndex(di->getId());
+      }
+    }
+
+    LOG(info) << "Publishing observations to shared memory ring " << m_shmName << " with "
+              << m_writer->getSlotCount() << " slots";
+  }
+
+  void ShmSink::stop()
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_writer.reset();
+  }
+
+  uint32_t ShmSink::dataItemIndex(const std::string &id)
+  {
+    auto it = m_indexes.find(id);
+    if (it != m_indexes.end())
+      return it->second;
+
+    auto index = m_writer->addDataItem(id);
+    if (index == NoDataItem)
+      LOG(warning) << "ShmSink: data item table is full, " << id << " has no index";
+    m_indexes.emplace(id, index);
+    return index;
+  }
+
+  bool ShmSink::publish(device_model::DevicePtr device)
+  {
+    lock_guard<mutex> lock(m_mutex);
+    if (!m_writer)
+      return false;
+
+    for (auto &weak : device->getDeviceDataItems())
+    {
+      if (auto di = weak.lock())
+        dataItemIndex(di->getId());
+    }
+    return true;
+  }
+
+  bool ShmSink::publish(observation::ObservationPtr &observation)
+  {
+    auto dataItem = observation->getDataItem();
+    if (!dataItem || observation->isOrphan())
+      return false;
+
+    lock_guard<mutex> lock(m_mutex);
+    if (!m_writer)
+      return false;
+
+    auto index = dataItemIndex(dataItem->getId());
+    auto timestamp = uint64_t(
+        chrono::duration_cast<chrono::microseconds>(observation->getTimestamp().time_since_epoch())
+            .count());
+    auto sequence = observation->getSequence();
+
+    auto write = [&](Kind kind, const void *data, size_t length, uint8_t level = 0) {
+      m_writer->write(sequence, timestamp, index, kind, level, data, length);
+    };
+
+    if (auto cond = dynamic_pointer_cast<Condition>(observation))
+    {
+      auto level = cond->getLevel();
+      if (level == Condition::UNAVAILABLE)
+      {
+        write(Kind::UNAVAILABLE, nullptr, 0);
+      }
+      else
+      {
+        m_buffer = cond->getCode();
+        m_buffer.push_back('\0');
+        if (auto message = get_if<string>(&cond->getValue()))
+          m_buffer.append(*message);
+        write(Kind::CONDITION, m_buffer.data(), m_buffer.size(), uint8_t(level));
+      }
+      return true;
+    }
+
+    if (observation->isUnavailable())
+    {
+      write(Kind::UNAVAILABLE, nullptr, 0);
+      return true;
+    }
+
+    const auto &value = observation->getValue();
+    visit(overloaded {[&](const string &s) { write(Kind::STRING, s.data(), s.size()); },
+                      [&](int64_t v) { write(Kind::INTEGER, &v, sizeof(v)); },
+                      [&](double v) { write(Kind::DOUBLE, &v, sizeof(v)); },
+                      [&](bool v) {
+                        int64_t i = v ? 1 : 0;
+                        write(Kind::INTEGER, &i, sizeof(i));
+                      },
+                      [&](const entity::Vector &v) {
+                        write(Kind::VECTOR, v.data(), v.size() * sizeof(double));
+                      },
+                      [&](const entity::DataSet &set) {
+                        m_buffer = set.format();
+                        write(Kind::DATA_SET, m_buffer.data(), m_buffer.size());
+                      },
+                      [&](const Timestamp &ts) {
+                        m_buffer = format(ts);
+                        write(Kind::STRING, m_buffer.data(), m_buffer.size());
+                      },
+                      [&](const auto &) { write(Kind::STRING, nullptr, 0); }},
+          value);
+
+    return true;
+  }
+
+  void ShmSink::registerFactory(SinkFactory &factory)
+  {
+    factory.registerFactory(
+        "ShmSink",
+        [](const std::string &name, boost::asio::io_context &io, SinkContractPtr &&contract,
+           const ConfigOptions &options, const boost::property_tree::ptree &block) -> SinkPtr {
+          return std::make_shared<ShmSink>(io, std::move(contract), options, block);
+        });
+  }
+}  // namespace mtconnect::sink::shm_sink
@@ -0,0 +1,88 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include "boost/asio/io_context.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "mtconnect/config.hpp"
+#include "mtconnect/observation/observation.hpp"
+#include "mtconnect/sink/sink.hpp"
+#include "mtconnect/utilities.hpp"
+
+namespace mtconnect::sink::shm_sink {
+  class ShmRingWriter;
+
+  /// @brief Publishes every observation into a shared memory ring
+  ///
+  /// Consumers on the same host read the ring with `ShmRingReader` from `shm_ring.hpp` without
+  /// going through the network or a printer. The record layout is described in `shm_ring.hpp`.
+  class AGENT_LIB_API ShmSink : public sink::Sink
+  {
+  public:
+    /// @brief Create a shared memory sink
+    /// @param context the boost asio io_context
+    /// @param contract the Sink Contract from the agent
+    /// @param options configuration options
+    /// @param config additional configuration options
+    ShmSink(boost::asio::io_context &context, sink::SinkContractPtr &&contract,
+            const ConfigOptions &options, const boost::property_tree::ptree &config);
+    ~ShmSink() override;
+
+    /// @brief Create the ring and add the data items of all the devices
+    void start() override;
+    /// @brief Remove the ring, readers keep their mapping until they close it
+    void stop() override;
+
+    /// @brief Write an observation to the ring
+    /// @param observation shared pointer to the observation
+    /// @return `true` if the observation was written
+    bool publish(observation::ObservationPtr &observation) override;
+    /// @brief Assets are not published
+    /// @return `false`
+    bool publish(asset::AssetPtr asset) override { return false; }
+    /// @brief Add the data items of a new or changed device to the table
+    /// @param device shared pointer to the device
+    /// @return `true` if the ring is open
+    bool publish(device_model::DevicePtr device) override;
+
+    /// @brief Register the Sink factory to create this sink
+    /// @param factory
+    static void registerFactory(SinkFactory &factory);
+
+    /// @brief get the ring writer
+    /// @return the writer or `nullptr` if the sink is not started
+    ShmRingWriter *getWriter() { return m_writer.get(); }
+
+  protected:
+    uint32_t dataItemIndex(const std::string &id);
+
+  protected:
+    ConfigOptions m_options;
+    std::string m_shmName;
+
+    std::mutex m_mutex;
+    std::unique_ptr<ShmRingWriter> m_writer;
+    std::unordered_map<std::string, uint32_t> m_indexes;
+    std::string m_buffer;
+  };
+}  // namespace mtconnect::sink::shm_sink
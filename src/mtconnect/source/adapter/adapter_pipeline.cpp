@@ -17,9 +17,12 @@
 
 #include "mtconnect/source/adapter/adapter_pipeline.hpp"
 
+#include <set>
+
 #include "mtconnect/agent.hpp"
 #include "mtconnect/configuration/agent_config.hpp"
 #include "mtconnect/configuration/config_options.hpp"
+#include "mtconnect/metrics/latency.hpp"
 #include "mtconnect/pipeline/convert_sample.hpp"
 #include "mtconnect/pipeline/correct_timestamp.hpp"
 #include "mtconnect/pipeline/deliver.hpp"
@@ -89,6 +92,52 @@ namespace mtconnect {
       m_identity = GetOption<string>(m_options, configuration::AdapterIdentity).value_or("unknown");
     }
 
+    void AdapterPipeline::start()
+    {
+      if (metrics::Registry::global().isEnabled())
+        instrumentStages();
+
+      Pipeline::start();
+    }
+
+    void AdapterPipeline::instrumentStages()
+    {
+      static const map<string, string> stages {{"ShdrTokenizer", "tokenize"},
+                                               {"ShdrTokenMapper", "map"},
+                                               {"JsonMapper", "map"},
+                                               {"DataMapper", "map"},
+                                               {"TopicMapper", "map"},
+                                               {"MTConnectXmlTransform", "map"},
+                                               {"DuplicateFilter", "filter"},
+                                               {"DeltaFilter", "filter"},
+                                               {"PeriodFilter", "filter"},
+                                               {"DeliverObservation", "deliver"},
+                                               {"DeliverAsset", "deliver"}};
+
+      auto identity = m_identity;
+      if (identity.empty())
+        identity = GetOption<string>(m_options, configuration::AdapterIdentity).value_or("unknown");
+
+      // Transforms can be reached through more than one path when pipelines merge
+      set<Transform *> visited;
+      std::function<void(TransformPtr)> instrument = [&](TransformPtr xform) {
+        if (!visited.insert(xform.get()).second)
+          return;
+
+        if (auto stage = stages.find(xform->getName()); stage != stages.end())
+        {
+          xform->setLatency(metrics::Registry::global().histogram(
+              "mtconnect_pipeline_stage_seconds", "Time spent in each adapter pipeline stage",
+              {{"adapter", identity}, {"stage", stage->second}},
+              identity + "_" + stage->second + "_latency"));
+        }
+
+        for (auto &next : xform->getNext())
+          instrument(next);
+      };
+      instrument(m_start);
+    }
+
     void AdapterPipeline::buildDeviceList()
     {
       m_devices =
@@ -62,6 +62,9 @@ namespace mtconnect::source::adapter {
     /// @brief build the pipeline
     /// @param options the configuration options
     void build(const ConfigOptions &options) override;
+    /// @brief start the pipeline and measure the time of each stage if latency metrics are
+    /// enabled
+    void start() override;
     /// @brief Create a handler
     /// @return the handler handing over ownership
     virtual std::unique_ptr<Handler> makeHandler();
@@ -80,6 +83,8 @@ namespace mtconnect::source::adapter {
     void buildDeviceDelivery(pipeline::TransformPtr next);
     void buildAssetDelivery(pipeline::TransformPtr next);
     void buildObservationDelivery(pipeline::TransformPtr next);
+    /// @brief attach the stage histograms to the tokenize, map, filter and deliver transforms
+    void instrumentStages();
 
   protected:
     StringList m_devices;
@@ -35,6 +35,7 @@
 #include "mtconnect/pipeline/period_filter.hpp"
 #include "mtconnect/pipeline/shdr_token_mapper.hpp"
 #include "mtconnect/pipeline/shdr_tokenizer.hpp"
+#include "mtconnect/pipeline/sparkplug_mapper.hpp"
 #include "mtconnect/pipeline/timestamp_extractor.hpp"
 #include "mtconnect/pipeline/topic_mapper.hpp"
 #include "mtconnect/pipeline/upcase_value.hpp"
@@ -257,6 +258,10 @@ namespace mtconnect {
       buildDeviceList();
       buildCommandAndStatusDelivery();
 
+      // Sparkplug B payloads are decoded before the topic mapper sees them
+      auto sparkplug = bind(make_shared<SparkplugMapper>(m_context, m_device));
+      sparkplug->bind(make_shared<NullTransform>(TypeGuard<Observations>(RUN)));
+
       // Build topic mapper pipeline
       auto next = bind(make_shared<TopicMapper>(
           m_context, GetOption<string>(m_options, configuration::Device).value_or("")));
@@ -284,6 +289,7 @@ namespace mtconnect {
           make_shared<MergeTransform>(TypeGuard<Observation>(RUN) || TypeGuard<asset::Asset>(RUN));
 
       mapper->bind(merge);
+      sparkplug->bind(merge);
       map1->bind(merge);
       map2->bind(merge);
 
@@ -30,6 +30,7 @@
 #include <utility>
 
 #include "mtconnect/logging.hpp"
+#include "mtconnect/observation/change_observer.hpp"
 
 using namespace std;
 using namespace std::chrono;
@@ -71,6 +72,8 @@ namespace mtconnect::source::adapter::shdr {
       m_socket.cancel();
       m_socket.close();
     }
+
+    // The registered receive buffer returns to the pool when the cancelled read completes
   }
 
   bool Connector::start() { return resolve(); }
@@ -212,6 +215,11 @@ namespace mtconnect::source::adapter::shdr {
       m_socket.set_option(asio::socket_base::keep_alive(true));
       m_localPort = m_socket.local_endpoint().port();
 
+#if defined(BOOST_ASIO_HAS_IO_URING)
+      if (!m_receiveBuffer)
+        m_receiveBuffer = asio::use_service<ReceiveBuffers>(m_strand.context()).acquire();
+#endif
+
       connected();
       m_connected = true;
       sendCommand("PING");
@@ -243,8 +251,12 @@ namespace mtconnect::source::adapter::shdr {
 
       m_timer.cancel();
 
-      while (parseSocketBuffer())
-        ;
+      {
+        // Observers are signaled once for all the lines in the read
+        observation::ChangeNotifier::Batch batch;
+        while (parseSocketBuffer())
+          ;
+      }
 
       m_timer.expires_after(m_receiveTimeLimit);
       m_timer.async_wait([this](boost::system::error_code ec) {
@@ -255,10 +267,38 @@ namespace mtconnect::source::adapter::shdr {
         }
       });
 
-      asio::async_read_until(m_socket, m_incoming, '\n', [this](sys::error_code ec, size_t len) {
-        asio::dispatch(m_strand, boost::bind(&Connector::reader, this, ec, len));
+      asyncRead();
+    }
+  }
+
+  void Connector::asyncRead()
+  {
+#if defined(BOOST_ASIO_HAS_IO_URING)
+    if (m_receiveBuffer)
+    {
+      // Read into the registered buffer and append to the incoming data on the strand. The
+      // read holds the lease, the kernel owns the buffer until the read completes even if the
+      // connector is destroyed. A cancelled read must not touch the connector.
+      auto lease = m_receiveBuffer;
+      m_socket.async_read_some(lease->buffer(), [this, lease](sys::error_code ec, size_t len) {
+        if (ec == asio::error::operation_aborted)
+          return;
+        asio::dispatch(m_strand, [this, lease, ec, len]() mutable {
+          if (!ec && m_incoming.size() + len > m_incoming.max_size())
+            ec = asio::error::not_found;
+          else if (!ec)
+            m_incoming.commit(
+                asio::buffer_copy(m_incoming.prepare(len), lease->buffer().buffer(), len));
+          reader(ec, len);
+        });
       });
+      return;
     }
+#endif
+
+    asio::async_read_until(m_socket, m_incoming, '\n', [this](sys::error_code ec, size_t len) {
+      asio::dispatch(m_strand, boost::bind(&Connector::reader, this, ec, len));
+    });
   }
 
   void Connector::writer(sys::error_code ec, size_t length)
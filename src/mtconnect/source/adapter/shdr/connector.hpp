@@ -26,6 +26,7 @@
 
 #include "mtconnect/config.hpp"
 #include "mtconnect/utilities.hpp"
+#include "receive_buffers.hpp"
 
 inline constexpr int HEARTBEAT_FREQ = 60000;
 
@@ -109,6 +110,7 @@ namespace mtconnect::source::adapter::shdr {
     void writer(boost::system::error_code ec, std::size_t length);
     void reader(boost::system::error_code ec, std::size_t length);
     bool parseSocketBuffer();
+    void asyncRead();
     void processLine(const std::string &line);
     void startHeartbeats(const std::string &buf);
     void heartbeat(boost::system::error_code ec);
@@ -135,6 +137,11 @@ namespace mtconnect::source::adapter::shdr {
     boost::asio::streambuf m_incoming;
     boost::asio::streambuf m_outgoing;
 
+#if defined(BOOST_ASIO_HAS_IO_URING)
+    // Registered receive buffer when using io_uring, shared with the outstanding read
+    ReceiveBuffers::LeasePtr m_receiveBuffer;
+#endif
+
     // Some timeers
     boost::asio::steady_timer m_timer;
     boost::asio::steady_timer m_heartbeatTimer;
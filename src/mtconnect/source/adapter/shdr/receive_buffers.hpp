@@ -0,0 +1,146 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+#pragma once
+
+#include <boost/asio.hpp>
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "mtconnect/config.hpp"
+#include "mtconnect/logging.hpp"
+
+#if defined(BOOST_ASIO_HAS_IO_URING)
+
+namespace mtconnect::source::adapter::shdr {
+  /// @brief Receive buffers registered with the io_uring of an io context
+  ///
+  /// A ring can only have one set of registered buffers, so the buffers are an asio service
+  /// shared by the connectors of the context. Reads into a registered buffer are submitted as
+  /// fixed buffer reads, so the kernel does not have to map the buffer for every read. The
+  /// buffers are registered when the first one is acquired. If the registration fails or all
+  /// the buffers are in use, connectors read into their own buffers.
+  class AGENT_LIB_API ReceiveBuffers : public boost::asio::execution_context::service
+  {
+  public:
+    using key_type = ReceiveBuffers;
+    static inline boost::asio::execution_context::id id;
+
+    /// @brief The size of each buffer
+    static constexpr std::size_t BufferSize = 8 * 1024;
+    /// @brief The number of buffers registered, 4MiB must fit in the locked memory limit
+    static constexpr std::size_t BufferCount = 512;
+
+    /// @brief Construct the service for an io context
+    /// @param context the io context
+    ReceiveBuffers(boost::asio::execution_context &context)
+      : boost::asio::execution_context::service(context)
+    {}
+
+    /// @brief A registered buffer that returns to the pool with its last reference
+    ///
+    /// A read holds a reference until it completes. The kernel can write to the buffer until
+    /// a cancelled read completes, so the buffer must not be reused before then.
+    class Lease
+    {
+    public:
+      Lease(ReceiveBuffers &buffers, std::size_t index) : m_buffers(buffers), m_index(index) {}
+      ~Lease() { m_buffers.release(m_index); }
+
+      /// @brief Get the registered buffer
+      /// @return the registered buffer
+      boost::asio::mutable_registered_buffer buffer() const
+      {
+        return *std::next(m_buffers.m_registration->begin(), m_index);
+      }
+
+    protected:
+      ReceiveBuffers &m_buffers;
+      std::size_t m_index;
+    };
+    using LeasePtr = std::shared_ptr<Lease>;
+
+    /// @brief Get a registered buffer
+    /// @return the buffer if one is available
+    LeasePtr acquire()
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!m_attempted)
+        registerBuffers();
+      if (m_free.empty())
+        return nullptr;
+
+      auto index = m_free.back();
+      m_free.pop_back();
+      return std::make_shared<Lease>(*this, index);
+    }
+
+    /// @brief get the number of buffers that can be acquired
+    std::size_t available()
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      return m_free.size();
+    }
+
+  protected:
+    void release(std::size_t index)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_free.push_back(index);
+    }
+
+    // Outstanding reads are completed or destroyed when the io_uring service shuts down, which
+    // happens after this service, so the registration is kept until the service is destroyed
+    void shutdown() override {}
+
+    void registerBuffers()
+    {
+      m_attempted = true;
+      m_storage = std::make_unique<char[]>(BufferSize * BufferCount);
+
+      std::vector<boost::asio::mutable_buffer> buffers;
+      for (std::size_t i = 0; i < BufferCount; i++)
+        buffers.emplace_back(m_storage.get() + i * BufferSize, BufferSize);
+
+      try
+      {
+        m_registration.emplace(boost::asio::register_buffers(context(), buffers));
+        for (std::size_t i = BufferCount; i > 0; i--)
+          m_free.push_back(i - 1);
+        LOG(info) << "Registered " << BufferCount << " receive buffers with io_uring";
+      }
+      catch (boost::system::system_error &e)
+      {
+        LOG(warning) << "Cannot register receive buffers with io_uring: " << e.what();
+        m_storage.reset();
+      }
+    }
+
+  protected:
+    std::mutex m_mutex;
+    bool m_attempted {false};
+    std::unique_ptr<char[]> m_storage;
+    std::optional<boost::asio::buffer_registration<std::vector<boost::asio::mutable_buffer>>>
+        m_registration;
+    std::vector<std::size_t> m_free;
+  };
+}  // namespace mtconnect::source::adapter::shdr
+
+#endif
@@ -25,6 +25,7 @@
 #include "mtconnect/pipeline/deliver.hpp"
 #include "mtconnect/pipeline/delta_filter.hpp"
 #include "mtconnect/pipeline/duplicate_filter.hpp"
+#include "mtconnect/pipeline/json_mapper.hpp"
 #include "mtconnect/pipeline/period_filter.hpp"
 #include "mtconnect/pipeline/timestamp_extractor.hpp"
 #include "mtconnect/pipeline/upcase_value.hpp"
@@ -43,11 +44,19 @@ namespace mtconnect::source {
     clear();
     TransformPtr next = m_start;
 
-    next->bind(make_shared<DeliverAsset>(m_context));
+    auto asset = next->bind(make_shared<DeliverAsset>(m_context));
     next->bind(make_shared<DeliverAssetCommand>(m_context));
     next->bind(make_shared<DeliverDevice>(m_context));
     next->bind(make_shared<DeliverDevices>(m_context));
 
+    // Map bulk json documents and merge their observations with the loopback observations
+    auto json = next->bind(make_shared<JsonMapper>(m_context));
+    json->bind(asset);
+    auto merge = make_shared<MergeTransform>(TypeGuard<Observation>(RUN));
+    next->bind(merge);
+    json->bind(merge);
+    next = merge;
+
     if (IsOptionSet(m_options, configuration::UpcaseDataItemValue))
       next = next->bind(make_shared<UpcaseValue>());
 
@@ -120,6 +129,14 @@ namespace mtconnect::source {
 
   void LoopbackSource::receive(DevicePtr device) { m_pipeline.run(device); }
 
+  entity::EntityPtr LoopbackSource::receiveJson(const std::string &document, DevicePtr device)
+  {
+    auto message = make_shared<JsonMessage>(
+        "JsonMessage", Properties {{"VALUE", document}, {"source", getIdentity()}});
+    message->m_device = device;
+    return m_pipeline.run(std::move(message));
+  }
+
   AssetPtr LoopbackSource::receiveAsset(DevicePtr device, const std::string &document,
                                         const std::optional<std::string> &id,
                                         const std::optional<std::string> &type,
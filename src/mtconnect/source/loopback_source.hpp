@@ -106,6 +106,14 @@ namespace mtconnect::source {
     /// @return the sequence number
     SequenceNumber_t receive(const std::string &shdr);
 
+    /// @brief map a json document of observations and assets and send them through the pipeline
+    ///
+    /// The document can be an object, an array of objects, or newline delimited objects.
+    /// @param document the json document
+    /// @param device the default device for data items not qualified by a device
+    /// @return the `JsonEntities` result with the mapped entities and per-record `errors`
+    entity::EntityPtr receiveJson(const std::string &document, DevicePtr device = nullptr);
+
     /// @brief receives a device and sends it to the sinks
     /// @param device the device to be received
     /// @return 0 since there is no sequence number for this.
@@ -29,17 +29,23 @@
 #include <boost/regex.hpp>
 #include <boost/uuid/detail/sha1.hpp>
 
+#include <atomic>
+#include <charconv>
 #include <chrono>
 #include <date/date.h>
+#include <exception>
 #include <filesystem>
 #include <format>
 #include <map>
 #include <mtconnect/version.h>
+#include <mutex>
 #include <optional>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <variant>
+#include <vector>
 
 #include "mtconnect/config.hpp"
 #include "mtconnect/logging.hpp"
@@ -238,6 +244,40 @@ namespace mtconnect {
     return true;
   }
 
+  /// @brief Parse a double from a range of characters without allocating
+  ///
+  /// Uses `std::from_chars` when the standard library supports floating point conversions and
+  /// falls back to `strtod` otherwise. A leading `+` is accepted.
+  ///
+  /// @param[in] first the first character of the number
+  /// @param[in] last the end of the range. The range must be part of a null terminated string.
+  /// @param[out] value the value
+  /// @return the character after the number or `first` if there is no number
+  inline const char *parseDouble(const char *first, const char *last, double &value)
+  {
+    const char *start = first;
+    if (start != last && *start == '+')
+    {
+      start++;
+      if (start != last && *start == '-')
+        return first;
+    }
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto [ptr, ec] = std::from_chars(start, last, value);
+    if (ec == std::errc())
+      return ptr;
+    else if (ec != std::errc::result_out_of_range)
+      return first;
+#endif
+
+    char *end = nullptr;
+    value = strtod(start, &end);
+    if (end == start)
+      return first;
+    return end;
+  }
+
   /// @brief Thread safe localtime function that uses localtime_s or localtime_r based on platform
   /// @param[in] timer pointer to time_t
   /// @param[out] buf pointer to tm struct to fill
@@ -701,6 +741,69 @@ namespace mtconnect {
     return time;
   }
 
+  /// @brief Format a timestamp the same as `format(const Timestamp &)` into a buffer
+  ///
+  /// Used by the printers to write timestamps without a stream or an allocation.
+  ///
+  /// @param[in] ts the timestamp
+  /// @param[out] buffer the text, at least 32 characters
+  /// @return a view of the text in the buffer
+  inline std::string_view formatTimestamp(const Timestamp &ts, char *buffer)
+  {
+    using namespace std;
+    auto us = date::floor<Microseconds>(ts);
+    auto days = date::floor<date::days>(us);
+    date::year_month_day ymd(days);
+    int year = int(ymd.year());
+    if (year < 0 || year > 9999)
+    {
+      auto text = format(ts);
+      auto len = min<size_t>(text.size(), 31);
+      text.copy(buffer, len);
+      return string_view(buffer, len);
+    }
+
+    auto digits = [](char *p, unsigned value, int width) {
+      for (int i = width - 1; i >= 0; i--, value /= 10)
+        p[i] = char('0' + value % 10);
+    };
+
+    auto time = (us - days).count();
+    auto seconds = unsigned(time / 1'000'000);
+    auto micros = unsigned(time % 1'000'000);
+
+    // YYYY-MM-DDTHH:MM:SS
+    digits(buffer, unsigned(year), 4);
+    buffer[4] = '-';
+    digits(buffer + 5, unsigned(ymd.month()), 2);
+    buffer[7] = '-';
+    digits(buffer + 8, unsigned(ymd.day()), 2);
+    buffer[10] = 'T';
+    digits(buffer + 11, seconds / 3600, 2);
+    buffer[13] = ':';
+    digits(buffer + 14, seconds / 60 % 60, 2);
+    buffer[16] = ':';
+    digits(buffer + 17, seconds % 60, 2);
+    size_t len = 19;
+
+    // Microseconds without the trailing zeros
+    if (micros > 0)
+    {
+      int width = 6;
+      while (micros % 10 == 0)
+      {
+        micros /= 10;
+        width--;
+      }
+      buffer[len++] = '.';
+      digits(buffer + len, micros, width);
+      len += width;
+    }
+    buffer[len++] = 'Z';
+
+    return string_view(buffer, len);
+  }
+
   /// @brief Capitalize a word
   ///
   /// Has special treatment of acronyms like AC, DC, PH, etc.
@@ -877,6 +980,60 @@ namespace mtconnect {
     return s;
   }
 
+  /// @brief Call a function for each index from `0` to `count` on a number of threads
+  ///
+  /// Indexes are handed out in order to the threads as they finish the previous one. The calling
+  /// thread is one of the threads. If a call throws, the remaining indexes are skipped and the
+  /// first exception is rethrown after all threads finish.
+  ///
+  /// @param[in] count the number of indexes
+  /// @param[in] threads the maximum number of threads, `1` or less calls the function serially
+  /// @param[in] fun the function taking a `size_t` index
+  template <typename F>
+  void ParallelFor(size_t count, size_t threads, F fun)
+  {
+    threads = std::min(threads, count);
+    if (threads <= 1)
+    {
+      for (size_t i = 0; i < count; i++)
+        fun(i);
+      return;
+    }
+
+    std::atomic<size_t> next {0};
+    std::atomic_bool failed {false};
+    std::exception_ptr error;
+    std::mutex errorLock;
+
+    auto worker = [&]() {
+      for (auto i = next++; i < count && !failed; i = next++)
+      {
+        try
+        {
+          fun(i);
+        }
+        catch (...)
+        {
+          std::lock_guard<std::mutex> lock(errorLock);
+          if (!error)
+            error = std::current_exception();
+          failed = true;
+        }
+      }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t t = 1; t < threads; t++)
+      pool.emplace_back(worker);
+    worker();
+    for (auto &thread : pool)
+      thread.join();
+
+    if (error)
+      std::rethrow_exception(error);
+  }
+
   namespace url {
     using UrlQueryPair = std::pair<std::string, std::string>;
 
@@ -2319,6 +2319,147 @@ TEST_F(AgentTest, should_signal_observer_when_observations_arrive)
   }
 }
 
+/// @test a stream over its send budget is sent the current values and resumes sampling
+TEST_F(AgentTest, should_coalesce_a_stream_over_its_send_budget)
+{
+  m_agentTestHelper = make_unique<AgentTestHelper>();
+  m_agentTestHelper->createAgent("/samples/test_config.xml", 8, 4, "2.0", 25, true, true,
+                                 {{configuration::MaxStreamChunksInFlight, 2}});
+  addAdapter();
+  auto rest = m_agentTestHelper->getRestService();
+  rest->start();
+
+  auto &circ = m_agentTestHelper->getAgent()->getCircularBuffer();
+  auto &session = m_agentTestHelper->m_session;
+  auto agentValue = [&circ](const string &id) {
+    auto obs = circ.getLatest().getObservation(id);
+    return obs ? obs->getValue<string>() : ""s;
+  };
+
+  QueryMap query;
+  query["interval"] = "10";
+  query["heartbeat"] = "1000";
+  query["from"] = to_string(circ.getSequence());
+  query["path"] = "//DataItem[@name='line' or @name='block']";
+
+  PARSE_XML_STREAM_QUERY("/LinuxCNC/sample", query);
+  m_agentTestHelper->m_adapter->processData("2021-02-01T12:00:00Z|line|1");
+  m_agentTestHelper->m_ioContext.run_for(50ms);
+  ASSERT_EQ(0, session->getChunksInFlight());
+
+  ///     - The client stops reading, the chunks stay in flight until the budget is exceeded
+  session->m_stalled = true;
+  for (int i = 2; i < 5; i++)
+  {
+    m_agentTestHelper->m_adapter->processData("2021-02-01T12:00:00Z|line|" + to_string(i));
+    m_agentTestHelper->m_ioContext.run_for(50ms);
+
+    PARSE_XML_CHUNK();
+    ASSERT_XML_PATH_EQUAL(doc, "//m:Line", to_string(i).c_str());
+    ASSERT_XML_PATH_COUNT(doc, "//m:Block", 0);
+  }
+  ASSERT_EQ(3, session->getChunksInFlight());
+  ASSERT_TRUE(session->isOverSendBudget());
+  ASSERT_EQ(0, rest->getLaggingStreams());
+
+  ///     - The next chunks have the current values for the filter
+  for (int i = 5; i < 7; i++)
+  {
+    m_agentTestHelper->m_adapter->processData("2021-02-01T12:00:00Z|line|" + to_string(i));
+    auto next = circ.getSequence();
+    m_agentTestHelper->m_ioContext.run_for(50ms);
+
+    PARSE_XML_CHUNK();
+    ASSERT_XML_PATH_EQUAL(doc, "//m:Line", to_string(i).c_str());
+    ASSERT_XML_PATH_EQUAL(doc, "//m:Block", "UNAVAILABLE");
+    ASSERT_XML_PATH_EQUAL(doc, "//m:Header@nextSequence", to_string(circ.getSequence()).c_str());
+
+    ///     - Only the start of lagging is observed on the agent device, not every chunk
+    ASSERT_EQ(i == 5 ? next + 2 : next, circ.getSequence());
+  }
+  ASSERT_EQ(1, rest->getLaggingStreams());
+  ASSERT_EQ(2, rest->getCoalescedChunks());
+  ASSERT_EQ("1", agentValue("lagging_streams"));
+  ASSERT_EQ("0", agentValue("coalesced_chunks"));
+
+  ///     - Incremental sampling resumes when the client reads again
+  session->resume();
+  m_agentTestHelper->m_adapter->processData("2021-02-01T12:00:00Z|line|7");
+  m_agentTestHelper->m_ioContext.run_for(50ms);
+  {
+    PARSE_XML_CHUNK();
+    ASSERT_XML_PATH_EQUAL(doc, "//m:Line", "7");
+    ASSERT_XML_PATH_COUNT(doc, "//m:Block", 0);
+  }
+  ASSERT_EQ(0, rest->getLaggingStreams());
+  ASSERT_EQ(2, rest->getCoalescedChunks());
+  ASSERT_EQ("0", agentValue("lagging_streams"));
+  ASSERT_EQ("2", agentValue("coalesced_chunks"));
+}
+
+/// @test a live stream that falls too far behind the buffer is sent the current values
+TEST_F(AgentTest, should_coalesce_a_stream_that_lags_behind_the_buffer)
+{
+  m_agentTestHelper = make_unique<AgentTestHelper>();
+  m_agentTestHelper->createAgent("/samples/test_config.xml", 8, 4, "1.3", 25, true, true,
+                                 {{configuration::MaxStreamLag, 5}});
+  addAdapter();
+  auto rest = m_agentTestHelper->getRestService();
+  rest->start();
+
+  auto &circ = m_agentTestHelper->getAgent()->getCircularBuffer();
+  auto &session = m_agentTestHelper->m_session;
+
+  QueryMap query;
+  query["interval"] = "10";
+  query["heartbeat"] = "1000";
+  query["count"] = "100";
+  query["from"] = to_string(circ.getSequence());
+  query["path"] = "//DataItem[@name='line' or @name='block']";
+
+  ///     - The stream is live once it reaches the end of the buffer
+  PARSE_XML_STREAM_QUERY("/LinuxCNC/sample", query);
+  m_agentTestHelper->m_adapter->processData("2021-02-01T12:00:00Z|line|0");
+  m_agentTestHelper->m_ioContext.run_for(50ms);
+  {
+    PARSE_XML_CHUNK();
+    ASSERT_XML_PATH_EQUAL(doc, "//m:Line", "0");
+  }
+
+  ///     - The write blocks while more than the maximum lag arrives
+  session->m_blocked = true;
+  m_agentTestHelper->m_adapter->processData("2021-02-01T12:00:00Z|line|1");
+  m_agentTestHelper->m_ioContext.run_for(50ms);
+  for (int i = 2; i < 12; i++)
+    m_agentTestHelper->m_adapter->processData("2021-02-01T12:00:00Z|line|" + to_string(i));
+  m_agentTestHelper->m_ioContext.run_for(50ms);
+  ASSERT_EQ(0, rest->getLaggingStreams());
+
+  session->resume();
+  m_agentTestHelper->m_ioContext.run_for(50ms);
+  {
+    PARSE_XML_CHUNK();
+    ASSERT_XML_PATH_COUNT(doc, "//m:Line", 1);
+    ASSERT_XML_PATH_EQUAL(doc, "//m:Line", "11");
+    ASSERT_XML_PATH_EQUAL(doc, "//m:Block", "UNAVAILABLE");
+    ASSERT_XML_PATH_EQUAL(doc, "//m:Header@nextSequence", to_string(circ.getSequence()).c_str());
+  }
+  ASSERT_EQ(1, rest->getLaggingStreams());
+  ASSERT_EQ(1, rest->getCoalescedChunks());
+
+  ///     - The next chunk starts after the current values without repeating them
+  m_agentTestHelper->m_adapter->processData("2021-02-01T12:00:00Z|line|12");
+  m_agentTestHelper->m_adapter->processData("2021-02-01T12:00:00Z|line|13");
+  m_agentTestHelper->m_ioContext.run_for(50ms);
+  {
+    PARSE_XML_CHUNK();
+    ASSERT_XML_PATH_COUNT(doc, "//m:Line", 2);
+    ASSERT_XML_PATH_EQUAL(doc, "//m:Line[1]", "12");
+    ASSERT_XML_PATH_COUNT(doc, "//m:Block", 0);
+  }
+  ASSERT_EQ(0, rest->getLaggingStreams());
+}
+
 /// @test check request with from out of range
 TEST_F(AgentTest, should_fail_if_from_is_out_of_range)
 {
@@ -2500,6 +2641,28 @@ TEST_F(AgentTest, device_should_have_hash_for_2_2)
   }
 }
 
+TEST_F(AgentTest, should_load_the_same_devices_on_multiple_threads)
+{
+  using namespace configuration;
+  auto load = [this](int threads) {
+    m_agentTestHelper->createAgent("/samples/two_devices.xml", 8, 4, "2.2", 4, true, true,
+                                   {{CreateUniqueIds, true}, {WorkerThreads, threads}});
+    list<tuple<string, string, string>> res;
+    for (auto &device : m_agentTestHelper->getAgent()->getDevices())
+      res.emplace_back(device->get<string>("name"), device->getAvailability()->getId(),
+                       device->get<string>("hash"));
+    return res;
+  };
+
+  auto serial = load(1);
+  auto parallel = load(4);
+
+  ASSERT_EQ(3, parallel.size());
+  ASSERT_EQ(serial, parallel);
+  ASSERT_EQ("Device2", get<0>(parallel.back()));
+  ASSERT_NE("d2-1", get<1>(parallel.back()));
+}
+
 TEST_F(AgentTest, should_not_add_spaces_to_output)
 {
   addAdapter();
@@ -2689,3 +2852,26 @@ TEST_F(AgentTest, should_not_have_device_model_change_time_in_the_header_for_pre
     ASSERT_FALSE(header.contains("deviceModelChangeTime"));
   }
 }
+
+TEST_F(AgentTest, should_serve_latency_metrics_in_prometheus_format)
+{
+  m_agentTestHelper->createAgent("/samples/test_config.xml", 8, 4, "2.0", 25, false, true,
+                                 {{configuration::LatencyMetrics, true}});
+  {
+    PARSE_XML_RESPONSE("/current");
+  }
+
+  {
+    PARSE_TEXT_RESPONSE("/metrics");
+    auto session = m_agentTestHelper->session();
+    ASSERT_EQ("text/plain; version=0.0.4", session->m_mimeType);
+
+    const auto &text = session->m_body;
+    EXPECT_NE(string::npos, text.find("# TYPE mtconnect_render_seconds summary\n")) << text;
+
+    string count("mtconnect_render_seconds_count{format=\"application/xml\",request=\"current\"} ");
+    auto pos = text.find(count);
+    ASSERT_NE(string::npos, pos) << text;
+    EXPECT_LT(0, stoi(text.substr(pos + count.size())));
+  }
+}
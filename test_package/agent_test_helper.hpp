@@ -22,6 +22,8 @@
 #include <map>
 #include <queue>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
@@ -92,10 +94,33 @@ namespace mtconnect {
                         std::optional<std::string> requestId = std::nullopt) override
         {
           m_chunkBody = chunk;
-          if (m_streaming)
-            complete();
-          else
+          if (!m_streaming)
+          {
             std::cout << "Streaming done" << std::endl;
+            return;
+          }
+
+          chunkQueued(chunk.size());
+          if (m_stalled || m_blocked)
+            m_unsent.push_back(chunk.size());
+          else
+            chunkSent(chunk.size());
+
+          if (m_blocked)
+            m_blockedComplete = complete;
+          else
+            complete();
+        }
+
+        /// @brief the client reads again, send the chunks in flight and complete a blocked write
+        void resume()
+        {
+          m_stalled = m_blocked = false;
+          for (auto size : m_unsent)
+            chunkSent(size);
+          m_unsent.clear();
+          if (auto complete = std::exchange(m_blockedComplete, nullptr))
+            complete();
         }
         void close() override { m_streaming = false; }
         void closeStream() override { m_streaming = false; }
@@ -108,6 +133,13 @@ namespace mtconnect {
         std::string m_chunkBody;
         std::string m_chunkMimeType;
         bool m_streaming {false};
+
+        /// Chunks stay in flight, the writes complete like a websocket queuing messages
+        bool m_stalled {false};
+        /// Chunks stay in flight and the write does not complete like a blocked HTTP socket
+        bool m_blocked {false};
+        std::vector<size_t> m_unsent;
+        Complete m_blockedComplete;
       };
 
       class TestWebsocketSession : public WebsocketSession<TestWebsocketSession>
@@ -27,6 +27,7 @@
 
 #include "agent_test_helper.hpp"
 #include "mtconnect/asset/asset_buffer.hpp"
+#include "mtconnect/asset/cutting_tool.hpp"
 #include "mtconnect/entity/entity.hpp"
 #include "mtconnect/printer//xml_printer.hpp"
 #include "test_utilities.hpp"
@@ -332,3 +333,92 @@ TEST_F(AssetBufferTest, verify_asset_counts_with_removal)
   ASSERT_EQ(6, counts10["Asset2"]);
   ASSERT_EQ(2, counts10["Asset3"]);
 }
+
+TEST_F(AssetBufferTest, should_find_assets_by_indexed_properties)
+{
+  CuttingTool::registerAsset();
+  ErrorList errors;
+  auto add = [&](const string &id, const string &device, const string &serial,
+                 const string &tool) {
+    Properties props {{"assetId", id},
+                      {"deviceUuid", device},
+                      {"timestamp", "2020-12-01T12:00:00Z"s},
+                      {"serialNumber", serial},
+                      {"toolId", tool}};
+    auto asset =
+        dynamic_pointer_cast<Asset>(CuttingTool::getFactory()->make("CuttingTool", props, errors));
+    ASSERT_EQ(0, errors.size());
+    m_assetBuffer->addAsset(asset);
+  };
+
+  add("T1", "D1", "S1", "100");
+  add("T2", "D1", "S2", "100");
+  add("T3", "D2", "S1", "200");
+
+  AssetList list;
+  ASSERT_EQ(2, m_assetBuffer->getAssetsByProperty(list, 10, "serialNumber", "S1"));
+  list.clear();
+  ASSERT_EQ(1, m_assetBuffer->getAssetsByProperty(list, 10, "serialNumber", "S1", true, "D2"s));
+  ASSERT_EQ("T3", list.front()->getAssetId());
+
+  list.clear();
+  ASSERT_EQ(2, m_assetBuffer->getAssetsByProperty(list, 10, "toolId", "100"));
+  list.clear();
+  ASSERT_EQ(1, m_assetBuffer->getAssetsByProperty(list, 1, "toolId", "100"));
+
+  // Removal updates the indexes
+  m_assetBuffer->removeAsset("T1");
+  list.clear();
+  ASSERT_EQ(1, m_assetBuffer->getAssetsByProperty(list, 10, "toolId", "100"));
+  ASSERT_EQ("T2", list.front()->getAssetId());
+  list.clear();
+  ASSERT_EQ(2, m_assetBuffer->getAssetsByProperty(list, 10, "toolId", "100", false));
+
+  // Replacing an asset reindexes the new property values
+  add("T2", "D1", "S3", "300");
+  list.clear();
+  ASSERT_EQ(0, m_assetBuffer->getAssetsByProperty(list, 10, "toolId", "100"));
+  ASSERT_EQ(1, m_assetBuffer->getAssetsByProperty(list, 10, "serialNumber", "S3"));
+
+  // Properties that are not indexed are found by scanning
+  list.clear();
+  ASSERT_EQ(2, m_assetBuffer->getAssetsByProperty(list, 10, "deviceUuid", "D1", false));
+}
+
+TEST_F(AssetBufferTest, should_return_newest_assets_first_for_device_and_type)
+{
+  ErrorList errors;
+  auto asset = makeAsset("Asset1", "A1", "D1", "2020-12-01T12:00:00Z", errors);
+  m_assetBuffer->addAsset(asset);
+  asset = makeAsset("Asset1", "A2", "D1", "2020-12-01T12:00:02Z", errors);
+  m_assetBuffer->addAsset(asset);
+  asset = makeAsset("Asset1", "A3", "D1", "2020-12-01T12:00:01Z", errors);
+  m_assetBuffer->addAsset(asset);
+  ASSERT_EQ(0, errors.size());
+
+  AssetList list;
+  m_assetBuffer->getAssets(list, 10, true, "D1"s, "Asset1"s);
+  ASSERT_EQ(3, list.size());
+  auto it = list.begin();
+  ASSERT_EQ("A2", (*it++)->getAssetId());
+  ASSERT_EQ("A3", (*it++)->getAssetId());
+  ASSERT_EQ("A1", (*it++)->getAssetId());
+
+  list.clear();
+  m_assetBuffer->getAssets(list, 2, true, nullopt, "Asset1"s);
+  ASSERT_EQ(2, list.size());
+  ASSERT_EQ("A2", list.front()->getAssetId());
+  ASSERT_EQ("A3", list.back()->getAssetId());
+
+  // Removing an asset updates the timestamp
+  m_assetBuffer->removeAsset("A1", Timestamp(date::sys_days(date::year {2021} / 1 / 1)));
+  list.clear();
+  m_assetBuffer->getAssets(list, 10, false, "D1"s, "Asset1"s);
+  ASSERT_EQ("A1", list.front()->getAssetId());
+
+  list.clear();
+  m_assetBuffer->getAssets(list, 10);
+  ASSERT_EQ(2, list.size());
+  ASSERT_EQ("A3", list.front()->getAssetId());
+  ASSERT_EQ("A2", list.back()->getAssetId());
+}
@@ -0,0 +1,200 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+// Ensure that gtest is the first header otherwise Windows raises an error
+#include <gtest/gtest.h>
+// Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
+
+#include <filesystem>
+#include <fstream>
+
+#include "mtconnect/asset/asset_log_storage.hpp"
+#include "mtconnect/asset/cutting_tool.hpp"
+#include "mtconnect/entity/entity.hpp"
+
+using namespace std;
+using namespace mtconnect;
+using namespace mtconnect::entity;
+using namespace mtconnect::asset;
+
+// main
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+class AssetLogStorageTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_directory = std::filesystem::temp_directory_path() / "mtconnect_asset_log_test";
+    std::error_code ec;
+    std::filesystem::remove_all(m_directory, ec);
+    m_storage = make_unique<AssetLogStorage>(m_directory, 10, 4);
+  }
+
+  void TearDown() override
+  {
+    m_storage.reset();
+    std::error_code ec;
+    std::filesystem::remove_all(m_directory, ec);
+  }
+
+  void reopen(size_t max = 10, size_t cacheSize = 4)
+  {
+    m_storage.reset();
+    m_storage = make_unique<AssetLogStorage>(m_directory, max, cacheSize);
+  }
+
+  AssetPtr makeAsset(const string &type, const string &uuid, const string &device, const string &ts)
+  {
+    ErrorList errors;
+    Properties props {{"assetId", uuid}, {"deviceUuid", device}, {"timestamp", ts}};
+    auto asset = dynamic_pointer_cast<Asset>(Asset::getFactory()->make(type, props, errors));
+    EXPECT_EQ(0, errors.size());
+    return asset;
+  }
+
+  std::filesystem::path m_directory;
+  std::unique_ptr<AssetLogStorage> m_storage;
+};
+
+TEST_F(AssetLogStorageTest, should_add_and_get_assets)
+{
+  m_storage->addAsset(makeAsset("Asset1", "A1", "D1", "2020-12-01T12:00:00Z"));
+  m_storage->addAsset(makeAsset("Asset2", "A2", "D2", "2020-12-01T12:00:01Z"));
+
+  ASSERT_EQ(2, m_storage->getCount());
+  auto asset = m_storage->getAsset("A1");
+  ASSERT_TRUE(asset);
+  ASSERT_EQ("Asset1", asset->getType());
+  ASSERT_EQ("D1", *asset->getDeviceUuid());
+
+  AssetList list;
+  ASSERT_EQ(2, m_storage->getAssets(list, 10));
+  ASSERT_EQ("A2", list.front()->getAssetId());
+  ASSERT_EQ("A1", list.back()->getAssetId());
+
+  ASSERT_EQ(1, m_storage->getCountForDeviceAndType("D1", "Asset1"));
+  ASSERT_EQ(0, m_storage->getCountForDeviceAndType("D1", "Asset2"));
+  ASSERT_EQ(1, m_storage->getCountForType("Asset2"));
+  ASSERT_EQ(1, m_storage->getCountForDevice("D2"));
+}
+
+TEST_F(AssetLogStorageTest, should_restore_assets_when_reopened)
+{
+  m_storage->addAsset(makeAsset("Asset1", "A1", "D1", "2020-12-01T12:00:00Z"));
+  m_storage->addAsset(makeAsset("Asset1", "A2", "D1", "2020-12-01T12:00:01Z"));
+  m_storage->addAsset(makeAsset("Asset2", "A3", "D2", "2020-12-01T12:00:02Z"));
+  m_storage->removeAsset("A2");
+
+  reopen();
+
+  ASSERT_EQ(3, m_storage->getCount(false));
+  ASSERT_EQ(2, m_storage->getCount());
+  ASSERT_EQ(0, m_storage->getCachedCount());
+
+  auto asset = m_storage->getAsset("A2");
+  ASSERT_TRUE(asset);
+  ASSERT_TRUE(asset->isRemoved());
+  ASSERT_EQ(1, m_storage->getCachedCount());
+
+  auto counts = m_storage->getCountsByType(false);
+  ASSERT_EQ(2, counts["Asset1"]);
+  ASSERT_EQ(1, counts["Asset2"]);
+  ASSERT_EQ(1, m_storage->getCountForDeviceAndType("D1", "Asset1"));
+  ASSERT_EQ(2, m_storage->getCountForDeviceAndType("D1", "Asset1", false));
+
+  AssetList list;
+  ASSERT_EQ(1, m_storage->getAssets(list, 10, true, "D1"s, "Asset1"s));
+  ASSERT_EQ("A1", list.front()->getAssetId());
+}
+
+TEST_F(AssetLogStorageTest, should_replace_and_evict_oldest_assets)
+{
+  for (int i = 0; i < 12; i++)
+  {
+    auto id = "A" + to_string(i);
+    auto old = m_storage->addAsset(makeAsset("Asset1", id, "D1", "2020-12-01T12:00:00Z"));
+    if (i < 10)
+      ASSERT_FALSE(old);
+    else
+      ASSERT_EQ("A" + to_string(i - 10), old->getAssetId());
+  }
+
+  ASSERT_EQ(10, m_storage->getCount());
+  ASSERT_FALSE(m_storage->getAsset("A0"));
+  ASSERT_FALSE(m_storage->getAsset("A1"));
+  ASSERT_TRUE(m_storage->getAsset("A2"));
+
+  // Replacing an asset returns the previous version
+  auto old = m_storage->addAsset(makeAsset("Asset1", "A5", "D2", "2020-12-01T12:00:05Z"));
+  ASSERT_TRUE(old);
+  ASSERT_EQ("D1", *old->getDeviceUuid());
+  ASSERT_EQ(10, m_storage->getCount());
+  ASSERT_EQ(1, m_storage->getCountForDevice("D2"));
+
+  reopen();
+  ASSERT_EQ(10, m_storage->getCount());
+  ASSERT_FALSE(m_storage->getAsset("A1"));
+  ASSERT_EQ("D2", *m_storage->getAsset("A5")->getDeviceUuid());
+}
+
+TEST_F(AssetLogStorageTest, should_compact_log_with_only_current_assets)
+{
+  for (int i = 0; i < 20; i++)
+    m_storage->addAsset(makeAsset("Asset1", "A1", "D1", "2020-12-01T12:00:00Z"));
+  m_storage->flush();
+
+  ASSERT_LT(0, m_storage->getDeadBytes());
+  auto size = m_storage->getLogSize();
+  ASSERT_EQ(size, std::filesystem::file_size(m_storage->getPath()));
+
+  m_storage->compact();
+  ASSERT_EQ(0, m_storage->getDeadBytes());
+  ASSERT_GT(size, m_storage->getLogSize());
+  ASSERT_EQ(m_storage->getLogSize(), std::filesystem::file_size(m_storage->getPath()));
+
+  reopen(10, 0);
+  ASSERT_EQ(1, m_storage->getCount());
+  ASSERT_TRUE(m_storage->getAsset("A1"));
+}
+
+TEST_F(AssetLogStorageTest, should_ignore_incomplete_record_at_end_of_log)
+{
+  m_storage->addAsset(makeAsset("Asset1", "A1", "D1", "2020-12-01T12:00:00Z"));
+  m_storage->addAsset(makeAsset("Asset1", "A2", "D1", "2020-12-01T12:00:01Z"));
+  m_storage->flush();
+  auto path = m_storage->getPath();
+  auto size = m_storage->getLogSize();
+  m_storage.reset();
+
+  // Simulate a crash while a record was being written
+  std::filesystem::resize_file(path, size - 10);
+
+  reopen();
+  ASSERT_EQ(1, m_storage->getCount());
+  ASSERT_TRUE(m_storage->getAsset("A1"));
+  ASSERT_FALSE(m_storage->getAsset("A2"));
+
+  m_storage->addAsset(makeAsset("Asset1", "A3", "D1", "2020-12-01T12:00:02Z"));
+  reopen();
+  ASSERT_EQ(2, m_storage->getCount());
+  ASSERT_TRUE(m_storage->getAsset("A3"));
+}
@@ -0,0 +1,168 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+// Ensure that gtest is the first header otherwise Windows raises an error
+#include <gtest/gtest.h>
+// Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
+
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "mtconnect/configuration/async_context.hpp"
+
+using namespace mtconnect;
+using namespace configuration;
+using namespace std;
+
+// main
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+TEST(AsyncContextTest, should_use_one_context_when_not_sharded)
+{
+  AsyncContext context;
+  context.setThreadCount(4);
+  context.setSharding(Sharding::NONE);
+
+  ASSERT_EQ(1, context.getShardCount());
+  ASSERT_FALSE(boost::asio::has_service<IoShards>(context.get()));
+  ASSERT_EQ(&context.get(), &context.place());
+  ASSERT_EQ(&context.get(), &context.place("device"));
+}
+
+TEST(AsyncContextTest, should_place_round_robin)
+{
+  AsyncContext context;
+  context.setThreadCount(4);
+  context.setSharding(Sharding::ROUND_ROBIN);
+
+  ASSERT_EQ(4, context.getShardCount());
+  ASSERT_TRUE(boost::asio::has_service<IoShards>(context.get()));
+
+  vector<boost::asio::io_context *> placed;
+  for (int i = 0; i < 8; i++)
+    placed.push_back(&context.place("device"));
+
+  ASSERT_EQ(&context.get(), placed[0]);
+  ASSERT_EQ(4, set<boost::asio::io_context *>(placed.begin(), placed.end()).size());
+  for (int i = 0; i < 4; i++)
+    ASSERT_EQ(placed[i], placed[i + 4]);
+}
+
+TEST(AsyncContextTest, should_place_by_device_hash)
+{
+  AsyncContext context;
+  context.setThreadCount(4);
+  context.setSharding(Sharding::DEVICE_HASH);
+
+  auto &first = context.place("device_1");
+  ASSERT_EQ(&first, &context.place("device_1"));
+  ASSERT_EQ(&first, &context.place("device_1"));
+
+  set<boost::asio::io_context *> devices;
+  for (int i = 0; i < 32; i++)
+    devices.insert(&context.place("device_" + to_string(i)));
+  ASSERT_LT(1, devices.size());
+
+  // Sessions have no device and are placed in turn
+  set<boost::asio::io_context *> sessions;
+  for (int i = 0; i < 4; i++)
+    sessions.insert(&context.place());
+  ASSERT_EQ(4, sessions.size());
+}
+
+TEST(AsyncContextTest, should_run_each_shard_on_its_own_thread)
+{
+  AsyncContext context;
+  context.setThreadCount(4);
+  context.setSharding(Sharding::ROUND_ROBIN);
+  context.setAffinity(true);
+
+  mutex lock;
+  set<thread::id> threads;
+  int count = 0;
+  for (int i = 0; i < 4; i++)
+  {
+    boost::asio::post(context.place(), [&]() {
+      std::this_thread::sleep_for(20ms);
+      lock_guard<mutex> guard(lock);
+      threads.insert(this_thread::get_id());
+      if (++count == 4)
+        context.stop();
+    });
+  }
+
+  ASSERT_EQ(0, context.start());
+  ASSERT_EQ(4, count);
+  ASSERT_EQ(4, threads.size());
+}
+
+TEST(AsyncContextTest, should_not_shard_a_single_thread)
+{
+  AsyncContext context;
+  context.setThreadCount(1);
+  context.setSharding(Sharding::ROUND_ROBIN);
+
+  ASSERT_EQ(1, context.getShardCount());
+  ASSERT_EQ(&context.get(), &context.place());
+}
+
+TEST(AsyncContextTest, should_keep_the_shards_when_reconfigured)
+{
+  AsyncContext context;
+  context.setThreadCount(4);
+  context.setSharding(Sharding::ROUND_ROBIN);
+
+  mutex lock;
+  set<thread::id> threads;
+  int count = 0;
+
+  // Reload the configuration while paused, as the agent does when the config file changes
+  boost::asio::post(context.get(), [&]() {
+    context.pause([&](AsyncContext &paused) {
+      paused.setThreadCount(8);
+      paused.setSharding(Sharding::NONE);
+      paused.setThreadCount(2);
+      paused.setSharding(Sharding::DEVICE_HASH);
+
+      for (int i = 0; i < 4; i++)
+      {
+        boost::asio::post(paused.place(), [&]() {
+          std::this_thread::sleep_for(20ms);
+          lock_guard<mutex> guard(lock);
+          threads.insert(this_thread::get_id());
+          if (++count == 4)
+            context.stop();
+        });
+      }
+    });
+  });
+
+  ASSERT_EQ(0, context.start());
+  ASSERT_EQ(4, context.getThreadCount());
+  ASSERT_EQ(4, context.getShardCount());
+  ASSERT_EQ(4, count);
+  ASSERT_EQ(4, threads.size());
+
+  // The placement can change, devices are now placed by hash
+  auto &first = context.place("device_1");
+  ASSERT_EQ(&first, &context.place("device_1"));
+}
@@ -0,0 +1,265 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+// Ensure that gtest is the first header otherwise Windows raises an error
+#include <gtest/gtest.h>
+// Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
+
+#include <bit>
+#include <memory>
+#include <string>
+
+#include "mtconnect/device_model/data_item/data_item.hpp"
+#include "mtconnect/device_model/device.hpp"
+#include "mtconnect/observation/observation.hpp"
+#include "mtconnect/parser/xml_parser.hpp"
+#include "mtconnect/printer/binary_printer.hpp"
+#include "mtconnect/printer/xml_printer.hpp"
+#include "mtconnect/utilities.hpp"
+#include "test_utilities.hpp"
+
+using namespace std;
+using namespace mtconnect;
+using namespace mtconnect::observation;
+using namespace mtconnect::entity;
+using namespace mtconnect::printer;
+
+// main
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+/// @brief Decodes the primitives of a binary frame
+class FrameReader
+{
+public:
+  FrameReader(const string &frame) : m_frame(frame) {}
+
+  uint8_t byte() { return uint8_t(m_frame.at(m_pos++)); }
+
+  uint64_t varint()
+  {
+    uint64_t v = 0;
+    for (int shift = 0;; shift += 7)
+    {
+      auto b = byte();
+      v |= uint64_t(b & 0x7F) << shift;
+      if ((b & 0x80) == 0)
+        return v;
+    }
+  }
+
+  int64_t svarint()
+  {
+    auto v = varint();
+    return int64_t(v >> 1) ^ -int64_t(v & 1);
+  }
+
+  double real()
+  {
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; i++)
+      bits |= uint64_t(byte()) << (i * 8);
+    return std::bit_cast<double>(bits);
+  }
+
+  string str()
+  {
+    auto len = varint();
+    auto s = m_frame.substr(m_pos, len);
+    m_pos += len;
+    return s;
+  }
+
+  bool atEnd() const { return m_pos == m_frame.size(); }
+
+  const string &m_frame;
+  size_t m_pos {0};
+};
+
+class BinaryPrinterTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_xmlPrinter = std::make_unique<printer::XmlPrinter>("1.5");
+    m_printer = std::make_unique<printer::BinaryPrinter>();
+    m_config = std::make_unique<parser::XmlParser>();
+    m_devices =
+        m_config->parseFile(TEST_RESOURCE_DIR "/samples/SimpleDevlce.xml", m_xmlPrinter.get());
+  }
+
+  void TearDown() override
+  {
+    m_config.reset();
+    m_xmlPrinter.reset();
+    m_printer.reset();
+  }
+
+  void addObservation(ObservationList &list, const char *name, uint64_t sequence,
+                      Properties props, Timestamp time)
+  {
+    DataItemPtr d;
+    for (auto &device : m_devices)
+      if ((d = device->getDeviceDataItem(name)))
+        break;
+    ASSERT_TRUE(d) << "Could not find data item " << name;
+    ErrorList errors;
+    auto event = Observation::make(d, props, time, errors);
+    ASSERT_TRUE(event);
+    ASSERT_EQ(0, errors.size());
+
+    event->setSequence(sequence);
+    list.emplace_back(event);
+  }
+
+  void checkHeader(FrameReader &reader, BinaryPrinter::FrameType type)
+  {
+    ASSERT_EQ("MTCB", reader.m_frame.substr(0, 4));
+    reader.m_pos = 4;
+    ASSERT_EQ(BinaryPrinter::FrameVersion, reader.byte());
+    ASSERT_EQ(uint8_t(type), reader.byte());
+  }
+
+  std::unique_ptr<printer::BinaryPrinter> m_printer;
+  std::unique_ptr<parser::XmlParser> m_config;
+  std::unique_ptr<printer::XmlPrinter> m_xmlPrinter;
+  std::list<DevicePtr> m_devices;
+};
+
+TEST_F(BinaryPrinterTest, should_print_header_and_data_item_table)
+{
+  auto now = chrono::system_clock::now();
+  ObservationList list;
+  addObservation(list, "Xpos", 100, {{"VALUE", 10.5}}, now);
+  addObservation(list, "Xload", 101, {{"VALUE", 20.0}}, now);
+  addObservation(list, "Xpos", 102, {{"VALUE", 11.5}}, now);
+
+  auto frame = m_printer->printSample(123, 131072, 103, 50, 102, list, false, "req1"s);
+
+  FrameReader reader(frame);
+  checkHeader(reader, BinaryPrinter::FrameType::STREAMS);
+  ASSERT_EQ(123, reader.varint());
+  ASSERT_EQ(131072, reader.varint());
+  ASSERT_EQ(103, reader.varint());
+  ASSERT_EQ(50, reader.varint());
+  ASSERT_EQ(102, reader.varint());
+  ASSERT_EQ("req1", reader.str());
+
+  ASSERT_EQ(2, reader.varint());
+  ASSERT_EQ("dcbc0570", reader.str());
+  ASSERT_EQ("f646f730", reader.str());
+  ASSERT_EQ(3, reader.varint());
+
+  ASSERT_EQ(0, reader.varint());
+  ASSERT_EQ(50, reader.svarint());
+  auto ts = reader.svarint();
+  ASSERT_EQ(chrono::duration_cast<chrono::microseconds>(now.time_since_epoch()).count(), ts);
+  ASSERT_EQ(uint8_t(BinaryPrinter::Kind::DOUBLE), reader.byte());
+  ASSERT_EQ(10.5, reader.real());
+
+  ASSERT_EQ(1, reader.varint());
+  ASSERT_EQ(1, reader.svarint());
+  ASSERT_EQ(0, reader.svarint());
+  ASSERT_EQ(uint8_t(BinaryPrinter::Kind::DOUBLE), reader.byte());
+  ASSERT_EQ(20.0, reader.real());
+
+  ASSERT_EQ(0, reader.varint());
+  ASSERT_EQ(1, reader.svarint());
+  ASSERT_EQ(0, reader.svarint());
+  ASSERT_EQ(uint8_t(BinaryPrinter::Kind::DOUBLE), reader.byte());
+  ASSERT_EQ(11.5, reader.real());
+
+  ASSERT_TRUE(reader.atEnd());
+}
+
+TEST_F(BinaryPrinterTest, should_print_strings_unavailable_and_conditions)
+{
+  auto now = chrono::system_clock::now();
+  ObservationList list;
+  addObservation(list, "avail", 10, {{"VALUE", "AVAILABLE"s}}, now);
+  addObservation(list, "Xload", 11, {{"VALUE", "UNAVAILABLE"s}}, now);
+  addObservation(list, "Xtravel", 12,
+                 {{"level", "fault"s}, {"nativeCode", "OT1"s}, {"VALUE", "Over travel"s}}, now);
+
+  auto frame = m_printer->printSample(1, 1024, 13, 10, 12, list);
+
+  FrameReader reader(frame);
+  checkHeader(reader, BinaryPrinter::FrameType::STREAMS);
+  for (int i = 0; i < 5; i++)
+    reader.varint();
+  ASSERT_EQ("", reader.str());
+  ASSERT_EQ(3, reader.varint());
+  ASSERT_EQ("d5b078a0", reader.str());
+  ASSERT_EQ("f646f730", reader.str());
+  ASSERT_EQ("e086dd60", reader.str());
+  ASSERT_EQ(3, reader.varint());
+
+  reader.varint();
+  reader.svarint();
+  reader.svarint();
+  ASSERT_EQ(uint8_t(BinaryPrinter::Kind::STRING), reader.byte());
+  ASSERT_EQ("AVAILABLE", reader.str());
+
+  reader.varint();
+  reader.svarint();
+  reader.svarint();
+  ASSERT_EQ(uint8_t(BinaryPrinter::Kind::UNAVAILABLE), reader.byte());
+
+  ASSERT_EQ(2, reader.varint());
+  reader.svarint();
+  reader.svarint();
+  ASSERT_EQ(uint8_t(BinaryPrinter::Kind::ENTITY), reader.byte());
+  ASSERT_EQ("Fault", reader.str());
+
+  map<string, string> props;
+  auto count = reader.varint();
+  for (uint64_t i = 0; i < count; i++)
+  {
+    auto key = reader.str();
+    ASSERT_EQ(uint8_t(BinaryPrinter::ValueTag::STRING), reader.byte()) << key;
+    props[key] = reader.str();
+  }
+  ASSERT_EQ("OT1", props["nativeCode"]);
+  ASSERT_EQ("Over travel", props["VALUE"]);
+  ASSERT_EQ(0, props.count("dataItemId"));
+
+  ASSERT_TRUE(reader.atEnd());
+}
+
+TEST_F(BinaryPrinterTest, should_return_unsupported_error_for_probe)
+{
+  auto frame = m_printer->printProbe(1, 1024, 10, 4, 2, m_devices, nullptr, false, false, "p"s);
+
+  FrameReader reader(frame);
+  checkHeader(reader, BinaryPrinter::FrameType::ERRORS);
+  for (int i = 0; i < 5; i++)
+    reader.varint();
+  ASSERT_EQ("p", reader.str());
+  ASSERT_EQ(1, reader.varint());
+  ASSERT_EQ("Error", reader.str());
+  ASSERT_EQ(2, reader.varint());
+  ASSERT_EQ("ErrorMessage", reader.str());
+  reader.byte();
+  reader.str();
+  ASSERT_EQ("errorCode", reader.str());
+  ASSERT_EQ(uint8_t(BinaryPrinter::ValueTag::STRING), reader.byte());
+  ASSERT_EQ("UNSUPPORTED", reader.str());
+  ASSERT_TRUE(reader.atEnd());
+}
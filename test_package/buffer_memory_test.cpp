@@ -0,0 +1,148 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+// Ensure that gtest is the first header otherwise Windows raises an error
+#include <gtest/gtest.h>
+// Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include "mtconnect/buffer/circular_buffer.hpp"
+#include "mtconnect/device_model/device.hpp"
+
+using namespace std;
+using namespace mtconnect;
+using namespace mtconnect::buffer;
+using namespace mtconnect::observation;
+using namespace device_model;
+using namespace entity;
+using namespace data_item;
+using namespace std::literals;
+using namespace date::literals;
+
+// Track the live heap bytes so the memory used by each buffer slot can be measured
+namespace {
+  std::atomic<int64_t> g_liveBytes {0};
+  constexpr size_t HeaderSize = alignof(std::max_align_t);
+}  // namespace
+
+void *operator new(size_t size)
+{
+  auto p = static_cast<char *>(std::malloc(size + HeaderSize));
+  if (p == nullptr)
+    throw std::bad_alloc();
+  *reinterpret_cast<size_t *>(p) = size;
+  g_liveBytes += size;
+  return p + HeaderSize;
+}
+
+void operator delete(void *ptr) noexcept
+{
+  if (ptr == nullptr)
+    return;
+  auto p = static_cast<char *>(ptr) - HeaderSize;
+  g_liveBytes -= *reinterpret_cast<size_t *>(p);
+  std::free(p);
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete[](void *ptr) noexcept { operator delete(ptr); }
+void operator delete(void *ptr, size_t) noexcept { operator delete(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { operator delete(ptr); }
+
+// main
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+class BufferMemoryTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ErrorList errors;
+    Properties d1 {
+        {"id", "1"s}, {"name", "DeviceTest1"s}, {"uuid", "UnivUniqId1"s}, {"iso841Class", "4"s}};
+    m_device = dynamic_pointer_cast<Device>(Device::getFactory()->make("Device", d1, errors));
+
+    m_comp = Component::make("Comp1", {{"id", "2"s}, {"name", "Comp1"s}}, errors);
+    m_device->addChild(m_comp, errors);
+
+    m_position = DataItem::make({{"id", "p1"s},
+                                 {"type", "POSITION"s},
+                                 {"category", "SAMPLE"s},
+                                 {"subType", "ACTUAL"s},
+                                 {"units", "MILLIMETER"s}},
+                                errors);
+    m_comp->addDataItem(m_position, errors);
+
+    m_execution =
+        DataItem::make({{"id", "e1"s}, {"type", "EXECUTION"s}, {"category", "EVENT"s}}, errors);
+    m_comp->addDataItem(m_execution, errors);
+  }
+
+  /// @brief fill a buffer and report the heap bytes per slot
+  double bytesPerEntry(bool compact)
+  {
+    constexpr unsigned int BufferSize = 14;
+    constexpr int Entries = 1 << BufferSize;
+
+    auto before = g_liveBytes.load();
+    {
+      CircularBuffer buffer(BufferSize, 1000, compact);
+      Timestamp time = Timestamp(date::sys_days(2021_y / jan / 19_d)) + 10h;
+
+      ErrorList errors;
+      for (int i = 0; i < Entries; i++)
+      {
+        ObservationPtr obs;
+        if (i % 4 == 0)
+          obs = Observation::make(m_execution, {{"VALUE", i % 8 ? "ACTIVE"s : "READY"s}},
+                                  time + chrono::milliseconds(i), errors);
+        else
+          obs = Observation::make(m_position, {{"VALUE", double(i) * 0.1}},
+                                  time + chrono::milliseconds(i), errors);
+        buffer.addToBuffer(obs);
+      }
+
+      auto perEntry = double(g_liveBytes.load() - before) / Entries;
+      cout << (compact ? "Compact" : "Observation") << " buffer: " << perEntry
+           << " bytes per entry" << endl;
+      return perEntry;
+    }
+  }
+
+  DevicePtr m_device;
+  ComponentPtr m_comp;
+  DataItemPtr m_position;
+  DataItemPtr m_execution;
+};
+
+TEST_F(BufferMemoryTest, should_report_bytes_per_entry_for_both_modes)
+{
+  auto full = bytesPerEntry(false);
+  auto compact = bytesPerEntry(true);
+
+  ASSERT_LT(0.0, compact);
+  ASSERT_LT(compact * 4.0, full);
+  ASSERT_GE(64.0, compact);
+}
@@ -212,6 +212,41 @@ namespace mtconnect {
     ASSERT_EQ(uint64_t {30}, changeObserver.getSequence());
   }
 
+  TEST_F(ChangeObserverTest, should_signal_once_per_batch_with_earliest_subscribed_sequence)
+  {
+    mtconnect::ChangeSignaler other;
+    mtconnect::ChangeObserver both(*m_strand), one(*m_strand);
+
+    m_signaler->addObserver(&both);
+    other.addObserver(&both);
+    other.addObserver(&one);
+    ASSERT_TRUE(other.hasObserver(&one));
+    ASSERT_FALSE(m_signaler->hasObserver(&one));
+
+    {
+      ChangeNotifier::Batch batch;
+      other.signalObservers(uint64_t {300});
+      m_signaler->signalObservers(uint64_t {200});
+      other.signalObservers(uint64_t {400});
+
+      ASSERT_FALSE(both.wasSignaled());
+      ASSERT_FALSE(one.wasSignaled());
+    }
+
+    ASSERT_TRUE(both.wasSignaled());
+    ASSERT_EQ(uint64_t {200}, both.getSequence());
+    ASSERT_TRUE(one.wasSignaled());
+    ASSERT_EQ(uint64_t {300}, one.getSequence());
+
+    m_signaler->removeObserver(&both);
+    both.reset();
+    one.reset();
+
+    m_signaler->signalObservers(uint64_t {500});
+    ASSERT_FALSE(both.wasSignaled());
+    ASSERT_FALSE(one.wasSignaled());
+  }
+
   class MockObserver : public AsyncObserver
   {
   public:
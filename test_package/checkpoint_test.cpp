@@ -43,6 +43,13 @@ int main(int argc, char *argv[])
 
 inline ConditionPtr Cond(ObservationPtr &ptr) { return dynamic_pointer_cast<Condition>(ptr); }
 
+inline ConditionList Active(ObservationPtr &ptr)
+{
+  ConditionList list;
+  Cond(ptr)->getConditionList(list);
+  return list;
+}
+
 class CheckpointTest : public testing::Test
 {
 protected:
@@ -114,20 +121,13 @@ TEST_F(CheckpointTest, AddObservations)
   ASSERT_TRUE(p2);
   m_checkpoint->addObservation(p2);
 
-  {
-    auto prev = dynamic_pointer_cast<Condition>(p2)->getPrev();
-    ASSERT_TRUE(prev);
-    EXPECT_EQ(p1, prev);
-  }
+  EXPECT_EQ((ConditionList {Cond(p1), Cond(p2)}), Active(p2));
 
   auto p3 = observation::Observation::make(m_dataItem1, normal, time, errors);
   ASSERT_TRUE(p3);
   m_checkpoint->addObservation(p3);
 
-  {
-    auto prev = dynamic_pointer_cast<Condition>(p3)->getPrev();
-    ASSERT_FALSE(prev);
-  }
+  EXPECT_TRUE(Cond(p3)->getActive().empty());
 
   EXPECT_EQ(2, p1.use_count());
   EXPECT_EQ(1, p2.use_count());
@@ -135,10 +135,7 @@ TEST_F(CheckpointTest, AddObservations)
   auto p4 = observation::Observation::make(m_dataItem1, warning1, time, errors);
   m_checkpoint->addObservation(p4);
 
-  {
-    auto prev = dynamic_pointer_cast<Condition>(p4)->getPrev();
-    ASSERT_FALSE(prev);
-  }
+  EXPECT_TRUE(Cond(p4)->getActive().empty());
   EXPECT_EQ(1, p3.use_count());
 
   auto p5 = observation::Observation::make(m_dataItem2, value, time, errors);
@@ -418,18 +415,16 @@ TEST_F(CheckpointTest, ConditionChaining)
   list.clear();
   m_checkpoint->getObservations(list);
   ASSERT_EQ(2, list.size());
-  ASSERT_EQ(p1, dynamic_pointer_cast<Condition>(p2)->getPrev());
+  ASSERT_EQ((ConditionList {Cond(p1), Cond(p2)}), Active(p2));
   list.clear();
 
   auto p3 = observation::Observation::make(m_dataItem1, warning3, time, errors);
   m_checkpoint->addObservation(p3);
   ASSERT_EQ(2, p3.use_count());
-  ASSERT_EQ(2, p2.use_count());
-  ASSERT_EQ(2, p1.use_count());
 
-  ASSERT_EQ(p2, dynamic_pointer_cast<Condition>(p3)->getPrev());
-  ASSERT_EQ(p1, dynamic_pointer_cast<Condition>(p2)->getPrev());
-  ASSERT_FALSE(dynamic_pointer_cast<Condition>(p1)->getPrev());
+  ASSERT_EQ((ConditionList {Cond(p1), Cond(p2), Cond(p3)}), Active(p3));
+  ASSERT_EQ((ConditionList {Cond(p1), Cond(p2)}), Active(p2));
+  ASSERT_TRUE(Cond(p1)->getActive().empty());
 
   list.clear();
   m_checkpoint->getObservations(list);
@@ -440,19 +435,10 @@ TEST_F(CheckpointTest, ConditionChaining)
   auto p4 = observation::Observation::make(m_dataItem1, fault2, time, errors);
   m_checkpoint->addObservation(p4);
   ASSERT_EQ(2, p4.use_count());
-  ASSERT_EQ(1, p3.use_count());
-  ASSERT_EQ(2, p2.use_count());
-  ASSERT_EQ(2, p1.use_count());
 
-  // Should have been deep copyied
-  ASSERT_NE(p3, Cond(p4)->getPrev());
-
-  // Codes should still match
-  ASSERT_EQ(Cond(p3)->getCode(), Cond(p4)->getPrev()->getCode());
-  ASSERT_EQ(2, Cond(p4)->getPrev().use_count());
-  ASSERT_EQ(Cond(p1)->getCode(), Cond(p4)->getPrev()->getPrev()->getCode());
-  ASSERT_EQ(2, Cond(p4)->getPrev()->getPrev().use_count());
-  ASSERT_FALSE(Cond(p4)->getPrev()->getPrev()->getPrev());
+  // The remaining conditions are shared and the earlier conditions are unchanged
+  ASSERT_EQ((ConditionList {Cond(p1), Cond(p3), Cond(p4)}), Active(p4));
+  ASSERT_EQ((ConditionList {Cond(p1), Cond(p2), Cond(p3)}), Active(p3));
 
   list.clear();
   m_checkpoint->getObservations(list);
@@ -461,7 +447,7 @@ TEST_F(CheckpointTest, ConditionChaining)
 
   auto p5 = observation::Observation::make(m_dataItem1, normal2, time, errors);
   m_checkpoint->addObservation(p5);
-  ASSERT_FALSE(Cond(p5)->getPrev());
+  ASSERT_TRUE(Cond(p5)->getActive().empty());
 
   // Check cleanup
   ObservationPtr p7 = m_checkpoint->getObservations().at(std::string("1"));
@@ -469,8 +455,7 @@ TEST_F(CheckpointTest, ConditionChaining)
   ASSERT_EQ(2, p7.use_count());
   ASSERT_NE(p5, p7);
   ASSERT_EQ(std::string("CODE3"), Cond(p7)->getCode());
-  ASSERT_EQ(std::string("CODE1"), Cond(p7)->getPrev()->getCode());
-  ASSERT_FALSE(Cond(p7)->getPrev()->getPrev());
+  ASSERT_EQ((ConditionList {Cond(p1), Cond(p7)}), Active(p7));
 
   list.clear();
   m_checkpoint->getObservations(list);
@@ -480,7 +465,7 @@ TEST_F(CheckpointTest, ConditionChaining)
   // Clear all
   auto p6 = observation::Observation::make(m_dataItem1, normal, time, errors);
   m_checkpoint->addObservation(p6);
-  ASSERT_FALSE(Cond(p6)->getPrev());
+  ASSERT_TRUE(Cond(p6)->getActive().empty());
 
   list.clear();
   m_checkpoint->getObservations(list);
@@ -635,18 +620,16 @@ TEST_F(CheckpointTest, condition_chaining_with_condition_id_for_23)
   list.clear();
   m_checkpoint->getObservations(list);
   ASSERT_EQ(2, list.size());
-  ASSERT_EQ(p1, dynamic_pointer_cast<Condition>(p2)->getPrev());
+  ASSERT_EQ((ConditionList {Cond(p1), Cond(p2)}), Active(p2));
   list.clear();
 
   auto p3 = observation::Observation::make(m_dataItem1, warning3, time, errors);
   m_checkpoint->addObservation(p3);
   ASSERT_EQ(2, p3.use_count());
-  ASSERT_EQ(2, p2.use_count());
-  ASSERT_EQ(2, p1.use_count());
 
-  ASSERT_EQ(p2, dynamic_pointer_cast<Condition>(p3)->getPrev());
-  ASSERT_EQ(p1, dynamic_pointer_cast<Condition>(p2)->getPrev());
-  ASSERT_FALSE(dynamic_pointer_cast<Condition>(p1)->getPrev());
+  ASSERT_EQ((ConditionList {Cond(p1), Cond(p2), Cond(p3)}), Active(p3));
+  ASSERT_EQ((ConditionList {Cond(p1), Cond(p2)}), Active(p2));
+  ASSERT_TRUE(Cond(p1)->getActive().empty());
 
   list.clear();
   m_checkpoint->getObservations(list);
@@ -657,19 +640,10 @@ TEST_F(CheckpointTest, condition_chaining_with_condition_id_for_23)
   auto p4 = observation::Observation::make(m_dataItem1, fault2, time, errors);
   m_checkpoint->addObservation(p4);
   ASSERT_EQ(2, p4.use_count());
-  ASSERT_EQ(1, p3.use_count());
-  ASSERT_EQ(2, p2.use_count());
-  ASSERT_EQ(2, p1.use_count());
-
-  // Should have been deep copyied
-  ASSERT_NE(p3, Cond(p4)->getPrev());
 
-  // Codes should still match
-  ASSERT_EQ(Cond(p3)->getCode(), Cond(p4)->getPrev()->getCode());
-  ASSERT_EQ(2, Cond(p4)->getPrev().use_count());
-  ASSERT_EQ(Cond(p1)->getCode(), Cond(p4)->getPrev()->getPrev()->getCode());
-  ASSERT_EQ(2, Cond(p4)->getPrev()->getPrev().use_count());
-  ASSERT_FALSE(Cond(p4)->getPrev()->getPrev()->getPrev());
+  // The remaining conditions are shared and the earlier conditions are unchanged
+  ASSERT_EQ((ConditionList {Cond(p1), Cond(p3), Cond(p4)}), Active(p4));
+  ASSERT_EQ((ConditionList {Cond(p1), Cond(p2), Cond(p3)}), Active(p3));
 
   list.clear();
   m_checkpoint->getObservations(list);
@@ -678,7 +652,7 @@ TEST_F(CheckpointTest, condition_chaining_with_condition_id_for_23)
 
   auto p5 = observation::Observation::make(m_dataItem1, normal2, time, errors);
   m_checkpoint->addObservation(p5);
-  ASSERT_FALSE(Cond(p5)->getPrev());
+  ASSERT_TRUE(Cond(p5)->getActive().empty());
 
   // Check cleanup
   ObservationPtr p7 = m_checkpoint->getObservations().at(std::string("1"));
@@ -686,8 +660,7 @@ TEST_F(CheckpointTest, condition_chaining_with_condition_id_for_23)
   ASSERT_EQ(2, p7.use_count());
   ASSERT_NE(p5, p7);
   ASSERT_EQ(std::string("CODE3"), Cond(p7)->getCode());
-  ASSERT_EQ(std::string("CODE1"), Cond(p7)->getPrev()->getCode());
-  ASSERT_FALSE(Cond(p7)->getPrev()->getPrev());
+  ASSERT_EQ((ConditionList {Cond(p1), Cond(p7)}), Active(p7));
 
   list.clear();
   m_checkpoint->getObservations(list);
@@ -697,7 +670,7 @@ TEST_F(CheckpointTest, condition_chaining_with_condition_id_for_23)
   // Clear all
   auto p6 = observation::Observation::make(m_dataItem1, normal, time, errors);
   m_checkpoint->addObservation(p6);
-  ASSERT_FALSE(Cond(p6)->getPrev());
+  ASSERT_TRUE(Cond(p6)->getActive().empty());
 
   list.clear();
   m_checkpoint->getObservations(list);
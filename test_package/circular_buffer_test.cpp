@@ -191,3 +191,118 @@ TEST_F(CircularBufferTest, should_skip_orphaned_observations)
   ASSERT_EQ(7, end);
   ASSERT_TRUE(eob);
 }
+
+TEST_F(CircularBufferTest, should_store_compact_records_and_materialize_observations)
+{
+  m_circularBuffer = make_unique<CircularBuffer>(4, 4, true);
+  ASSERT_TRUE(m_circularBuffer->isCompact());
+
+  addSomeObservations();
+
+  entity::ErrorList errors;
+  Timestamp time = Timestamp(date::sys_days(2021_y / jan / 19_d)) + 10h + 2min;
+  for (int i = 0; i < 12; i++)
+  {
+    auto obs = Observation::make(m_dataItem2, {{"VALUE", double(i)}}, time, errors);
+    m_circularBuffer->addToBuffer(obs);
+  }
+
+  ASSERT_EQ(19, m_circularBuffer->getSequence());
+  ASSERT_EQ(3, m_circularBuffer->getFirstSequence());
+
+  std::optional<SequenceNumber_t> start {3}, stop;
+  SequenceNumber_t first, end;
+  bool eob = false;
+  FilterSetOpt opt;
+  auto list {m_circularBuffer->getObservations(100, opt, start, stop, end, first, eob)};
+
+  ASSERT_EQ(16, list->size());
+  ASSERT_EQ(3, first);
+  ASSERT_EQ(19, end);
+  ASSERT_TRUE(eob);
+
+  auto it = list->begin();
+  auto normal = *it++;
+  ASSERT_EQ(3, normal->getSequence());
+  ASSERT_EQ(Condition::NORMAL, Cond(normal)->getLevel());
+
+  ++it;
+  auto value = *it++;
+  ASSERT_EQ(5, value->getSequence());
+  ASSERT_EQ(m_dataItem2, value->getDataItem());
+  ASSERT_EQ(123.0, value->getValue<double>());
+
+  auto last = list->back();
+  ASSERT_EQ(18, last->getSequence());
+  ASSERT_EQ(11.0, last->getValue<double>());
+  ASSERT_EQ(time, last->getTimestamp());
+  ASSERT_EQ("Position", last->getName());
+
+  auto check = m_circularBuffer->getCheckpointAt(10, opt);
+  ObservationList observations;
+  check->getObservations(observations);
+  ASSERT_EQ(2, observations.size());
+}
+
+TEST_F(CircularBufferTest, should_skip_orphaned_compact_observations)
+{
+  m_circularBuffer = make_unique<CircularBuffer>(4, 4, true);
+  addSomeObservations();
+
+  m_dataItem2.reset();
+  ASSERT_TRUE(m_device->removeFromList("Components", m_comp2));
+  m_comp2.reset();
+
+  std::optional<SequenceNumber_t> start {1}, stop;
+  SequenceNumber_t first, end;
+  bool eob = false;
+  FilterSetOpt opt;
+  auto list {m_circularBuffer->getObservations(100, opt, start, stop, end, first, eob)};
+
+  ASSERT_EQ(4, list->size());
+  ASSERT_EQ(7, end);
+}
+
+TEST_F(CircularBufferTest, should_rebind_buffered_observations_to_replacement_data_item)
+{
+  for (auto compact : {false, true})
+  {
+    SetUp();
+    m_circularBuffer = make_unique<CircularBuffer>(4, 4, compact);
+    addSomeObservations();
+
+    // Replace Comp2 and its data item with new entities using the same ids
+    ErrorList errors;
+    auto comp = Component::make("Comp2", {{"id", "3"s}, {"name", "Comp2"s}}, errors);
+    auto replacement = DataItem::make({{"id", "3"s},
+                                       {"type", "POSITION"s},
+                                       {"category", "SAMPLE"s},
+                                       {"name", "DataItemTest3"s},
+                                       {"subType", "ACTUAL"s},
+                                       {"units", "MILLIMETER"s},
+                                       {"nativeUnits", "MILLIMETER"s}},
+                                      errors);
+    comp->addDataItem(replacement, errors);
+    replacement->rebind(*m_dataItem2);
+
+    ASSERT_TRUE(m_device->removeFromList("Components", m_comp2));
+    m_comp2.reset();
+    m_dataItem2.reset();
+
+    std::optional<SequenceNumber_t> start {1}, stop;
+    SequenceNumber_t first, end;
+    bool eob = false;
+    FilterSetOpt opt;
+    auto list {m_circularBuffer->getObservations(100, opt, start, stop, end, first, eob)};
+
+    ASSERT_EQ(6, list->size()) << (compact ? "compact" : "observation") << " buffer";
+    auto last = list->back();
+    ASSERT_EQ(6, last->getSequence());
+    ASSERT_EQ(replacement, last->getDataItem());
+
+    auto latest = m_circularBuffer->getLatest().getObservation("3");
+    ASSERT_TRUE(latest);
+    ASSERT_FALSE(latest->isOrphan());
+    ASSERT_EQ(replacement, latest->getDataItem());
+  }
+}
@@ -28,6 +28,8 @@ class MTConnectAgentTest(ConanFile):
             tc.cache_variables['SHARED_AGENT_LIB'] = True
         if agent_options.with_ruby:
             tc.cache_variables['WITH_RUBY'] = True
+        if agent_options.with_python:
+            tc.cache_variables['WITH_PYTHON'] = True
         
         tc.generate()
         
@@ -0,0 +1,146 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+// Ensure that gtest is the first header otherwise Windows raises an error
+#include <gtest/gtest.h>
+// Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mtconnect/observation/condition_table.hpp"
+#include "mtconnect/observation/observation.hpp"
+
+using namespace std;
+using namespace mtconnect;
+using namespace mtconnect::observation;
+
+// main
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+class ConditionTableTest : public testing::Test
+{
+protected:
+  static ConditionPtr condition(const string &code)
+  {
+    return make_shared<Condition>("Fault"s, entity::Properties {{"nativeCode", code}});
+  }
+
+  static vector<string> codes(const ConditionTable &table)
+  {
+    ConditionList list;
+    table.getConditionList(list);
+    vector<string> result;
+    for (auto &c : list)
+      result.push_back(c->get<string>("nativeCode"));
+    return result;
+  }
+};
+
+TEST_F(ConditionTableTest, should_find_conditions_by_code)
+{
+  ConditionTable table;
+  EXPECT_TRUE(table.empty());
+  EXPECT_FALSE(table.find("A"));
+  EXPECT_FALSE(table.newest());
+
+  auto a = condition("A");
+  auto b = condition("B");
+  table.set("B", b);
+  table.set("A", a);
+
+  EXPECT_FALSE(table.empty());
+  EXPECT_EQ(2, table.size());
+  EXPECT_EQ(a, table.find("A"));
+  EXPECT_EQ(b, table.find("B"));
+  EXPECT_FALSE(table.find("C"));
+  EXPECT_EQ(a, table.newest());
+}
+
+TEST_F(ConditionTableTest, should_list_conditions_in_activation_order)
+{
+  ConditionTable table;
+  vector<string> order;
+  for (int i = 0; i < 200; i++)
+    order.push_back("CODE" + to_string((i * 37) % 200));
+
+  for (auto &code : order)
+    table.set(code, condition(code));
+  EXPECT_EQ(200, table.size());
+  EXPECT_EQ(order, codes(table));
+
+  // Reactivating a code moves it to the end
+  table.set(order[10], condition(order[10]));
+  auto code = order[10];
+  order.erase(order.begin() + 10);
+  order.push_back(code);
+  EXPECT_EQ(200, table.size());
+  EXPECT_EQ(order, codes(table));
+  EXPECT_EQ(code, table.newest()->get<string>("nativeCode"));
+}
+
+TEST_F(ConditionTableTest, should_clear_codes_and_find_the_newest_remaining)
+{
+  ConditionTable table;
+  vector<string> order;
+  for (int i = 0; i < 500; i++)
+  {
+    order.push_back("C" + to_string(i));
+    table.set(order.back(), condition(order.back()));
+  }
+
+  mt19937 gen(42);
+  shuffle(order.begin(), order.end(), gen);
+  vector<string> cleared(order.begin(), order.begin() + 400);
+  for (auto &code : cleared)
+    EXPECT_TRUE(table.erase(code));
+  EXPECT_FALSE(table.erase(cleared.front()));
+  EXPECT_EQ(100, table.size());
+
+  for (auto &code : cleared)
+    EXPECT_FALSE(table.find(code));
+
+  vector<string> remaining(order.begin() + 400, order.end());
+  sort(remaining.begin(), remaining.end(),
+       [](const string &a, const string &b) { return stoi(a.substr(1)) < stoi(b.substr(1)); });
+  EXPECT_EQ(remaining, codes(table));
+  EXPECT_EQ(remaining.back(), table.newest()->get<string>("nativeCode"));
+}
+
+TEST_F(ConditionTableTest, should_not_change_copies_of_a_table)
+{
+  ConditionTable table;
+  for (auto code : {"A", "B", "C", "D"})
+    table.set(code, condition(code));
+
+  auto copy = table;
+  copy.erase("B");
+  copy.set("E", condition("E"));
+  copy.set("A", condition("A"));
+
+  EXPECT_EQ((vector<string> {"A", "B", "C", "D"}), codes(table));
+  EXPECT_EQ((vector<string> {"C", "D", "E", "A"}), codes(copy));
+  EXPECT_NE(table.find("A"), copy.find("A"));
+  EXPECT_EQ(table.find("C"), copy.find("C"));
+}
@@ -1265,6 +1265,92 @@ Port = 0
     th.join();
   }
 
+  TEST_F(ConfigTest, should_only_restart_changed_adapters_and_sinks_when_config_changes)
+  {
+    string config(R"DOC(
+Port = 0
+Adapters {
+  First {
+    Host = 127.0.0.1
+    Port = 7878
+  }
+  Second {
+    Host = 127.0.0.1
+    Port = 7879
+  }
+}
+)DOC");
+
+    m_config->loadConfig(config);
+
+    auto agent = m_config->getAgent();
+    ASSERT_TRUE(agent);
+    auto rest = dynamic_pointer_cast<sink::rest_sink::RestService>(agent->findSink("RestService"));
+    ASSERT_TRUE(rest);
+    auto instance = rest->instanceId();
+
+    auto first = agent->findSource("shdr://127.0.0.1:7878");
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(agent->findSource("shdr://127.0.0.1:7879"));
+    auto count = agent->getSources().size();
+
+    // Change the second adapter and add a third
+    string changed(R"DOC(
+Port = 0
+Adapters {
+  First {
+    Host = 127.0.0.1
+    Port = 7878
+  }
+  Second {
+    Host = 127.0.0.1
+    Port = 7880
+  }
+  Third {
+    Host = 127.0.0.1
+    Port = 7881
+  }
+}
+)DOC");
+
+    ASSERT_TRUE(m_config->updateConfig(changed));
+    ASSERT_EQ(agent, m_config->getAgent());
+    ASSERT_EQ(instance, rest->instanceId());
+    ASSERT_EQ(count + 1, agent->getSources().size());
+
+    ASSERT_EQ(first, agent->findSource("shdr://127.0.0.1:7878"));
+    ASSERT_FALSE(agent->findSource("shdr://127.0.0.1:7879"));
+    ASSERT_TRUE(agent->findSource("shdr://127.0.0.1:7880"));
+    ASSERT_TRUE(agent->findSource("shdr://127.0.0.1:7881"));
+
+    auto third =
+        dynamic_pointer_cast<source::adapter::Adapter>(agent->findSource("shdr://127.0.0.1:7881"));
+    auto status = third->getIdentity() + "_connection_status";
+    ASSERT_TRUE(agent->getAgentDevice()->getDeviceDataItem(status));
+    ASSERT_TRUE(agent->getDataItemById(status));
+
+    // Remove the third adapter and restore the second
+    ASSERT_TRUE(m_config->updateConfig(config));
+    ASSERT_EQ(count, agent->getSources().size());
+    ASSERT_TRUE(agent->findSource("shdr://127.0.0.1:7879"));
+    ASSERT_FALSE(agent->findSource("shdr://127.0.0.1:7881"));
+
+    // The removed adapter is no longer in the agent device
+    ASSERT_FALSE(agent->getAgentDevice()->getDeviceDataItem(status));
+    ASSERT_FALSE(agent->getDataItemById(status));
+    auto probe = agent->getPrinter("xml")->printProbe(0, 0, 0, 0, 0, agent->getDevices());
+    ASSERT_EQ(string::npos, probe.find(status));
+    auto adapters = agent->getAgentDevice()->getAdapters()->getChildren();
+    ASSERT_TRUE(adapters);
+    ASSERT_EQ(2, adapters->size());
+
+    // A change to the top level options requires a restart
+    ASSERT_FALSE(m_config->updateConfig("BufferSize = 10\n" + config));
+
+    // As does a configuration that has not changed
+    ASSERT_FALSE(m_config->updateConfig(config));
+  }
+
   TEST_F(ConfigTest, should_reload_device_xml_and_add_new_devices)
   {
     fs::path root {createTempDirectory("4")};
@@ -595,3 +595,48 @@ TEST_F(ConnectorTest, should_override_adapter_heartbeat_in_pong)
   ASSERT_TRUE(m_connector->heartbeats());
   ASSERT_EQ(std::chrono::milliseconds {123}, m_connector->heartbeatFrequency());
 }
+
+#if defined(BOOST_ASIO_HAS_IO_URING)
+/// @test a registered buffer returns to the pool when its last reference is released
+TEST_F(ConnectorTest, should_keep_a_registered_buffer_until_the_read_releases_it)
+{
+  auto &buffers = asio::use_service<ReceiveBuffers>(m_context);
+  auto lease = buffers.acquire();
+  if (!lease)
+    GTEST_SKIP() << "Cannot register buffers, check the locked memory limit";
+
+  auto available = buffers.available();
+  EXPECT_EQ(ReceiveBuffers::BufferCount - 1, available);
+
+  // An outstanding read holds a reference after the connector releases its own
+  auto read = lease;
+  lease.reset();
+  EXPECT_EQ(available, buffers.available());
+
+  read.reset();
+  EXPECT_EQ(available + 1, buffers.available());
+}
+
+/// @test destroying a connector does not return the buffer while its read is outstanding
+TEST_F(ConnectorTest, should_not_release_the_receive_buffer_of_a_pending_read)
+{
+  auto &buffers = asio::use_service<ReceiveBuffers>(m_context);
+
+  startServer();
+  m_connector->start(m_port);
+  runUntil(2s, [this]() -> bool { return m_connected && m_connector->isConnected(); });
+
+  auto available = buffers.available();
+  if (available == 0)
+    GTEST_SKIP() << "Cannot register buffers, check the locked memory limit";
+  EXPECT_EQ(ReceiveBuffers::BufferCount - 1, available);
+
+  // The read is cancelled, but the kernel owns the buffer until it completes
+  m_connector.reset();
+  EXPECT_EQ(available, buffers.available());
+
+  // The aborted read completes and returns the buffer without touching the connector
+  m_context.run_for(2ms);
+  EXPECT_EQ(available + 1, buffers.available());
+}
+#endif
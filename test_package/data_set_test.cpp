@@ -201,6 +201,21 @@ TEST_F(DataSetTest, parser_with_partial_number)
   ASSERT_EQ(4.56, get<double>(set.find("d"_E)->m_value));
 }
 
+TEST_F(DataSetTest, parser_with_signed_and_exponent_numbers)
+{
+  DataSet set;
+  ASSERT_TRUE(
+      set.parse(" a=+5\tb=-3.25 c=1.5e3 d=x=y e=99999999999999999999 f=-12 g=abc  ", false));
+  ASSERT_EQ(7, set.size());
+  ASSERT_EQ(5, get<int64_t>(set.find("a"_E)->m_value));
+  ASSERT_EQ(-3.25, get<double>(set.find("b"_E)->m_value));
+  ASSERT_EQ(1500.0, get<double>(set.find("c"_E)->m_value));
+  ASSERT_EQ("x=y", get<string>(set.find("d"_E)->m_value));
+  ASSERT_EQ("99999999999999999999", get<string>(set.find("e"_E)->m_value));
+  ASSERT_EQ(-12, get<int64_t>(set.find("f"_E)->m_value));
+  ASSERT_EQ("abc", get<string>(set.find("g"_E)->m_value));
+}
+
 TEST_F(DataSetTest, UpdateOneElement)
 {
   ErrorList errors;
@@ -248,9 +248,10 @@ TEST_F(DuplicateFilterTest, test_condition_duplicates)
     ASSERT_TRUE(cond);
     ASSERT_EQ("YYY", cond->get<string>("nativeCode"));
     ASSERT_EQ(Condition::WARNING, cond->getLevel());
-    auto prev = cond->getPrev();
-    ASSERT_TRUE(prev);
-    ASSERT_FALSE(prev->getPrev());
+    ConditionList active;
+    cond->getConditionList(active);
+    ASSERT_EQ(2, active.size());
+    auto prev = active.front();
     ASSERT_EQ("XXX", prev->get<string>("nativeCode"));
     ASSERT_EQ("100", prev->get<string>("nativeSeverity"));
   }
@@ -267,10 +268,10 @@ TEST_F(DuplicateFilterTest, test_condition_duplicates)
     ASSERT_EQ("101", cond->get<string>("nativeSeverity"));
     ASSERT_EQ("XXX", cond->get<string>("nativeCode"));
 
-    auto prev = cond->getPrev();
-    ASSERT_TRUE(prev);
-    ASSERT_EQ("YYY", prev->get<string>("nativeCode"));
-    ASSERT_FALSE(prev->getPrev());
+    ConditionList active;
+    cond->getConditionList(active);
+    ASSERT_EQ(2, active.size());
+    ASSERT_EQ("YYY", active.front()->get<string>("nativeCode"));
   }
 
   {
@@ -283,7 +284,7 @@ TEST_F(DuplicateFilterTest, test_condition_duplicates)
     auto cond = dynamic_pointer_cast<Condition>(obs);
     ASSERT_EQ("YYY", cond->get<string>("nativeCode"));
     ASSERT_TRUE(cond);
-    ASSERT_FALSE(cond->getPrev());
+    ASSERT_TRUE(cond->getActive().empty());
   }
 
   {
@@ -302,7 +303,7 @@ TEST_F(DuplicateFilterTest, test_condition_duplicates)
     auto cond = dynamic_pointer_cast<Condition>(obs);
     ASSERT_TRUE(cond);
     ASSERT_EQ(Condition::NORMAL, cond->getLevel());
-    ASSERT_FALSE(cond->getPrev());
+    ASSERT_TRUE(cond->getActive().empty());
   }
 
   {
@@ -471,6 +471,42 @@ TEST_F(EntityTest, TestRequirementVectorConversions)
   EXPECT_THROW(r6.convertType(v), PropertyError);
 }
 
+TEST_F(EntityTest, should_convert_a_1024_point_time_series)
+{
+  using namespace std::chrono;
+
+  string series;
+  for (int i = 0; i < 1024; i++)
+  {
+    if (i > 0)
+      series += (i % 16 == 0) ? "\t" : " ";
+    series += format(sin(i / 16.0) * 100.0);
+  }
+  series += " +1.5 -2e-3";
+
+  Requirement r1("vector", ValueType::VECTOR);
+  Value v;
+  auto start = high_resolution_clock::now();
+  for (int i = 0; i < 1000; i++)
+  {
+    v = series;
+    ASSERT_TRUE(r1.convertType(v));
+  }
+  auto delta = duration_cast<microseconds>(high_resolution_clock::now() - start);
+  cout << endl << "1024 point conversion " << (delta.count() / 1000.0) << "us" << endl << endl;
+
+  auto &vec = get<Vector>(v);
+  ASSERT_EQ(1026, vec.size());
+  ASSERT_EQ(1026, vec.capacity());
+  EXPECT_EQ(0.0, vec[0]);
+  EXPECT_NEAR(sin(1000 / 16.0) * 100.0, vec[1000], 0.0000001);
+  EXPECT_EQ(1.5, vec[1024]);
+  EXPECT_EQ(-0.002, vec[1025]);
+
+  v = "1.0 2.0 +-3.0"s;
+  EXPECT_THROW(r1.convertType(v), PropertyError);
+}
+
 TEST_F(EntityTest, TestRequirementUpperCaseStringConversion)
 {
   Value v("hello kitty"s);
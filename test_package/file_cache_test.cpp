@@ -135,14 +135,14 @@ TEST_F(FileCacheTest, file_cache_should_compress_file)
   ASSERT_TRUE(file);
   EXPECT_EQ("text/plain", file->m_mimeType);
   EXPECT_TRUE(file->m_cached);
-  EXPECT_FALSE(file->m_pathGz);
+  EXPECT_FALSE(file->getPathGz());
 
   auto gzFile = m_cache->getFile("/resources/zipped_file.txt", "gzip, deflate"s);
 
   ASSERT_TRUE(gzFile);
   EXPECT_EQ("text/plain", gzFile->m_mimeType);
   EXPECT_TRUE(gzFile->m_cached);
-  EXPECT_TRUE(gzFile->m_pathGz);
+  EXPECT_TRUE(gzFile->getPathGz());
 
   // Cleanup
   if (fs::exists(zipped))
@@ -174,7 +174,7 @@ TEST_F(FileCacheTest, file_cache_should_compress_file_async)
     ASSERT_TRUE(gzFile);
     EXPECT_EQ("text/plain", gzFile->m_mimeType);
     EXPECT_TRUE(gzFile->m_cached);
-    EXPECT_TRUE(gzFile->m_pathGz);
+    EXPECT_TRUE(gzFile->getPathGz());
 
     context.stop();
   });
@@ -221,11 +221,11 @@ TEST_F(FileCacheTest, file_cache_should_recompress_if_gzip_older_than_file)
   ASSERT_TRUE(gzFile);
   EXPECT_EQ("text/plain", gzFile->m_mimeType);
   EXPECT_TRUE(gzFile->m_cached);
-  EXPECT_TRUE(gzFile->m_pathGz);
+  EXPECT_TRUE(gzFile->getPathGz());
 
-  ASSERT_TRUE(fs::exists(*gzFile->m_pathGz));
+  ASSERT_TRUE(fs::exists(*gzFile->getPathGz()));
 
-  auto zipTime = fs::last_write_time(*gzFile->m_pathGz);
+  auto zipTime = fs::last_write_time(*gzFile->getPathGz());
   auto fileTime = fs::last_write_time(gzFile->m_path);
   ASSERT_GT(zipTime, fileTime);
 
@@ -235,7 +235,7 @@ TEST_F(FileCacheTest, file_cache_should_recompress_if_gzip_older_than_file)
   auto gzFile2 = m_cache->getFile("/resources/zipped_file.txt", "gzip, deflate"s);
   ASSERT_TRUE(gzFile2);
 
-  auto zipTime2 = fs::last_write_time(*gzFile2->m_pathGz);
+  auto zipTime2 = fs::last_write_time(*gzFile2->getPathGz());
   ASSERT_GT(zipTime2, zipTime);
 
   auto fileTime2 = fs::last_write_time(gzFile2->m_path);
@@ -249,7 +249,7 @@ TEST_F(FileCacheTest, file_cache_should_recompress_if_gzip_older_than_file)
   auto gzFile3 = m_cache->getFile("/resources/zipped_file.txt", "gzip, deflate"s);
   ASSERT_TRUE(gzFile3);
 
-  auto zipTime3 = fs::last_write_time(*gzFile3->m_pathGz);
+  auto zipTime3 = fs::last_write_time(*gzFile3->getPathGz());
   ASSERT_GT(zipTime3, zipTime2);
 
   auto fileTime3 = fs::last_write_time(gzFile3->m_path);
@@ -261,3 +261,37 @@ TEST_F(FileCacheTest, file_cache_should_recompress_if_gzip_older_than_file)
     fs::remove(zipped);
   }
 }
+
+TEST_F(FileCacheTest, file_cache_should_precompress_registered_files_in_the_background)
+{
+  namespace fs = std::filesystem;
+
+  // Cleanup
+  fs::path zipped(TEST_RESOURCE_DIR);
+  zipped /= "zipped_file.txt.gz";
+  if (fs::exists(zipped))
+  {
+    fs::remove(zipped);
+  }
+
+  m_cache->setMinCompressedFileSize(1024);
+  m_cache->setPrecompress(true);
+  m_cache->registerFile("/resources/zipped_file.txt", TEST_RESOURCE_DIR "/zipped_file.txt", "2.0");
+
+  for (int i = 0; i < 50 && !fs::exists(zipped); i++)
+    std::this_thread::sleep_for(100ms);
+  ASSERT_TRUE(fs::exists(zipped));
+
+  auto gzFile = m_cache->getFile("/resources/zipped_file.txt", "gzip, deflate"s);
+  ASSERT_TRUE(gzFile);
+  EXPECT_EQ("text/plain", gzFile->m_mimeType);
+  ASSERT_TRUE(gzFile->getPathGz());
+  EXPECT_EQ(zipped, *gzFile->getPathGz());
+
+  // Cleanup
+  m_cache.reset();
+  if (fs::exists(zipped))
+  {
+    fs::remove(zipped);
+  }
+}
@@ -0,0 +1,576 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+// Ensure that gtest is the first header otherwise Windows raises an error
+#include <gtest/gtest.h>
+// Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#ifdef AGENT_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+#include "agent_test_helper.hpp"
+#include "mtconnect/sink/historian_sink/arrow_ipc.hpp"
+#include "mtconnect/sink/historian_sink/historian_sink.hpp"
+
+using namespace std;
+using namespace std::chrono_literals;
+using namespace mtconnect;
+using namespace mtconnect::sink::historian_sink;
+namespace fs = std::filesystem;
+
+// main
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+/// @brief Decodes an Arrow IPC file using the layout in Schema.fbs, Message.fbs and File.fbs
+///
+/// Independent of the writer so the flatbuffer metadata is checked against the format.
+class ArrowFileReader
+{
+public:
+  struct Field
+  {
+    string m_name;
+    bool m_nullable;
+    uint8_t m_type;
+    bool m_dictionary;
+  };
+
+  struct Batch
+  {
+    int64_t m_length;
+    vector<pair<int64_t, int64_t>> m_nodes;
+    vector<string> m_buffers;
+  };
+
+  ArrowFileReader(string data) : m_data(std::move(data))
+  {
+    if (m_data.size() < 18 || m_data.compare(0, 8, string("ARROW1\0\0", 8)) != 0 ||
+        m_data.compare(m_data.size() - 6, 6, "ARROW1") != 0)
+      throw runtime_error("Not an Arrow file");
+
+    auto footerLength = read<int32_t>(m_data.size() - 10);
+    auto footer = root(m_data.size() - 10 - footerLength);
+
+    auto schema = table(footer, 1);
+    auto fields = vectorAt(schema, 1);
+    for (uint32_t i = 0; i < read<uint32_t>(fields); i++)
+    {
+      auto field = element(fields, i);
+      m_fields.push_back({string(stringAt(field, 0)), scalar<uint8_t>(field, 1) != 0,
+                          scalar<uint8_t>(field, 2), offset(field, 4) != 0});
+    }
+    auto metadata = vectorAt(schema, 2);
+    for (uint32_t i = 0; i < read<uint32_t>(metadata); i++)
+    {
+      auto pair = element(metadata, i);
+      m_metadata.emplace(stringAt(pair, 0), stringAt(pair, 1));
+    }
+
+    for (auto block : blocks(footer, 2))
+    {
+      auto [header, body] = message(block, 2);
+      m_dictionaries.emplace(scalar<int64_t>(header, 0), batch(table(header, 1), body));
+    }
+    for (auto block : blocks(footer, 3))
+    {
+      auto [header, body] = message(block, 3);
+      m_batches.push_back(batch(header, body));
+    }
+  }
+
+  /// @brief get the strings of a utf8 column or dictionary
+  static vector<string> strings(const Batch &batch, size_t buffer)
+  {
+    vector<string> values;
+    auto &offsets = batch.m_buffers[buffer + 1];
+    for (int64_t i = 0; i < batch.m_length; i++)
+    {
+      int32_t range[2];
+      memcpy(range, offsets.data() + i * sizeof(int32_t), sizeof(range));
+      values.push_back(batch.m_buffers[buffer + 2].substr(range[0], range[1] - range[0]));
+    }
+    return values;
+  }
+
+  template <typename T>
+  static vector<T> values(const Batch &batch, size_t buffer)
+  {
+    vector<T> values(batch.m_length);
+    memcpy(values.data(), batch.m_buffers[buffer + 1].data(), values.size() * sizeof(T));
+    return values;
+  }
+
+  static bool bit(const string &bits, int64_t i) { return (bits[i / 8] >> (i % 8)) & 1; }
+  /// @brief an empty validity buffer means all values are valid
+  static bool valid(const string &validity, int64_t i)
+  {
+    return validity.empty() || bit(validity, i);
+  }
+
+  vector<Field> m_fields;
+  map<string, string> m_metadata;
+  map<int64_t, Batch> m_dictionaries;
+  vector<Batch> m_batches;
+
+protected:
+  template <typename T>
+  T read(size_t pos) const
+  {
+    if (pos + sizeof(T) > m_data.size())
+      throw runtime_error("Read past the end of the file");
+    T value;
+    memcpy(&value, m_data.data() + pos, sizeof(T));
+    return value;
+  }
+
+  size_t root(size_t buffer) const { return buffer + read<uint32_t>(buffer); }
+
+  /// @brief the position of a field of a table or 0 if it is not present
+  size_t offset(size_t table, uint16_t slot) const
+  {
+    auto vtable = table - read<int32_t>(table);
+    auto entry = 4 + slot * sizeof(uint16_t);
+    if (entry >= read<uint16_t>(vtable))
+      return 0;
+    auto field = read<uint16_t>(vtable + entry);
+    return field == 0 ? 0 : table + field;
+  }
+  template <typename T>
+  T scalar(size_t table, uint16_t slot) const
+  {
+    auto pos = offset(table, slot);
+    return pos == 0 ? T(0) : read<T>(pos);
+  }
+  size_t indirect(size_t pos) const { return pos + read<uint32_t>(pos); }
+  size_t table(size_t table, uint16_t slot) const
+  {
+    auto pos = offset(table, slot);
+    if (pos == 0)
+      throw runtime_error("Missing table");
+    return indirect(pos);
+  }
+  size_t vectorAt(size_t parent, uint16_t slot) const { return table(parent, slot); }
+  size_t element(size_t vector, uint32_t i) const { return indirect(vector + 4 + i * 4); }
+  string_view stringAt(size_t parent, uint16_t slot) const
+  {
+    auto pos = table(parent, slot);
+    return string_view(m_data).substr(pos + 4, read<uint32_t>(pos));
+  }
+
+  /// @brief the offset and metadata length of the blocks in the footer
+  vector<pair<int64_t, int32_t>> blocks(size_t footer, uint16_t slot) const
+  {
+    vector<pair<int64_t, int32_t>> result;
+    auto vector = vectorAt(footer, slot);
+    for (uint32_t i = 0; i < read<uint32_t>(vector); i++)
+    {
+      auto block = vector + 4 + i * 24;
+      result.emplace_back(read<int64_t>(block), read<int32_t>(block + 8));
+    }
+    return result;
+  }
+
+  /// @brief the header table and body position of a message
+  pair<size_t, size_t> message(pair<int64_t, int32_t> block, uint8_t headerType) const
+  {
+    if (read<int32_t>(block.first) != -1)
+      throw runtime_error("Missing continuation marker");
+    auto message = root(block.first + 8);
+    if (scalar<int16_t>(message, 0) != 4 || scalar<uint8_t>(message, 1) != headerType)
+      throw runtime_error("Unexpected message");
+    return {table(message, 2), size_t(block.first + block.second)};
+  }
+
+  Batch batch(size_t header, size_t body) const
+  {
+    Batch batch {scalar<int64_t>(header, 0), {}, {}};
+    auto compressed = offset(header, 3) != 0;
+    if (compressed && scalar<int8_t>(table(header, 3), 0) != 1)
+      throw runtime_error("Unknown codec");
+
+    auto nodes = vectorAt(header, 1);
+    for (uint32_t i = 0; i < read<uint32_t>(nodes); i++)
+      batch.m_nodes.emplace_back(read<int64_t>(nodes + 4 + i * 16),
+                                 read<int64_t>(nodes + 12 + i * 16));
+
+    auto buffers = vectorAt(header, 2);
+    for (uint32_t i = 0; i < read<uint32_t>(buffers); i++)
+    {
+      auto start = body + read<int64_t>(buffers + 4 + i * 16);
+      auto length = size_t(read<int64_t>(buffers + 12 + i * 16));
+      if (start + length > m_data.size())
+        throw runtime_error("Buffer past the end of the file");
+      auto data = m_data.substr(start, length);
+      if (compressed && length > 0)
+      {
+        auto uncompressed = read<int64_t>(start);
+        data.erase(0, sizeof(int64_t));
+        if (uncompressed >= 0)
+        {
+#ifdef AGENT_WITH_ZSTD
+          string buffer(uncompressed, '\0');
+          auto size = ZSTD_decompress(buffer.data(), buffer.size(), data.data(), data.size());
+          if (ZSTD_isError(size) || size != buffer.size())
+            throw runtime_error("Cannot decompress buffer");
+          data = std::move(buffer);
+#else
+          throw runtime_error("Compressed buffer without zstd");
+#endif
+        }
+      }
+      batch.m_buffers.push_back(std::move(data));
+    }
+    return batch;
+  }
+
+protected:
+  string m_data;
+};
+
+class HistorianSinkTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_directory = fs::temp_directory_path() / "mtconnect_historian_test";
+    fs::remove_all(m_directory);
+  }
+
+  void TearDown() override
+  {
+    m_sink.reset();
+    m_agentTestHelper.reset();
+    fs::remove_all(m_directory);
+  }
+
+  void createAgent(map<string, string> options = {})
+  {
+    m_agentTestHelper = make_unique<AgentTestHelper>();
+    AgentTestHelper::Hook hook = [this, options](AgentTestHelper &helper) {
+      boost::property_tree::ptree block;
+      block.put(configuration::HistorianPath, m_directory.string());
+      block.put(configuration::HistorianCompression, "none");
+      for (auto &[key, value] : options)
+        block.put(key, value);
+      auto contract = helper.getAgent()->makeSinkContract();
+      m_sink = make_shared<HistorianSink>(helper.m_ioContext, std::move(contract),
+                                          ConfigOptions {}, block);
+      helper.getAgent()->addSink(m_sink);
+    };
+    m_agentTestHelper->setAgentCreateHook(hook);
+    m_agentTestHelper->createAgent("/samples/test_config.xml", 8, 4, "2.0", 25, false, true);
+  }
+
+  void addObservation(const string &id, const entity::Properties &properties)
+  {
+    auto agent = m_agentTestHelper->getAgent();
+    m_agentTestHelper->addToBuffer(agent->getDataItemById(id), properties,
+                                   chrono::system_clock::now());
+  }
+
+  vector<fs::path> files(const string &uuid)
+  {
+    vector<fs::path> paths;
+    for (auto &entry : fs::directory_iterator(m_directory / uuid))
+      paths.push_back(entry.path());
+    sort(paths.begin(), paths.end());
+    return paths;
+  }
+
+  static string contents(const fs::path &path)
+  {
+    ifstream file(path, ios::binary);
+    stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+  }
+
+  void shouldReadBackAllColumnTypes(arrow::Compression compression)
+  {
+    fs::create_directories(m_directory);
+    auto path = m_directory / "types.arrow";
+    arrow::FileWriter writer(
+        {{"timestamp", arrow::ColumnType::TIMESTAMP},
+         {"sequence", arrow::ColumnType::UINT64},
+         {"id", arrow::ColumnType::DICTIONARY},
+         {"value", arrow::ColumnType::DOUBLE, true},
+         {"text", arrow::ColumnType::UTF8, true},
+         {"flag", arrow::ColumnType::BOOL}},
+        {{"mtconnect.device.uuid", "000"}}, compression);
+    writer.open(path, {{"a", "b", "c"}});
+
+    vector<arrow::ColumnData> batch {arrow::ColumnType::TIMESTAMP, arrow::ColumnType::UINT64,
+                                     arrow::ColumnType::DICTIONARY, arrow::ColumnType::DOUBLE,
+                                     arrow::ColumnType::UTF8,       arrow::ColumnType::BOOL};
+    auto append = [&batch](int i) {
+      batch[0].appendInteger(1'700'000'000'000'000 + i);
+      batch[1].appendInteger(i);
+      batch[2].appendInteger(i % 3);
+      if (i % 7 == 0)
+        batch[3].appendNull();
+      else
+        batch[3].appendDouble(i * 0.5);
+      if (i % 5 == 0)
+        batch[4].appendNull();
+      else
+        batch[4].appendString("t" + to_string(i));
+      batch[5].appendBool(i % 2 == 0);
+    };
+
+    for (int i = 0; i < 100; i++)
+      append(i);
+    writer.write(batch);
+    for (auto &column : batch)
+      column.clear();
+    for (int i = 100; i < 105; i++)
+      append(i);
+    writer.write(batch);
+    writer.close();
+
+    ArrowFileReader reader(contents(path));
+
+    ASSERT_EQ(6, reader.m_fields.size());
+    vector<tuple<string, bool, uint8_t, bool>> fields;
+    for (auto &field : reader.m_fields)
+      fields.emplace_back(field.m_name, field.m_nullable, field.m_type, field.m_dictionary);
+    // Type ids from Schema.fbs: Int = 2, FloatingPoint = 3, Utf8 = 5, Bool = 6, Timestamp = 10
+    EXPECT_EQ((vector<tuple<string, bool, uint8_t, bool>> {{"timestamp", false, 10, false},
+                                                          {"sequence", false, 2, false},
+                                                          {"id", false, 5, true},
+                                                          {"value", true, 3, false},
+                                                          {"text", true, 5, false},
+                                                          {"flag", false, 6, false}}),
+              fields);
+    EXPECT_EQ("000", reader.m_metadata["mtconnect.device.uuid"]);
+
+    ASSERT_EQ(1, reader.m_dictionaries.size());
+    ASSERT_EQ(1, reader.m_dictionaries.count(2));
+    EXPECT_EQ((vector<string> {"a", "b", "c"}),
+              ArrowFileReader::strings(reader.m_dictionaries[2], 0));
+
+    ASSERT_EQ(2, reader.m_batches.size());
+    int i = 0;
+    for (auto &batch : reader.m_batches)
+    {
+      ASSERT_EQ(13, batch.m_buffers.size());
+      ASSERT_EQ(6, batch.m_nodes.size());
+      auto timestamps = ArrowFileReader::values<int64_t>(batch, 0);
+      auto sequences = ArrowFileReader::values<uint64_t>(batch, 2);
+      auto ids = ArrowFileReader::values<int32_t>(batch, 4);
+      auto numbers = ArrowFileReader::values<double>(batch, 6);
+      auto texts = ArrowFileReader::strings(batch, 8);
+      auto &flags = batch.m_buffers[12];
+
+      for (int64_t row = 0; row < batch.m_length; row++, i++)
+      {
+        EXPECT_EQ(1'700'000'000'000'000 + i, timestamps[row]);
+        EXPECT_EQ(uint64_t(i), sequences[row]);
+        EXPECT_EQ(i % 3, ids[row]);
+        EXPECT_EQ(i % 7 != 0, ArrowFileReader::valid(batch.m_buffers[6], row));
+        if (i % 7 != 0)
+        {
+          EXPECT_EQ(i * 0.5, numbers[row]);
+        }
+        EXPECT_EQ(i % 5 != 0, ArrowFileReader::valid(batch.m_buffers[8], row));
+        if (i % 5 != 0)
+        {
+          EXPECT_EQ("t" + to_string(i), texts[row]);
+        }
+        EXPECT_EQ(i % 2 == 0, ArrowFileReader::bit(flags, row));
+      }
+
+      // Columns without nulls have no validity buffer
+      EXPECT_TRUE(batch.m_buffers[0].empty());
+      EXPECT_EQ(0, batch.m_nodes[0].second);
+      EXPECT_EQ(batch.m_length, batch.m_nodes[3].first);
+      EXPECT_EQ(batch.m_length == 100 ? 15 : 0, batch.m_nodes[3].second);
+      EXPECT_EQ(batch.m_length == 100 ? 20 : 1, batch.m_nodes[4].second);
+    }
+    EXPECT_EQ(105, i);
+  }
+
+  fs::path m_directory;
+  unique_ptr<AgentTestHelper> m_agentTestHelper;
+  shared_ptr<HistorianSink> m_sink;
+};
+
+TEST_F(HistorianSinkTest, should_pack_validity_and_offsets_of_columns)
+{
+  arrow::ColumnData text(arrow::ColumnType::UTF8);
+  text.appendString("a");
+  text.appendNull();
+  text.appendString("bc");
+
+  vector<string> buffers;
+  text.getBuffers(buffers);
+  ASSERT_EQ(3, buffers.size());
+  EXPECT_EQ(string(1, '\x05'), buffers[0]);
+  vector<int32_t> offsets(4);
+  ASSERT_EQ(offsets.size() * sizeof(int32_t), buffers[1].size());
+  memcpy(offsets.data(), buffers[1].data(), buffers[1].size());
+  EXPECT_EQ((vector<int32_t> {0, 1, 1, 3}), offsets);
+  EXPECT_EQ("abc", buffers[2]);
+
+  arrow::ColumnData flags(arrow::ColumnType::BOOL);
+  for (int i = 0; i < 10; i++)
+    flags.appendBool(i % 3 == 0);
+  buffers.clear();
+  flags.getBuffers(buffers);
+  ASSERT_EQ(2, buffers.size());
+  EXPECT_TRUE(buffers[0].empty());
+  EXPECT_EQ(string("\x49\x02", 2), buffers[1]);
+}
+
+TEST_F(HistorianSinkTest, should_write_a_complete_arrow_file)
+{
+  fs::create_directories(m_directory);
+  auto path = m_directory / "test.arrow";
+  arrow::FileWriter writer({{"id", arrow::ColumnType::DICTIONARY},
+                            {"value", arrow::ColumnType::DOUBLE, true}},
+                           {{"key", "value"}}, arrow::Compression::ZSTD);
+  writer.open(path, {{"a", "b"}});
+  ASSERT_TRUE(fs::exists(path.string() + ".tmp"));
+
+  vector<arrow::ColumnData> batch {arrow::ColumnType::DICTIONARY, arrow::ColumnType::DOUBLE};
+  for (int i = 0; i < 1000; i++)
+  {
+    batch[0].appendInteger(i % 2);
+    batch[1].appendDouble(i);
+  }
+  writer.write(batch);
+  writer.close();
+
+  ASSERT_FALSE(fs::exists(path.string() + ".tmp"));
+  auto data = contents(path);
+  ASSERT_EQ(writer.getSize(), data.size());
+  EXPECT_EQ(string("ARROW1\0\0", 8), data.substr(0, 8));
+  EXPECT_EQ("ARROW1", data.substr(data.size() - 6));
+
+  int32_t footer;
+  memcpy(&footer, data.data() + data.size() - 10, sizeof(footer));
+  EXPECT_EQ(0, footer % 8);
+  EXPECT_LT(size_t(footer), data.size());
+
+#ifdef AGENT_WITH_ZSTD
+  // The values are compressed
+  EXPECT_LT(data.size(), 1000 * sizeof(double));
+#else
+  EXPECT_GT(data.size(), 1000 * sizeof(double));
+#endif
+}
+
+TEST_F(HistorianSinkTest, should_read_back_an_uncompressed_file)
+{
+  shouldReadBackAllColumnTypes(arrow::Compression::NONE);
+}
+
+#ifdef AGENT_WITH_ZSTD
+TEST_F(HistorianSinkTest, should_read_back_a_zstd_compressed_file)
+{
+  shouldReadBackAllColumnTypes(arrow::Compression::ZSTD);
+}
+#endif
+
+TEST_F(HistorianSinkTest, should_write_observations_of_a_device)
+{
+  createAgent();
+  m_sink->start();
+
+  addObservation("x1", {{"VALUE", 12.5}});
+  addObservation("p4", {{"VALUE", "PROGRAM_1"s}});
+  addObservation("clc", {{"level", "FAULT"s}, {"nativeCode", "OVER"s}, {"VALUE", "Overload"s}});
+  addObservation("p3", {{"VALUE", "UNAVAILABLE"s}});
+
+  m_sink->flush();
+  m_sink->closeFiles();
+
+  auto paths = files("000");
+  ASSERT_EQ(1, paths.size());
+  EXPECT_EQ(".arrow", paths[0].extension());
+
+  auto data = contents(paths[0]);
+  EXPECT_NE(string::npos, data.find("PROGRAM_1"));
+  EXPECT_NE(string::npos, data.find("Overload"));
+  EXPECT_NE(string::npos, data.find("OVER"));
+  EXPECT_NE(string::npos, data.find("FAULT"));
+  EXPECT_NE(string::npos, data.find("mtconnect.device.uuid"));
+
+  double value = 12.5;
+  EXPECT_NE(string::npos, data.find(string(reinterpret_cast<const char *>(&value), 8)));
+
+  ArrowFileReader reader(data);
+  vector<string> names;
+  for (auto &field : reader.m_fields)
+    names.push_back(field.m_name);
+  EXPECT_EQ((vector<string> {"timestamp", "sequence", "data_item_id", "number", "text",
+                             "condition_level", "native_code", "unavailable"}),
+            names);
+  EXPECT_EQ("000", reader.m_metadata["mtconnect.device.uuid"]);
+  ASSERT_FALSE(reader.m_batches.empty());
+  vector<string> texts;
+  for (auto &batch : reader.m_batches)
+  {
+    auto values = ArrowFileReader::strings(batch, 8);
+    texts.insert(texts.end(), values.begin(), values.end());
+  }
+  EXPECT_NE(texts.end(), find(texts.begin(), texts.end(), "PROGRAM_1"));
+  EXPECT_NE(texts.end(), find(texts.begin(), texts.end(), "Overload"));
+}
+
+TEST_F(HistorianSinkTest, should_start_a_new_file_when_the_segment_is_full)
+{
+  createAgent({{configuration::HistorianSegmentSize, "1"}});
+  m_sink->start();
+
+  addObservation("x1", {{"VALUE", 1.0}});
+  m_sink->flush();
+  addObservation("x1", {{"VALUE", 2.0}});
+  m_sink->flush();
+
+  // Only devices with new observations are written
+  m_sink->flush();
+  m_sink->closeFiles();
+
+  auto paths = files("000");
+  ASSERT_EQ(2, paths.size());
+  EXPECT_EQ("_0.arrow", paths[0].filename().string().substr(16));
+  EXPECT_EQ("_1.arrow", paths[1].filename().string().substr(16));
+}
+
+TEST_F(HistorianSinkTest, should_remove_expired_files)
+{
+  auto directory = m_directory / "000";
+  fs::create_directories(directory);
+  ofstream(directory / "old.arrow") << "old";
+  ofstream(directory / "new.arrow") << "new";
+  fs::last_write_time(directory / "old.arrow", fs::file_time_type::clock::now() - 48h);
+
+  createAgent({{configuration::HistorianRetention, "3600"}});
+  m_sink->start();
+
+  EXPECT_FALSE(fs::exists(directory / "old.arrow"));
+  EXPECT_TRUE(fs::exists(directory / "new.arrow"));
+}
@@ -0,0 +1,422 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+// Ensure that gtest is the first header otherwise Windows raises an error
+#include <gtest/gtest.h>
+// Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
+
+#include <filesystem>
+#include <future>
+
+#include "mtconnect/buffer/circular_buffer.hpp"
+#include "mtconnect/buffer/history_store.hpp"
+#include "mtconnect/device_model/device.hpp"
+
+using namespace std;
+using namespace mtconnect;
+using namespace mtconnect::buffer;
+using namespace mtconnect::observation;
+using namespace device_model;
+using namespace entity;
+using namespace data_item;
+using namespace std::literals;
+using namespace date::literals;
+
+// main
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+class HistoryStoreTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_directory = std::filesystem::temp_directory_path() / "mtconnect_history_test";
+
+    ErrorList errors;
+    Properties d1 {
+        {"id", "1"s}, {"name", "DeviceTest1"s}, {"uuid", "UnivUniqId1"s}, {"iso841Class", "4"s}};
+    m_device = dynamic_pointer_cast<Device>(Device::getFactory()->make("Device", d1, errors));
+
+    m_comp = Component::make("Comp1", {{"id", "2"s}, {"name", "Comp1"s}}, errors);
+    m_device->addChild(m_comp, errors);
+
+    m_condition = DataItem::make(
+        {{"id", "c1"s}, {"type", "LOAD"s}, {"category", "CONDITION"s}, {"name", "load"s}},
+        errors);
+    m_comp->addDataItem(m_condition, errors);
+
+    m_position = DataItem::make({{"id", "p1"s},
+                                 {"type", "POSITION"s},
+                                 {"category", "SAMPLE"s},
+                                 {"subType", "ACTUAL"s},
+                                 {"units", "MILLIMETER"s}},
+                                errors);
+    m_comp->addDataItem(m_position, errors);
+
+    m_execution =
+        DataItem::make({{"id", "e1"s}, {"type", "EXECUTION"s}, {"category", "EVENT"s}}, errors);
+    m_comp->addDataItem(m_execution, errors);
+
+    m_variables = DataItem::make({{"id", "v1"s},
+                                  {"type", "VARIABLE"s},
+                                  {"category", "EVENT"s},
+                                  {"representation", "DATA_SET"s}},
+                                 errors);
+    m_comp->addDataItem(m_variables, errors);
+
+    m_timeseries = DataItem::make({{"id", "t1"s},
+                                   {"type", "POSITION"s},
+                                   {"category", "SAMPLE"s},
+                                   {"units", "MILLIMETER"s},
+                                   {"representation", "TIME_SERIES"s}},
+                                  errors);
+    m_comp->addDataItem(m_timeseries, errors);
+
+    m_resolver = [this](const std::string &id) -> DataItemPtr {
+      for (auto &di : {m_condition, m_position, m_execution, m_variables, m_timeseries})
+        if (di->getId() == id)
+          return di;
+      return nullptr;
+    };
+  }
+
+  void TearDown() override
+  {
+    std::error_code ec;
+    std::filesystem::remove_all(m_directory, ec);
+  }
+
+  std::unique_ptr<HistoryStore> makeStore(size_t blockSize, size_t maxBlocks = 0)
+  {
+    auto store = make_unique<HistoryStore>(m_directory, blockSize, maxBlocks);
+    store->setResolver(m_resolver);
+    return store;
+  }
+
+  ObservationPtr makeObservation(DataItemPtr di, const Properties &props, int offset,
+                                 int64_t seq = 0)
+  {
+    ErrorList errors;
+    auto obs = Observation::make(di, props, m_time + std::chrono::milliseconds(offset), errors);
+    if (seq > 0)
+      obs->setSequence(seq);
+    return obs;
+  }
+
+  Timestamp m_time {Timestamp(date::sys_days(2021_y / jan / 19_d)) + 10h + 1min};
+  std::filesystem::path m_directory;
+  HistoryStore::DataItemResolver m_resolver;
+  DevicePtr m_device;
+  ComponentPtr m_comp;
+  DataItemPtr m_condition;
+  DataItemPtr m_position;
+  DataItemPtr m_execution;
+  DataItemPtr m_variables;
+  DataItemPtr m_timeseries;
+};
+
+TEST_F(HistoryStoreTest, should_seal_blocks_and_restore_observations)
+{
+  auto store = makeStore(4);
+
+  int64_t seq = 1;
+  for (int i = 0; i < 5; i++)
+  {
+    store->append(makeObservation(m_position, {{"VALUE", double(i) + 0.5}}, i * 10, seq++));
+    store->append(makeObservation(m_execution, {{"VALUE", (i % 2) ? "ACTIVE"s : "READY"s}},
+                                  i * 10 + 1, seq++));
+  }
+
+  store->wait();
+  ASSERT_EQ(2, store->getBlockCount());
+  ASSERT_EQ(1, store->getFirstSequence());
+  ASSERT_EQ(11, store->getEndSequence());
+  ASSERT_LT(0, store->getStoredBytes());
+
+  ObservationList list;
+  auto next = store->getObservations(list, 1, 11, 100, nullopt);
+  ASSERT_EQ(11, next);
+  ASSERT_EQ(10, list.size());
+
+  int64_t expected = 1;
+  for (auto &obs : list)
+  {
+    ASSERT_EQ(expected, obs->getSequence());
+    expected++;
+  }
+
+  auto it = list.begin();
+  auto first = *it++;
+  ASSERT_EQ(m_position, first->getDataItem());
+  ASSERT_EQ(0.5, first->getValue<double>());
+  ASSERT_EQ(m_time, first->getTimestamp());
+  ASSERT_EQ("Position", first->getName());
+
+  auto second = *it++;
+  ASSERT_EQ(m_execution, second->getDataItem());
+  ASSERT_EQ("READY", second->getValue<string>());
+  ASSERT_EQ(m_time + 1ms, second->getTimestamp());
+
+  auto last = list.back();
+  ASSERT_EQ("READY", last->getValue<string>());
+  ASSERT_EQ(m_time + 41ms, last->getTimestamp());
+}
+
+TEST_F(HistoryStoreTest, should_serve_blocks_before_and_after_they_are_written)
+{
+  auto store = makeStore(4);
+
+  for (int64_t seq = 1; seq <= 14; seq++)
+    store->append(makeObservation(m_position, {{"VALUE", double(seq)}}, int(seq), seq));
+
+  // Some blocks may still be waiting for the writer
+  ObservationList list;
+  ASSERT_EQ(15, store->getObservations(list, 1, 15, 100, nullopt));
+  ASSERT_EQ(14, list.size());
+  SequenceNumber_t expected = 1;
+  for (auto &obs : list)
+    ASSERT_EQ(expected++, obs->getSequence());
+
+  list.clear();
+  store->getObservations(list, 1, 15, 5, nullopt, false);
+  ASSERT_EQ(5, list.size());
+  ASSERT_EQ(14, list.front()->getSequence());
+  ASSERT_EQ(10, list.back()->getSequence());
+
+  store->wait();
+  ASSERT_EQ(3, store->getBlockCount());
+  ASSERT_EQ(1, store->getFirstSequence());
+  ASSERT_EQ(15, store->getEndSequence());
+
+  list.clear();
+  ASSERT_EQ(15, store->getObservations(list, 1, 15, 100, nullopt));
+  ASSERT_EQ(14, list.size());
+}
+
+TEST_F(HistoryStoreTest, should_filter_and_limit_observations)
+{
+  auto store = makeStore(4);
+
+  int64_t seq = 1;
+  for (int i = 0; i < 10; i++)
+  {
+    store->append(makeObservation(m_position, {{"VALUE", double(i)}}, i, seq++));
+    store->append(makeObservation(m_execution, {{"VALUE", "ACTIVE"s}}, i, seq++));
+  }
+
+  ObservationList list;
+  FilterSet filter {"p1"};
+  auto next = store->getObservations(list, 4, 21, 3, filter);
+  ASSERT_EQ(3, list.size());
+  ASSERT_EQ(10, next);
+
+  auto it = list.begin();
+  ASSERT_EQ(5, (*it++)->getSequence());
+  ASSERT_EQ(7, (*it++)->getSequence());
+  ASSERT_EQ(9, (*it++)->getSequence());
+
+  list.clear();
+  store->getObservations(list, 1, 15, 3, filter, false);
+  ASSERT_EQ(3, list.size());
+  it = list.begin();
+  ASSERT_EQ(13, (*it++)->getSequence());
+  ASSERT_EQ(11, (*it++)->getSequence());
+  ASSERT_EQ(9, (*it++)->getSequence());
+}
+
+TEST_F(HistoryStoreTest, should_restore_conditions_data_sets_and_time_series)
+{
+  auto store = makeStore(8);
+
+  store->append(makeObservation(m_condition,
+                                {{"level", "FAULT"s},
+                                 {"nativeCode", "OVER"s},
+                                 {"qualifier", "HIGH"s},
+                                 {"VALUE", "Overload"s}},
+                                0, 1));
+  store->append(makeObservation(m_condition, {{"level", "UNAVAILABLE"s}}, 1, 2));
+  store->append(makeObservation(m_execution, {{"VALUE", "UNAVAILABLE"s}}, 2, 3));
+
+  DataSet ds;
+  ds.emplace("a", int64_t(1));
+  ds.emplace("b", 2.5);
+  ds.emplace("c", "text"s);
+  ds.emplace("d", DataSetValue(), true);
+  store->append(makeObservation(m_variables, {{"VALUE", ds}}, 3, 4));
+
+  store->append(makeObservation(
+      m_timeseries, {{"VALUE", Vector {1.0, 2.0, 3.5}}, {"sampleCount", int64_t(3)}}, 4, 5));
+  store->flush();
+
+  ASSERT_EQ(1, store->getBlockCount());
+
+  ObservationList list;
+  store->getObservations(list, 1, 6, 10, nullopt);
+  ASSERT_EQ(5, list.size());
+
+  auto it = list.begin();
+  auto fault = dynamic_pointer_cast<Condition>(*it++);
+  ASSERT_TRUE(fault);
+  ASSERT_EQ(Condition::FAULT, fault->getLevel());
+  ASSERT_EQ("OVER", fault->getCode());
+  ASSERT_EQ("HIGH", fault->get<string>("qualifier"));
+  ASSERT_EQ("Overload", fault->getValue<string>());
+
+  auto unavailable = dynamic_pointer_cast<Condition>(*it++);
+  ASSERT_TRUE(unavailable->isUnavailable());
+  ASSERT_EQ(Condition::UNAVAILABLE, unavailable->getLevel());
+
+  auto exec = *it++;
+  ASSERT_TRUE(exec->isUnavailable());
+
+  auto vars = dynamic_pointer_cast<DataSetEvent>(*it++);
+  ASSERT_TRUE(vars);
+  auto &set = vars->getDataSet();
+  ASSERT_EQ(4, set.size());
+  ASSERT_EQ(1, set.get<int64_t>("a"));
+  ASSERT_EQ(2.5, set.get<double>("b"));
+  ASSERT_EQ("text", set.get<string>("c"));
+  ASSERT_TRUE(set.find(DataSetEntry("d"))->m_removed);
+
+  auto ts = *it++;
+  ASSERT_TRUE(dynamic_pointer_cast<Timeseries>(ts));
+  auto values = ts->getValue<Vector>();
+  ASSERT_EQ(3, values.size());
+  ASSERT_EQ(3.5, values[2]);
+  ASSERT_EQ(3, ts->get<int64_t>("sampleCount"));
+}
+
+TEST_F(HistoryStoreTest, should_discard_oldest_blocks)
+{
+  auto store = makeStore(4, 2);
+
+  for (int64_t seq = 1; seq <= 16; seq++)
+    store->append(makeObservation(m_position, {{"VALUE", double(seq)}}, int(seq), seq));
+
+  store->wait();
+  ASSERT_EQ(2, store->getBlockCount());
+  ASSERT_EQ(9, store->getFirstSequence());
+
+  int files = 0;
+  for (auto &entry : std::filesystem::directory_iterator(m_directory))
+    if (entry.path().extension() == ".mtch")
+      files++;
+  ASSERT_EQ(2, files);
+}
+
+TEST_F(HistoryStoreTest, should_serve_evicted_observations_from_circular_buffer)
+{
+  // 16 entry circular buffer
+  CircularBuffer buffer(4, 4);
+  buffer.setHistoryStore(makeStore(8));
+
+  for (int i = 0; i < 50; i++)
+  {
+    auto obs = makeObservation(i % 2 ? m_execution : m_position,
+                               {{"VALUE", i % 2 ? "ACTIVE"s : "100"s}}, i);
+    buffer.addToBuffer(obs);
+  }
+
+  ASSERT_EQ(51, buffer.getSequence());
+  ASSERT_EQ(35, buffer.getFirstSequence());
+  ASSERT_EQ(1, buffer.getFirstAvailableSequence());
+
+  SequenceNumber_t end, first;
+  bool endOfBuffer;
+
+  auto list = buffer.getObservations(100, nullopt, 1, nullopt, end, first, endOfBuffer);
+  ASSERT_EQ(50, list->size());
+  ASSERT_EQ(1, first);
+  ASSERT_EQ(51, end);
+  ASSERT_TRUE(endOfBuffer);
+
+  SequenceNumber_t expected = 1;
+  for (auto &obs : *list)
+    ASSERT_EQ(expected++, obs->getSequence());
+
+  list = buffer.getObservations(10, nullopt, 5, nullopt, end, first, endOfBuffer);
+  ASSERT_EQ(10, list->size());
+  ASSERT_EQ(5, list->front()->getSequence());
+  ASSERT_EQ(15, end);
+  ASSERT_FALSE(endOfBuffer);
+
+  list = buffer.getObservations(10, nullopt, 30, nullopt, end, first, endOfBuffer);
+  ASSERT_EQ(10, list->size());
+  ASSERT_EQ(30, list->front()->getSequence());
+  ASSERT_EQ(39, list->back()->getSequence());
+  ASSERT_EQ(40, end);
+
+  FilterSet filter {"e1"};
+  list = buffer.getObservations(3, filter, 1, 40, end, first, endOfBuffer);
+  ASSERT_EQ(3, list->size());
+  auto it = list->begin();
+  ASSERT_EQ(40, (*it++)->getSequence());
+  ASSERT_EQ(38, (*it++)->getSequence());
+  ASSERT_EQ(36, (*it++)->getSequence());
+
+  list = buffer.getObservations(3, filter, 1, 20, end, first, endOfBuffer);
+  ASSERT_EQ(3, list->size());
+  it = list->begin();
+  ASSERT_EQ(20, (*it++)->getSequence());
+  ASSERT_EQ(18, (*it++)->getSequence());
+  ASSERT_EQ(16, (*it++)->getSequence());
+  ASSERT_EQ(21, end);
+}
+
+TEST_F(HistoryStoreTest, should_read_history_without_holding_the_locks)
+{
+  CircularBuffer buffer(4, 4);
+  buffer.setHistoryStore(makeStore(8));
+
+  for (int i = 0; i < 50; i++)
+  {
+    auto obs = makeObservation(m_position, {{"VALUE", double(i)}}, i);
+    buffer.addToBuffer(obs);
+  }
+  buffer.getHistoryStore()->wait();
+  ASSERT_LT(0, buffer.getHistoryStore()->getBlockCount());
+
+  // Add an observation from another thread while a block is being read. It evicts an
+  // observation into the history store, so it needs the buffer and the history store locks.
+  bool added = false;
+  buffer.getHistoryStore()->setResolver([&](const std::string &id) {
+    if (!added)
+    {
+      added = true;
+      auto adding = std::async(std::launch::async, [&]() {
+        auto obs = makeObservation(m_position, {{"VALUE", 100.0}}, 100);
+        buffer.addToBuffer(obs);
+      });
+      EXPECT_EQ(std::future_status::ready, adding.wait_for(2s));
+    }
+    return m_resolver(id);
+  });
+
+  SequenceNumber_t end, first;
+  bool endOfBuffer;
+  auto list = buffer.getObservations(10, nullopt, 1, nullopt, end, first, endOfBuffer);
+  ASSERT_TRUE(added);
+  ASSERT_EQ(10, list->size());
+  ASSERT_EQ(1, list->front()->getSequence());
+  ASSERT_EQ(11, end);
+  ASSERT_FALSE(endOfBuffer);
+  ASSERT_EQ(52, buffer.getSequence());
+}
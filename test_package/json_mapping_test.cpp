@@ -1221,5 +1221,75 @@ TEST_F(JsonMappingTest, should_ignore_Invalid_make_DataItem)
   ASSERT_EQ("ACTIVE", obs->getValue<string>());
 }
 
+/// @test verify newline delimited objects are each mapped as a record
+TEST_F(JsonMappingTest, should_parse_newline_delimited_records)
+{
+  auto dev = makeDevice("Device", {{"id", "device"s}, {"name", "device"s}, {"uuid", "device"s}});
+  makeDataItem("device", {{"id", "a"s}, {"type", "EXECUTION"s}, {"category", "EVENT"s}});
+  makeDataItem("device", {{"id", "b"s}, {"type", "POSITION"s}, {"category", "SAMPLE"s}});
+
+  Properties props {{"VALUE", R"({"timestamp": "2023-11-09T11:20:00Z", "a": "ACTIVE"}
+{"timestamp": "2023-11-09T11:21:00Z", "b": 1.5, "c": 10}
+{"timestamp": "2023-11-09T11:22:00Z", "a": "READY", "b": 2.5}
+)"s}};
+
+  auto jmsg = std::make_shared<JsonMessage>("JsonMessage", props);
+  jmsg->m_device = dev;
+
+  auto res = (*m_mapper)(std::move(jmsg));
+  ASSERT_TRUE(res);
+
+  auto list = get<EntityList>(res->getValue());
+  ASSERT_EQ(4, list.size());
+
+  auto time = Timestamp(date::sys_days(2023_y / nov / 9_d)) + 11h + 20min;
+  auto it = list.begin();
+  auto obs = dynamic_pointer_cast<Observation>(*it++);
+  ASSERT_EQ("a", obs->getDataItem()->getId());
+  ASSERT_EQ(time, obs->getTimestamp());
+
+  obs = dynamic_pointer_cast<Observation>(*it++);
+  ASSERT_EQ("b", obs->getDataItem()->getId());
+  ASSERT_EQ(time + 1min, obs->getTimestamp());
+
+  obs = dynamic_pointer_cast<Observation>(*it++);
+  ASSERT_EQ("READY", obs->getValue<string>());
+  ASSERT_EQ(time + 2min, obs->getTimestamp());
+
+  auto errors = res->maybeGet<EntityList>("errors");
+  ASSERT_TRUE(errors);
+  ASSERT_EQ(1, errors->size());
+  ASSERT_EQ(1, errors->front()->get<int64_t>("record"));
+  ASSERT_EQ("Cannot find data item for c", errors->front()->getValue<string>());
+}
+
+/// @test verify errors in an array of objects are reported by array index
+TEST_F(JsonMappingTest, should_report_errors_by_record_for_arrays)
+{
+  auto dev = makeDevice("Device", {{"id", "device"s}, {"name", "device"s}, {"uuid", "device"s}});
+  makeDataItem("device", {{"id", "a"s}, {"type", "EXECUTION"s}, {"category", "EVENT"s}});
+
+  Properties props {{"VALUE", R"([
+  {"timestamp": "2023-11-09T11:20:00Z", "a": "ACTIVE"},
+  {"timestamp": "2023-11-09T11:21:00Z", "a": "READY"},
+  {"timestamp": "2023-11-09T11:22:00Z", "x": "READY"},
+  {"timestamp": "2023-11-09T11:23:00Z", "a": "STOPPED"}
+])"s}};
+
+  auto jmsg = std::make_shared<JsonMessage>("JsonMessage", props);
+  jmsg->m_device = dev;
+
+  auto res = (*m_mapper)(std::move(jmsg));
+  ASSERT_TRUE(res);
+
+  auto list = get<EntityList>(res->getValue());
+  ASSERT_EQ(3, list.size());
+
+  auto errors = res->maybeGet<EntityList>("errors");
+  ASSERT_TRUE(errors);
+  ASSERT_EQ(1, errors->size());
+  ASSERT_EQ(2, errors->front()->get<int64_t>("record"));
+}
+
 /// @test verify the json mapper can an asset in json
 TEST_F(JsonMappingTest, should_parse_json_asset) { GTEST_SKIP(); }
@@ -729,3 +729,53 @@ TEST_F(JsonPrinterStreamTest, should_have_device_model_change_time_in_header)
   ASSERT_EQ(string("2026-01-01T00:00:00Z"),
             header.at("/deviceModelChangeTime"_json_pointer).get<string>());
 }
+
+TEST_F(JsonPrinterStreamTest, should_print_the_same_scalar_and_complex_observations_when_cached)
+{
+  ObservationList list;
+  Timestamp now = chrono::system_clock::now();
+
+  addObservationToList(list, "if36ff60", 10254804, "AUTOMATIC"_value, now);  // Controller Mode
+  addObservationToList(list, "r186cd60", 10254805, Properties {{"VALUE", Vector {10, 20, 30}}},
+                       now);  // Path Position
+  addObservationToList(list, "a5b23650", 10254806,
+                       Properties {{"level", "fault"s},
+                                   {"nativeCode", "syn"s},
+                                   {"qualifier", "HIGH"s},
+                                   {"VALUE", "Syntax \"error\""s}},
+                       now);  // Motion condition
+  addObservationToList(list, "tc9edc70", 10254807,
+                       Properties {{"sampleCount", int64_t(2)},
+                                   {"sampleRate", 100.0},
+                                   {"VALUE", Vector {1.5, 2.5}}},
+                       now);  // Volt Ampere Time Series
+
+  for (auto version : {1u, 2u})
+  {
+    printer::JsonPrinter printer(version, false);
+    auto direct = json::parse(printer.printSample(123, 131072, 10254808, 1, 10254807, list));
+    printer.setRenderCache(true);
+    auto cached = json::parse(printer.printSample(123, 131072, 10254808, 1, 10254807, list));
+
+    ASSERT_EQ(direct.at("/MTConnectStreams/Streams"_json_pointer),
+              cached.at("/MTConnectStreams/Streams"_json_pointer))
+        << "version " << version;
+  }
+
+  printer::JsonPrinter printer(2, false);
+  auto jdoc = json::parse(printer.printSample(123, 131072, 10254808, 1, 10254807, list));
+  auto stream = jdoc.at("/MTConnectStreams/Streams/DeviceStream/0/ComponentStream/0"_json_pointer);
+
+  auto mode = stream.at("/Events/ControllerMode/0"_json_pointer);
+  ASSERT_EQ(string("AUTOMATIC"), mode.at("/value"_json_pointer).get<string>());
+  ASSERT_EQ(format(now), mode.at("/timestamp"_json_pointer).get<string>());
+  ASSERT_EQ(uint64_t(10254804), mode.at("/sequence"_json_pointer).get<uint64_t>());
+
+  auto fault = stream.at("/Condition/Fault/0"_json_pointer);
+  ASSERT_EQ(string("Syntax \"error\""), fault.at("/value"_json_pointer).get<string>());
+  ASSERT_EQ(string("HIGH"), fault.at("/qualifier"_json_pointer).get<string>());
+
+  auto position = stream.at("/Samples/PathPosition/0"_json_pointer);
+  ASSERT_EQ(3_S, position.at("/value"_json_pointer).size());
+  ASSERT_EQ(20.0, position.at("/value/1"_json_pointer).get<double>());
+}
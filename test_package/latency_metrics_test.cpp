@@ -0,0 +1,206 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+// Ensure that gtest is the first header otherwise Windows raises an error
+#include <gtest/gtest.h>
+// Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
+
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "mtconnect/metrics/latency.hpp"
+
+using namespace std;
+using namespace std::chrono_literals;
+using namespace mtconnect;
+using namespace mtconnect::metrics;
+
+// main
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+TEST(LatencyMetricsTest, should_map_values_to_buckets_within_a_sixteenth)
+{
+  for (uint64_t v = 0; v < Histogram::LinearBuckets; v++)
+    ASSERT_EQ(v, Histogram::bucketLimit(Histogram::bucketFor(v)));
+
+  for (size_t i = 0; i < Histogram::BucketCount; i++)
+    ASSERT_EQ(i, Histogram::bucketFor(Histogram::bucketLimit(i)));
+
+  for (uint64_t v : {33ull, 100ull, 1000ull, 123456ull, 987654321ull, 1ull << 39})
+  {
+    auto limit = Histogram::bucketLimit(Histogram::bucketFor(v));
+    ASSERT_LE(v, limit);
+    ASSERT_LE(double(limit - v) / double(v), 1.0 / 16.0) << v;
+  }
+
+  ASSERT_EQ(Histogram::BucketCount - 1, Histogram::bucketFor(1ull << 50));
+}
+
+TEST(LatencyMetricsTest, should_compute_quantiles_and_merge_threads)
+{
+  Histogram histogram;
+  vector<thread> threads;
+  for (int t = 0; t < 6; t++)
+  {
+    threads.emplace_back([&histogram]() {
+      for (uint64_t v = 1; v <= 1000; v++)
+        histogram.record(v * 1000);
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+
+  auto snapshot = histogram.snapshot();
+  ASSERT_EQ(6000, snapshot.m_count);
+  ASSERT_EQ(6 * 500500 * 1000ull, snapshot.m_sum);
+  ASSERT_EQ(1000000, snapshot.m_max);
+
+  auto median = snapshot.quantile(0.5);
+  ASSERT_GE(median, 500000);
+  ASSERT_LE(median, 500000 + 500000 / 16);
+  auto p99 = snapshot.quantile(0.99);
+  ASSERT_GE(p99, 990000);
+  ASSERT_LE(p99, 1000000);
+  ASSERT_EQ(1000000, snapshot.quantile(1.0));
+
+  histogram.record(5000000);
+  auto interval = histogram.snapshot().since(snapshot);
+  ASSERT_EQ(1, interval.m_count);
+  ASSERT_EQ(5000000, interval.m_sum);
+  ASSERT_LE(5000000, interval.quantile(0.99));
+}
+
+TEST(LatencyMetricsTest, should_exclude_nested_stages_from_stage_time)
+{
+  Histogram outer, inner;
+  {
+    StageTimer timer(&outer);
+    this_thread::sleep_for(2ms);
+    {
+      StageTimer nested(&inner);
+      this_thread::sleep_for(20ms);
+    }
+  }
+
+  auto o = outer.snapshot();
+  auto i = inner.snapshot();
+  ASSERT_EQ(1, o.m_count);
+  ASSERT_EQ(1, i.m_count);
+  ASSERT_LE(20000000, i.m_sum);
+  ASSERT_LE(2000000, o.m_sum);
+  ASSERT_GT(i.m_sum, o.m_sum);
+
+  // A null histogram does not measure
+  StageTimer none(nullptr);
+  ScopedTimer nothing(nullptr);
+}
+
+TEST(LatencyMetricsTest, should_record_uncontended_lock_as_zero)
+{
+  Histogram histogram;
+  mutex m;
+  {
+    unique_lock<mutex> lock(m, defer_lock);
+    lockTimed(lock, &histogram);
+    ASSERT_TRUE(lock.owns_lock());
+  }
+
+  auto snapshot = histogram.snapshot();
+  ASSERT_EQ(1, snapshot.m_count);
+  ASSERT_EQ(1, snapshot.m_counts[0]);
+
+  unique_lock<mutex> lock(m, defer_lock);
+  lockTimed(lock, nullptr);
+  ASSERT_TRUE(lock.owns_lock());
+}
+
+TEST(LatencyMetricsTest, should_only_create_histograms_when_enabled)
+{
+  Registry registry;
+  ASSERT_EQ(nullptr, registry.histogram("test_seconds", "A test"));
+
+  registry.setEnabled(true);
+  auto a = registry.histogram("test_seconds", "A test", {{"stage", "map"}});
+  auto b = registry.histogram("test_seconds", "A test", {{"stage", "map"}});
+  auto c = registry.histogram("test_seconds", "A test", {{"stage", "filter"}});
+  ASSERT_NE(nullptr, a);
+  ASSERT_EQ(a, b);
+  ASSERT_NE(a, c);
+}
+
+TEST(LatencyMetricsTest, should_print_prometheus_summaries)
+{
+  Registry registry;
+  registry.setEnabled(true);
+  auto h = registry.histogram("mtconnect_test_seconds", "Test latency",
+                              {{"adapter", "a\"1"}, {"stage", "map"}});
+  // Values at the top of their buckets are printed exactly
+  h->record(uint64_t(1023));
+  h->record(uint64_t(3071));
+
+  stringstream out;
+  registry.printPrometheus(out);
+  auto text = out.str();
+
+  EXPECT_NE(string::npos, text.find("# HELP mtconnect_test_seconds Test latency\n"));
+  EXPECT_NE(string::npos, text.find("# TYPE mtconnect_test_seconds summary\n"));
+  EXPECT_NE(string::npos, text.find("mtconnect_test_seconds{adapter=\"a\\\"1\",stage=\"map\","
+                                    "quantile=\"0.5\"} 1.023e-06\n"))
+      << text;
+  EXPECT_NE(string::npos,
+            text.find("mtconnect_test_seconds_sum{adapter=\"a\\\"1\",stage=\"map\"} 4.094e-06\n"));
+  EXPECT_NE(string::npos,
+            text.find("mtconnect_test_seconds_count{adapter=\"a\\\"1\",stage=\"map\"} 2\n"));
+}
+
+TEST(LatencyMetricsTest, should_report_percentile_of_interval_to_data_items)
+{
+  Registry registry;
+  registry.setEnabled(true);
+  auto a = registry.histogram("test_seconds", "A test", {{"stage", "map"}}, "map_latency");
+  auto b = registry.histogram("test_seconds", "A test", {{"stage", "other"}}, "map_latency");
+  auto c = registry.histogram("test_seconds", "A test", {{"stage", "filter"}}, "filter_latency");
+  registry.histogram("untracked_seconds", "Not published");
+
+  boost::asio::io_context context;
+  boost::asio::io_context::strand strand(context);
+  map<string, double> published;
+  auto reporter = make_shared<LatencyReporter>(
+      strand, registry, [&](const string &id, double seconds) { published[id] = seconds; });
+
+  a->record(uint64_t(1000));
+  b->record(uint64_t(3000));
+  c->record(uint64_t(7000000));
+  reporter->report();
+
+  ASSERT_EQ(2, published.size());
+  // Quantiles are reported within 1/16 of the value
+  ASSERT_NEAR(3e-6, published["map_latency"], 3e-6 / 16);
+  ASSERT_NEAR(7e-3, published["filter_latency"], 7e-3 / 16);
+
+  // Only data items with new values are published
+  published.clear();
+  a->record(uint64_t(20));
+  reporter->report();
+  ASSERT_EQ(1, published.size());
+  ASSERT_EQ(20e-9, published["map_latency"]);
+}
@@ -0,0 +1,130 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+/// @file
+/// Smoke tests of the load generator adapters against an agent
+
+// Ensure that gtest is the first header otherwise Windows raises an error
+#include <gtest/gtest.h>
+// Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
+
+#include "adapter_load.hpp"
+#include "agent_test_helper.hpp"
+#include "client_load.hpp"
+#include "mtconnect/agent.hpp"
+
+using namespace std;
+using namespace mtconnect;
+namespace lg = mtconnect::loadgen;
+
+// main
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+class LoadgenTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_agentTestHelper = make_unique<AgentTestHelper>();
+    m_agentTestHelper->createAgent("/samples/loadgen.xml", 8, 4, "2.0", 25);
+    m_kinds = lg::Mix {}.sequence();
+  }
+
+  void TearDown() override
+  {
+    if (m_adapter)
+    {
+      m_adapter->stop();
+      m_agentTestHelper->m_ioContext.run_for(100ms);
+      m_adapter.reset();
+    }
+    m_agentTestHelper.reset();
+  }
+
+  /// Start a loopback adapter on a free port and connect the agent to it
+  void startAdapter(double rate, const vector<string> *replay = nullptr)
+  {
+    m_adapter =
+        make_shared<lg::AdapterLoad>(m_agentTestHelper->m_ioContext, 0, rate, m_kinds, m_stats);
+    if (replay)
+      m_adapter->setReplay(*replay);
+    m_adapter->start();
+    ASSERT_NE(0, m_adapter->port());
+
+    m_agentTestHelper->addAdapter({}, "127.0.0.1", m_adapter->port(), "lg0");
+    m_agentTestHelper->m_adapter->start();
+  }
+
+  std::unique_ptr<AgentTestHelper> m_agentTestHelper;
+  std::vector<lg::Kind> m_kinds;
+  lg::AdapterStats m_stats;
+  std::shared_ptr<lg::AdapterLoad> m_adapter;
+};
+
+#define DEVICE_STREAM "//m:DeviceStream[@name='lg0']"
+
+/// @test the agent receives every kind of observation and the latency can be measured
+TEST_F(LoadgenTest, should_deliver_observations_from_a_loopback_adapter)
+{
+  auto from = lg::Clock::now();
+  startAdapter(2000.0);
+
+  ASSERT_TRUE(
+      m_agentTestHelper->waitFor(5000ms, [this]() { return m_stats.m_observations >= 200; }));
+  m_agentTestHelper->m_ioContext.run_for(100ms);
+  EXPECT_EQ(1, m_stats.m_connections);
+  EXPECT_EQ(0, m_stats.m_behind);
+  EXPECT_LT(0, m_stats.m_bytes);
+
+  {
+    PARSE_XML_RESPONSE("/lg0/current");
+    ASSERT_XML_PATH_EQUAL(doc, DEVICE_STREAM "//m:Availability", "AVAILABLE");
+  }
+
+  // Every data item the adapter sends has been updated since the adapter started
+  lg::ClientStats stats("current");
+  auto now = lg::Clock::now();
+  lg::ScanTimestamps(m_agentTestHelper->m_session->m_body, [&](lg::Clock::time_point time) {
+    if (time >= from)
+      stats.m_latency.record(uint64_t(chrono::nanoseconds(now - time).count()));
+  });
+
+  auto latency = stats.m_latency.snapshot();
+  EXPECT_LE(8, latency.m_count);
+  EXPECT_GT(uint64_t(chrono::nanoseconds(10s).count()), latency.quantile(0.99));
+}
+
+/// @test a replayed recording is timestamped and sent as is
+TEST_F(LoadgenTest, should_replay_recorded_lines)
+{
+  vector<string> replay {"|exec|ACTIVE", "|program|O1234", "|system|FAULT|E42||HIGH|Too hot"};
+  startAdapter(300.0, &replay);
+
+  ASSERT_TRUE(m_agentTestHelper->waitFor(5000ms, [this]() { return m_stats.m_observations >= 6; }));
+  m_agentTestHelper->m_ioContext.run_for(100ms);
+
+  PARSE_XML_RESPONSE("/lg0/current");
+  ASSERT_XML_PATH_EQUAL(doc, DEVICE_STREAM "//m:Availability", "AVAILABLE");
+  ASSERT_XML_PATH_EQUAL(doc, DEVICE_STREAM "//m:Execution", "ACTIVE");
+  ASSERT_XML_PATH_EQUAL(doc, DEVICE_STREAM "//m:Program", "O1234");
+  ASSERT_XML_PATH_EQUAL(doc, DEVICE_STREAM "//m:Fault@nativeCode", "E42");
+  ASSERT_XML_PATH_EQUAL(doc, DEVICE_STREAM "//m:Fault", "Too hot");
+}
@@ -203,33 +203,51 @@ TEST_F(ObservationTest, ConditionEventChaining)
   auto dataItem =
       DataItem::make({{"id", "c1"s}, {"category", "CONDITION"s}, {"type", "TEMPERATURE"s}}, errors);
 
-  ConditionPtr event1 = Cond(Observation::make(dataItem, {{"level", "FAULT"s}}, m_time, errors));
-  ConditionPtr event2 = Cond(Observation::make(dataItem, {{"level", "FAULT"s}}, m_time, errors));
-  ConditionPtr event3 = Cond(Observation::make(dataItem, {{"level", "FAULT"s}}, m_time, errors));
+  auto fault = [&](const string &code) {
+    return Cond(Observation::make(dataItem, {{"level", "FAULT"s}, {"nativeCode", code}}, m_time,
+                                  errors));
+  };
+  ConditionPtr event1 = fault("A");
+  ConditionPtr event2 = fault("B");
+  ConditionPtr event3 = fault("C");
 
-  ASSERT_TRUE(event1 == event1->getFirst());
+  ASSERT_TRUE(event1->getActive().empty());
 
-  event1->appendTo(event2);
-  ASSERT_TRUE(event1->getFirst() == event2);
+  event2->activateAfter(event1);
+  ASSERT_EQ(event1, event2->find("A"));
 
-  event2->appendTo(event3);
-  ASSERT_TRUE(event1->getFirst() == event3);
-
-  ASSERT_EQ(1, event1.use_count());
-  ASSERT_EQ(2, event2.use_count());
-  ASSERT_EQ(2, event3.use_count());
+  event3->activateAfter(event2);
+  ASSERT_EQ(event1, event3->find("A"));
+  ASSERT_EQ(event2, event3->find("B"));
+  ASSERT_EQ(event3, event3->find("C"));
 
   ConditionList list;
-  event1->getConditionList(list);
+  event3->getConditionList(list);
   ASSERT_EQ(3, list.size());
-  ASSERT_TRUE(list.front() == event3);
-  ASSERT_TRUE(list.back() == event1);
+  ASSERT_TRUE(list.front() == event1);
+  ASSERT_TRUE(list.back() == event3);
 
   ConditionList list2;
   event2->getConditionList(list2);
   ASSERT_EQ(2, list2.size());
-  ASSERT_TRUE(list2.front() == event3);
+  ASSERT_TRUE(list2.front() == event1);
   ASSERT_TRUE(list2.back() == event2);
+
+  // Reactivating a code replaces the condition and moves it to the end
+  auto event4 = fault("A");
+  event4->activateAfter(event3);
+  ConditionList list3;
+  event4->getConditionList(list3);
+  ASSERT_EQ((ConditionList {event2, event3, event4}), list3);
+
+  // Clearing a code leaves the earlier conditions unchanged
+  auto cleared = event4->copyAndClear("B");
+  ConditionList list4;
+  cleared->getConditionList(list4);
+  ASSERT_EQ(2, list4.size());
+  ASSERT_EQ(event3, list4.front());
+  ASSERT_EQ("A", list4.back()->getCode());
+  ASSERT_EQ(event2, event4->find("B"));
 }
 
 TEST_F(ObservationTest, subType_prefix_should_be_passed_through)
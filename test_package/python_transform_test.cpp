@@ -1,5 +1,5 @@
 //
-// Copyright Copyright 2009-2022, AMT – The Association For Manufacturing Technology (“AMT”)
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
 // All rights reserved.
 //
 //    Licensed under the Apache License, Version 2.0 (the "License");
@@ -19,31 +19,22 @@
 #include <gtest/gtest.h>
 // Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
 #include <boost/python.hpp>
-#include <boost/python/dict.hpp>
-#include <boost/python/extract.hpp>
-#include <boost/python/stl_iterator.hpp>
-#include <boost/python/str.hpp>
-#include <boost/python/tuple.hpp>
 
 #include <chrono>
+#include <filesystem>
+#include <string>
 
-#include "adapter/adapter.hpp"
-#include "agent_test_helper.hpp"
-#include "observation/observation.hpp"
-#include "pipeline/deliver.hpp"
-#include "pipeline/delta_filter.hpp"
-#include "pipeline/duplicate_filter.hpp"
-#include "pipeline/pipeline.hpp"
-#include "pipeline/shdr_token_mapper.hpp"
-
-using namespace mtconnect;
-using namespace mtconnect::adapter;
-using namespace mtconnect::pipeline;
-using namespace mtconnect::observation;
-using namespace std;
-using namespace std::literals;
-using namespace std::chrono_literals;
-using namespace mtconnect::rest_sink;
+#include "mtconnect/agent.hpp"
+#include "mtconnect/configuration/agent_config.hpp"
+#include "mtconnect/observation/observation.hpp"
+#include "mtconnect/pipeline/pipeline_contract.hpp"
+#include "mtconnect/source/loopback_source.hpp"
+
+#ifdef _WIN32
+#include <direct.h>
+#define getcwd _getcwd
+#define chdir _chdir
+#endif
 
 // main
 int main(int argc, char *argv[])
@@ -52,22 +43,248 @@ int main(int argc, char *argv[])
   return RUN_ALL_TESTS();
 }
 
-class PythonTransformTest : public testing::Test
-{
-protected:
-  void SetUp() override
+namespace {
+  using namespace std;
+  using namespace std::chrono_literals;
+  using namespace mtconnect;
+  using namespace configuration;
+  using namespace observation;
+  using namespace device_model;
+  using namespace entity;
+  using namespace data_item;
+  using namespace pipeline;
+  using namespace asset;
+  namespace py = boost::python;
+
+  class MockPipelineContract : public PipelineContract
+  {
+  public:
+    MockPipelineContract(const Agent *agent) : m_agent(agent) {}
+    DevicePtr findDevice(const std::string &device) override { return nullptr; }
+    DataItemPtr findDataItem(const std::string &device, const std::string &name) override
+    {
+      return m_agent->getDataItemForDevice(device, name);
+    }
+    void eachDataItem(EachDataItem fun) override {}
+    void deliverObservation(observation::ObservationPtr obs) override
+    {
+      m_observations.push_back(obs);
+    }
+    void deliverAsset(AssetPtr a) override {}
+    void deliverDevices(std::list<DevicePtr>) override {}
+    void deliverDevice(DevicePtr) override {}
+    void deliverAssetCommand(entity::EntityPtr c) override {}
+    int32_t getSchemaVersion() const override { return IntDefaultSchemaVersion(); }
+    bool isValidating() const override { return false; }
+    void deliverCommand(entity::EntityPtr c) override {}
+    void deliverConnectStatus(entity::EntityPtr, const StringList &, bool) override {}
+    void sourceFailed(const std::string &id) override {}
+    const ObservationPtr checkDuplicate(const ObservationPtr &obs) const override { return obs; }
+
+    const Agent *m_agent;
+    std::vector<ObservationPtr> m_observations;
+  };
+
+  class PythonTransformTest : public testing::Test
+  {
+  protected:
+    void SetUp() override
+    {
+      m_config = std::make_unique<AgentConfiguration>();
+      m_config->setDebug(true);
+      m_cwd = std::filesystem::current_path();
+
+      m_context = make_shared<PipelineContext>();
+      m_context->m_contract = make_unique<MockPipelineContract>(m_config->getAgent());
+    }
+
+    void TearDown() override
+    {
+      // The transforms outlive the test in __main__, release them and their timers while
+      // the io context is alive
+      if (m_loopback)
+      {
+        exec("collect = keep = None");
+        m_loopback->stop();
+        m_config->getContext().restart();
+        m_config->getContext().poll();
+      }
+      m_config.reset();
+      m_loopback.reset();
+      m_strand.reset();
+      chdir(m_cwd.string().c_str());
+    }
+
+    void load(const char *file)
+    {
+      string str("Devices = " TEST_RESOURCE_DIR
+                 "/samples/test_config.xml\n"
+                 "Python {\n"
+                 "  module = " TEST_RESOURCE_DIR "/python/" +
+                 string(file) +
+                 "\n"
+                 "}\n");
+      m_config->loadConfig(str);
+
+      // The Python code finds the source through the agent
+      ConfigOptions options;
+      m_strand = make_unique<boost::asio::io_context::strand>(m_config->getContext());
+      m_loopback =
+          make_shared<source::LoopbackSource>("PythonSource", *m_strand, m_context, options);
+      m_config->getAgent()->addSource(m_loopback);
+    }
+
+    /// @brief run code in `__main__` holding the GIL
+    void exec(const string &code)
+    {
+      auto gil = PyGILState_Ensure();
+      try
+      {
+        py::object main = py::import("__main__");
+        py::exec(py::str(code), main.attr("__dict__"));
+      }
+      catch (py::error_already_set const &)
+      {
+        PyErr_Print();
+        ADD_FAILURE() << "Python error running: " << code;
+      }
+      PyGILState_Release(gil);
+    }
+
+    /// @brief evaluate an expression in `__main__` holding the GIL
+    template <typename T>
+    T eval(const string &expression)
+    {
+      T result {};
+      auto gil = PyGILState_Ensure();
+      try
+      {
+        py::object main = py::import("__main__");
+        result = py::extract<T>(py::eval(py::str(expression), main.attr("__dict__")));
+      }
+      catch (py::error_already_set const &)
+      {
+        PyErr_Print();
+        ADD_FAILURE() << "Python error evaluating: " << expression;
+      }
+      PyGILState_Release(gil);
+      return result;
+    }
+
+    void receive(const string &name, const Value &value, Timestamp timestamp)
+    {
+      auto dataItem = m_config->getAgent()->getDataItemForDevice("LinuxCNC", name);
+      ASSERT_TRUE(dataItem);
+      m_loopback->receive(dataItem, {{"VALUE", value}}, timestamp);
+    }
+
+    const vector<ObservationPtr> &delivered()
+    {
+      return static_cast<MockPipelineContract *>(m_context->m_contract.get())->m_observations;
+    }
+
+    shared_ptr<PipelineContext> m_context;
+    std::unique_ptr<AgentConfiguration> m_config;
+    std::unique_ptr<boost::asio::io_context::strand> m_strand;
+    shared_ptr<source::LoopbackSource> m_loopback;
+    std::filesystem::path m_cwd;
+  };
+
+  TEST_F(PythonTransformTest, should_run_a_batch_when_it_is_full)
   {
-    m_agentTestHelper = make_unique<AgentTestHelper>();
-    m_agentTestHelper->createAgent("/samples/SimpleDevlce.xml", 8, 4, "1.7", 25);
-    m_agentId = to_string(getCurrentTimeInSec());
-    m_device = m_agentTestHelper->m_agent->getDeviceByName("LinuxCNC");
+    load("should_batch_samples.py");
+    exec(R"(
+collect = Collect(3, 60000)
+agent.get_source('PythonSource').get_pipeline().splice_after('Start', collect)
+)");
+
+    Timestamp now = chrono::system_clock::now();
+    receive("Xact", 1.5, now);
+    receive("Xact", "UNAVAILABLE"s, now + 1ms);
+    EXPECT_EQ(0, eval<int>("len(batches)"));
+    EXPECT_TRUE(delivered().empty());
+
+    receive("Xcom", 3.0, now + 2ms);
+    ASSERT_EQ(1, eval<int>("len(batches)"));
+    EXPECT_EQ(3, eval<int>("batches[0][0]"));
+
+    // The values of each data item are in order, UNAVAILABLE is NaN
+    EXPECT_EQ(2, eval<int>("len(batches[0][1]['x1'][0])"));
+    EXPECT_EQ(1.5, eval<double>("batches[0][1]['x1'][0][0]"));
+    EXPECT_TRUE(eval<bool>("math.isnan(batches[0][1]['x1'][0][1])"));
+    EXPECT_EQ(3.0, eval<double>("batches[0][1]['x2'][0][0]"));
+
+    auto micros =
+        chrono::duration_cast<chrono::microseconds>(now.time_since_epoch()).count();
+    EXPECT_EQ(micros, eval<int64_t>("batches[0][1]['x1'][1][0]"));
+    EXPECT_EQ(micros + 1000, eval<int64_t>("batches[0][1]['x1'][1][1]"));
+    EXPECT_EQ(micros + 2000, eval<int64_t>("batches[0][1]['x2'][1][0]"));
+
+    // None forwards the whole batch in order
+    ASSERT_EQ(3, delivered().size());
+    EXPECT_EQ("x1", delivered()[0]->getDataItem()->getId());
+    EXPECT_TRUE(delivered()[1]->isUnavailable());
+    EXPECT_EQ("x2", delivered()[2]->getDataItem()->getId());
   }
 
-  void TearDown() override { m_agentTestHelper.reset(); }
+  TEST_F(PythonTransformTest, should_run_a_batch_after_the_interval)
+  {
+    load("should_batch_samples.py");
+    exec(R"(
+collect = Collect(1000, 10)
+agent.get_source('PythonSource').get_pipeline().splice_after('Start', collect)
+)");
 
-  std::unique_ptr<AgentTestHelper> m_agentTestHelper;
-  std::string m_agentId;
-  DevicePtr m_device {nullptr};
-};
+    Timestamp now = chrono::system_clock::now();
+    receive("Xact", 1.0, now);
+    receive("Xact", 2.0, now + 1ms);
+    EXPECT_EQ(0, eval<int>("len(batches)"));
 
-TEST_F(PythonTransformTest, add_python_transform_to_adapter_pipeline) {}
+    // The timer runs on the pipeline strand
+    auto &context = m_config->getContext();
+    for (int i = 0; i < 100 && delivered().size() < 2; i++)
+    {
+      context.run_for(10ms);
+      context.restart();
+    }
+
+    ASSERT_EQ(1, eval<int>("len(batches)"));
+    EXPECT_EQ(2, eval<int>("batches[0][0]"));
+    ASSERT_EQ(2, delivered().size());
+    EXPECT_EQ(1.0, delivered()[0]->getValue<double>());
+    EXPECT_EQ(2.0, delivered()[1]->getValue<double>());
+  }
+
+  TEST_F(PythonTransformTest, should_forward_the_entities_returned_by_run)
+  {
+    load("should_batch_samples.py");
+    exec(R"(
+keep = KeepLast()
+agent.get_source('PythonSource').get_pipeline().splice_after('Start', keep)
+)");
+
+    Timestamp now = chrono::system_clock::now();
+    receive("Xact", 1.0, now);
+    receive("Xact", 2.0, now + 1ms);
+    receive("Xact", 3.0, now + 2ms);
+
+    ASSERT_EQ(1, delivered().size());
+    EXPECT_EQ(3.0, delivered()[0]->getValue<double>());
+  }
+
+  TEST_F(PythonTransformTest, should_flush_a_batch_on_demand)
+  {
+    load("should_batch_samples.py");
+    exec(R"(
+collect = Collect(1000, 60000)
+agent.get_source('PythonSource').get_pipeline().splice_after('Start', collect)
+)");
+
+    receive("Xact", 1.0, chrono::system_clock::now());
+    EXPECT_TRUE(delivered().empty());
+
+    exec("collect.flush()");
+    EXPECT_EQ(1, eval<int>("len(batches)"));
+    ASSERT_EQ(1, delivered().size());
+  }
+}  // namespace
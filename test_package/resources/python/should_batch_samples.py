@@ -0,0 +1,22 @@
+import math
+
+batches = []
+
+class Collect(pipeline.BatchTransform):
+  def __init__(self, size, interval):
+    super().__init__("Collect", size, interval)
+
+  def run(self, batch):
+    samples = {}
+    for id in batch.data_items():
+      samples[id] = (list(memoryview(batch.values(id))),
+                     list(memoryview(batch.timestamps(id))))
+    batches.append((len(batch), samples))
+    return None
+
+class KeepLast(pipeline.BatchTransform):
+  def __init__(self):
+    super().__init__("KeepLast", 3, 60000)
+
+  def run(self, batch):
+    return [batch[-1]]
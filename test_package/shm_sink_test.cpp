@@ -0,0 +1,306 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+// Ensure that gtest is the first header otherwise Windows raises an error
+#include <gtest/gtest.h>
+// Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "agent_test_helper.hpp"
+#include "mtconnect/sink/shm_sink/shm_ring.hpp"
+#include "mtconnect/sink/shm_sink/shm_sink.hpp"
+
+using namespace std;
+using namespace std::chrono_literals;
+using namespace mtconnect;
+using namespace mtconnect::sink::shm_sink;
+
+// main
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+class ShmSinkTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_name = "/mtconnect_test_" + to_string(::getpid()) + "_" +
+             testing::UnitTest::GetInstance()->current_test_info()->name();
+  }
+
+  void TearDown() override { ::shm_unlink(m_name.c_str()); }
+
+  string m_name;
+};
+
+TEST_F(ShmSinkTest, should_read_each_kind_of_record)
+{
+  ShmRingWriter writer(m_name, 1024, 4096, 42);
+  ShmRingReader reader(m_name);
+  ASSERT_EQ(42, reader.getInstanceId());
+
+  auto x = writer.addDataItem("x1");
+  auto c = writer.addDataItem("clc");
+  ASSERT_EQ(0, x);
+  ASSERT_EQ(1, c);
+
+  double d = 1.5;
+  int64_t i = -12;
+  string s = "READY";
+  vector<double> v {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+  string cond("OVER\0Load too high", 18);
+
+  writer.write(1, 1000, x, Kind::DOUBLE, 0, &d, sizeof(d));
+  writer.write(2, 1001, x, Kind::INTEGER, 0, &i, sizeof(i));
+  writer.write(3, 1002, x, Kind::STRING, 0, s.data(), s.size());
+  writer.write(4, 1003, x, Kind::VECTOR, 0, v.data(), v.size() * sizeof(double));
+  writer.write(5, 1004, c, Kind::CONDITION, uint8_t(ConditionLevel::FAULT), cond.data(),
+               cond.size());
+  writer.write(6, 1005, c, Kind::UNAVAILABLE, 0, nullptr, 0);
+
+  Record record;
+  ASSERT_EQ(ShmRingReader::Status::RECORD, reader.read(record));
+  EXPECT_EQ(1, record.m_sequence);
+  EXPECT_EQ(1000, record.m_timestamp);
+  EXPECT_EQ("x1", reader.dataItemId(record.m_dataItem));
+  EXPECT_EQ(Kind::DOUBLE, record.m_kind);
+  EXPECT_EQ(1.5, record.asDouble());
+
+  ASSERT_EQ(ShmRingReader::Status::RECORD, reader.read(record));
+  EXPECT_EQ(Kind::INTEGER, record.m_kind);
+  EXPECT_EQ(-12, record.asInteger());
+
+  ASSERT_EQ(ShmRingReader::Status::RECORD, reader.read(record));
+  EXPECT_EQ(Kind::STRING, record.m_kind);
+  EXPECT_EQ("READY", record.asString());
+
+  ASSERT_EQ(ShmRingReader::Status::RECORD, reader.read(record));
+  EXPECT_EQ(Kind::VECTOR, record.m_kind);
+  EXPECT_EQ(v, record.asVector());
+
+  ASSERT_EQ(ShmRingReader::Status::RECORD, reader.read(record));
+  EXPECT_EQ("clc", reader.dataItemId(record.m_dataItem));
+  EXPECT_EQ(Kind::CONDITION, record.m_kind);
+  EXPECT_EQ(uint8_t(ConditionLevel::FAULT), record.m_level);
+  EXPECT_EQ("OVER", record.nativeCode());
+  EXPECT_EQ("Load too high", record.message());
+
+  ASSERT_EQ(ShmRingReader::Status::RECORD, reader.read(record));
+  EXPECT_EQ(6, record.m_sequence);
+  EXPECT_EQ(Kind::UNAVAILABLE, record.m_kind);
+  EXPECT_TRUE(record.m_payload.empty());
+
+  ASSERT_EQ(ShmRingReader::Status::EMPTY, reader.read(record));
+  EXPECT_EQ(0, reader.getLag());
+}
+
+TEST_F(ShmSinkTest, should_span_slots_and_truncate_large_payloads)
+{
+  ShmRingWriter writer(m_name, 256, 4096, 1);
+  ShmRingReader reader(m_name);
+
+  string medium(200, 'm');
+  string large(10000, 'l');
+  writer.write(1, 0, 0, Kind::STRING, 0, medium.data(), medium.size());
+  writer.write(2, 0, 0, Kind::STRING, 0, large.data(), large.size());
+  EXPECT_EQ(SlotsFor(200) + 64, writer.getPosition());
+
+  Record record;
+  ASSERT_EQ(ShmRingReader::Status::RECORD, reader.read(record));
+  EXPECT_EQ(medium, record.asString());
+  EXPECT_EQ(0, record.m_flags);
+
+  ASSERT_EQ(ShmRingReader::Status::RECORD, reader.read(record));
+  EXPECT_EQ(TRUNCATED, record.m_flags);
+  EXPECT_EQ(RecordSlot::PayloadSize + 63 * ContinuationSlot::PayloadSize,
+            record.m_payload.size());
+  EXPECT_EQ(large.substr(0, record.m_payload.size()), record.asString());
+}
+
+TEST_F(ShmSinkTest, should_detect_overrun_and_skip_to_newer_records)
+{
+  ShmRingWriter writer(m_name, 256, 4096, 1);
+  ShmRingReader reader(m_name);
+
+  for (int64_t i = 1; i <= 1000; i++)
+    writer.write(uint64_t(i), 0, 0, Kind::INTEGER, 0, &i, sizeof(i));
+
+  Record record;
+  ASSERT_EQ(ShmRingReader::Status::OVERRUN, reader.read(record));
+  EXPECT_EQ(1, reader.getOverruns());
+  EXPECT_LE(1000 - 256, reader.getSkipped());
+
+  uint64_t last = 0, count = 0;
+  while (reader.read(record) == ShmRingReader::Status::RECORD)
+  {
+    EXPECT_EQ(int64_t(record.m_sequence), record.asInteger());
+    EXPECT_GT(record.m_sequence, last);
+    last = record.m_sequence;
+    count++;
+  }
+  EXPECT_EQ(1000, last);
+  EXPECT_EQ(1000, reader.getSkipped() + count);
+}
+
+TEST_F(ShmSinkTest, should_start_at_oldest_record_and_support_many_readers)
+{
+  ShmRingWriter writer(m_name, 256, 4096, 1);
+  for (int64_t i = 1; i <= 300; i++)
+    writer.write(uint64_t(i), 0, 0, Kind::INTEGER, 0, &i, sizeof(i));
+
+  ShmRingReader oldest(m_name, true);
+  ShmRingReader first(m_name), second(m_name);
+
+  Record record;
+  ASSERT_EQ(ShmRingReader::Status::RECORD, oldest.read(record));
+  EXPECT_EQ(45, record.m_sequence);
+  EXPECT_EQ(ShmRingReader::Status::EMPTY, first.read(record));
+
+  int64_t v = 301;
+  writer.write(301, 0, 0, Kind::INTEGER, 0, &v, sizeof(v));
+  for (auto reader : {&first, &second})
+  {
+    ASSERT_EQ(ShmRingReader::Status::RECORD, reader->read(record));
+    EXPECT_EQ(301, record.asInteger());
+    EXPECT_EQ(ShmRingReader::Status::EMPTY, reader->read(record));
+  }
+}
+
+TEST_F(ShmSinkTest, should_follow_a_writer_from_many_threads)
+{
+  constexpr uint64_t Records = 2000000;
+  constexpr int Readers = 3;
+
+  ShmRingWriter writer(m_name, 65536, 4096, 1);
+  atomic_bool done {false};
+  atomic_int ready {0};
+
+  struct Result
+  {
+    uint64_t m_records {0};
+    uint64_t m_skipped {0};
+    uint64_t m_last {0};
+    bool m_ordered {true};
+    bool m_valid {true};
+  };
+  vector<Result> results(Readers);
+  vector<thread> readers;
+  for (int r = 0; r < Readers; r++)
+  {
+    readers.emplace_back([&, r]() {
+      ShmRingReader reader(m_name);
+      auto &result = results[r];
+      Record record;
+      ready++;
+      while (true)
+      {
+        auto finished = done.load();
+        auto status = reader.read(record);
+        if (status == ShmRingReader::Status::RECORD)
+        {
+          result.m_records++;
+          result.m_ordered = result.m_ordered && record.m_sequence > result.m_last;
+          result.m_valid = result.m_valid && record.asInteger() == int64_t(record.m_sequence) &&
+                           (record.m_sequence % 5 != 0 || record.asString().size() == 100);
+          result.m_last = record.m_sequence;
+        }
+        else if (status == ShmRingReader::Status::EMPTY && finished)
+          break;
+      }
+      result.m_skipped = reader.getSkipped();
+    });
+  }
+  while (ready < Readers)
+    this_thread::yield();
+
+  auto start = chrono::steady_clock::now();
+  char payload[100];
+  for (uint64_t i = 1; i <= Records; i++)
+  {
+    // Every fifth record spans two slots
+    memcpy(payload, &i, sizeof(i));
+    writer.write(i, 0, 0, Kind::INTEGER, 0, payload, i % 5 == 0 ? 100 : 8);
+  }
+  auto elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  done = true;
+  for (auto &t : readers)
+    t.join();
+
+  cout << "Wrote " << uint64_t(Records / elapsed) << " records/s" << endl;
+  for (auto &result : results)
+  {
+    EXPECT_TRUE(result.m_ordered);
+    EXPECT_TRUE(result.m_valid);
+    EXPECT_EQ(Records, result.m_last);
+    EXPECT_GT(result.m_records, 0);
+    cout << "Reader received " << result.m_records << " records, skipped " << result.m_skipped
+         << " slots" << endl;
+  }
+}
+
+TEST_F(ShmSinkTest, should_publish_observations_from_the_agent)
+{
+  AgentTestHelper helper;
+  shared_ptr<ShmSink> sink;
+  AgentTestHelper::Hook hook = [&](AgentTestHelper &h) {
+    boost::property_tree::ptree block;
+    block.put(configuration::ShmName, m_name);
+    auto contract = h.getAgent()->makeSinkContract();
+    sink = make_shared<ShmSink>(h.m_ioContext, std::move(contract), ConfigOptions {}, block);
+    h.getAgent()->addSink(sink);
+  };
+  helper.setAgentCreateHook(hook);
+  helper.createAgent("/samples/test_config.xml", 8, 4, "2.0", 25, false, true);
+  sink->start();
+  ASSERT_NE(nullptr, sink->getWriter());
+
+  ShmRingReader reader(m_name);
+  auto agent = helper.getAgent();
+  auto now = chrono::system_clock::now();
+  helper.addToBuffer(agent->getDataItemById("x1"), {{"VALUE", 12.5}}, now);
+  helper.addToBuffer(agent->getDataItemById("clc"),
+                     {{"level", "FAULT"s}, {"nativeCode", "OVER"s}, {"VALUE", "Overload"s}},
+                     now);
+  helper.addToBuffer(agent->getDataItemById("x1"), {{"VALUE", "UNAVAILABLE"s}}, now);
+
+  Record record;
+  ASSERT_EQ(ShmRingReader::Status::RECORD, reader.read(record));
+  EXPECT_EQ("x1", reader.dataItemId(record.m_dataItem));
+  EXPECT_EQ(Kind::DOUBLE, record.m_kind);
+  EXPECT_EQ(12.5, record.asDouble());
+  EXPECT_EQ(chrono::duration_cast<chrono::microseconds>(now.time_since_epoch()).count(),
+            int64_t(record.m_timestamp));
+
+  ASSERT_EQ(ShmRingReader::Status::RECORD, reader.read(record));
+  EXPECT_EQ("clc", reader.dataItemId(record.m_dataItem));
+  EXPECT_EQ(Kind::CONDITION, record.m_kind);
+  EXPECT_EQ(uint8_t(ConditionLevel::FAULT), record.m_level);
+  EXPECT_EQ("OVER", record.nativeCode());
+  EXPECT_EQ("Overload", record.message());
+
+  ASSERT_EQ(ShmRingReader::Status::RECORD, reader.read(record));
+  EXPECT_EQ(Kind::UNAVAILABLE, record.m_kind);
+  EXPECT_EQ(ShmRingReader::Status::EMPTY, reader.read(record));
+
+  sink->stop();
+}
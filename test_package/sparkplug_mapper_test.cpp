@@ -0,0 +1,348 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+// Ensure that gtest is the first header otherwise Windows raises an error
+#include <gtest/gtest.h>
+// Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
+
+#include <boost/asio.hpp>
+
+#include <chrono>
+#include <map>
+#include <string>
+
+#include "mtconnect/configuration/config_options.hpp"
+#include "mtconnect/device_model/device.hpp"
+#include "mtconnect/mqtt/mqtt_client_impl.hpp"
+#include "mtconnect/mqtt/mqtt_server_impl.hpp"
+#include "mtconnect/observation/observation.hpp"
+#include "mtconnect/pipeline/pipeline_context.hpp"
+#include "mtconnect/pipeline/sparkplug_mapper.hpp"
+#include "mtconnect/source/adapter/mqtt/mqtt_adapter.hpp"
+
+using namespace std;
+using namespace mtconnect;
+using namespace mtconnect::pipeline;
+using namespace mtconnect::observation;
+using namespace mtconnect::asset;
+using namespace device_model;
+using namespace data_item;
+using namespace std::literals;
+using namespace std::chrono_literals;
+
+// main
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+// Payloads as an edge node publishes them for the device `plc`.
+//
+// DBIRTH at 1700000000000, seq 1:
+//   Axes/Xact   alias 1 Double  10.5 with an engUnit property
+//   execution   alias 2 String  ACTIVE
+//   PartCount   alias 3 Int32   7
+//   Temperature alias 4 String  Normal
+//   Unmapped    alias 5 Boolean true
+static const string Birth =
+    "\x08\x80\xd0\x95\xff\xbc\x31\x12\x32\x0a\x09\x41\x78\x65\x73\x2f\x58\x61\x63\x74\x10\x01"
+    "\x18\x80\xd0\x95\xff\xbc\x31\x20\x0a\x4a\x11\x0a\x07\x65\x6e\x67\x55\x6e\x69\x74\x12\x06"
+    "\x08\x0c\x42\x02\x6d\x6d\x69\x00\x00\x00\x00\x00\x00\x25\x40\x12\x17\x0a\x09\x65\x78\x65"
+    "\x63\x75\x74\x69\x6f\x6e\x10\x02\x20\x0c\x7a\x06\x41\x43\x54\x49\x56\x45\x12\x11\x0a\x09"
+    "\x50\x61\x72\x74\x43\x6f\x75\x6e\x74\x10\x03\x20\x03\x50\x07\x12\x19\x0a\x0b\x54\x65\x6d"
+    "\x70\x65\x72\x61\x74\x75\x72\x65\x10\x04\x20\x0c\x7a\x06\x4e\x6f\x72\x6d\x61\x6c\x12\x10"
+    "\x0a\x08\x55\x6e\x6d\x61\x70\x70\x65\x64\x10\x05\x20\x0b\x70\x01\x18\x01"s;
+
+// DDATA at 1700000001000, seq 2, by alias only:
+//   1 11.25, 3 -2, 2 null, 4 Fault, 9 (not in the birth certificate) 1.5
+static const string Data =
+    "\x08\xe8\xd7\x95\xff\xbc\x31\x12\x12\x10\x01\x18\xe8\xd7\x95\xff\xbc\x31\x69\x00\x00\x00"
+    "\x00\x00\x80\x26\x40\x12\x08\x10\x03\x50\xfe\xff\xff\xff\x0f\x12\x04\x10\x02\x38\x01\x12"
+    "\x09\x10\x04\x7a\x05\x46\x61\x75\x6c\x74\x12\x07\x10\x09\x65\x00\x00\xc0\x3f\x18\x02"s;
+
+// DDEATH at 1700000002000, seq 3
+static const string Death = "\x08\xd0\xdf\x95\xff\xbc\x31\x18\x03"s;
+
+static const Timestamp BirthTime {1700000000000ms};
+
+class MockPipelineContract : public PipelineContract
+{
+public:
+  MockPipelineContract(std::map<string, DataItemPtr> &items) : m_dataItems(items) {}
+  DevicePtr findDevice(const std::string &name) override { return nullptr; }
+  DataItemPtr findDataItem(const std::string &device, const std::string &name) override
+  {
+    auto it = m_dataItems.find(name);
+    return it != m_dataItems.end() ? it->second : nullptr;
+  }
+  void eachDataItem(EachDataItem fun) override {}
+  void deliverObservation(observation::ObservationPtr obs) override
+  {
+    m_observations.push_back(obs);
+  }
+  void deliverAsset(AssetPtr) override {}
+  void deliverDevices(std::list<DevicePtr>) override {}
+  void deliverDevice(DevicePtr) override {}
+  void deliverAssetCommand(entity::EntityPtr) override {}
+  void deliverCommand(entity::EntityPtr) override {}
+  void deliverConnectStatus(entity::EntityPtr status, const StringList &, bool) override
+  {
+    m_status = status->getValue<string>();
+  }
+  void sourceFailed(const std::string &id) override {}
+  const ObservationPtr checkDuplicate(const ObservationPtr &obs) const override { return obs; }
+  int32_t getSchemaVersion() const override { return SCHEMA_VERSION(2, 3); };
+  bool isValidating() const override { return false; }
+
+  std::map<string, DataItemPtr> &m_dataItems;
+  std::list<ObservationPtr> m_observations;
+  string m_status;
+};
+
+class SparkplugMapperTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_context = make_shared<PipelineContext>();
+    m_context->m_contract = make_unique<MockPipelineContract>(m_dataItems);
+    m_mapper = make_shared<SparkplugMapper>(m_context);
+    m_mapper->bind(make_shared<NullTransform>(TypeGuard<Entity>(RUN)));
+
+    ErrorList errors;
+    Properties props {{"id", "plc"s}, {"name", "plc"s}, {"uuid", "plc"s}};
+    m_device = dynamic_pointer_cast<Device>(Device::getFactory()->make("Device", props, errors));
+
+    makeDataItem({{"id", "x"s}, {"name", "Xact"s}, {"type", "POSITION"s}, {"category", "SAMPLE"s}});
+    makeDataItem(
+        {{"id", "e"s}, {"name", "execution"s}, {"type", "EXECUTION"s}, {"category", "EVENT"s}});
+    makeDataItem(
+        {{"id", "c"s}, {"name", "PartCount"s}, {"type", "PART_COUNT"s}, {"category", "EVENT"s}});
+    makeDataItem({{"id", "t"s},
+                  {"name", "Temperature"s},
+                  {"type", "TEMPERATURE"s},
+                  {"category", "CONDITION"s}});
+  }
+
+  void TearDown() override
+  {
+    m_dataItems.clear();
+    m_device.reset();
+  }
+
+  void makeDataItem(const Properties &props)
+  {
+    Properties ps(props);
+    ErrorList errors;
+    auto di = DataItem::make(ps, errors);
+    ASSERT_TRUE(errors.empty());
+    m_dataItems.emplace(di->getId(), di);
+    m_dataItems.emplace(*di->getName(), di);
+    m_device->addDataItem(di, errors);
+  }
+
+  EntityList run(const string &type, const string &payload)
+  {
+    auto topic = "spBv1.0/Factory/" + type + "/edge1/plc";
+    auto message =
+        make_shared<Entity>("Message", Properties {{"VALUE", payload}, {"topic", topic}});
+    auto res = (*m_mapper)(std::move(message));
+    EXPECT_TRUE(dynamic_pointer_cast<Observations>(res));
+    return res->getValue<EntityList>();
+  }
+
+  static ObservationPtr find(const EntityList &list, const string &id)
+  {
+    for (auto &e : list)
+    {
+      auto obs = dynamic_pointer_cast<Observation>(e);
+      if (obs && obs->getDataItem()->getId() == id)
+        return obs;
+    }
+    return nullptr;
+  }
+
+  shared_ptr<PipelineContext> m_context;
+  shared_ptr<SparkplugMapper> m_mapper;
+  std::map<string, DataItemPtr> m_dataItems;
+  DevicePtr m_device;
+};
+
+TEST_F(SparkplugMapperTest, should_decode_a_payload)
+{
+  sparkplug::Payload payload;
+  ASSERT_TRUE(sparkplug::Decode(Birth, payload));
+
+  EXPECT_EQ(1700000000000, *payload.m_timestamp);
+  EXPECT_EQ(1, *payload.m_seq);
+  ASSERT_EQ(5, payload.m_metrics.size());
+
+  auto &xact = payload.m_metrics[0];
+  EXPECT_EQ("Axes/Xact", *xact.m_name);
+  EXPECT_EQ(1, *xact.m_alias);
+  EXPECT_EQ(sparkplug::DataType::DOUBLE, xact.m_datatype);
+  EXPECT_EQ(10.5, get<double>(xact.m_value));
+
+  auto &count = payload.m_metrics[2];
+  EXPECT_EQ("PartCount", *count.m_name);
+  EXPECT_EQ(sparkplug::DataType::INT32, count.m_datatype);
+  EXPECT_EQ(7, get<int64_t>(count.m_value));
+
+  EXPECT_EQ("ACTIVE", get<string>(payload.m_metrics[1].m_value));
+  EXPECT_TRUE(get<bool>(payload.m_metrics[4].m_value));
+
+  sparkplug::Payload truncated;
+  EXPECT_FALSE(sparkplug::Decode(Birth.substr(0, 40), truncated));
+}
+
+TEST_F(SparkplugMapperTest, should_interpret_integers_using_the_data_type)
+{
+  sparkplug::Metric metric;
+  metric.m_value = int64_t(0xFFFFFFFE);
+  EXPECT_EQ(-2, get<int64_t>(sparkplug::GetValue(metric, sparkplug::DataType::INT32)));
+  EXPECT_EQ(int64_t(0xFFFFFFFE), get<int64_t>(sparkplug::GetValue(metric, sparkplug::DataType::UINT32)));
+  EXPECT_EQ(-2, get<int64_t>(sparkplug::GetValue(metric, sparkplug::DataType::INT8)));
+
+  metric.m_value = int64_t(1700000000000);
+  EXPECT_EQ(BirthTime, get<Timestamp>(sparkplug::GetValue(metric, sparkplug::DataType::DATETIME)));
+
+  metric.m_isNull = true;
+  auto value = sparkplug::GetValue(metric, sparkplug::DataType::INT32);
+  EXPECT_TRUE(holds_alternative<monostate>(value));
+}
+
+TEST_F(SparkplugMapperTest, should_map_metrics_by_alias_after_the_birth_certificate)
+{
+  auto birth = run("DBIRTH", Birth);
+  ASSERT_EQ(4, birth.size());
+
+  auto xact = find(birth, "x");
+  ASSERT_TRUE(xact);
+  EXPECT_EQ(10.5, xact->getValue<double>());
+  EXPECT_EQ(BirthTime, xact->getTimestamp());
+  EXPECT_EQ("ACTIVE", find(birth, "e")->getValue<string>());
+  EXPECT_EQ("7", find(birth, "c")->getValue<string>());
+  auto temp = dynamic_pointer_cast<Condition>(find(birth, "t"));
+  ASSERT_TRUE(temp);
+  EXPECT_EQ(Condition::NORMAL, temp->getLevel());
+
+  auto data = run("DDATA", Data);
+  ASSERT_EQ(4, data.size());
+
+  xact = find(data, "x");
+  EXPECT_EQ(11.25, xact->getValue<double>());
+  EXPECT_EQ(BirthTime + 1s, xact->getTimestamp());
+  EXPECT_EQ("-2", find(data, "c")->getValue<string>());
+  EXPECT_TRUE(find(data, "e")->isUnavailable());
+  temp = dynamic_pointer_cast<Condition>(find(data, "t"));
+  EXPECT_EQ(Condition::FAULT, temp->getLevel());
+}
+
+TEST_F(SparkplugMapperTest, should_make_data_items_unavailable_when_the_device_dies)
+{
+  run("DBIRTH", Birth);
+
+  auto death = run("DDEATH", Death);
+  ASSERT_EQ(4, death.size());
+  for (auto &e : death)
+  {
+    auto obs = dynamic_pointer_cast<Observation>(e);
+    EXPECT_TRUE(obs->isUnavailable());
+    EXPECT_EQ(BirthTime + 2s, obs->getTimestamp());
+  }
+
+  // The aliases are forgotten until the next birth certificate
+  EXPECT_TRUE(run("DDATA", Data).empty());
+}
+
+TEST_F(SparkplugMapperTest, should_make_device_data_items_unavailable_when_the_node_dies)
+{
+  run("DBIRTH", Birth);
+
+  auto message = make_shared<Entity>(
+      "Message", Properties {{"VALUE", Death}, {"topic", "spBv1.0/Factory/NDEATH/edge1"s}});
+  auto death = (*m_mapper)(std::move(message))->getValue<EntityList>();
+  EXPECT_EQ(4, death.size());
+}
+
+TEST_F(SparkplugMapperTest, should_only_run_for_sparkplug_topics)
+{
+  Entity sparkplug("Message", Properties {{"VALUE", Data}, {"topic", "spBv1.0/G/DDATA/E/D"s}});
+  EXPECT_EQ(RUN, m_mapper->check(&sparkplug));
+
+  Entity other("Message", Properties {{"VALUE", "{}"s}, {"topic", "spBv1.0x/G/DDATA/E"s}});
+  EXPECT_EQ(CONTINUE, m_mapper->check(&other));
+}
+
+TEST_F(SparkplugMapperTest, should_receive_payloads_from_the_mqtt_adapter)
+{
+  using namespace mtconnect::configuration;
+  using namespace mtconnect::source::adapter::mqtt_adapter;
+
+  boost::asio::io_context ioc;
+  auto waitFor = [&ioc](function<bool()> pred) {
+    for (int i = 0; i < 50 && !pred(); i++)
+      ioc.run_for(100ms);
+    return pred();
+  };
+
+  ConfigOptions common {{MqttTls, false}, {AutoAvailable, false}, {RealTime, false}};
+  ConfigOptions serverOptions(common);
+  MergeOptions(serverOptions, {{ServerIp, "127.0.0.1"s}, {MqttPort, 0}});
+  auto server = make_shared<mqtt_server::MqttTcpServer>(ioc, serverOptions);
+  ASSERT_TRUE(server->start());
+  ioc.run_for(500ms);
+  int port = server->getPort();
+
+  auto contract = make_unique<MockPipelineContract>(m_dataItems);
+  auto &observations = contract->m_observations;
+  auto &status = contract->m_status;
+  auto context = make_shared<PipelineContext>();
+  context->m_contract = std::move(contract);
+
+  ConfigOptions options {{Url, "mqtt://127.0.0.1:"s + to_string(port)},
+                         {Host, "127.0.0.1"s},
+                         {Port, port},
+                         {Protocol, "mqtt"s},
+                         {Topics, StringList {"spBv1.0/#"s}}};
+  boost::property_tree::ptree tree;
+  auto adapter = make_shared<MqttAdapter>(ioc, context, options, tree);
+  ASSERT_TRUE(adapter->start());
+  ASSERT_TRUE(waitFor([&status]() { return status == "CONNECTED"; }));
+
+  ConfigOptions clientOptions(common);
+  MergeOptions(clientOptions, {{MqttHost, "127.0.0.1"s}, {MqttPort, port}});
+  auto client = make_shared<mqtt_client::MqttTcpClient>(ioc, clientOptions,
+                                                        make_unique<mqtt_client::ClientHandler>());
+  ASSERT_TRUE(client->start());
+  ASSERT_TRUE(waitFor([&client]() { return client->isConnected(); }));
+
+  client->publish("spBv1.0/Factory/DBIRTH/edge1/plc", Birth);
+  ASSERT_TRUE(waitFor([&observations]() { return observations.size() >= 4; }));
+  client->publish("spBv1.0/Factory/DDATA/edge1/plc", Data);
+  ASSERT_TRUE(waitFor([&observations]() { return observations.size() >= 8; }));
+
+  auto last = observations.back();
+  EXPECT_EQ("t", last->getDataItem()->getId());
+  EXPECT_EQ(Condition::FAULT, dynamic_pointer_cast<Condition>(last)->getLevel());
+
+  client->stop();
+  adapter->stop();
+  server->stop();
+  ioc.run_for(500ms);
+}
@@ -213,4 +213,42 @@ TEST(UtilitiesTest, ParseTimeMilli)
   ASSERT_TRUE(1353414802123000LL == time);
 }
 
+TEST(UtilitiesTest, should_format_timestamp_into_buffer_like_format)
+{
+  using namespace std::chrono;
+  char buffer[32];
+  Timestamp base(seconds(1353414802));
+  for (auto offset : {0LL, 1LL, 10LL, 120000LL, 123456LL, 999999LL, 500000000LL, -1LL})
+  {
+    auto ts = base + microseconds(offset);
+    ASSERT_EQ(format(ts), formatTimestamp(ts, buffer));
+  }
+
+  ASSERT_EQ("2012-11-20T12:33:22Z", formatTimestamp(base, buffer));
+  ASSERT_EQ("2012-11-20T12:33:22.12Z", formatTimestamp(base + milliseconds(120), buffer));
+  ASSERT_EQ("1969-12-31T23:59:59.5Z", formatTimestamp(Timestamp(milliseconds(-500)), buffer));
+}
+
 TEST(UtilitiesTest, Int64ToString) { ASSERT_EQ((string) "8805345009", to_string(8805345009ULL)); }
+
+TEST(UtilitiesTest, should_call_each_index_once_on_multiple_threads)
+{
+  vector<atomic_int> calls(100);
+  ParallelFor(calls.size(), 4, [&](size_t i) { calls[i]++; });
+  for (auto &c : calls)
+    ASSERT_EQ(1, c);
+
+  int serial = 0;
+  ParallelFor(10, 1, [&](size_t i) { ASSERT_EQ(serial++, int(i)); });
+  ASSERT_EQ(10, serial);
+}
+
+TEST(UtilitiesTest, should_rethrow_exception_from_parallel_for)
+{
+  ASSERT_THROW(ParallelFor(20, 4,
+                           [](size_t i) {
+                             if (i == 7)
+                               throw runtime_error("failed");
+                           }),
+               runtime_error);
+}
@@ -90,6 +90,13 @@ public:
               std::string(BOOST_BEAST_VERSION_STRING) + " websocket-client");
     }));
 
+    if (m_deflate)
+    {
+      websocket::permessage_deflate pmd;
+      pmd.client_enable = true;
+      m_stream.set_option(pmd);
+    }
+
     string host = "127.0.0.1:" + std::to_string(port);
     m_stream.async_handshake(host, "/", yield[ec]);
 
@@ -106,6 +113,7 @@ public:
   void onRead(beast::error_code ec, std::size_t bytes_transferred)
   {
     m_result = beast::buffers_to_string(m_buffer.data());
+    m_binary = m_stream.got_binary();
     m_buffer.consume(m_buffer.size());
 
     m_done = true;
@@ -153,6 +161,8 @@ public:
   }
 
   bool m_connected {false};
+  bool m_deflate {false};
+  bool m_binary {false};
   int m_status;
   std::string m_result;
   asio::io_context& m_context;
@@ -252,6 +262,39 @@ TEST_F(WebsocketsTest, should_make_simple_request)
   ASSERT_EQ("All Devices for 1", m_client->m_result);
 }
 
+TEST_F(WebsocketsTest, should_negotiate_compression_and_send_binary_frames)
+{
+  using namespace mtconnect::configuration;
+  createServer({{WebsocketCompression, true}});
+
+  auto sample = [&](SessionPtr session, RequestPtr request) -> bool {
+    ResponsePtr resp = make_unique<Response>(status::ok);
+    resp->m_body = string("MTCB\x01\x01\x00", 7) + *request->m_requestId;
+    resp->m_mimeType = "application/vnd.mtconnect.binary";
+    resp->m_requestId = request->m_requestId;
+    session->writeResponse(std::move(resp));
+    return true;
+  };
+
+  m_server->addRouting({boost::beast::http::verb::get, "/sample", sample}).command("sample");
+  m_server->addCommands();
+
+  start();
+  m_client->m_deflate = true;
+  startClient();
+
+  asio::spawn(m_context,
+              std::bind(&Client::request, m_client.get(), "{\"id\":\"2\",\"request\":\"sample\"}"s,
+                        std::placeholders::_1),
+              boost::asio::detached);
+
+  m_client->waitFor(2s, [this]() { return m_client->m_done; });
+
+  ASSERT_TRUE(m_client->m_done);
+  ASSERT_TRUE(m_client->m_binary);
+  ASSERT_EQ(string("MTCB\x01\x01\x00", 7) + "2", m_client->m_result);
+}
+
 TEST_F(WebsocketsTest, should_return_error_when_there_is_no_id)
 {
   weak_ptr<Session> savedSession;
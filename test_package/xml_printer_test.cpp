@@ -20,6 +20,7 @@
 // Keep this comment to keep gtest.h above. (clang-format off/on is not working here!)
 
 #include "mtconnect/asset/asset.hpp"
+#include "mtconnect/asset/cutting_tool.hpp"
 #include "mtconnect/buffer/checkpoint.hpp"
 #include "mtconnect/device_model/data_item/data_item.hpp"
 #include "mtconnect/device_model/device.hpp"
@@ -516,6 +517,95 @@ TEST_F(XmlPrinterTest, PrintSample)
                         "x-1.149250 y1.048981");
 }
 
+TEST_F(XmlPrinterTest, should_reuse_cached_observation_text)
+{
+  XmlPrinter printer(false);
+  printer.setSchemaVersion("1.2");
+
+  ObservationList events {newEvent("Xact", 10843512, "0.553472"_value),
+                          newEvent("line", 11351720, "229"_value),
+                          newEvent("block", 11351726, "x<1.149250 & y>1.048981"_value)};
+
+  auto streams = [&]() {
+    auto doc = printer.printSample(123, 131072, 10974584, 10843512, 10123800, events);
+    return doc.substr(doc.find("<Streams>"));
+  };
+
+  const uint32_t key = XML_OBSERVATION | SCHEMA_VERSION(1, 2);
+  auto expected = streams();
+  ASSERT_FALSE(events[0]->getRenderCache().get(key));
+
+  printer.setRenderCache(true);
+  ASSERT_EQ(expected, streams());
+  for (auto &event : events)
+    ASSERT_TRUE(event->getRenderCache().get(key));
+  ASSERT_EQ(expected, streams());
+
+  // Each schema version has its own text
+  printer.setSchemaVersion("2.3");
+  printer.setRenderCache(false);
+  auto expected23 = streams();
+  printer.setRenderCache(true);
+  ASSERT_EQ(expected23, streams());
+  ASSERT_TRUE(events[0]->getRenderCache().get(XML_OBSERVATION | SCHEMA_VERSION(2, 3)));
+  ASSERT_NE(events[0]->getRenderCache().get(key),
+            events[0]->getRenderCache().get(XML_OBSERVATION | SCHEMA_VERSION(2, 3)));
+
+  // Copies are made to be modified and do not share the cached text
+  auto copy = events[0]->copy();
+  ASSERT_FALSE(copy->getRenderCache().get(key));
+}
+
+TEST_F(XmlPrinterTest, should_reuse_cached_asset_text_until_the_asset_changes)
+{
+  XmlPrinter printer(false);
+  printer.setSchemaVersion("2.0");
+  asset::CuttingTool::registerAsset();
+
+  ErrorList errors;
+  Properties props {{"assetId", "T1"s},
+                    {"deviceUuid", "D1"s},
+                    {"timestamp", "2020-12-01T12:00:00Z"s},
+                    {"serialNumber", "S1"s},
+                    {"toolId", "100"s}};
+  auto asset = dynamic_pointer_cast<asset::Asset>(
+      asset::CuttingTool::getFactory()->make("CuttingTool", props, errors));
+  ASSERT_EQ(0, errors.size());
+  asset::AssetList list {asset};
+
+  auto assets = [&]() {
+    auto doc = printer.printAssets(123, 1024, 1, list);
+    return doc.substr(doc.find("<Assets>"));
+  };
+
+  const uint32_t key = XML_ASSET | SCHEMA_VERSION(2, 0);
+  auto expected = assets();
+  ASSERT_FALSE(asset->getRenderCache().get(key));
+
+  printer.setAssetRenderCache(true);
+  ASSERT_EQ(expected, assets());
+  ASSERT_TRUE(asset->getRenderCache().get(key));
+  ASSERT_EQ(expected, assets());
+
+  // Changing the asset invalidates the cached text
+  asset->setRemoved();
+  ASSERT_FALSE(asset->getRenderCache().get(key));
+  auto removed = assets();
+  ASSERT_NE(string::npos, removed.find("removed=\"true\""));
+  ASSERT_TRUE(asset->getRenderCache().get(key));
+
+  // As does adding to an entity list
+  auto note = make_shared<Factory>(Requirements {{"VALUE", true}});
+  auto notes = make_shared<Factory>(
+      Requirements {{"Note", ValueType::ENTITY, note, 1, Requirement::Infinite}});
+  auto parent =
+      make_shared<Factory>(Requirements {{"Notes", ValueType::ENTITY_LIST, notes, false}});
+  Properties noteProps {{"VALUE", "checked"s}};
+  auto entity = note->make("Note", noteProps, errors);
+  ASSERT_TRUE(asset->addToList("Notes", parent, entity, errors));
+  ASSERT_FALSE(asset->getRenderCache().get(key));
+}
+
 TEST_F(XmlPrinterTest, Condition)
 {
   Checkpoint checkpoint;
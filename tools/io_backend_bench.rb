@@ -0,0 +1,194 @@
+# Compares the I/O backends of agent builds. Runs each agent with N simulated SHDR adapters and
+# M streaming sample clients and reports the system calls per observation and the CPU time per
+# client. The worker thread options measure the scaling of sharded io contexts. The system calls
+# are counted with `perf stat`, which needs permission to use the raw_syscalls tracepoints
+# (run as root or lower kernel.perf_event_paranoid).
+#
+# usage: ruby io_backend_bench.rb [options] <agent> [<agent> ...]
+#
+#   ruby io_backend_bench.rb -a 500 -c 300 build-epoll/bin/agent build-uring/bin/agent
+#   ruby io_backend_bench.rb -w 16 -s device_hash --affinity build/bin/agent
+
+require 'fileutils'
+require 'net/http'
+require 'optparse'
+require 'socket'
+require 'time'
+require 'tmpdir'
+
+options = { adapters: 500, clients: 300, rate: 10, duration: 30, port: 5100, http: 5099,
+            threads: 4, sharding: 'none', affinity: false }
+OptionParser.new do |opts|
+  opts.banner = 'usage: io_backend_bench.rb [options] <agent> [<agent> ...]'
+  opts.on('-a', '--adapters N', Integer, 'Number of SHDR adapters') { |v| options[:adapters] = v }
+  opts.on('-c', '--clients N', Integer, 'Number of streaming clients') { |v| options[:clients] = v }
+  opts.on('-r', '--rate N', Integer, 'Lines per second per adapter') { |v| options[:rate] = v }
+  opts.on('-d', '--duration S', Integer, 'Seconds to measure') { |v| options[:duration] = v }
+  opts.on('-p', '--port N', Integer, 'First adapter port') { |v| options[:port] = v }
+  opts.on('-w', '--workers N', Integer, 'Agent worker threads') { |v| options[:threads] = v }
+  opts.on('-s', '--sharding MODE', 'none, round_robin or device_hash') do |v|
+    options[:sharding] = v
+  end
+  opts.on('--affinity', 'Pin the worker threads to CPUs') { options[:affinity] = true }
+end.parse!
+
+if ARGV.empty?
+  puts 'usage: io_backend_bench.rb [options] <agent> [<agent> ...]'
+  exit 9
+end
+
+CLK_TCK = 100.0
+
+def write_config(dir, options)
+  File.open(File.join(dir, 'devices.xml'), 'w') do |f|
+    f.puts '<?xml version="1.0" encoding="UTF-8"?>'
+    f.puts '<MTConnectDevices xmlns="urn:mtconnect.org:MTConnectDevices:2.0">'
+    f.puts '<Header creationTime="2025-01-01T00:00:00Z" sender="bench" instanceId="1" ' \
+           'bufferSize="131072" version="2.0"/>'
+    f.puts '<Devices>'
+    options[:adapters].times do |i|
+      f.puts <<~DEVICE
+        <Device id="d#{i}" name="d#{i}" uuid="bench-#{i}">
+          <DataItems>
+            <DataItem id="d#{i}_avail" type="AVAILABILITY" category="EVENT"/>
+            <DataItem id="d#{i}_x" name="x" type="POSITION" category="SAMPLE" units="MILLIMETER"/>
+            <DataItem id="d#{i}_exec" name="exec" type="EXECUTION" category="EVENT"/>
+          </DataItems>
+        </Device>
+      DEVICE
+    end
+    f.puts '</Devices></MTConnectDevices>'
+  end
+
+  File.open(File.join(dir, 'agent.cfg'), 'w') do |f|
+    f.puts <<~CONFIG
+      Devices = #{File.join(dir, 'devices.xml')}
+      Port = #{options[:http]}
+      WorkerThreads = #{options[:threads]}
+      WorkerSharding = #{options[:sharding]}
+      WorkerAffinity = #{options[:affinity]}
+      BufferSize = 17
+      SchemaVersion = 2.0
+      logger_config {
+        output = file #{File.join(dir, 'agent.log')}
+        level = info
+      }
+    CONFIG
+    f.puts 'Adapters {'
+    options[:adapters].times do |i|
+      f.puts "  d#{i} {\n    Host = 127.0.0.1\n    Port = #{options[:port] + i}\n  }"
+    end
+    f.puts '}'
+  end
+end
+
+# Each adapter accepts the agent connection, answers pings, and sends a position and an
+# execution at the rate
+def start_adapters(options, running)
+  options[:adapters].times.map do |i|
+    server = TCPServer.new('127.0.0.1', options[:port] + i)
+    Thread.new do
+      while running[0]
+        socket = server.accept
+        interval = 1.0 / options[:rate]
+        n = 0
+        begin
+          while running[0]
+            if (line = socket.read_nonblock(1024, exception: false)).is_a?(String) &&
+               line.include?('* PING')
+              socket.write("* PONG 10000\n")
+            end
+            n += 1
+            exec = n.even? ? 'ACTIVE' : 'READY'
+            socket.write("#{Time.now.utc.iso8601(6)}|x|#{n % 1000}.5|exec|#{exec}\n")
+            sleep interval
+          end
+        rescue StandardError
+          socket.close
+        end
+      end
+    end
+  end
+end
+
+def start_clients(options, running)
+  options[:clients].times.map do |i|
+    Thread.new do
+      Net::HTTP.start('127.0.0.1', options[:http]) do |http|
+        path = "/d#{i % options[:adapters]}/sample?interval=100&heartbeat=10000&count=1000"
+        http.request_get(path) do |res|
+          res.read_body { |_| break unless running[0] }
+        end
+      end
+    rescue StandardError
+      nil
+    end
+  end
+end
+
+def next_sequence(options)
+  body = Net::HTTP.get(URI("http://127.0.0.1:#{options[:http]}/current?path=//Header"))
+  body[/nextSequence="(\d+)"/, 1].to_i
+end
+
+def cpu_ticks(pid)
+  fields = File.read("/proc/#{pid}/stat").split(') ').last.split
+  fields[11].to_i + fields[12].to_i
+end
+
+def count_syscalls(pid, duration)
+  out = `perf stat -x, -e raw_syscalls:sys_enter -p #{pid} -- sleep #{duration} 2>&1`
+  count = out[/^(\d+),/, 1]
+  count&.to_i
+end
+
+def bench(agent, options)
+  Dir.mktmpdir('io_bench') do |dir|
+    write_config(dir, options)
+    running = [true]
+    adapters = start_adapters(options, running)
+    pid = spawn(agent, 'run', File.join(dir, 'agent.cfg'), out: File::NULL, err: File::NULL)
+
+    begin
+      sleep 1 until begin
+        next_sequence(options)
+      rescue StandardError
+        nil
+      end
+      clients = start_clients(options, running)
+      sleep 5
+
+      backend = File.read(File.join(dir, 'agent.log'))[/worker threads using (\w+)/, 1]
+      seq = next_sequence(options)
+      ticks = cpu_ticks(pid)
+      syscalls = count_syscalls(pid, options[:duration])
+      observations = next_sequence(options) - seq
+      cpu = (cpu_ticks(pid) - ticks) / CLK_TCK
+
+      running[0] = false
+      { agent: agent, backend: backend || 'unknown', observations: observations,
+        syscalls: syscalls, cpu: cpu }
+    ensure
+      running[0] = false
+      Process.kill('TERM', pid)
+      Process.wait(pid)
+      (clients || []).each { |t| t.join(1) }
+      adapters.each { |t| t.join(1) }
+    end
+  end
+end
+
+results = ARGV.map { |agent| bench(agent, options) }
+
+puts "#{options[:threads]} workers, sharding #{options[:sharding]}, affinity #{options[:affinity]}"
+puts format('%-10s %12s %14s %14s %16s', 'backend', 'obs/s', 'syscalls/s', 'syscalls/obs',
+            'CPU ms/client/s')
+results.each do |r|
+  per_second = r[:observations] / options[:duration].to_f
+  syscalls = r[:syscalls] ? r[:syscalls] / options[:duration].to_f : nil
+  per_obs = r[:syscalls] && r[:observations].positive? ? r[:syscalls].to_f / r[:observations] : nil
+  per_client = r[:cpu] * 1000 / options[:duration] / [options[:clients], 1].max
+  puts format('%-10s %12.0f %14s %14s %16.3f', r[:backend], per_second,
+              syscalls ? format('%.0f', syscalls) : 'n/a',
+              per_obs ? format('%.3f', per_obs) : 'n/a', per_client)
+end
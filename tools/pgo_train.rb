@@ -0,0 +1,131 @@
+# Training workload for a profile guided optimization build. Runs the instrumented agent with
+# the demo OKUMA device while agent_loadgen replays the recorded demo SHDR file through several
+# adapters, with streaming, polling and WebSocket clients requesting XML and then JSON
+# documents. Probe and asset requests cover the remaining REST paths. The agent is stopped
+# with SIGTERM so it writes its profile when it exits. agent_loadgen links the instrumented
+# agent library, its profile is written to the excluded directory.
+#
+# usage: ruby pgo_train.rb --agent <agent> --loadgen <agent_loadgen> [options]
+#
+# The pgo-train build target runs this script when the build is configured with
+# AGENT_PGO=GENERATE and AGENT_WITH_LOADGEN.
+
+require 'fileutils'
+require 'net/http'
+require 'optparse'
+
+source = File.expand_path('..', __dir__)
+options = { dir: 'pgo_train', excluded: 'pgo_excluded', adapters: 4, rate: 2000, duration: 20, port: 5200, http: 5199,
+            threads: 2, replay: File.join(source, 'demo', 'agent', 'okuma.txt'),
+            devices: File.join(source, 'demo', 'agent', 'Devices.xml') }
+OptionParser.new do |opts|
+  opts.banner = 'usage: pgo_train.rb --agent <agent> --loadgen <agent_loadgen> [options]'
+  opts.on('--agent PATH', 'The instrumented agent') { |v| options[:agent] = v }
+  opts.on('--loadgen PATH', 'The agent_loadgen executable') { |v| options[:loadgen] = v }
+  opts.on('--dir DIR', 'Working directory for the configuration and logs') do |v|
+    options[:dir] = v
+  end
+  opts.on('--excluded-dir DIR', 'Directory for the agent_loadgen profile') do |v|
+    options[:excluded] = v
+  end
+  opts.on('-a', '--adapters N', Integer, 'Number of replaying adapters') do |v|
+    options[:adapters] = v
+  end
+  opts.on('-r', '--rate N', Integer, 'Lines per second per adapter') { |v| options[:rate] = v }
+  opts.on('-d', '--duration S', Integer, 'Seconds for each document format') do |v|
+    options[:duration] = v
+  end
+  opts.on('-p', '--port N', Integer, 'First adapter port') { |v| options[:port] = v }
+  opts.on('--replay FILE', 'Recorded SHDR file to replay') { |v| options[:replay] = v }
+end.parse!
+
+unless options[:agent] && options[:loadgen]
+  puts 'usage: pgo_train.rb --agent <agent> --loadgen <agent_loadgen> [options]'
+  exit 9
+end
+
+def write_config(dir, options)
+  File.open(File.join(dir, 'agent.cfg'), 'w') do |f|
+    f.puts <<~CONFIG
+      Devices = #{options[:devices]}
+      Port = #{options[:http]}
+      WorkerThreads = #{options[:threads]}
+      BufferSize = 17
+      JsonVersion = 2
+      ReconnectInterval = 500
+      logger_config {
+        output = file #{File.join(dir, 'agent.log')}
+        level = warning
+      }
+    CONFIG
+    f.puts 'Adapters {'
+    options[:adapters].times do |i|
+      f.puts "  okuma#{i} {\n    Device = OKUMA\n    Host = 127.0.0.1\n" \
+             "    Port = #{options[:port] + i}\n  }"
+    end
+    f.puts '}'
+  end
+end
+
+def get(options, path, accept)
+  Net::HTTP.start('127.0.0.1', options[:http]) do |http|
+    http.request(Net::HTTP::Get.new(path, 'Accept' => accept))
+  end
+end
+
+def wait_for_agent(options)
+  60.times do
+    return if get(options, '/probe', 'text/xml').is_a?(Net::HTTPSuccess)
+  rescue StandardError
+    sleep 0.5
+  end
+  raise 'the agent did not start'
+end
+
+# The request paths the load clients do not cover
+def requests(options, accept)
+  ['/probe', '/OKUMA/probe', '/current?path=//DataItem[@category="SAMPLE"]',
+   '/sample?count=1000', '/sample?from=1&count=100', '/assets', '/current?at=1']
+    .each { |path| get(options, path, accept) }
+end
+
+def run_load(options, format)
+  # LLVM_PROFILE_FILE redirects a Clang profile, GCOV_PREFIX a GCC profile
+  excluded = File.expand_path(options[:excluded])
+  env = { 'LLVM_PROFILE_FILE' => File.join(excluded, '%p.profraw'), 'GCOV_PREFIX' => excluded }
+  system(env, options[:loadgen], 'run', '--adapters', options[:adapters].to_s,
+         '--port', options[:port].to_s, '--rate', options[:rate].to_s,
+         '--replay', options[:replay], '--agent-port', options[:http].to_s,
+         '--host', '127.0.0.1', '--format', format,
+         '--sample-clients', '4', '--current-clients', '2', '--websocket-clients', '2',
+         '--sample-interval', '10', '--poll-interval', '200',
+         '--duration', options[:duration].to_s, '--warmup', '2', '--report', '10',
+         '--threads', '2', exception: true)
+end
+
+FileUtils.mkdir_p(options[:dir])
+dir = File.expand_path(options[:dir])
+write_config(dir, options)
+
+# The adapters must be listening before the agent connects, start the first load
+# generator in the background and the agent after it
+pid = nil
+begin
+  %w[xml json].each_with_index do |format, i|
+    loader = Thread.new { run_load(options, format) }
+    sleep 1
+    if i.zero?
+      pid = spawn(options[:agent], 'run', File.join(dir, 'agent.cfg'), chdir: dir)
+      wait_for_agent(options)
+    end
+    accept = format == 'json' ? 'application/json' : 'text/xml'
+    requests(options, accept)
+    loader.join
+    requests(options, accept)
+  end
+ensure
+  if pid
+    Process.kill('TERM', pid)
+    Process.wait(pid)
+  end
+end
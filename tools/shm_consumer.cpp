@@ -0,0 +1,121 @@
+//
+// Copyright Copyright 2009-2025, AMT – The Association For Manufacturing Technology (“AMT”)
+// All rights reserved.
+//
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+//
+
+// Prints the observations the ShmSink writes to a shared memory ring.
+//
+// Build from the root of the repository:
+//
+//   c++ -std=c++17 -O2 -Isrc tools/shm_consumer.cpp -o shm_consumer -lrt
+//
+// Usage: shm_consumer [name] [--oldest]
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "mtconnect/sink/shm_sink/shm_ring.hpp"
+
+using namespace std;
+using namespace mtconnect::sink::shm_sink;
+
+static void print(ShmRingReader &reader, const Record &record)
+{
+  cout << record.m_sequence << ' ' << record.m_timestamp << ' '
+       << reader.dataItemId(record.m_dataItem) << ' ';
+  switch (record.m_kind)
+  {
+    case Kind::UNAVAILABLE:
+      cout << "UNAVAILABLE";
+      break;
+
+    case Kind::DOUBLE:
+      cout << record.asDouble();
+      break;
+
+    case Kind::INTEGER:
+      cout << record.asInteger();
+      break;
+
+    case Kind::VECTOR:
+      for (auto v : record.asVector())
+        cout << v << ' ';
+      break;
+
+    case Kind::CONDITION:
+    {
+      static const char *levels[] = {"NORMAL", "WARNING", "FAULT", "UNAVAILABLE"};
+      cout << (record.m_level < 4 ? levels[record.m_level] : "?") << ' ' << record.nativeCode()
+           << ' ' << record.message();
+      break;
+    }
+
+    case Kind::STRING:
+    case Kind::DATA_SET:
+      cout << record.asString();
+      break;
+  }
+  if (record.m_flags & TRUNCATED)
+    cout << " (truncated)";
+  cout << '\n';
+}
+
+int main(int argc, char *argv[])
+{
+  string name = "/mtconnect_observations";
+  bool oldest = false;
+  for (int i = 1; i < argc; i++)
+  {
+    string arg = argv[i];
+    if (arg == "--oldest")
+      oldest = true;
+    else
+      name = arg;
+  }
+
+  try
+  {
+    ShmRingReader reader(name, oldest);
+    cerr << "Following " << name << " instance " << reader.getInstanceId() << endl;
+
+    Record record;
+    while (true)
+    {
+      switch (reader.read(record))
+      {
+        case ShmRingReader::Status::RECORD:
+          print(reader, record);
+          break;
+
+        case ShmRingReader::Status::OVERRUN:
+          cerr << "Overrun, skipped " << reader.getSkipped() << " slots in total" << endl;
+          break;
+
+        case ShmRingReader::Status::EMPTY:
+          cout.flush();
+          this_thread::sleep_for(chrono::milliseconds(1));
+          break;
+      }
+    }
+  }
+  catch (exception &e)
+  {
+    cerr << e.what() << endl;
+    return 1;
+  }
+
+  return 0;
+}